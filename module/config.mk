@@ -75,12 +75,18 @@ CSRCS = \
 	../module/usb_disk_mode.c   				\
 	../src/command.c					\
 	../src/every.c					\
+	../src/grid_key.c					\
 	../src/helpers.c					\
 	../src/drum_helpers.c					\
-	../src/match_token.c					\
+	../src/ii_cache.c					\
+	../src/ii_queue.c					\
+	../src/midi_script.c					\
+	../src/match_token_hash.c				\
+	../src/quantize.c					\
 	../src/scanner.c					\
 	../src/scale.c						\
 	../src/scene_serialization.c				\
+	../src/script_packing.c					\
 	../src/state.c						\
 	../src/table.c						\
 	../src/teletype.c					\
@@ -108,6 +114,7 @@ CSRCS = \
 	../src/ops/midi.c					\
 	../src/ops/orca.c      					\
 	../src/ops/patterns.c					\
+	../src/ops/prof.c					\
 	../src/ops/queue.c					\
 	../src/ops/stack.c					\
 	../src/ops/telex.c					\
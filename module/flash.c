@@ -1,5 +1,6 @@
 #include "flash.h"
 
+#include <stddef.h>
 #include <string.h>
 
 // asf
@@ -10,9 +11,11 @@
 #include "print_funcs.h"
 
 // this
+#include "helpers.h"
+#include "script_packing.h"
 #include "teletype.h"
 
-#define FIRSTRUN_KEY 0x22
+#define FIRSTRUN_KEY 0x24
 #define BUTTON_STATE_SIZE (GRID_BUTTON_COUNT >> 3)
 
 typedef struct {
@@ -21,12 +24,32 @@ typedef struct {
 } grid_data_t;
 static grid_data_t grid_data;
 
+// scripts packed with pack_scripts, followed by the text as consecutive nul
+// terminated lines. Only the first length bytes of data are ever written.
+// The size is what is left of NVRAM_SIZE for each of the 64 slots once the
+// patterns and grid are stored. Typed scripts pack into about 10 * (1 + 6 *
+// 34) = 2050 bytes, but scenes loaded over USB can need up to
+// SCRIPT_PACKED_MAX_SIZE plus the text, and flash_write refuses those rather
+// than store part of them.
+#define PACKED_SCENE_SIZE 2536
+
+// __flash_nvram_size__ in config.mk
+#define NVRAM_SIZE (200 * 1024)
+
+typedef struct {
+    uint16_t text_offset;
+    uint16_t length;
+    uint8_t data[PACKED_SCENE_SIZE];
+} packed_scene_t;
+static packed_scene_t packed_scene;
+
 // NVRAM data structure located in the flash array.
 typedef const struct {
-    scene_script_t scripts[EDITABLE_SCRIPT_COUNT];
     scene_pattern_t patterns[PATTERN_COUNT];
     grid_data_t grid_data;
-    char text[SCENE_TEXT_LINES][SCENE_TEXT_CHARS];
+    // CRC-32 of the rest of the scene, see flash_scene_hash
+    uint32_t hash;
+    packed_scene_t packed;
 } nvram_scene_t;
 
 typedef const struct {
@@ -41,14 +64,56 @@ typedef const struct {
 
 static __attribute__((__section__(".flash_nvram"))) nvram_data_t f;
 
+// fails to compile if the slots have outgrown the section
+typedef char nvram_fits[sizeof(nvram_data_t) <= NVRAM_SIZE ? 1 : -1];
+
+// The layout used before scenes were packed, 32 slots of unpacked scripts and
+// text. flash_prepare moves the scenes from it to the packed layout once.
+#define OLD_FIRSTRUN_KEY 0x22
+#define OLD_SCENE_SLOTS 32
+
+typedef const struct {
+    scene_script_t scripts[EDITABLE_SCRIPT_COUNT];
+    scene_pattern_t patterns[PATTERN_COUNT];
+    grid_data_t grid_data;
+    char text[SCENE_TEXT_LINES][SCENE_TEXT_CHARS];
+} old_nvram_scene_t;
+
+typedef const struct {
+    old_nvram_scene_t scenes[OLD_SCENE_SLOTS];
+    uint8_t last_scene;
+    tele_mode_t last_mode;
+    uint8_t fresh;
+    cal_data_t cal;
+    device_config_t device_config;
+} old_nvram_data_t;
+
+#define OLD_F ((old_nvram_data_t *)&f)
+
 static void pack_grid(scene_state_t *scene);
 static void unpack_grid(scene_state_t *scene);
+static bool pack_scene(scene_state_t *scene,
+                       char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS]);
+static void unpack_text(const packed_scene_t *p,
+                        char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS]);
+static const char *packed_text(const packed_scene_t *p, const char **end);
+static void write_changed_pages(volatile void *dst, const void *src, size_t n);
+static void migrate_old_scenes(void);
+
+// pages erased and written by the last flash_write
+static uint16_t last_write_pages;
 
 u8 is_flash_fresh() {
-    return f.fresh != FIRSTRUN_KEY;
+    return f.fresh != FIRSTRUN_KEY && OLD_F->fresh != OLD_FIRSTRUN_KEY;
 }
 
 void flash_prepare() {
+    // scenes saved by an earlier version are kept
+    if (f.fresh != FIRSTRUN_KEY && OLD_F->fresh == OLD_FIRSTRUN_KEY) {
+        migrate_old_scenes();
+        return;
+    }
+
     // if it's not empty return
     if (f.fresh != FIRSTRUN_KEY) {
         int confirm = 1;
@@ -94,18 +159,92 @@ void flash_prepare() {
     }
 }
 
-void flash_write(uint8_t preset_no, scene_state_t *scene,
+// Slot i of the new layout ends before slot i + 1 of the old one starts, so
+// copying the slots in order reads each old slot before it is overwritten. The
+// settings after the old slots are kept in RAM as the last new slots cover
+// them.
+static void migrate_old_scenes() {
+    print_dbg("\r\n:::: packing scenes saved by an earlier version");
+
+    uint8_t last_scene = OLD_F->last_scene;
+    cal_data_t cal = OLD_F->cal;
+    device_config_t device_config = OLD_F->device_config;
+
+    // an interrupted migration must not be started again over packed slots
+    flashc_memset8((void *)&OLD_F->fresh, 0xFF, 1, true);
+
+    scene_state_t scene;
+    char text[SCENE_TEXT_LINES][SCENE_TEXT_CHARS];
+    for (uint8_t i = 0; i < SCENE_SLOTS; i++) {
+        ss_init(&scene);
+        memset(text, 0, SCENE_TEXT_LINES * SCENE_TEXT_CHARS);
+        if (i < OLD_SCENE_SLOTS) {
+            old_nvram_scene_t *old = &OLD_F->scenes[i];
+            memcpy(ss_scripts_ptr(&scene), &old->scripts,
+                   ss_scripts_size(EDITABLE_SCRIPT_COUNT));
+            memcpy(ss_patterns_ptr(&scene), &old->patterns,
+                   ss_patterns_size());
+            memcpy(&grid_data, &old->grid_data, sizeof(grid_data_t));
+            unpack_grid(&scene);
+            memcpy(text, &old->text, SCENE_TEXT_LINES * SCENE_TEXT_CHARS);
+        }
+
+        // typed scripts always fit, a scene with long text loses its last
+        // lines
+        uint8_t lines = SCENE_TEXT_LINES;
+        while (!flash_write(i, &scene, &text) && lines > 0)
+            text[--lines][0] = 0;
+    }
+
+    flashc_memcpy((void *)&f.cal, &cal, sizeof(cal), true);
+    flashc_memcpy((void *)&f.device_config, &device_config,
+                  sizeof(device_config), true);
+    flash_update_last_saved_scene(last_scene);
+    flash_update_last_mode(M_LIVE);
+    flashc_memset8((void *)&f.fresh, FIRSTRUN_KEY, 1, true);
+}
+
+// returns false, and leaves the slot as it was, if the scene is too large to
+// store
+bool flash_write(uint8_t preset_no, scene_state_t *scene,
                  char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS]) {
-    if (preset_no >= SCENE_SLOTS) return;
-    flashc_memcpy((void *)&f.scenes[preset_no].scripts, ss_scripts_ptr(scene),
-                  ss_scripts_size(EDITABLE_SCRIPT_COUNT), true);
-    flashc_memcpy((void *)&f.scenes[preset_no].patterns, ss_patterns_ptr(scene),
-                  ss_patterns_size(), true);
+    last_write_pages = 0;
+    if (preset_no >= SCENE_SLOTS) return false;
+    if (!pack_scene(scene, text)) {
+        print_dbg("\r\nscene too large to save: ");
+        print_dbg_ulong(preset_no);
+        return false;
+    }
+    write_changed_pages(&f.scenes[preset_no].patterns, ss_patterns_ptr(scene),
+                        ss_patterns_size());
     pack_grid(scene);
-    flashc_memcpy((void *)&f.scenes[preset_no].grid_data, &grid_data,
-                  sizeof(grid_data_t), true);
-    flashc_memcpy((void *)&f.scenes[preset_no].text, text,
-                  SCENE_TEXT_LINES * SCENE_TEXT_CHARS, true);
+    write_changed_pages(&f.scenes[preset_no].grid_data, &grid_data,
+                        sizeof(grid_data_t));
+    // only write the part of data that's in use, so a short scene only erases
+    // the pages it touches
+    const size_t packed_size =
+        offsetof(packed_scene_t, data) + packed_scene.length;
+    write_changed_pages(&f.scenes[preset_no].packed, &packed_scene,
+                        packed_size);
+
+    uint32_t hash = 0xFFFFFFFF;
+    hash = crc32_update(hash, (const uint8_t *)ss_patterns_ptr(scene),
+                        ss_patterns_size());
+    hash = crc32_update(hash, (const uint8_t *)&grid_data, sizeof(grid_data));
+    hash = ~crc32_update(hash, (const uint8_t *)&packed_scene, packed_size);
+    write_changed_pages(&f.scenes[preset_no].hash, &hash, sizeof(hash));
+    return true;
+}
+
+// a hash of everything stored for a scene, two slots with the same hash hold
+// the same scene
+uint32_t flash_scene_hash(uint8_t preset_no) {
+    if (preset_no >= SCENE_SLOTS) return 0;
+    return f.scenes[preset_no].hash;
+}
+
+uint16_t flash_last_write_pages() {
+    return last_write_pages;
 }
 
 void flash_read(uint8_t preset_no, scene_state_t *scene,
@@ -113,8 +252,10 @@ void flash_read(uint8_t preset_no, scene_state_t *scene,
                 uint8_t init_pattern, uint8_t init_grid,
                 uint8_t init_i2c_op_address) {
     if (preset_no >= SCENE_SLOTS) return;
-    memcpy(ss_scripts_ptr(scene), &f.scenes[preset_no].scripts,
-           ss_scripts_size(EDITABLE_SCRIPT_COUNT));
+    const packed_scene_t *p = &f.scenes[preset_no].packed;
+    uint16_t text_offset = p->text_offset;
+    if (text_offset > PACKED_SCENE_SIZE) text_offset = 0;
+    unpack_scripts(p->data, text_offset, scene);
     if (init_pattern) {
         memcpy(ss_patterns_ptr(scene), &f.scenes[preset_no].patterns,
                ss_patterns_size());
@@ -123,8 +264,7 @@ void flash_read(uint8_t preset_no, scene_state_t *scene,
         memcpy(&grid_data, &f.scenes[preset_no].grid_data, sizeof(grid_data_t));
         unpack_grid(scene);
     }
-    memcpy(text, &f.scenes[preset_no].text,
-           SCENE_TEXT_LINES * SCENE_TEXT_CHARS);
+    unpack_text(p, text);
     // need to reset timestamps
     uint32_t ticks = get_ticks();
     for (size_t i = 0; i < TOTAL_SCRIPT_COUNT; i++)
@@ -145,7 +285,11 @@ void flash_update_last_saved_scene(uint8_t preset_no) {
 }
 
 const char *flash_scene_text(uint8_t preset_no, size_t line) {
-    return f.scenes[preset_no].text[line];
+    const char *end;
+    const char *t = packed_text(&f.scenes[preset_no].packed, &end);
+    for (; t < end; t += strlen(t) + 1)
+        if (line-- == 0) return t;
+    return "";
 }
 
 tele_mode_t flash_last_mode() {
@@ -173,6 +317,28 @@ void flash_get_device_config(device_config_t *device_config) {
     *device_config = f.device_config;
 }
 
+// copies n bytes from src to dst in flash a page at a time, skipping pages
+// that already hold the same bytes. Every page flashc_memcpy touches is
+// erased, which stalls the CPU for milliseconds, so an unchanged save should
+// cost nothing.
+static void write_changed_pages(volatile void *dst, const void *src,
+                                size_t n) {
+    volatile uint8_t *d = dst;
+    const uint8_t *s = src;
+    while (n > 0) {
+        size_t chunk = AVR32_FLASHC_PAGE_SIZE -
+                       ((uint32_t)d & (AVR32_FLASHC_PAGE_SIZE - 1));
+        if (chunk > n) chunk = n;
+        if (memcmp((const void *)d, s, chunk) != 0) {
+            flashc_memcpy(d, s, chunk, true);
+            last_write_pages++;
+        }
+        d += chunk;
+        s += chunk;
+        n -= chunk;
+    }
+}
+
 static void pack_grid(scene_state_t *scene) {
     uint8_t byte = 0;
     uint8_t byte_count = 0;
@@ -196,3 +362,49 @@ static void unpack_grid(scene_state_t *scene) {
     for (uint16_t i = 0; i < GRID_FADER_COUNT; i++)
         scene->grid.fader[i].value = grid_data.fader_states[i];
 }
+
+// false if the scripts and text don't fit in PACKED_SCENE_SIZE
+static bool pack_scene(scene_state_t *scene,
+                       char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS]) {
+    // trailing empty lines aren't stored
+    uint8_t lines = SCENE_TEXT_LINES;
+    while (lines > 0 && (*text)[lines - 1][0] == 0) lines--;
+    size_t n = packed_scripts_size(scene);
+    for (uint8_t l = 0; l < lines; l++)
+        n += strnlen((*text)[l], SCENE_TEXT_CHARS - 1) + 1;
+    if (n > PACKED_SCENE_SIZE) return false;
+
+    n = pack_scripts(scene, packed_scene.data, PACKED_SCENE_SIZE);
+    packed_scene.text_offset = n;
+    for (uint8_t l = 0; l < lines; l++) {
+        size_t len = strnlen((*text)[l], SCENE_TEXT_CHARS - 1);
+        memcpy(&packed_scene.data[n], (*text)[l], len);
+        packed_scene.data[n + len] = 0;
+        n += len + 1;
+    }
+    packed_scene.length = n;
+    return true;
+}
+
+static void unpack_text(const packed_scene_t *p,
+                        char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS]) {
+    memset(text, 0, SCENE_TEXT_LINES * SCENE_TEXT_CHARS);
+    const char *end;
+    const char *t = packed_text(p, &end);
+    for (uint8_t l = 0; l < SCENE_TEXT_LINES && t < end; l++) {
+        strncpy((*text)[l], t, SCENE_TEXT_CHARS - 1);
+        t += strlen(t) + 1;
+    }
+}
+
+// returns the first text line of p and sets end to one past the last, a slot
+// that was never written has no text
+static const char *packed_text(const packed_scene_t *p, const char **end) {
+    const char *t = (const char *)p->data;
+    if (p->text_offset > p->length || p->length > PACKED_SCENE_SIZE) {
+        *end = t;
+        return t;
+    }
+    *end = t + p->length;
+    return t + p->text_offset;
+}
@@ -7,7 +7,7 @@
 #include "line_editor.h"
 #include "teletype.h"
 
-#define SCENE_SLOTS 32
+#define SCENE_SLOTS 64
 
 u8 is_flash_fresh(void);
 void flash_prepare(void);
@@ -15,8 +15,10 @@ void flash_read(uint8_t preset_no, scene_state_t *scene,
                 char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS],
                 uint8_t init_pattern, uint8_t init_grid,
                 uint8_t init_i2c_op_address);
-void flash_write(uint8_t preset_no, scene_state_t *scene,
+bool flash_write(uint8_t preset_no, scene_state_t *scene,
                  char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS]);
+uint16_t flash_last_write_pages(void);
+uint32_t flash_scene_hash(uint8_t preset_no);
 uint8_t flash_last_saved_scene(void);
 void flash_update_last_saved_scene(uint8_t preset_no);
 const char *flash_scene_text(uint8_t preset_no, size_t line);
@@ -4,9 +4,11 @@
 #include "flash.h"
 #include "font.h"
 #include "globals.h"
+#include "grid_key.h"
 #include "live_mode.h"
 #include "pattern_mode.h"
 #include "preset_r_mode.h"
+#include "preset_w_mode.h"
 #include "state.h"
 #include "teletype.h"
 #include "teletype_io.h"
@@ -20,6 +22,19 @@
 #define GRID_ON_BRIGHTNESS 13
 #define GRID_SCRIPT_TRIGGER 60
 
+// controls are numbered in the order keys are handled: xypads, then faders,
+// then buttons
+#define GRID_CONTROL_FADER GRID_XYPAD_COUNT
+#define GRID_CONTROL_BUTTON (GRID_CONTROL_FADER + GRID_FADER_COUNT)
+#define GRID_CONTROL_COUNT (GRID_CONTROL_BUTTON + GRID_BUTTON_COUNT)
+#define GRID_CELLS (GRID_MAX_DIMENSION * GRID_MAX_DIMENSION)
+// enough for every key to be covered by four controls, scenes with more
+// overlap than that fall back to checking every control
+#define GRID_INDEX_SIZE (GRID_CELLS * 4)
+// an 8x8 quadrant sent with the mext /led/level/map command, the command and
+// offsets then a nibble per LED
+#define GRID_QUADRANT_BYTES 35
+
 typedef enum {
     G_LIVE_V,
     G_LIVE_D,
@@ -191,11 +206,28 @@ static u8 screen[GRID_MAX_DIMENSION][GRID_MAX_DIMENSION / 2];
 static hold_repeat_info held_keys[GRID_MAX_KEY_PRESSED];
 static u8 timers_uninitialized = 1;
 static script_trigger_info script_triggers[11];
+static grid_slew_stats_t slew_stats;
+
+// the controls under each key, those for cell c are
+// index_control[index_start[c]] up to index_control[index_start[c + 1]]
+static u16 index_start[GRID_CELLS + 1];
+static u16 index_control[GRID_INDEX_SIZE];
+static u16 all_controls[GRID_CONTROL_COUNT];
+static u8 index_full;
+
+// the last frame sent to the grid, only quadrants that differ from it are
+// sent again
+static u8 sent_frame[MONOME_MAX_LED_BYTES];
+static u8 sent_frame_valid;
+static grid_frame_stats_t frame_stats;
+static u32 frame_second, frame_second_bytes;
 
 static void grid_control_refresh(scene_state_t *ss);
 static u8 grid_control_process_key(scene_state_t *ss, u8 x, u8 y, u8 z,
                                    u8 from_held);
 static void hold_repeat_timer_callback(void *o);
+static u16 grid_index_lookup(scene_state_t *ss, u8 x, u8 y,
+                             const u16 **controls);
 static void grid_process_key_hold_repeat(scene_state_t *ss, u8 x, u8 y);
 static void grid_screen_refresh_ctrl(scene_state_t *ss, u8 page, u8 x1, u8 y1,
                                      u8 x2, u8 y2);
@@ -203,7 +235,6 @@ static void grid_screen_refresh_led(scene_state_t *ss, u8 full_grid, u8 page,
                                     u8 x1, u8 y1, u8 x2, u8 y2);
 static void grid_screen_refresh_info(scene_state_t *ss, u8 page, u8 x1, u8 y1,
                                      u8 x2, u8 y2);
-static bool grid_within_area(u8 x, u8 y, grid_common_t *gc);
 static void grid_fill_area(s8 x, s8 y, s8 w, s8 h, s8 level);
 static void grid_fill_area_scr(s8 x, s8 y, s8 w, s8 h, s8 level, u8 page);
 static u16 calc_fader_level(scene_state_t *ss, u8 i, u8 vert);
@@ -832,10 +863,11 @@ static u8 grid_control_process_key(scene_state_t *ss, u8 x, u8 y, u8 z,
         }
         else if (y == 7 && x == 4 && !from_held) {
             if (preset_write) {
-                flash_write(preset_select, ss, &scene_text);
-                flash_update_last_saved_scene(preset_select);
-                preset_write = 0;
-                restore_last_mode(ss);
+                // stays in preset write if the scene is too large to save
+                if (process_preset_w_save()) {
+                    preset_write = 0;
+                    restore_last_mode(ss);
+                }
             }
             else {
                 set_mode(M_PRESET_W);
@@ -1088,191 +1120,40 @@ void grid_process_key(scene_state_t *ss, u8 _x, u8 _y, u8 z, u8 emulated) {
     u8 scripts[EDITABLE_SCRIPT_COUNT];
     for (u8 i = 0; i < EDITABLE_SCRIPT_COUNT; i++) scripts[i] = 0;
 
-    for (u8 i = 0; i < GRID_XYPAD_COUNT; i++) {
-        if (z && GXYC.enabled && SG.group[GXYC.group].enabled &&
-            grid_within_area(x, y, &GXYC)) {
-            GXY.value_x = x - GXYC.x;
-            GXY.value_y = y - GXYC.y;
-            if (GXYC.script != -1) scripts[GXYC.script] = 1;
-            SG.latest_group = GXYC.group;
-            if (SG.group[GXYC.group].script != -1)
-                scripts[SG.group[GXYC.group].script] = 1;
-            refresh = 1;
-        }
-    }
+    const u16 *hit;
+    u16 hits = grid_index_lookup(ss, x, y, &hit);
+    u16 n = 0;
 
-    u16 value;
-    s8 held;
-    if (z) {
-        for (u8 i = 0; i < GRID_FADER_COUNT; i++) {
-            if (GFC.enabled && SG.group[GFC.group].enabled &&
-                grid_within_area(x, y, &GFC)) {
-                held = -1;
-                if (GF.type & 1) {
-                    for (u8 j = 0; j < GRID_MAX_KEY_PRESSED; j++)
-                        if (held_keys[j].used && (held_keys[j].y != y) &&
-                            grid_within_area(held_keys[j].x, held_keys[j].y,
-                                             &GFC)) {
-                            held = j;
-                            break;
-                        }
-                }
-                else {
-                    for (u8 j = 0; j < GRID_MAX_KEY_PRESSED; j++)
-                        if (held_keys[j].used && (held_keys[j].x != x) &&
-                            grid_within_area(held_keys[j].x, held_keys[j].y,
-                                             &GFC)) {
-                            held = j;
-                            break;
-                        }
-                }
+    for (; n < hits && hit[n] < GRID_CONTROL_FADER; n++)
+        if (grid_key_xypad(ss, hit[n], x, y, z, scripts)) refresh = 1;
 
-                switch (GF.type) {
-                    case FADER_CH_BAR:
-                    case FADER_CH_DOT:
-                        if (held == -1) {
-                            GF.slide = 0;
-                            GF.value = x - GFC.x;
-                        }
-                        else {
-                            GF.slide = 1;
-                            GF.slide_acc = 0;
-                            GF.slide_end = x - GFC.x;
-                            GF.slide_delta = 16;
-                            GF.slide_dir = GF.slide_end > GF.value;
-                        }
-                        break;
-                    case FADER_CV_BAR:
-                    case FADER_CV_DOT:
-                        if (held == -1) {
-                            GF.slide = 0;
-                            GF.value = GFC.h + GFC.y - y - 1;
-                        }
-                        else {
-                            GF.slide = 1;
-                            GF.slide_acc = 0;
-                            GF.slide_end = GFC.h + GFC.y - y - 1;
-                            GF.slide_delta = 16;
-                            GF.slide_dir = GF.slide_end > GF.value;
-                        }
-                        break;
-                    case FADER_FH_BAR:
-                    case FADER_FH_DOT:
-                        if (held != -1 &&
-                            (held_keys[held].x == GFC.x ||
-                             held_keys[held].x == (GFC.x + GFC.w - 1)))
-                            held = -1;
-                        if (held == -1) {
-                            GF.slide = 0;
-                            if (x == GFC.x) {
-                                if (GF.value) GF.value--;
-                            }
-                            else if (x == GFC.x + GFC.w - 1) {
-                                if (GF.value < GFC.level) GF.value++;
-                            }
-                            else {
-                                value =
-                                    ((((x - GFC.x - 1) << 1) + 1) * GFC.level) /
-                                    (GFC.w - 2);
-                                GF.value = (value >> 1) + (value & 1);
-                            }
-                        }
-                        else {
-                            GF.slide = 1;
-                            GF.slide_acc = 0;
-                            if (x == GFC.x)
-                                value = 0;
-                            else if (x == (GFC.x + GFC.w - 1))
-                                value = GFC.level;
-                            else {
-                                value =
-                                    ((((x - GFC.x - 1) << 1) + 1) * GFC.level) /
-                                    (GFC.w - 2);
-                                value = (value >> 1) + (value & 1);
-                            }
-                            GF.slide_end = value;
-                            value = ((GFC.w - 2) << 4) / GFC.level;
-                            if (value == 0) value = 1;
-                            GF.slide_delta = value;
-                            GF.slide_dir = GF.slide_end > GF.value;
-                        }
-                        break;
-                    case FADER_FV_BAR:
-                    case FADER_FV_DOT:
-                        if (held != -1 &&
-                            (held_keys[held].y == GFC.y ||
-                             held_keys[held].y == (GFC.y + GFC.h - 1)))
-                            held = -1;
-                        if (held == -1) {
-                            GF.slide = 0;
-                            if (y == GFC.y) {
-                                if (GF.value < GFC.level) GF.value++;
-                            }
-                            else if (y == GFC.y + GFC.h - 1) {
-                                if (GF.value) GF.value--;
-                            }
-                            else {
-                                value = ((((GFC.h + GFC.y - y - 2) << 1) + 1) *
-                                         GFC.level) /
-                                        (GFC.h - 2);
-                                GF.value = (value >> 1) + (value & 1);
-                            }
-                        }
-                        else {
-                            GF.slide = 1;
-                            GF.slide_acc = 0;
-                            if (y == GFC.y)
-                                value = GFC.level;
-                            else if (y == (GFC.y + GFC.h - 1))
-                                value = 0;
-                            else {
-                                value = ((((GFC.h + GFC.y - y - 2) << 1) + 1) *
-                                         GFC.level) /
-                                        (GFC.h - 2);
-                                value = (value >> 1) + (value & 1);
-                            }
-                            GF.slide_end = value;
-                            value = ((GFC.h - 2) << 4) / GFC.level;
-                            if (value == 0) value = 1;
-                            GF.slide_delta = value;
-                            GF.slide_dir = GF.slide_end > GF.value;
-                        }
-                        break;
+    if (z) {
+        for (; n < hits && hit[n] < GRID_CONTROL_BUTTON; n++) {
+            u8 i = hit[n] - GRID_CONTROL_FADER;
+            // another key held on the fader makes it slide
+            s16 held_x = GRID_KEY_NONE, held_y = GRID_KEY_NONE;
+            for (u8 j = 0; j < GRID_MAX_KEY_PRESSED; j++)
+                if (held_keys[j].used &&
+                    (GF.type & 1 ? held_keys[j].y != y
+                                 : held_keys[j].x != x) &&
+                    grid_within_area(held_keys[j].x, held_keys[j].y, &GFC)) {
+                    held_x = held_keys[j].x;
+                    held_y = held_keys[j].y;
+                    break;
                 }
-
-                if (GFC.script != -1) scripts[GFC.script] = 1;
-                SG.latest_fader = i;
-                SG.latest_group = GFC.group;
-                if (SG.group[GFC.group].script != -1)
-                    scripts[SG.group[GFC.group].script] = 1;
+            if (grid_key_fader(ss, i, x, y, held_x, held_y, scripts))
                 refresh = 1;
-            }
         }
     }
 
-    for (u16 i = 0; i < GRID_BUTTON_COUNT; i++) {
-        if (GBC.enabled && SG.group[GBC.group].enabled &&
-            grid_within_area(x, y, &GBC)) {
-            if (GB.latch) {
-                if (z) {
-                    GB.state = !GB.state;
-                    if (GBC.script != -1) scripts[GBC.script] = 1;
-                }
-            }
-            else {
-                GB.state = z;
-                if (GBC.script != -1) scripts[GBC.script] = 1;
-            }
-            SG.latest_button = i;
-            SG.latest_group = GBC.group;
-            if (SG.group[GBC.group].script != -1)
-                scripts[SG.group[GBC.group].script] = 1;
+    for (; n < hits; n++) {
+        if (hit[n] < GRID_CONTROL_BUTTON) continue;  // faders on a release
+        if (grid_key_button(ss, hit[n] - GRID_CONTROL_BUTTON, x, y, z,
+                            scripts))
             refresh = 1;
-        }
     }
 
-    for (u8 i = 0; i < EDITABLE_SCRIPT_COUNT; i++)
-        if (scripts[i]) run_script(ss, i);
+    grid_key_run_scripts(ss, scripts);
 
     if (refresh) SG.grid_dirty = SG.scr_dirty = 1;
 }
@@ -1285,8 +1166,14 @@ void grid_process_key_hold_repeat(scene_state_t *ss, u8 x, u8 y) {
     u8 scripts[EDITABLE_SCRIPT_COUNT];
     for (u8 i = 0; i < EDITABLE_SCRIPT_COUNT; i++) scripts[i] = 0;
 
+    const u16 *hit;
+    u16 hits = grid_index_lookup(ss, x, y, &hit);
+
     u8 update = 0;
-    for (u8 i = 0; i < GRID_FADER_COUNT; i++) {
+    for (u16 n = 0; n < hits; n++) {
+        if (hit[n] < GRID_CONTROL_FADER || hit[n] >= GRID_CONTROL_BUTTON)
+            continue;
+        u8 i = hit[n] - GRID_CONTROL_FADER;
         if (GFC.enabled && SG.group[GFC.group].enabled &&
             grid_within_area(x, y, &GFC)) {
             update = 0;
@@ -1342,11 +1229,23 @@ void hold_repeat_timer_callback(void *o) {
 
 void grid_process_fader_slew(scene_state_t *ss) {
     u8 refresh = 0;
-    u8 scripts[EDITABLE_SCRIPT_COUNT];
-    for (u8 i = 0; i < EDITABLE_SCRIPT_COUNT; i++) scripts[i] = 0;
+    u16 scripts = 0;
+    u8 visited = 0;
+    u8 moved[GRID_FADER_COUNT];
+    u8 moved_count = 0;
+
+    u8 *link = &SG.slide_head;
+    while (*link != GRID_FADER_NONE) {
+        u8 i = *link;
+        visited++;
+        // slide is also cleared by key presses, G.RST and G.GRP.RST
+        if (!GF.slide) {
+            *link = GF.slide_next;
+            GF.slide_listed = 0;
+            continue;
+        }
+        link = &GF.slide_next;
 
-    for (u8 i = 0; i < GRID_FADER_COUNT; i++) {
-        if (!GF.slide) continue;
         GF.slide_acc++;
         if (GF.slide_acc >= GF.slide_delta) {
             GF.slide_acc = 0;
@@ -1359,21 +1258,53 @@ void grid_process_fader_slew(scene_state_t *ss) {
                 GF.value = GF.slide_end;
                 GF.slide = 0;
             }
-            SG.latest_fader = i;
-            SG.latest_group = GFC.group;
-            if (GFC.script != -1) run_script(ss, GFC.script);
+            moved[moved_count++] = i;
             if (SG.group[GFC.group].script != -1)
-                scripts[SG.group[GFC.group].script] = 1;
+                scripts |= 1 << SG.group[GFC.group].script;
+            slew_stats.steps++;
             refresh = 1;
         }
     }
 
+    // the scripts run once every fader has stepped, a fader's own script once
+    // for each fader that moved so that G.FDRI, G.FDRN and G.FDRV see it
+    for (u8 m = 0; m < moved_count; m++) {
+        u8 i = moved[m];
+        SG.latest_fader = i;
+        SG.latest_group = GFC.group;
+        if (GFC.script == -1) continue;
+        run_script(ss, GFC.script);
+        slew_stats.scripts++;
+    }
+
+    // and a group script once however many of its faders moved, seeing the
+    // last one
+    if (moved_count) {
+        u8 i = moved[moved_count - 1];
+        SG.latest_fader = i;
+        SG.latest_group = GFC.group;
+    }
     for (u8 i = 0; i < EDITABLE_SCRIPT_COUNT; i++)
-        if (scripts[i]) run_script(ss, i);
+        if (scripts & (1 << i)) {
+            run_script(ss, i);
+            slew_stats.scripts++;
+        }
+
+    slew_stats.ticks++;
+    slew_stats.visited += visited;
+    if (visited > slew_stats.max_visited) slew_stats.max_visited = visited;
 
     if (refresh) SG.grid_dirty = SG.scr_dirty = 1;
 }
 
+const grid_slew_stats_t *grid_fader_slew_stats() {
+    return &slew_stats;
+}
+
+void grid_fader_slew_stats_reset() {
+    slew_stats = (grid_slew_stats_t){ 0 };
+}
+
 void grid_clear_held_keys() {
     for (u8 i = 0; i < GRID_MAX_KEY_PRESSED; i++) {
         held_keys[i].used = 0;
@@ -1381,9 +1312,66 @@ void grid_clear_held_keys() {
     }
 }
 
-bool grid_within_area(u8 x, u8 y, grid_common_t *gc) {
-    return x >= gc->x && x < (gc->x + gc->w) && y >= gc->y &&
-           y < (gc->y + gc->h);
+static grid_common_t *grid_control(scene_state_t *ss, u16 c) {
+    if (c < GRID_CONTROL_FADER) return &ss->grid.xypad[c].common;
+    if (c < GRID_CONTROL_BUTTON)
+        return &ss->grid.fader[c - GRID_CONTROL_FADER].common;
+    return &ss->grid.button[c - GRID_CONTROL_BUTTON].common;
+}
+
+static bool grid_control_active(scene_state_t *ss, grid_common_t *gc) {
+    return gc->enabled && SG.group[gc->group].enabled;
+}
+
+// counts the controls under each key, then places them, going through the
+// controls in order keeps each key's list in the order they are handled
+static void grid_index_build(scene_state_t *ss) {
+    SG.index_dirty = 0;
+    for (u16 c = 0; c <= GRID_CELLS; c++) index_start[c] = 0;
+
+    for (u16 c = 0; c < GRID_CONTROL_COUNT; c++) {
+        grid_common_t *gc = grid_control(ss, c);
+        if (!grid_control_active(ss, gc)) continue;
+        for (u8 y = gc->y; y < gc->y + gc->h && y < GRID_MAX_DIMENSION; y++)
+            for (u8 x = gc->x; x < gc->x + gc->w && x < GRID_MAX_DIMENSION;
+                 x++)
+                index_start[y * GRID_MAX_DIMENSION + x + 1]++;
+    }
+    for (u16 c = 1; c <= GRID_CELLS; c++) index_start[c] += index_start[c - 1];
+
+    index_full = index_start[GRID_CELLS] > GRID_INDEX_SIZE;
+    if (index_full) {
+        for (u16 c = 0; c < GRID_CONTROL_COUNT; c++) all_controls[c] = c;
+        return;
+    }
+
+    // placing a control moves its key's start along, so afterwards each
+    // start is where the next key's list begins
+    for (u16 c = 0; c < GRID_CONTROL_COUNT; c++) {
+        grid_common_t *gc = grid_control(ss, c);
+        if (!grid_control_active(ss, gc)) continue;
+        for (u8 y = gc->y; y < gc->y + gc->h && y < GRID_MAX_DIMENSION; y++)
+            for (u8 x = gc->x; x < gc->x + gc->w && x < GRID_MAX_DIMENSION;
+                 x++)
+                index_control[index_start[y * GRID_MAX_DIMENSION + x]++] = c;
+    }
+    for (u16 c = GRID_CELLS; c > 0; c--) index_start[c] = index_start[c - 1];
+    index_start[0] = 0;
+}
+
+// the controls that may be under a key, ordered like GRID_CONTROL_*, the
+// index is rebuilt first if the scene changed any of them
+u16 grid_index_lookup(scene_state_t *ss, u8 x, u8 y, const u16 **controls) {
+    if (SG.index_dirty) grid_index_build(ss);
+    if (index_full) {
+        *controls = all_controls;
+        return GRID_CONTROL_COUNT;
+    }
+    if (x >= GRID_MAX_DIMENSION || y >= GRID_MAX_DIMENSION) return 0;
+
+    u16 c = y * GRID_MAX_DIMENSION + x;
+    *controls = &index_control[index_start[c]];
+    return index_start[c + 1] - index_start[c];
 }
 
 u16 calc_fader_level(scene_state_t *ss, u8 i, u8 vert) {
@@ -1610,6 +1598,61 @@ void grid_fill_area(s8 x, s8 y, s8 w, s8 h, s8 level) {
     }
 }
 
+static bool grid_quadrant_changed(u8 q) {
+    u16 d = ((q >> 1) << 7) + ((q & 1) << 3);
+    for (u16 j = 0; j < 8; j++)
+        for (u16 i = 0; i < 8; i++) {
+            u16 led = d + (j << 4) + i;
+            if (led < MONOME_MAX_LED_BYTES &&
+                monomeLedBuffer[led] != sent_frame[led])
+                return true;
+        }
+    return false;
+}
+
+u8 grid_frame_changes() {
+    u8 quadrants = 0;
+    for (u8 q = 0; q < 4; q++)
+        if (!sent_frame_valid || grid_quadrant_changed(q)) quadrants |= 1 << q;
+    for (u16 i = 0; i < MONOME_MAX_LED_BYTES; i++)
+        sent_frame[i] = monomeLedBuffer[i];
+    sent_frame_valid = 1;
+
+    u8 sent = 0;
+    for (u8 q = 0; q < 4; q++)
+        if (quadrants & (1 << q)) sent++;
+    if (sent)
+        frame_stats.frames++;
+    else
+        frame_stats.unchanged++;
+    frame_stats.quadrants += sent;
+    frame_stats.skipped += 4 - sent;
+    frame_stats.bytes += sent * GRID_QUADRANT_BYTES;
+
+    u32 second = tele_get_ticks() / 1000;
+    if (second != frame_second) {
+        frame_stats.bytes_per_second =
+            second == frame_second + 1 ? frame_second_bytes : 0;
+        frame_second = second;
+        frame_second_bytes = 0;
+    }
+    frame_second_bytes += sent * GRID_QUADRANT_BYTES;
+
+    return quadrants;
+}
+
+void grid_frame_resend() {
+    sent_frame_valid = 0;
+}
+
+const grid_frame_stats_t *grid_frame_stats() {
+    return &frame_stats;
+}
+
+void grid_frame_stats_reset() {
+    frame_stats = (grid_frame_stats_t){ 0 };
+}
+
 ///////////////////////////////////////// screen functions
 
 void grid_screen_refresh(scene_state_t *ss, u8 is_full, u8 page, u8 ctrl, u8 x1,
@@ -12,13 +12,43 @@
 #define GXY ss->grid.xypad[i]
 #define GXYC ss->grid.xypad[i].common
 
+// the work done by grid_process_fader_slew, which only visits faders that
+// are sliding
+typedef struct {
+    u32 ticks;
+    u32 visited;     // faders looked at, summed over all ticks
+    u32 steps;       // fader values moved
+    u32 scripts;     // fader scripts run, and group scripts (once per tick)
+    u8 max_visited;  // most faders looked at in one tick
+} grid_slew_stats_t;
+
+// LED frames sent by grid_frame_changes, bytes are counted as the mext
+// protocol sends them
+typedef struct {
+    u32 frames;            // refreshes that sent at least one quadrant
+    u32 unchanged;         // refreshes that sent nothing
+    u32 quadrants;         // quadrants sent
+    u32 skipped;           // quadrants left out as they hadn't changed
+    u32 bytes;             // bytes sent, in total
+    u32 bytes_per_second;  // bytes sent in the last full second
+} grid_frame_stats_t;
+
 extern void grid_set_control_mode(u8 control, u8 mode, scene_state_t *ss);
 extern void grid_metro_triggered(scene_state_t *ss);
 extern void grid_refresh(scene_state_t *ss);
+// compares monomeLedBuffer with the last frame sent and returns the
+// quadrants to send, as monomeFrameDirty flags. after grid_frame_resend it
+// returns all of them, for a grid that was just connected.
+extern u8 grid_frame_changes(void);
+extern void grid_frame_resend(void);
+extern const grid_frame_stats_t *grid_frame_stats(void);
+extern void grid_frame_stats_reset(void);
 extern void grid_screen_refresh(scene_state_t *ss, u8 is_full, u8 page, u8 ctrl,
                                 u8 x1, u8 y1, u8 x2, u8 y2);
 extern void grid_process_key(scene_state_t *ss, u8 x, u8 y, u8 z, u8 emulated);
 extern void grid_process_fader_slew(scene_state_t *ss);
+extern const grid_slew_stats_t *grid_fader_slew_stats(void);
+extern void grid_fader_slew_stats_reset(void);
 extern void grid_clear_held_keys(void);
 
 #endif
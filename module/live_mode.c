@@ -11,6 +11,7 @@
 
 // teletype
 #include "helpers.h"
+#include "ops/prof.h"
 #include "teletype_io.h"
 
 // libavr32
@@ -36,6 +37,7 @@ static process_result_t output;
 static error_t status;
 static char error_msg[TELE_ERROR_MSG_LENGTH];
 static bool show_welcome_message;
+static char message[36];
 
 static uint8_t grid_x1 = 0, grid_y1 = 0, grid_x2 = 0, grid_y2 = 0;
 static uint8_t grid_pressed = 0;
@@ -285,6 +287,11 @@ void init_live_mode() {
     dirty = D_ALL;
 }
 
+void set_live_message(const char *s) {
+    strncpy(message, s, sizeof(message) - 1);
+    dirty |= D_MESSAGE;
+}
+
 void set_live_mode() {
     line_editor_set(&le, "");
     history_line = -1;
@@ -767,6 +774,10 @@ uint8_t screen_refresh_live() {
             itoa(output.value, s, 10);
             output.has_value = false;
         }
+        else if (message[0]) {
+            strcpy(s, message);
+            message[0] = 0;
+        }
         else if (show_welcome_message) {
             strcpy(s, "TELETYPE ");
             strncat(s, git_version, 35 - strlen(s));
@@ -833,6 +844,27 @@ uint8_t screen_refresh_live() {
                         line[i / 2 + 2].data[row * 128 + 26 * 4 - 1] = 0x1;
                     }
                 }
+
+#ifdef TELETYPE_PROFILE
+            // the op that has taken the most time since PROF.CLR
+            const char *name;
+            const op_profile_t *p = prof_rank(0, &name);
+            region_fill(&line[1], 0);
+            if (p) {
+                char prof[36];
+                strcpy(prof, name);
+                strcat(prof, " ");
+                itoa(p->calls > INT16_MAX ? INT16_MAX : p->calls, s, 10);
+                strcat(prof, s);
+                strcat(prof, "X ");
+                uint32_t us = tele_profile_count_us(p->cycles);
+                itoa(us > INT16_MAX ? INT16_MAX : us, s, 10);
+                strcat(prof, s);
+                strcat(prof, "US");
+                font_string_region_clip(&line[1], prof, 2, 0, 0x4, 0);
+            }
+            screen_dirty |= 1 << 1;
+#endif
         }
     }
 
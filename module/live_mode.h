@@ -10,6 +10,8 @@ void set_slew_icon(bool display);
 void set_metro_icon(bool display);
 void init_live_mode(void);
 void set_live_mode(void);
+// shown on the message line until the next command or key press
+void set_live_message(const char *s);
 void set_grid_updated(void);
 void set_vars_updated(void);
 void set_dash_updated(void);
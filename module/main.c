@@ -43,7 +43,10 @@
 #include "globals.h"
 #include "grid.h"
 #include "help_mode.h"
+#include "ii_cache.h"
+#include "ii_queue.h"
 #include "keyboard_helper.h"
+#include "midi_script.h"
 #include "live_mode.h"
 #include "pattern_mode.h"
 #include "preset_r_mode.h"
@@ -58,7 +61,7 @@
 profile_t prof_Script[TOTAL_SCRIPT_COUNT], prof_Delay[DELAY_SIZE], prof_CV,
     prof_ADC, prof_ScreenRefresh;
 
-void tele_profile_script(size_t s) {
+void tele_profile_script(size_t s, bool start) {
     profile_update(&prof_Script[s]);
 }
 
@@ -66,6 +69,14 @@ void tele_profile_delay(uint8_t d) {
     profile_update(&prof_Delay[d]);
 }
 
+uint32_t tele_profile_count() {
+    return Get_system_register(AVR32_COUNT);
+}
+
+uint32_t tele_profile_count_us(uint32_t count) {
+    return cpu_cy_2_us(count, FCPU_HZ);
+}
+
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -73,8 +84,12 @@ void tele_profile_delay(uint8_t d) {
 
 #define RATE_CLOCK 10
 #define RATE_CV 6
+#define RATE_II_POLL 10
 #define SS_TIMEOUT 90 /* minutes */ * 60 * 100
 
+// data of the kEventAppCustom events
+enum { APP_CUSTOM_METRO, APP_CUSTOM_II_POLL };
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // globals (defined in globals.h)
@@ -139,6 +154,7 @@ static softTimer_t monomePollTimer = { .next = NULL, .prev = NULL };
 static softTimer_t monomeRefreshTimer = { .next = NULL, .prev = NULL };
 static softTimer_t gridFaderTimer = { .next = NULL, .prev = NULL };
 static softTimer_t midiScriptTimer = { .next = NULL, .prev = NULL };
+static softTimer_t iiPollTimer = { .next = NULL, .prev = NULL };
 static softTimer_t trPulseTimer[TR_COUNT];
 
 
@@ -157,6 +173,7 @@ static void monome_poll_timer_callback(void* obj);
 static void monome_refresh_timer_callback(void* obj);
 static void grid_fader_timer_callback(void* obj);
 static void midiScriptTimer_callback(void* obj);
+static void iiPollTimer_callback(void* obj);
 static void trPulseTimer_callback(void* obj);
 
 // event handler prototypes
@@ -286,7 +303,13 @@ void hidTimer_callback(void* o) {
 }
 
 void metroTimer_callback(void* o) {
-    event_t e = { .type = kEventAppCustom, .data = 0 };
+    event_t e = { .type = kEventAppCustom, .data = APP_CUSTOM_METRO };
+    event_post(&e);
+}
+
+// the poll reads block, so they run from their own event rather than the tick
+void iiPollTimer_callback(void* o) {
+    event_t e = { .type = kEventAppCustom, .data = APP_CUSTOM_II_POLL };
     event_post(&e);
 }
 
@@ -323,31 +346,7 @@ void grid_fader_timer_callback(void* o) {
 }
 
 void midiScriptTimer_callback(void* obj) {
-    u8 executed[EDITABLE_SCRIPT_COUNT];
-    for (uint8_t i = 0; i < EDITABLE_SCRIPT_COUNT; i++) executed[i] = 0;
-
-    if (scene_state.midi.on_count && scene_state.midi.on_script >= 0 &&
-        scene_state.midi.on_script < EDITABLE_SCRIPT_COUNT) {
-        run_script(&scene_state, scene_state.midi.on_script);
-        executed[scene_state.midi.on_script] = 1;
-    }
-
-    if (scene_state.midi.off_count && scene_state.midi.off_script >= 0 &&
-        scene_state.midi.off_script < EDITABLE_SCRIPT_COUNT) {
-        if (!executed[scene_state.midi.off_script])
-            run_script(&scene_state, scene_state.midi.off_script);
-        executed[scene_state.midi.off_script] = 1;
-    }
-
-    if (scene_state.midi.cc_count && scene_state.midi.cc_script >= 0 &&
-        scene_state.midi.cc_script < EDITABLE_SCRIPT_COUNT) {
-        if (!executed[scene_state.midi.cc_script])
-            run_script(&scene_state, scene_state.midi.cc_script);
-    }
-
-    scene_state.midi.on_count = 0;
-    scene_state.midi.off_count = 0;
-    scene_state.midi.cc_count = 0;
+    midi_script_run_queued(&scene_state);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -519,6 +518,9 @@ void handler_MscConnect(int32_t data) {
         region_draw(&line[i]);
     }
 
+    // the event loop stops while in disk mode, save calibration first
+    ss_cal_commit(&scene_state);
+
     // do USB
     tele_usb_disk();
 
@@ -588,8 +590,12 @@ void handler_EventTimer(int32_t data) {
 }
 
 void handler_AppCustom(int32_t data) {
-    // If we need multiple custom event handlers then we can use an enum in the
-    // data argument. For now, we're just using it for the metro
+    // the data argument says which of the custom events this is
+    if (data == APP_CUSTOM_II_POLL) {
+        ii_cache_refresh();
+        return;
+    }
+
     if (ss_get_script_len(&scene_state, METRO_SCRIPT)) {
         set_metro_icon(true);
         run_script(&scene_state, METRO_SCRIPT);
@@ -622,6 +628,7 @@ static void handler_MonomeConnect(s32 data) {
     grid_set_control_mode(grid_control_mode, mode, &scene_state);
 
     scene_state.grid.grid_dirty = 1;
+    grid_frame_resend();
     grid_clear_held_keys();
 }
 
@@ -631,8 +638,8 @@ static void handler_MonomePoll(s32 data) {
 
 static void handler_MonomeRefresh(s32 data) {
     grid_refresh(&scene_state);
-    monomeFrameDirty = 0b1111;
-    (*monome_refresh)();
+    monomeFrameDirty |= grid_frame_changes();
+    if (monomeFrameDirty) (*monome_refresh)();
 }
 
 static void handler_MonomeGridKey(s32 data) {
@@ -656,89 +663,31 @@ static void handler_standard_midi_packet(s32 data) {
 }
 
 static void midi_note_on(u8 ch, u8 num, u8 vel) {
-    scene_state.midi.last_event_type = 1;
-    scene_state.midi.last_channel = ch;
-    scene_state.midi.last_note = num;
-    scene_state.midi.last_velocity = vel;
-
-    if (scene_state.midi.on_script != -1 &&
-        scene_state.midi.on_count < MAX_MIDI_EVENTS) {
-        scene_state.midi.on_channel[scene_state.midi.on_count] = ch;
-        scene_state.midi.note_on[scene_state.midi.on_count] = num;
-        scene_state.midi.note_vel[scene_state.midi.on_count] = vel;
-        scene_state.midi.on_count++;
-    }
+    midi_script_note_on(&scene_state, ch, num, vel);
 }
 
 static void midi_note_off(u8 ch, u8 num, u8 vel) {
-    scene_state.midi.last_event_type = 2;
-    scene_state.midi.last_channel = ch;
-    scene_state.midi.last_note = num;
-    scene_state.midi.last_velocity = vel;
-
-    if (scene_state.midi.off_script != -1 &&
-        scene_state.midi.off_count < MAX_MIDI_EVENTS) {
-        scene_state.midi.off_channel[scene_state.midi.off_count] = ch;
-        scene_state.midi.note_off[scene_state.midi.off_count] = num;
-        scene_state.midi.off_count++;
-    }
+    midi_script_note_off(&scene_state, ch, num, vel);
 }
 
 static void midi_control_change(u8 ch, u8 num, u8 val) {
-    scene_state.midi.last_event_type = 3;
-    scene_state.midi.last_channel = ch;
-    scene_state.midi.last_controller = num;
-    scene_state.midi.last_cc = val;
-
-    if (scene_state.midi.cc_script != -1) {
-        u8 found = 0;
-        for (u8 i = 0; i < scene_state.midi.cc_count; i++) {
-            if (scene_state.midi.cn[i] == num &&
-                scene_state.midi.cc_channel[i] == ch) {
-                scene_state.midi.cc[i] = val;
-                found = 1;
-                break;
-            }
-        }
-
-        if (!found && scene_state.midi.cc_count < MAX_MIDI_EVENTS) {
-            scene_state.midi.cc_channel[scene_state.midi.cc_count] = ch;
-            scene_state.midi.cn[scene_state.midi.cc_count] = num;
-            scene_state.midi.cc[scene_state.midi.cc_count] = val;
-            scene_state.midi.cc_count++;
-        }
-    }
+    midi_script_cc(&scene_state, ch, num, val);
 }
 
 static void midi_clock_tick(void) {
-    if (++midi_clock_counter >= scene_state.midi.clock_div) {
-        midi_clock_counter = 0;
-        scene_state.midi.last_event_type = 4;
-        if (scene_state.midi.clk_script >= 0 &&
-            scene_state.midi.clk_script < EDITABLE_SCRIPT_COUNT)
-            run_script(&scene_state, scene_state.midi.clk_script);
-    }
+    midi_script_clock(&scene_state, &midi_clock_counter);
 }
 
 static void midi_seq_start(void) {
-    scene_state.midi.last_event_type = 5;
-    if (scene_state.midi.start_script >= 0 &&
-        scene_state.midi.start_script < EDITABLE_SCRIPT_COUNT)
-        run_script(&scene_state, scene_state.midi.start_script);
+    midi_script_start(&scene_state);
 }
 
 static void midi_seq_stop(void) {
-    scene_state.midi.last_event_type = 6;
-    if (scene_state.midi.stop_script >= 0 &&
-        scene_state.midi.stop_script < EDITABLE_SCRIPT_COUNT)
-        run_script(&scene_state, scene_state.midi.stop_script);
+    midi_script_stop(&scene_state);
 }
 
 static void midi_seq_continue(void) {
-    scene_state.midi.last_event_type = 7;
-    if (scene_state.midi.continue_script >= 0 &&
-        scene_state.midi.continue_script < EDITABLE_SCRIPT_COUNT)
-        run_script(&scene_state, scene_state.midi.continue_script);
+    midi_script_continue(&scene_state);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1159,6 +1108,8 @@ void tele_scene(uint8_t i, uint8_t init_grid, uint8_t init_pattern) {
     if (i >= SCENE_SLOTS) return;
     preset_select = i;
     flash_read(i, &scene_state, &scene_text, init_pattern, init_grid, 0);
+    // the followers of the old scene may not be there any more
+    ii_cache_clear();
     set_dash_updated();
     if (init_grid) scene_state.grid.scr_dirty = scene_state.grid.grid_dirty = 1;
 }
@@ -1273,6 +1224,7 @@ int main(void) {
     preset_select = flash_last_saved_scene();
     ss_set_scene(&scene_state, preset_select);
     flash_read(preset_select, &scene_state, &scene_text, 1, 1, 1);
+    ii_cache_clear();
 
     // setup daisy chain for two dacs
     spi_selectChip(DAC_SPI, DAC_SPI_NPCS);
@@ -1288,6 +1240,7 @@ int main(void) {
     timer_add(&refreshTimer, 63, &refreshTimer_callback, NULL);
     timer_add(&gridFaderTimer, 25, &grid_fader_timer_callback, NULL);
     timer_add(&midiScriptTimer, 25, &midiScriptTimer_callback, NULL);
+    timer_add(&iiPollTimer, RATE_II_POLL, &iiPollTimer_callback, NULL);
 
     // update IN and PARAM in case Init uses them
     tele_update_adc(1);
@@ -1343,6 +1296,16 @@ int main(void) {
             print_dbg_ulong(profile_delta_us(&prof_ADC));
             print_dbg("\r\nScreen Refresh:\t");
             print_dbg_ulong(profile_delta_us(&prof_ScreenRefresh));
+            print_dbg("\r\nFlash pages (last save):\t");
+            print_dbg_ulong(flash_last_write_pages());
+            const ii_queue_stats_t *ii = ii_queue_stats();
+            print_dbg("\r\nI2C writes queued:\t");
+            print_dbg_ulong(ii->queued);
+            print_dbg("\r\nI2C writes coalesced:\t");
+            print_dbg_ulong(ii->coalesced);
+            print_dbg("\r\nI2C queue depth (max):\t");
+            print_dbg_ulong(ii->max_depth);
+            ii_queue_stats_reset();
         }
 #endif
     }
@@ -3,6 +3,7 @@
 // this
 #include "flash.h"
 #include "globals.h"
+#include "ii_cache.h"
 #include "keyboard_helper.h"
 #include "live_mode.h"
 
@@ -109,6 +110,7 @@ uint8_t screen_refresh_preset_r() {
 void do_preset_read() {
     ss_grid_init(&scene_state);
     flash_read(preset_select, &scene_state, &scene_text, 1, 1, 1);
+    ii_cache_clear();
     flash_update_last_saved_scene(preset_select);
     ss_set_scene(&scene_state, preset_select);
 
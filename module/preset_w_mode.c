@@ -28,7 +28,10 @@ static const uint8_t D_LIST = 1 << 1;
 static const uint8_t D_ALL = 0xFF;
 static uint8_t dirty;
 
+static bool too_big;
+
 void set_preset_w_mode() {
+    too_big = false;
     edit_line = 0;
     edit_offset = 0;
     line_editor_set(&le, scene_text[0]);
@@ -96,10 +99,10 @@ void process_preset_w_keys(uint8_t k, uint8_t m, bool is_held_key) {
     else if (match_alt(m, k, HID_ENTER)) {
         if (!is_held_key) {
             strcpy(scene_text[edit_line + edit_offset], line_editor_get(&le));
-            flash_write(preset_select, &scene_state, &scene_text);
-            flash_update_last_saved_scene(preset_select);
-            set_last_mode();
-            set_dash_updated();
+            if (process_preset_w_save()) {
+                set_last_mode();
+                set_dash_updated();
+            }
         }
     }
     else {  // pass to line editor
@@ -108,6 +111,17 @@ void process_preset_w_keys(uint8_t k, uint8_t m, bool is_held_key) {
     }
 }
 
+// saves the scene to preset_select, a scene too large for its flash slot isn't
+// saved and the header says so
+bool process_preset_w_save() {
+    too_big = !flash_write(preset_select, &scene_state, &scene_text);
+    if (too_big) {
+        dirty |= D_LIST;
+        return false;
+    }
+    flash_update_last_saved_scene(preset_select);
+    return true;
+}
 
 uint8_t screen_refresh_preset_w() {
     if (!(dirty & D_ALL)) { return 0; }
@@ -118,7 +132,8 @@ uint8_t screen_refresh_preset_w() {
         itoa(preset_select, header + 4, 10);
         region_fill(&line[0], 1);
         font_string_region_clip_right(&line[0], header, 126, 0, 0xf, 1);
-        font_string_region_clip(&line[0], "WRITE", 2, 0, 0xf, 1);
+        font_string_region_clip(&line[0], too_big ? "TOO BIG" : "WRITE", 2,
+                                0, 0xf, 1);
 
         for (uint8_t y = 1; y < 7; y++) {
             uint8_t a = edit_line == (y - 1);
@@ -6,6 +6,7 @@
 
 void set_preset_w_mode(void);
 void process_preset_w_keys(uint8_t key, uint8_t mod_key, bool is_held_key);
+bool process_preset_w_save(void);
 uint8_t screen_refresh_preset_w(void);
 
 #endif
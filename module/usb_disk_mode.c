@@ -6,6 +6,8 @@
 
 #include "flash.h"
 #include "globals.h"
+#include "helpers.h"
+#include "live_mode.h"
 #include "scene_serialization.h"
 
 // libavr32
@@ -14,7 +16,6 @@
 #include "util.h"
 
 // asf
-#include "delay.h"
 #include "fat.h"
 #include "file.h"
 #include "fs_com.h"
@@ -24,26 +25,178 @@
 #include "uhi_msc_mem.h"
 #include "usb_protocol_msc.h"
 
-// Local functions for usb filesystem serialization
-void tele_usb_putc(void* self_data, uint8_t c);
+// Local functions for usb filesystem serialization, the scene serializer
+// calls these with whole sectors
 void tele_usb_write_buf(void* self_data, uint8_t* buffer, uint16_t size);
-uint16_t tele_usb_getc(void* self_data);
-bool tele_usb_eof(void* self_data);
-
-void tele_usb_putc(void* self_data, uint8_t c) {
-    file_putc(c);
-}
+uint16_t tele_usb_read_buf(void* self_data, uint8_t* buffer, uint16_t size);
 
 void tele_usb_write_buf(void* self_data, uint8_t* buffer, uint16_t size) {
     file_write_buf(buffer, size);
 }
 
-uint16_t tele_usb_getc(void* self_data) {
-    return file_getc();
+uint16_t tele_usb_read_buf(void* self_data, uint8_t* buffer, uint16_t size) {
+    return file_read_buf(buffer, size);
+}
+
+// tt00s.txt -> tt00s.ttb, the binary copy of a scene file
+static void binary_filename(char* binary, const char* filename) {
+    strcpy(binary, filename);
+    strcpy(binary + strlen(binary) - 3, "ttb");
+}
+
+// the last write date of filename as YYYYMMDDHHMMSSmm, false if it isn't on
+// the drive
+static bool file_date(const char* filename, char date[17]) {
+    nav_filelist_reset();
+    bool found = nav_filelist_findname((FS_STRING)filename, 0);
+    if (found) {
+        memset(date, 0, 17);
+        nav_file_dateget((FS_STRING)date, FS_DATE_LAST_WRITE);
+    }
+    nav_filelist_reset();
+    return found;
+}
+
+// writes the scene in the binary format as well, failures are ignored as the
+// text file has been written
+static void tele_usb_write_binary(
+    const char* filename, scene_state_t* scene,
+    char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS]) {
+    char binary[13];
+    binary_filename(binary, filename);
+    if (!nav_file_create((FS_STRING)binary) && fs_g_status != FS_ERR_FILE_EXIST)
+        return;
+    if (!file_open(FOPEN_MODE_W)) return;
+
+    tt_serializer_t tele_usb_writer;
+    tele_usb_writer.write_buffer = &tele_usb_write_buf;
+    tele_usb_writer.print_dbg = &print_dbg;
+    tele_usb_writer.data = NULL;  // asf disk i/o holds state
+    serialize_scene_binary(&tele_usb_writer, scene, text);
+    file_close();
 }
 
-bool tele_usb_eof(void* self_data) {
-    return file_eof() != 0;
+// loads the binary copy of a scene file if there is one and it's intact. It's
+// ignored if the text file has been written since, e.g. edited on a computer
+static bool tele_usb_read_binary(
+    const char* filename, scene_state_t* scene,
+    char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS]) {
+    char binary[13];
+    binary_filename(binary, filename);
+    char text_date[17], binary_date[17];
+    if (!file_date(binary, binary_date)) return false;
+    if (file_date(filename, text_date) && strcmp(binary_date, text_date) < 0) {
+        print_dbg("\r\nstale binary scene: ");
+        print_dbg(binary);
+        return false;
+    }
+
+    bool loaded = false;
+    if (nav_filelist_findname(binary, 0) &&
+        file_open(FOPEN_MODE_R)) {
+        tt_deserializer_t tele_usb_reader;
+        tele_usb_reader.read_buffer = &tele_usb_read_buf;
+        tele_usb_reader.print_dbg = &print_dbg;
+        tele_usb_reader.data = NULL;  // asf disk i/o holds state
+        loaded = deserialize_scene_binary(&tele_usb_reader, scene, text);
+        file_close();
+        if (!loaded) {
+            print_dbg("\r\nbad binary scene: ");
+            print_dbg(binary);
+            // it may have been partly read
+            ss_init(scene);
+            memset(text, 0, SCENE_TEXT_LINES * SCENE_TEXT_CHARS);
+        }
+    }
+    nav_filelist_reset();
+    return loaded;
+}
+
+// SYNC_MANIFEST on the drive remembers what was synced last time, so only
+// scenes that changed since are written or read. Delete it to sync
+// everything.
+#define SYNC_MANIFEST "ttsync.dat"
+#define SYNC_MANIFEST_KEY 0x54545332  // TTS2
+
+typedef struct {
+    uint32_t key;
+    // flash_scene_hash of the scene last written to ttNNs.txt
+    uint32_t written[SCENE_SLOTS];
+    // scene_signature of ttNNs.txt and ttNNs.ttb just after they were written
+    uint32_t written_file[SCENE_SLOTS];
+    // file_signature of ttNN.txt and ttNN.ttb when they were last read
+    uint32_t read[SCENE_SLOTS];
+} sync_manifest_t;
+
+static sync_manifest_t manifest;
+
+static void manifest_load(void) {
+    memset(&manifest, 0, sizeof(manifest));
+    nav_filelist_reset();
+    if (nav_filelist_findname((FS_STRING)SYNC_MANIFEST, 0) &&
+        file_open(FOPEN_MODE_R)) {
+        uint16_t n = file_read_buf((uint8_t*)&manifest, sizeof(manifest));
+        file_close();
+        if (n != sizeof(manifest) || manifest.key != SYNC_MANIFEST_KEY)
+            memset(&manifest, 0, sizeof(manifest));
+    }
+    nav_filelist_reset();
+}
+
+static void manifest_save(void) {
+    manifest.key = SYNC_MANIFEST_KEY;
+    nav_filelist_reset();
+    if (nav_file_create((FS_STRING)SYNC_MANIFEST) ||
+        fs_g_status == FS_ERR_FILE_EXIST) {
+        if (file_open(FOPEN_MODE_W)) {
+            file_write_buf((uint8_t*)&manifest, sizeof(manifest));
+            file_close();
+        }
+    }
+    nav_filelist_reset();
+}
+
+// folds the size and last write date of filename into hash, from the
+// directory entry so nothing is read from the file itself
+static bool file_signature(const char* filename, uint32_t* hash) {
+    nav_filelist_reset();
+    bool found = nav_filelist_findname((FS_STRING)filename, 0);
+    if (found) {
+        char date[17];
+        memset(date, 0, sizeof(date));
+        nav_file_dateget((FS_STRING)date, FS_DATE_LAST_WRITE);
+        uint32_t size = nav_file_lgt();
+        *hash = crc32_update(*hash, (const uint8_t*)date, sizeof(date));
+        *hash = crc32_update(*hash, (const uint8_t*)&size, sizeof(size));
+    }
+    nav_filelist_reset();
+    return found;
+}
+
+// the signature of a scene's text and binary files, false if neither is
+// there
+static bool scene_signature(const char* filename, uint32_t* signature) {
+    char binary[13];
+    binary_filename(binary, filename);
+    uint32_t hash = 0xFFFFFFFF;
+    bool found = file_signature(filename, &hash);
+    found |= file_signature(binary, &hash);
+    *signature = ~hash;
+    return found;
+}
+
+// a line of the summary, the scene number followed by a character for each
+// of 16 scenes
+static void draw_summary_line(uint8_t l, uint8_t first, const char* status) {
+    char s[24];
+    s[0] = '0' + first / 10;
+    s[1] = '0' + first % 10;
+    s[2] = ' ';
+    memcpy(s + 3, status + first, 16);
+    s[19] = 0;
+    region_fill(&line[l], 0);
+    font_string_region_clip(&line[l], s, 2, 0, 0xa, 0);
+    region_draw(&line[l]);
 }
 
 // usb disk mode entry point
@@ -73,6 +226,14 @@ void tele_usb_disk() {
         // Check if LUN has been already tested
         if (lun_state & (1 << lun)) { continue; }
 
+        manifest_load();
+
+        // what happened to each scene: - nothing, W written, R read, * both,
+        // ! too large to read
+        char status[SCENE_SLOTS];
+        memset(status, '-', sizeof(status));
+        uint8_t written = 0, read = 0;
+
         // WRITE SCENES
         char filename[13];
         strcpy(filename, "tt00s.txt");
@@ -84,18 +245,29 @@ void tele_usb_disk() {
         region_draw(&line[0]);
 
         for (int i = 0; i < SCENE_SLOTS; i++) {
+            filename[2] = '0' + i / 10;
+            filename[3] = '0' + i % 10;
+
+            // strcat is dangerous, make sure the buffer is large enough!
+            if ((i & 1) == 0) strcat(text_buffer, ".");
+            region_fill(&line[0], 0);
+            font_string_region_clip_tab(&line[0], text_buffer, 2, 0, 0xa, 0);
+            region_draw(&line[0]);
+
+            // already on the drive, and not changed there since
+            uint32_t hash = flash_scene_hash(i);
+            uint32_t signature;
+            if (manifest.written[i] == hash &&
+                scene_signature(filename, &signature) &&
+                manifest.written_file[i] == signature)
+                continue;
+
             scene_state_t scene;
             ss_init(&scene);
 
             char text[SCENE_TEXT_LINES][SCENE_TEXT_CHARS];
             memset(text, 0, SCENE_TEXT_LINES * SCENE_TEXT_CHARS);
 
-            strcat(text_buffer, ".");  // strcat is dangerous, make sure the
-                                       // buffer is large enough!
-            region_fill(&line[0], 0);
-            font_string_region_clip_tab(&line[0], text_buffer, 2, 0, 0xa, 0);
-            region_draw(&line[0]);
-
             flash_read(i, &scene, &text, 1, 1, 1);
 
             if (!nav_file_create((FS_STRING)filename)) {
@@ -123,7 +295,6 @@ void tele_usb_disk() {
             }
 
             tt_serializer_t tele_usb_writer;
-            tele_usb_writer.write_char = &tele_usb_putc;
             tele_usb_writer.write_buffer = &tele_usb_write_buf;
             tele_usb_writer.print_dbg = &print_dbg;
             tele_usb_writer.data =
@@ -131,15 +302,14 @@ void tele_usb_disk() {
             serialize_scene(&tele_usb_writer, &scene, &text);
 
             file_close();
+            tele_usb_write_binary(filename, &scene, &text);
             lun_state |= (1 << lun);  // LUN test is done.
 
-            if (filename[3] == '9') {
-                filename[3] = '0';
-                filename[2]++;
-            }
-            else
-                filename[3]++;
-
+            manifest.written[i] = hash;
+            scene_signature(filename, &signature);
+            manifest.written_file[i] = signature;
+            status[i] = 'W';
+            written++;
             print_dbg(".");
         }
 
@@ -156,44 +326,83 @@ void tele_usb_disk() {
         region_draw(&line[1]);
 
         for (int i = 0; i < SCENE_SLOTS; i++) {
+            filename[2] = '0' + i / 10;
+            filename[3] = '0' + i % 10;
+
+            // strcat is dangerous, make sure the buffer is large enough!
+            if ((i & 1) == 0) strcat(text_buffer, ".");
+            region_fill(&line[1], 0);
+            font_string_region_clip_tab(&line[1], text_buffer, 2, 0, 0xa, 0);
+            region_draw(&line[1]);
+
+            // nothing to read, or not changed since it was last read
+            uint32_t signature;
+            if (!scene_signature(filename, &signature) ||
+                manifest.read[i] == signature)
+                continue;
+
             scene_state_t scene;
             ss_init(&scene);
             char text[SCENE_TEXT_LINES][SCENE_TEXT_CHARS];
             memset(text, 0, SCENE_TEXT_LINES * SCENE_TEXT_CHARS);
 
-            strcat(text_buffer, ".");  // strcat is dangerous, make sure the
-                                       // buffer is large enough!
-            region_fill(&line[1], 0);
-            font_string_region_clip_tab(&line[1], text_buffer, 2, 0, 0xa, 0);
-            region_draw(&line[1]);
-            if (nav_filelist_findname(filename, 0)) {
+            // the binary copy loads without parsing, the text file is used
+            // when there isn't one or it's newer
+            bool found = false, loaded = false;
+            if (tele_usb_read_binary(filename, &scene, &text)) {
+                print_dbg("\r\nfound binary: ");
+                print_dbg(filename);
+                found = true;
+                loaded = flash_write(i, &scene, &text);
+            }
+            else if (nav_filelist_findname(filename, 0)) {
                 print_dbg("\r\nfound: ");
                 print_dbg(filename);
                 if (!file_open(FOPEN_MODE_R))
                     print_dbg("\r\ncan't open");
                 else {
                     tt_deserializer_t tele_usb_reader;
-                    tele_usb_reader.read_char = &tele_usb_getc;
-                    tele_usb_reader.eof = &tele_usb_eof;
+                    tele_usb_reader.read_buffer = &tele_usb_read_buf;
                     tele_usb_reader.print_dbg = &print_dbg;
                     tele_usb_reader.data =
                         NULL;  // asf disk i/o holds state, no handles needed
                     deserialize_scene(&tele_usb_reader, &scene, &text);
 
                     file_close();
-                    flash_write(i, &scene, &text);
+                    found = true;
+                    loaded = flash_write(i, &scene, &text);
                 }
             }
 
             nav_filelist_reset();
 
-            if (filename[3] == '9') {
-                filename[3] = '0';
-                filename[2]++;
+            if (loaded) {
+                manifest.read[i] = signature;
+                status[i] = status[i] == 'W' ? '*' : 'R';
+                read++;
             }
-            else
-                filename[3]++;
+            // too large for its flash slot, the slot keeps what it had
+            else if (found)
+                status[i] = '!';
         }
+
+        manifest_save();
+
+        // summary, which scenes were written and read stays on the screen
+        // when live mode comes back, and the message line says how many
+        region_fill(&line[0], 0);
+        region_draw(&line[0]);
+        region_fill(&line[1], 0);
+        region_draw(&line[1]);
+        for (uint8_t l = 0; l < SCENE_SLOTS / 16; l++)
+            draw_summary_line(2 + l, l * 16, status);
+        itoa(written, text_buffer, 10);
+        strcat(text_buffer, " WRITTEN, ");
+        itoa(read, text_buffer + strlen(text_buffer), 10);
+        strcat(text_buffer, " READ");
+        print_dbg("\r\n");
+        print_dbg(text_buffer);
+        set_live_message(text_buffer);
     }
 
     nav_exit();
@@ -0,0 +1,490 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "grid_key.h"
+#include "ii_bus.h"
+#include "ii_cache.h"
+#include "ii_queue.h"
+#include "midi_script.h"
+#include "profile.h"
+#include "scene_serialization.h"
+#include "teletype.h"
+#include "teletype_io.h"
+
+// Headless batch runner: loads a scene, replays a file of timestamped input
+// events against it in virtual time and logs every TR, CV and II output.
+//
+//     tt-batch [-p] [-k khz] scene.txt [events.txt]
+//
+// Events are read from stdin when no file is given, one per line:
+//
+//     <ms> TR <n> [0|1]          trigger input n, or set its level
+//     <ms> IN <value>            IN / PARAM knob, raw 0 - 16383
+//     <ms> PARAM <value>
+//     <ms> MIDI ON <ch> <note> <velocity>
+//     <ms> MIDI OFF <ch> <note> <velocity>
+//     <ms> MIDI CC <ch> <controller> <value>
+//     <ms> MIDI CLK | START | STOP | CONT
+//     <ms> GRID <x> <y> <z>
+//     <ms> CMD <command>         run a command like the live prompt
+//     <ms> II <addr> <byte>... = <value>
+//                                answer reads of the query bytes from addr
+//                                with value, see simulator/ii_bus.h
+//     <ms> END                   stop, the run otherwise ends at the last event
+//
+// Lines starting with # are ignored, times can't go backwards. The timers
+// from module/main.c (tele_tick, metro, TR pulses, MIDI scripts and the II.POLL
+// refresh) run off
+// the same virtual clock, so TIME, LAST and delays advance as they would on
+// the module, only as fast as the host can go. Pass -p to print the profile
+// and the i2c traffic to stderr at the end.
+//
+// II writes and reads go to the virtual bus in ii_bus.c, running at 100 kHz
+// unless -k says otherwise, and are logged with the reply.
+
+// same as module/main.c
+#define RATE_CLOCK 10
+#define MIDI_SCRIPT_RATE 25
+#define RATE_II_POLL 10
+
+#define BATCH_LINE_LENGTH 256
+
+static scene_state_t ss;
+static FILE *out;
+
+static uint32_t now;
+static uint32_t next_tick;
+static uint32_t next_midi;
+static uint32_t next_ii_poll;
+
+static bool metro_enabled;
+static uint32_t metro_time;
+static uint32_t next_metro;
+
+static bool pulse_on[TR_COUNT];
+static uint32_t pulse_start[TR_COUNT];
+static uint32_t pulse_end[TR_COUNT];
+
+static bool inputs[TRIGGER_INPUTS];
+static int16_t cv[CV_COUNT];
+static int16_t cv_off[CV_COUNT];
+static uint8_t midi_clock_counter;
+
+
+////////////////////////////////////////////////////////////////////////////////
+// teletype_io.h
+
+uint32_t tele_get_ticks() {
+    return now;
+}
+
+void tele_metro_updated() {
+    uint32_t m = ss.variables.m;
+    if (m < METRO_MIN_UNSUPPORTED_MS) m = METRO_MIN_UNSUPPORTED_MS;
+
+    // like a soft timer, a new period only applies after the next run
+    if (ss.variables.m_act && !metro_enabled) next_metro = now + m;
+    metro_enabled = ss.variables.m_act;
+    metro_time = m;
+}
+
+void tele_metro_reset() {
+    if (metro_enabled) next_metro = now + metro_time;
+}
+
+void tele_tr(uint8_t i, int16_t v) {
+    fprintf(out, "%8" PRIu32 " TR %u %d\n", now, i + 1, v ? 1 : 0);
+}
+
+void tele_tr_pulse(uint8_t i, int16_t time) {
+    if (i >= TR_COUNT) return;
+    pulse_on[i] = true;
+    pulse_start[i] = now;
+    pulse_end[i] = now + time;
+}
+
+void tele_tr_pulse_clear(uint8_t i) {
+    if (i >= TR_COUNT) return;
+    pulse_on[i] = false;
+}
+
+void tele_tr_pulse_time(uint8_t i, int16_t time) {
+    if (i >= TR_COUNT || !pulse_on[i]) return;
+    pulse_end[i] = pulse_start[i] + time;
+    if (pulse_end[i] <= now) {
+        pulse_on[i] = false;
+        tele_tr_pulse_end(&ss, i);
+    }
+}
+
+void tele_cv(uint8_t i, int16_t v, uint8_t s) {
+    cv[i] = v;
+    fprintf(out, "%8" PRIu32 " CV %u %d%s\n", now, i + 1, v,
+            s ? " SLEW" : "");
+}
+
+void tele_cv_slew(uint8_t i, int16_t v) {
+    fprintf(out, "%8" PRIu32 " CV.SLEW %u %d\n", now, i + 1, v);
+}
+
+// slews are logged but not run, so this is where the CV ends up
+uint16_t tele_get_cv(uint8_t i) {
+    int32_t v = cv[i] + cv_off[i];
+    return v < 0 ? 0 : v > 16383 ? 16383 : v;
+}
+
+void tele_cv_off(uint8_t i, int16_t v) {
+    cv_off[i] = v;
+    fprintf(out, "%8" PRIu32 " CV.OFF %u %d\n", now, i + 1, v);
+}
+
+void tele_ii_tx(uint8_t addr, uint8_t *data, uint8_t l) {
+    ii_bus_tx(addr, data, l);
+    fprintf(out, "%8" PRIu32 " II 0x%02X", now, addr);
+    for (uint8_t i = 0; i < l; i++) fprintf(out, " %u", data[i]);
+    fprintf(out, "\n");
+}
+
+void tele_ii_rx(uint8_t addr, uint8_t *data, uint8_t l) {
+    ii_bus_rx(addr, data, l);
+    fprintf(out, "%8" PRIu32 " II.RX 0x%02X", now, addr);
+    for (uint8_t i = 0; i < l; i++) fprintf(out, " %u", data[i]);
+    fprintf(out, "\n");
+}
+
+void tele_scene(uint8_t i, uint8_t init_grid, uint8_t init_pattern) {
+    fprintf(out, "%8" PRIu32 " SCENE %u\n", now, i);
+}
+
+void tele_kill() {
+    for (uint8_t i = 0; i < TR_COUNT; i++) tele_tr(i, 0);
+}
+
+bool tele_get_input_state(uint8_t n) {
+    return n < TRIGGER_INPUTS && inputs[n];
+}
+
+void tele_update_adc(uint8_t force) {}
+void tele_has_delays(bool has_delays) {}
+void tele_has_stack(bool has_stack) {}
+void tele_pattern_updated() {}
+void tele_vars_updated() {}
+void tele_mute() {}
+void tele_save_calibration() {}
+void device_flip() {}
+void set_live_submode(uint8_t submode) {}
+void select_dash_screen(uint8_t screen) {}
+void print_dashboard_value(uint8_t index, int16_t value) {}
+
+int16_t get_dashboard_value(uint8_t index) {
+    return 0;
+}
+
+void reset_midi_counter() {
+    midi_clock_counter = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// grid
+
+// keys are handled one at a time, so faders jump rather than slide and there is
+// no hold and repeat
+static void grid_key(uint8_t x, uint8_t y, uint8_t z) {
+    uint8_t scripts[EDITABLE_SCRIPT_COUNT] = { 0 };
+    for (uint8_t i = 0; i < GRID_XYPAD_COUNT; i++)
+        grid_key_xypad(&ss, i, x, y, z, scripts);
+    if (z)
+        for (uint8_t i = 0; i < GRID_FADER_COUNT; i++)
+            grid_key_fader(&ss, i, x, y, GRID_KEY_NONE, GRID_KEY_NONE,
+                           scripts);
+    for (uint16_t i = 0; i < GRID_BUTTON_COUNT; i++)
+        grid_key_button(&ss, i, x, y, z, scripts);
+    grid_key_run_scripts(&ss, scripts);
+}
+
+void grid_key_press(uint8_t x, uint8_t y, uint8_t z) {
+    grid_key(x, y, z);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// timers
+
+static uint32_t next_timer(void) {
+    uint32_t next = next_tick < next_midi ? next_tick : next_midi;
+    if (next_ii_poll < next) next = next_ii_poll;
+    if (metro_enabled && next_metro < next) next = next_metro;
+    for (uint8_t i = 0; i < TR_COUNT; i++)
+        if (pulse_on[i] && pulse_end[i] < next) next = pulse_end[i];
+    return next;
+}
+
+// runs every timer that falls due up to and including time t
+static void run_until(uint32_t t) {
+    uint32_t next;
+    while ((next = next_timer()) <= t) {
+        now = next;
+        for (uint8_t i = 0; i < TR_COUNT; i++)
+            if (pulse_on[i] && pulse_end[i] == now) {
+                pulse_on[i] = false;
+                tele_tr_pulse_end(&ss, i);
+            }
+        if (metro_enabled && next_metro == now) {
+            next_metro += metro_time;
+            if (ss_get_script_len(&ss, METRO_SCRIPT))
+                run_script(&ss, METRO_SCRIPT);
+        }
+        if (next_tick == now) {
+            next_tick += RATE_CLOCK;
+            tele_tick(&ss, RATE_CLOCK);
+        }
+        if (next_midi == now) {
+            next_midi += MIDI_SCRIPT_RATE;
+            midi_script_run_queued(&ss);
+        }
+        if (next_ii_poll == now) {
+            next_ii_poll += RATE_II_POLL;
+            ii_cache_refresh();
+        }
+    }
+    now = t;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// events
+
+static void trigger(uint8_t input, bool state) {
+    if (inputs[input] == state) return;
+    inputs[input] = state;
+    if (ss_get_mute(&ss, input)) return;
+    if (ss.variables.script_pol[input] & (state ? 1 : 2))
+        run_script(&ss, input);
+}
+
+static void midi_event(const char *type, int a, int b, int c) {
+    if (strcmp(type, "ON") == 0)
+        midi_script_note_on(&ss, a, b, c);
+    else if (strcmp(type, "OFF") == 0)
+        midi_script_note_off(&ss, a, b, c);
+    else if (strcmp(type, "CC") == 0)
+        midi_script_cc(&ss, a, b, c);
+    else if (strcmp(type, "CLK") == 0)
+        midi_script_clock(&ss, &midi_clock_counter);
+    else if (strcmp(type, "START") == 0)
+        midi_script_start(&ss);
+    else if (strcmp(type, "STOP") == 0)
+        midi_script_stop(&ss);
+    else
+        midi_script_continue(&ss);
+}
+
+static bool run_command(const char *text) {
+    tele_command_t command;
+    char error_msg[TELE_ERROR_MSG_LENGTH];
+    error_t status = parse(text, &command, error_msg);
+    if (status == E_OK) status = validate(&command, error_msg);
+    if (status != E_OK) {
+        fprintf(stderr, "%s: %s %s\n", text, tele_error(status), error_msg);
+        return false;
+    }
+
+    exec_state_t es;
+    es_init(&es);
+    es_push(&es);
+    es_variables(&es)->script_number = LIVE_SCRIPT;
+    process_result_t result = process_command(&ss, &es, &command);
+    ii_flush();
+    if (result.has_value)
+        fprintf(out, "%8" PRIu32 " >>> %d\n", now, result.value);
+    return true;
+}
+
+// <addr> <byte>... = <value>, numbers in C notation so 0x60 works
+static bool ii_event(char *rest) {
+    uint8_t query[II_BUS_KEY_MAX];
+    uint8_t l = 0;
+    char *end;
+    long addr = strtol(rest, &end, 0);
+    if (end == rest) return false;
+    rest = end;
+    while (true) {
+        while (*rest == ' ' || *rest == '\t') rest++;
+        if (*rest == '=') break;
+        long b = strtol(rest, &end, 0);
+        if (end == rest || l == II_BUS_KEY_MAX) return false;
+        query[l++] = b;
+        rest = end;
+    }
+    long value = strtol(rest + 1, &end, 0);
+    if (end == rest + 1 || l == 0) return false;
+    ii_bus_set(addr, query, l, value);
+    return true;
+}
+
+// returns false for a malformed line
+static bool run_event(char *line, bool *end) {
+    char type[8], arg[8];
+    int a = 0, b = 0, c = 0, n;
+    if (sscanf(line, "%7s%n", type, &n) != 1) return false;
+    char *rest = line + n;
+
+    if (strcmp(type, "TR") == 0) {
+        int args = sscanf(rest, "%d %d", &a, &b);
+        if (args < 1 || a < 1 || a > TRIGGER_INPUTS) return false;
+        if (args == 2)
+            trigger(a - 1, b);
+        else {
+            trigger(a - 1, true);
+            trigger(a - 1, false);
+        }
+    }
+    else if (strcmp(type, "IN") == 0 || strcmp(type, "PARAM") == 0) {
+        if (sscanf(rest, "%d", &a) != 1) return false;
+        if (type[0] == 'I')
+            ss_set_in(&ss, a);
+        else
+            ss_set_param(&ss, a);
+    }
+    else if (strcmp(type, "MIDI") == 0) {
+        if (sscanf(rest, "%7s %d %d %d", arg, &a, &b, &c) < 1) return false;
+        midi_event(arg, a, b, c);
+    }
+    else if (strcmp(type, "GRID") == 0) {
+        if (sscanf(rest, "%d %d %d", &a, &b, &c) != 3) return false;
+        grid_key(a, b, c);
+    }
+    else if (strcmp(type, "II") == 0) {
+        if (!ii_event(rest)) return false;
+    }
+    else if (strcmp(type, "CMD") == 0) {
+        while (*rest == ' ' || *rest == '\t') rest++;
+        rest[strcspn(rest, "\r\n")] = '\0';
+        return run_command(rest);
+    }
+    else if (strcmp(type, "END") == 0)
+        *end = true;
+    else
+        return false;
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// main
+
+static uint16_t batch_read_buffer(void *self_data, uint8_t *buffer,
+                                  uint16_t size) {
+    return fread(buffer, 1, size, (FILE *)self_data);
+}
+
+static void batch_print_dbg(const char *str) {}
+
+static bool load_scene(const char *path) {
+    static char text[SCENE_TEXT_LINES][SCENE_TEXT_CHARS];
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    tt_deserializer_t stream = { .read_buffer = batch_read_buffer,
+                                 .print_dbg = batch_print_dbg,
+                                 .data = f };
+    deserialize_scene(&stream, &ss, &text);
+    fclose(f);
+    return true;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+int main(int argc, char **argv) {
+    bool dump_profile = false;
+    uint16_t khz = 100;
+    int arg = 1;
+    while (arg < argc && argv[arg][0] == '-') {
+        if (strcmp(argv[arg], "-p") == 0)
+            dump_profile = true;
+        else if (strcmp(argv[arg], "-k") == 0 && arg + 1 < argc)
+            khz = atoi(argv[++arg]);
+        else
+            break;
+        arg++;
+    }
+    if (arg >= argc || argv[arg][0] == '-') {
+        fprintf(stderr, "usage: %s [-p] [-k khz] scene.txt [events.txt]\n",
+                argv[0]);
+        return 2;
+    }
+    ii_bus_init(khz);
+
+    out = stdout;
+    static char out_buffer[1 << 16];
+    setvbuf(out, out_buffer, _IOFBF, sizeof(out_buffer));
+
+    ss_init(&ss);
+    if (!load_scene(argv[arg])) {
+        perror(argv[arg]);
+        return 2;
+    }
+    FILE *events = arg + 1 < argc ? fopen(argv[arg + 1], "r") : stdin;
+    if (!events) {
+        perror(argv[arg + 1]);
+        return 2;
+    }
+
+    uint64_t start = now_ns();
+
+    // boot the way module/main.c does
+    next_tick = RATE_CLOCK;
+    next_midi = MIDI_SCRIPT_RATE;
+    next_ii_poll = RATE_II_POLL;
+    tele_metro_updated();
+    run_script(&ss, INIT_SCRIPT);
+    ss.initializing = false;
+
+    char line[BATCH_LINE_LENGTH];
+    uint32_t line_no = 0;
+    uint32_t event_count = 0;
+    bool end = false;
+    int status = 0;
+    while (!end && fgets(line, sizeof(line), events)) {
+        line_no++;
+        char *p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0') continue;
+
+        char *rest;
+        unsigned long t = strtoul(p, &rest, 10);
+        if (rest == p || t < now) {
+            fprintf(stderr, "line %" PRIu32 ": bad time\n", line_no);
+            status = 1;
+            break;
+        }
+        run_until(t);
+        if (!run_event(rest, &end)) {
+            fprintf(stderr, "line %" PRIu32 ": bad event: %s", line_no, rest);
+            status = 1;
+            break;
+        }
+        event_count++;
+    }
+    if (events != stdin) fclose(events);
+    fflush(out);
+
+    double wall_ms = (now_ns() - start) / 1e6;
+    fprintf(stderr,
+            "%" PRIu32 " events, %" PRIu32 " ms in %.1f ms, %.0fx real time\n",
+            event_count, now, wall_ms, wall_ms > 0 ? now / wall_ms : 0);
+    if (dump_profile) {
+        profile_dump(stderr);
+        ii_bus_dump(stderr);
+    }
+    return status;
+}
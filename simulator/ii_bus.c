@@ -0,0 +1,309 @@
+#include "ii_bus.h"
+
+#include <string.h>  // memcmp, memcpy, memset
+
+#include "ii.h"
+#include "ops/telex.h"
+#include "profile.h"
+#include "teletype_io.h"
+
+typedef struct {
+    uint8_t addr;
+    uint8_t key_l;
+    uint8_t key[II_BUS_KEY_MAX];
+    int16_t value;
+} ii_register_t;
+
+static const ii_follower_t *followers[II_BUS_FOLLOWERS];
+static uint8_t follower_count;
+
+static ii_register_t registers[II_BUS_REGISTERS];
+static uint16_t register_count;
+
+// reads ask about whatever was last written to the follower
+static uint8_t last_query[128][II_BUS_KEY_MAX];
+static uint8_t last_query_l[128];
+
+static uint16_t khz = 100;
+
+// indexed like the scripts, with one more for traffic outside of any script
+static ii_bus_count_t by_script[TOTAL_SCRIPT_COUNT + 1];
+static ii_bus_count_t by_follower[II_BUS_FOLLOWERS + 1];
+static ii_bus_count_t total;
+
+static uint8_t script_stack[8];
+static uint8_t script_depth;
+
+static uint32_t window;
+static uint64_t window_bits;
+static uint64_t peak_bits;
+static uint32_t saturated;  // windows with more traffic than fits in them
+
+
+////////////////////////////////////////////////////////////////////////////////
+// register model
+
+static ii_register_t *find_register(uint8_t addr, const uint8_t *key,
+                                    uint8_t key_l) {
+    for (uint16_t i = 0; i < register_count; i++) {
+        ii_register_t *r = &registers[i];
+        if (r->addr == addr && r->key_l == key_l &&
+            memcmp(r->key, key, key_l) == 0)
+            return r;
+    }
+    return NULL;
+}
+
+static void store(uint8_t addr, const uint8_t *key, uint8_t key_l,
+                  int16_t value) {
+    if (key_l == 0 || key_l > II_BUS_KEY_MAX) return;
+    ii_register_t *r = find_register(addr, key, key_l);
+    if (!r) {
+        if (register_count == II_BUS_REGISTERS) return;
+        r = &registers[register_count++];
+        r->addr = addr;
+        r->key_l = key_l;
+        memcpy(r->key, key, key_l);
+    }
+    r->value = value;
+}
+
+// the register a query reads, which is the one the matching setter writes
+static uint8_t query_key(const uint8_t *query, uint8_t l, uint8_t *key) {
+    if (l == 0 || l > II_BUS_KEY_MAX) return 0;
+    memcpy(key, query, l);
+    key[0] &= ~II_GET;
+    return l;
+}
+
+// like ii_tx_value the last two bytes are the value and the bytes before them
+// name the register, a two byte write sets a one byte value
+void ii_bus_register_tx(const ii_follower_t *f, uint8_t addr,
+                        const uint8_t *data, uint8_t l) {
+    if (data[0] & II_GET) return;
+    if (l == 2)
+        store(addr, data, 1, data[1]);
+    else if (l > 2)
+        store(addr, data, l - 2, (data[l - 2] << 8) | data[l - 1]);
+}
+
+void ii_bus_register_rx(const ii_follower_t *f, uint8_t addr, uint8_t *data,
+                        uint8_t l) {
+    uint8_t key[II_BUS_KEY_MAX];
+    uint8_t key_l = query_key(last_query[addr], last_query_l[addr], key);
+    ii_register_t *r = key_l ? find_register(addr, key, key_l) : NULL;
+    int16_t value = r ? r->value : 0;
+
+    memset(data, 0, l);
+    if (l == 1)
+        data[0] = value;
+    else if (l > 1) {
+        data[0] = value >> 8;
+        data[1] = value & 0xFF;
+    }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// followers
+
+#define REGISTER_FOLLOWER(n, a, c) \
+    { .name = n,                   \
+      .addr = a,                   \
+      .count = c,                  \
+      .tx = ii_bus_register_tx,    \
+      .rx = ii_bus_register_rx }
+
+static const ii_follower_t builtin[] = {
+    REGISTER_FOLLOWER("TXo", TO, 8),
+    REGISTER_FOLLOWER("TXi", TI, 8),
+    REGISTER_FOLLOWER("Ansible", II_ANSIBLE_ADDR, 1),
+    REGISTER_FOLLOWER("JF", JF_ADDR, 1),
+    REGISTER_FOLLOWER("JF 2", JF_ADDR_2, 1),
+    // takes writes only, there are no SC getters
+    { .name = "ER-301",
+      .addr = ER301_1,
+      .count = 3,
+      .tx = ii_bus_register_tx },
+    REGISTER_FOLLOWER("Disting EX", DISTING_EX_1, 4),
+    REGISTER_FOLLOWER("crow 1", CROW_ADDR_0, 1),
+    REGISTER_FOLLOWER("crow 2", CROW_ADDR_1, 1),
+    REGISTER_FOLLOWER("crow 3", CROW_ADDR_2, 1),
+    REGISTER_FOLLOWER("crow 4", CROW_ADDR_3, 1),
+};
+
+static int8_t find_follower(uint8_t addr) {
+    for (int8_t i = follower_count - 1; i >= 0; i--)
+        if (addr >= followers[i]->addr &&
+            addr < followers[i]->addr + followers[i]->count)
+            return i;
+    return -1;
+}
+
+bool ii_bus_attach(const ii_follower_t *f) {
+    if (follower_count == II_BUS_FOLLOWERS) return false;
+    followers[follower_count++] = f;
+    return true;
+}
+
+void ii_bus_init(uint16_t k) {
+    follower_count = 0;
+    for (uint8_t i = 0; i < sizeof(builtin) / sizeof(builtin[0]); i++)
+        ii_bus_attach(&builtin[i]);
+    register_count = 0;
+    memset(last_query_l, 0, sizeof(last_query_l));
+    script_depth = 0;
+    ii_bus_set_khz(k);
+    ii_bus_reset_stats();
+}
+
+void ii_bus_set_khz(uint16_t k) {
+    khz = k ? k : 1;
+}
+
+void ii_bus_set(uint8_t addr, const uint8_t *query, uint8_t l, int16_t value) {
+    uint8_t key[II_BUS_KEY_MAX];
+    uint8_t key_l = query_key(query, l, key);
+    store(addr & 0x7F, key, key_l, value);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// accounting
+
+static void add(ii_bus_count_t *c, bool read, uint8_t l, uint64_t bits) {
+    if (read)
+        c->reads++;
+    else
+        c->writes++;
+    c->bytes += l;
+    c->bits += bits;
+}
+
+// a start, the address and every byte with its ack, and a stop
+static uint64_t transaction_bits(uint8_t l) {
+    return 1 + 9 * (l + 1) + 1;
+}
+
+static uint64_t window_capacity(void) {
+    return (uint64_t)khz * II_BUS_WINDOW_MS;
+}
+
+static void end_window(void) {
+    if (window_bits > peak_bits) peak_bits = window_bits;
+    if (window_bits > window_capacity()) saturated++;
+    window_bits = 0;
+}
+
+static void count(bool read, uint8_t l, int8_t follower) {
+    uint64_t bits = transaction_bits(l);
+    // scripts nested deeper than the stack count against the deepest one on it
+    uint8_t depth = script_depth < sizeof(script_stack) ? script_depth
+                                                        : sizeof(script_stack);
+    uint8_t s = depth ? script_stack[depth - 1] : TOTAL_SCRIPT_COUNT;
+    add(&by_script[s], read, l, bits);
+    add(&by_follower[follower < 0 ? II_BUS_FOLLOWERS : follower], read, l,
+        bits);
+    add(&total, read, l, bits);
+
+    uint32_t w = tele_get_ticks() / II_BUS_WINDOW_MS;
+    if (w != window) {
+        end_window();
+        window = w;
+    }
+    window_bits += bits;
+}
+
+void ii_bus_script_start(uint8_t s) {
+    if (script_depth < sizeof(script_stack)) script_stack[script_depth] = s;
+    script_depth++;
+}
+
+void ii_bus_script_end() {
+    if (script_depth) script_depth--;
+}
+
+const ii_bus_count_t *ii_bus_script_count(uint8_t s) {
+    return &by_script[s < TOTAL_SCRIPT_COUNT ? s : TOTAL_SCRIPT_COUNT];
+}
+
+void ii_bus_reset_stats() {
+    memset(by_script, 0, sizeof(by_script));
+    memset(by_follower, 0, sizeof(by_follower));
+    memset(&total, 0, sizeof(total));
+    window = tele_get_ticks() / II_BUS_WINDOW_MS;
+    window_bits = peak_bits = 0;
+    saturated = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// transactions
+
+void ii_bus_tx(uint8_t addr, const uint8_t *data, uint8_t l) {
+    addr &= 0x7F;
+    int8_t f = find_follower(addr);
+    count(false, l, f);
+
+    last_query_l[addr] = l <= II_BUS_KEY_MAX ? l : 0;
+    memcpy(last_query[addr], data, last_query_l[addr]);
+    if (f >= 0 && l > 0) followers[f]->tx(followers[f], addr, data, l);
+}
+
+void ii_bus_rx(uint8_t addr, uint8_t *data, uint8_t l) {
+    addr &= 0x7F;
+    int8_t f = find_follower(addr);
+    count(true, l, f);
+
+    if (f >= 0 && followers[f]->rx)
+        followers[f]->rx(followers[f], addr, data, l);
+    else
+        memset(data, 0, l);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+// dump
+
+static double busy_ms(const ii_bus_count_t *c) {
+    return (double)c->bits / khz;
+}
+
+static void dump_count(FILE *out, const char *name, const ii_bus_count_t *c) {
+    if (c->writes == 0 && c->reads == 0) return;
+    fprintf(out, "%-16s %8u %8u %10u %10.2f\n", name, c->writes, c->reads,
+            c->bytes, busy_ms(c));
+}
+
+void ii_bus_dump(FILE *out) {
+    fprintf(out,
+            "\ni2c at %u kHz: %u writes, %u reads, %u bytes, %.2f ms busy\n",
+            khz, total.writes, total.reads, total.bytes, busy_ms(&total));
+
+    // the simulator in tt.c has no clock, there is nothing to divide by
+    uint32_t time = tele_get_ticks();
+    if (time > 0) {
+        // count the window still open without closing it
+        uint64_t peak = window_bits > peak_bits ? window_bits : peak_bits;
+        uint32_t over = saturated + (window_bits > window_capacity());
+        fprintf(out,
+                "load %.1f%% on average, %.1f%% in the busiest %u ms, %u "
+                "windows over 100%%\n",
+                100.0 * busy_ms(&total) / time,
+                100.0 * peak / window_capacity(), II_BUS_WINDOW_MS, over);
+    }
+
+    fprintf(out, "\n%-16s %8s %8s %10s %10s\n", "", "writes", "reads",
+            "bytes", "busy ms");
+    for (uint8_t i = 0; i < TOTAL_SCRIPT_COUNT; i++) {
+        char name[16];
+        profile_script_name(i, name);
+        dump_count(out, name, &by_script[i]);
+    }
+    dump_count(out, "(no script)", &by_script[TOTAL_SCRIPT_COUNT]);
+
+    fprintf(out, "\n");
+    for (uint8_t i = 0; i < follower_count; i++)
+        dump_count(out, followers[i]->name, &by_follower[i]);
+    dump_count(out, "(no follower)", &by_follower[II_BUS_FOLLOWERS]);
+}
@@ -0,0 +1,83 @@
+#ifndef _SIM_II_BUS_H_
+#define _SIM_II_BUS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Virtual i2c bus for the host builds. The simulators pass every tele_ii_tx
+// and tele_ii_rx to it, it hands them to the follower answering at the
+// address and counts the traffic per script, per follower and against the
+// time the same transactions would take on a real bus.
+//
+// The followers are stand-ins, not emulations: they keep the last value
+// written to each register and answer a read with it, the II_GET bit of the
+// query stripped. That is enough to check that remote getters and setters
+// agree and to see how busy a scene keeps the bus. Values a real follower
+// measures itself (TI.IN, CROW.IN, ...) can be set with ii_bus_set.
+//
+// Bus time assumes a start, the address byte, the data bytes each with an ack
+// and a stop per transaction, at the configured clock. The load is measured
+// in windows of II_BUS_WINDOW_MS by tele_get_ticks, so it only means
+// something when the simulator keeps time.
+
+#define II_BUS_FOLLOWERS 16
+#define II_BUS_REGISTERS 256
+#define II_BUS_KEY_MAX 8     // register names longer than this aren't stored
+#define II_BUS_WINDOW_MS 10  // bus load is measured over windows this long
+
+typedef struct {
+    uint32_t writes;
+    uint32_t reads;
+    uint32_t bytes;  // data bytes, not counting the address
+    uint64_t bits;   // clock cycles on the bus, start, address and acks
+} ii_bus_count_t;
+
+typedef struct ii_follower_s ii_follower_t;
+struct ii_follower_s {
+    const char *name;
+    uint8_t addr;   // first address it answers on
+    uint8_t count;  // and how many addresses from there
+    void (*tx)(const ii_follower_t *f, uint8_t addr, const uint8_t *data,
+               uint8_t l);
+    // NULL for followers that only take writes, reads of them get zeros
+    void (*rx)(const ii_follower_t *f, uint8_t addr, uint8_t *data, uint8_t l);
+};
+
+// the register model used by the built in followers, for custom ones to
+// fall back on
+void ii_bus_register_tx(const ii_follower_t *f, uint8_t addr,
+                        const uint8_t *data, uint8_t l);
+void ii_bus_register_rx(const ii_follower_t *f, uint8_t addr, uint8_t *data,
+                        uint8_t l);
+
+// clears the registers and the counts and attaches the built in followers:
+// TXo, TXi, Ansible, Just Friends, ER-301, Disting EX and crow. khz is the
+// bus clock, 100 or 400 on the module.
+void ii_bus_init(uint16_t khz);
+void ii_bus_set_khz(uint16_t khz);
+
+// returns false when the table is full, a follower attached later wins over
+// one attached earlier on the same address
+bool ii_bus_attach(const ii_follower_t *f);
+
+void ii_bus_tx(uint8_t addr, const uint8_t *data, uint8_t l);
+void ii_bus_rx(uint8_t addr, uint8_t *data, uint8_t l);
+
+// make reads of query from addr return value
+void ii_bus_set(uint8_t addr, const uint8_t *query, uint8_t l, int16_t value);
+
+// called from tele_profile_script when a script starts and ends, traffic is
+// counted against the innermost script running and goes back to the caller
+// once a script run with SCRIPT returns, even when it called itself
+void ii_bus_script_start(uint8_t s);
+void ii_bus_script_end(void);
+
+// the traffic counted against script s, TOTAL_SCRIPT_COUNT for the traffic
+// outside of any script
+const ii_bus_count_t *ii_bus_script_count(uint8_t s);
+
+void ii_bus_reset_stats(void);
+void ii_bus_dump(FILE *out);
+
+#endif
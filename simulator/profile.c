@@ -0,0 +1,153 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include "profile.h"
+
+#include <string.h>
+#include <time.h>
+
+#include "ii_bus.h"
+#include "ops/prof.h"
+#include "teletype_io.h"
+
+profile_t profile;
+
+// when each script that is running started, innermost last, so that a script
+// that calls itself with SCRIPT is timed once per call
+static uint64_t script_start[EXEC_DEPTH + 1];
+static uint8_t script_depth;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint16_t bucket_index(uint64_t ns) {
+    if (ns < (2 << PROFILE_SUB_BITS)) return ns;
+    uint8_t msb = 63;
+    while (!(ns >> msb)) msb--;
+    uint8_t shift = msb - PROFILE_SUB_BITS;
+    return ((shift + 1) << PROFILE_SUB_BITS) +
+           ((ns >> shift) & ((1 << PROFILE_SUB_BITS) - 1));
+}
+
+// the largest value that falls into bucket i
+static uint64_t bucket_max(uint16_t i) {
+    if (i < (2 << PROFILE_SUB_BITS)) return i;
+    uint8_t shift = (i >> PROFILE_SUB_BITS) - 1;
+    uint64_t sub = i & ((1 << PROFILE_SUB_BITS) - 1);
+    return (((1 << PROFILE_SUB_BITS) + sub + 1) << shift) - 1;
+}
+
+static void hist_add(profile_hist_t *h, uint64_t ns) {
+    if (h->count == 0 || ns < h->min) h->min = ns;
+    if (ns > h->max) h->max = ns;
+    h->count++;
+    h->buckets[bucket_index(ns)]++;
+}
+
+// delays don't nest, each one is started and ended by the same call
+static void hist_toggle(profile_hist_t *h) {
+    uint64_t now = now_ns();
+    if (!h->running) {
+        h->start = now;
+        h->running = true;
+        return;
+    }
+    h->running = false;
+    hist_add(h, now - h->start);
+}
+
+void profile_reset() {
+    memset(&profile, 0, sizeof(profile));
+    prof_clear();
+}
+
+// returns the upper bound of the bucket holding the given percentile, clamped
+// to the largest latency seen
+uint64_t profile_percentile(const profile_hist_t *h, uint8_t percent) {
+    if (h->count == 0) return 0;
+    uint64_t target = ((uint64_t)h->count * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (uint16_t i = 0; i < PROFILE_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= target) {
+            uint64_t ns = bucket_max(i);
+            return ns < h->max ? ns : h->max;
+        }
+    }
+    return h->max;
+}
+
+static void dump_hist(FILE *out, const char *name, const profile_hist_t *h) {
+    if (h->count == 0) return;
+    fprintf(out, "%-8s %8u %10.1f %10.1f %10.1f %10.1f\n", name, h->count,
+            h->min / 1e3, profile_percentile(h, 50) / 1e3,
+            profile_percentile(h, 99) / 1e3, h->max / 1e3);
+}
+
+void profile_script_name(uint8_t s, char *name) {
+    if (s == METRO_SCRIPT)
+        strcpy(name, "M");
+    else if (s == INIT_SCRIPT)
+        strcpy(name, "I");
+    else if (s == DELAY_SCRIPT)
+        strcpy(name, "DEL");
+    else if (s == LIVE_SCRIPT)
+        strcpy(name, "LIVE");
+    else
+        sprintf(name, "%u", s + 1);
+}
+
+void profile_dump(FILE *out) {
+    fprintf(out, "%-8s %8s %10s %10s %10s %10s\n", "", "runs", "min us",
+            "p50 us", "p99 us", "max us");
+    for (uint8_t i = 0; i < TOTAL_SCRIPT_COUNT; i++) {
+        char name[16];
+        profile_script_name(i, name);
+        dump_hist(out, name, &profile.script[i]);
+    }
+    for (uint8_t i = 0; i < DELAY_SIZE; i++) {
+        char name[16];
+        sprintf(name, "DEL[%u]", i);
+        dump_hist(out, name, &profile.delay[i]);
+    }
+
+    // ordered by total time, which includes anything an op runs
+    fprintf(out, "\n%-16s %10s %10s %10s\n", "", "calls", "total us",
+            "mean us");
+    const op_profile_t *p;
+    const char *name;
+    for (uint16_t n = 0; (p = prof_rank(n, &name)); n++)
+        fprintf(out, "%-16s %10u %10.1f %10.3f\n", name, p->calls,
+                p->cycles / 1e3, p->cycles / 1e3 / p->calls);
+}
+
+void tele_profile_script(size_t s, bool start) {
+    // scripts nested deeper than the stack aren't timed
+    if (start) {
+        if (script_depth < EXEC_DEPTH + 1) script_start[script_depth] = now_ns();
+        script_depth++;
+        ii_bus_script_start(s);
+        return;
+    }
+
+    if (script_depth == 0) return;
+    script_depth--;
+    if (script_depth < EXEC_DEPTH + 1)
+        hist_add(&profile.script[s], now_ns() - script_start[script_depth]);
+    ii_bus_script_end();
+}
+
+void tele_profile_delay(uint8_t d) {
+    hist_toggle(&profile.delay[d]);
+}
+
+// counts nanoseconds, only differences are used so wrapping is fine
+uint32_t tele_profile_count() {
+    return now_ns();
+}
+
+uint32_t tele_profile_count_us(uint32_t count) {
+    return count / 1000;
+}
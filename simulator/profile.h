@@ -0,0 +1,45 @@
+#ifndef _SIM_PROFILE_H_
+#define _SIM_PROFILE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "state.h"
+
+// Host implementation of the TELETYPE_PROFILE hooks, timed with
+// clock_gettime.
+//
+// Each hook is called once when a script or delay starts and once when it
+// ends. Scripts are paired up by the start flag of tele_profile_script, so a
+// script that calls itself with SCRIPT is timed once per call.
+
+// latencies are kept in log-linear buckets: 8 linear buckets for every power
+// of 2, which is enough to read p50 / p99 to within 12.5%
+#define PROFILE_SUB_BITS 3
+#define PROFILE_BUCKETS (64 << PROFILE_SUB_BITS)
+
+typedef struct {
+    uint64_t start;
+    bool running;
+    uint32_t count;
+    uint64_t min;
+    uint64_t max;
+    uint32_t buckets[PROFILE_BUCKETS];
+} profile_hist_t;
+
+typedef struct {
+    profile_hist_t script[TOTAL_SCRIPT_COUNT];
+    profile_hist_t delay[DELAY_SIZE];
+} profile_t;
+
+extern profile_t profile;
+
+// also clears the per op counters in ops/prof.c
+void profile_reset(void);
+uint64_t profile_percentile(const profile_hist_t *h, uint8_t percent);
+// M, I, DEL, LIVE or the script number, name needs room for 4 characters
+void profile_script_name(uint8_t s, char *name);
+void profile_dump(FILE *out);
+
+#endif
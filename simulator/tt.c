@@ -6,6 +6,9 @@
 #include <string.h>
 #include <time.h>
 
+#include "ii_bus.h"
+#include "ii_queue.h"
+#include "profile.h"
 #include "teletype.h"
 #include "teletype_io.h"
 #include "util.h"
@@ -82,6 +85,7 @@ void tele_cv_off(uint8_t i, int16_t v) {
 }
 
 void tele_ii_tx(uint8_t addr, uint8_t *data, uint8_t l) {
+    ii_bus_tx(addr, data, l);
     printf("II_tx  addr:%" PRIu8 " l:%" PRIu8, addr, l);
     printf("\n");
     for (size_t i = 0; i < l; i++) {
@@ -118,8 +122,12 @@ int16_t get_dashboard_value(uint8_t index) {
 void reset_midi_counter() {}
 
 void tele_ii_rx(uint8_t addr, uint8_t *data, uint8_t l) {
+    ii_bus_rx(addr, data, l);
     printf("II_rx  addr:%" PRIu8 " l:%" PRIu8, addr, l);
     printf("\n");
+    for (size_t i = 0; i < l; i++) {
+        printf("[%" PRIuPTR "] = %" PRIu8 "\n", i, data[i]);
+    }
 }
 
 void tele_scene(uint8_t i, uint8_t init_grid, uint8_t init_pattern) {
@@ -150,9 +158,6 @@ bool tele_get_input_state(uint8_t n) {
 
 void tele_save_calibration() {}
 
-void tele_profile_script(size_t s) {}
-void tele_profile_delay(uint8_t d) {}
-
 void grid_key_press(uint8_t x, uint8_t y, uint8_t z) {
     printf("GRID KEY PRESS x:%" PRIu8 " y:%" PRIu8 " z:%" PRIu8, x, y, z);
     printf("\n");
@@ -180,10 +185,12 @@ int main() {
 
     in = malloc(256);
 
-    printf("teletype. (blank line quits)\n\n");
+    printf("teletype. (blank line quits, :PROF dumps the profile, "
+           ":PROF RESET clears it)\n\n");
 
     scene_state_t ss;
     ss_init(&ss);
+    ii_bus_init(100);
 
     do {
         printf("> ");
@@ -195,6 +202,19 @@ int main() {
             i++;
         }
 
+        if (strncmp(in, ":PROF", 5) == 0) {
+            if (strncmp(in, ":PROF RESET", 11) == 0) {
+                profile_reset();
+                ii_bus_reset_stats();
+            }
+            else {
+                profile_dump(stdout);
+                ii_bus_dump(stdout);
+            }
+            printf("\n");
+            continue;
+        }
+
         tele_command_t temp;
         exec_state_t es;
         es_init(&es);
@@ -207,6 +227,7 @@ int main() {
             printf("\n");
             if (status == E_OK) {
                 process_result_t output = process_command(&ss, &es, &temp);
+                ii_flush();
                 if (output.has_value) { printf(">>> %i\n", output.value); }
             }
         }
@@ -11,30 +11,60 @@ static const int16_t chaos_value_min = -10000;
 static const int16_t chaos_value_max = 10000;
 static const int16_t chaos_param_min = 0;
 static const int16_t chaos_param_max = 10000;
-// fixed beta for henon map
-static const float chaos_henon_b = 0.3;
 // cellular automata parameters (1-d, binary)
 static const int chaos_cell_count = 8;
 static const int chaos_cell_max = 0xff;
 
+// fixed point constants, worked out by the compiler
+#define Q_ONE ((int32_t)1 << CHAOS_Q)
+#define Q(f) ((int32_t)((f) * (double)Q_ONE + 0.5))
+// fixed beta for henon map
+#define Q_HENON_B Q(0.3)
+#define Q_HENON_X_MAX Q(1.5)
+// 1 / 1.5, which Q happens to round up so that 1.5 comes back as 10000
+#define Q_HENON_X_SCALE Q(2.0 / 3.0)
+
 static chaos_state_t chaos_state = { .ix = 5000,
                                      .ir = 5000,
                                      .alg = CHAOS_ALGO_LOGISTIC };
 
+static int32_t q_mul(int32_t a, int32_t b) {
+    return ((int64_t)a * b) >> CHAOS_Q;
+}
+
+// n / d in fixed point, n is scaled by multiplying as shifting a negative
+// value left is undefined
+static int32_t q_div(int32_t n, int32_t d) {
+    return (int64_t)n * (1 << CHAOS_Q) / d;
+}
+
+// q * scale rounded towards zero, like a float cast
+static int16_t q_to_int(int32_t q, int32_t scale) {
+    int64_t v = (int64_t)q * scale;
+    return v < 0 ? -(int16_t)(-v >> CHAOS_Q) : (int16_t)(v >> CHAOS_Q);
+}
+
 void chaos_init() {
+    chaos_state.qx0 = chaos_state.qx1 = 0;
     chaos_scale_values(&chaos_state);
 }
 
-// scale integer state and param values to float,
+// scale integer state and param values to fixed point,
 // as appropriate for current algorithm
 static void chaos_scale_values(chaos_state_t* state) {
+    // the maps only stay within range of the fixed point values for values
+    // and params in their documented ranges
+    int16_t x = state->ix, r = state->ir;
+    if (x < chaos_value_min) { x = chaos_value_min; }
+    if (x > chaos_value_max) { x = chaos_value_max; }
+    if (r < chaos_param_min) { r = chaos_param_min; }
+    if (r > chaos_param_max) { r = chaos_param_max; }
+
     switch (state->alg) {
         case CHAOS_ALGO_HENON:
             // for henon, x in [-1.5, 1.5], r in [1, 1.4]
-            state->fx = state->ix / (float)chaos_value_max * 1.5;
-            state->fr = 1.f + state->ir / (float)chaos_param_max * 0.4;
-            if (state->fr < 1.f) { state->fr = 1.f; }
-            if (state->fr > 1.4) { state->fr = 1.4f; }
+            state->qx = q_div(x * 3, chaos_value_max * 2);
+            state->qr = Q_ONE + q_div(r * 4, chaos_param_max * 10);
             break;
         case CHAOS_ALGO_CELLULAR:
             // 1d binary CA takes binary state and rule
@@ -47,9 +77,10 @@ static void chaos_scale_values(chaos_state_t* state) {
         case CHAOS_ALGO_CUBIC:
         case CHAOS_ALGO_LOGISTIC:  // fall through
         default:
-            // for cubic / logistic, x in [-1, 1] and r in [3.2, 4)
-            state->fx = state->ix / (float)chaos_value_max;
-            state->fr = state->ir / (float)chaos_param_max * 0.9999 + 3.0;
+            // for cubic / logistic, x in [-1, 1] and r in [3, 4)
+            state->qx = q_div(x, chaos_value_max);
+            state->qr = 3 * Q_ONE + q_div((int32_t)r * 9999,
+                                          (int32_t)chaos_param_max * 10000);
             break;
     }
 }
@@ -60,30 +91,32 @@ void chaos_set_val(int16_t val) {
 }
 
 static int16_t logistic_get_val() {
-    if (chaos_state.fx < 0.f) { chaos_state.fx = 0.f; }
-    chaos_state.fx = chaos_state.fx * chaos_state.fr * (1.f - chaos_state.fx);
-    chaos_state.ix = chaos_state.fx * (float)chaos_value_max;
+    if (chaos_state.qx < 0) { chaos_state.qx = 0; }
+    chaos_state.qx = q_mul(q_mul(chaos_state.qx, chaos_state.qr),
+                           Q_ONE - chaos_state.qx);
+    chaos_state.ix = q_to_int(chaos_state.qx, chaos_value_max);
     return chaos_state.ix;
 }
 
 static int16_t cubic_get_val() {
-    float x3 = chaos_state.fx * chaos_state.fx * chaos_state.fx;
-    chaos_state.fx =
-        chaos_state.fr * x3 + chaos_state.fx * (1.f - chaos_state.fr);
-    chaos_state.ix = chaos_state.fx * (float)chaos_value_max;
+    int32_t x3 = q_mul(q_mul(chaos_state.qx, chaos_state.qx), chaos_state.qx);
+    chaos_state.qx = q_mul(chaos_state.qr, x3) +
+                     q_mul(chaos_state.qx, Q_ONE - chaos_state.qr);
+    chaos_state.ix = q_to_int(chaos_state.qx, chaos_value_max);
     return chaos_state.ix;
 }
 
 static int16_t henon_get_val() {
-    float x0_2 = chaos_state.fx0 * chaos_state.fx0;
-    float x = 1.f - (x0_2 * chaos_state.fr) + (chaos_henon_b * chaos_state.fx1);
+    int32_t x0_2 = q_mul(chaos_state.qx0, chaos_state.qx0);
+    int32_t x = Q_ONE - q_mul(x0_2, chaos_state.qr) +
+                q_mul(Q_HENON_B, chaos_state.qx1);
     // reflect bounds to avoid blowup
-    while (x < -1.5) { x = -1.5 - x; }
-    while (x > 1.5) { x = 1.5 - x; }
-    chaos_state.fx1 = chaos_state.fx0;
-    chaos_state.fx0 = chaos_state.fx;
-    chaos_state.fx = x;
-    chaos_state.ix = x / 1.5 * (float)chaos_value_max;
+    while (x < -Q_HENON_X_MAX) { x = -Q_HENON_X_MAX - x; }
+    while (x > Q_HENON_X_MAX) { x = Q_HENON_X_MAX - x; }
+    chaos_state.qx1 = chaos_state.qx0;
+    chaos_state.qx0 = chaos_state.qx;
+    chaos_state.qx = x;
+    chaos_state.ix = q_to_int(q_mul(x, Q_HENON_X_SCALE), chaos_value_max);
     return chaos_state.ix;
 }
 
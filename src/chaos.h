@@ -10,19 +10,24 @@ typedef enum {
     CHAOS_ALGO_COUNT      // unused, don't remve
 } chaos_algo_t;
 
-// keep value and parameter in both integer and float formats
+// fractional bits in the fixed point values, Q4.28 leaves room for the
+// largest intermediate (about 3.2 in the henon map) as there is no FPU
+#define CHAOS_Q 28
+
+// keep value and parameter in both integer and fixed point formats
 // this way, can switch algos on the fly and re-initialize (dunno if this is
 // possible anyway)
 typedef struct {
     int16_t ix;        // state value in integer format
-    float fx;          // normalized floating point state value (as needed)
+    int32_t qx;        // normalized fixed point state value (as needed)
     int16_t ir;        // parameter value in integer format
-    float fr;          // floating-point parm value (as needed)
-    float fx0;         // state history (as needed)
-    float fx1;         // state history (as needed)
+    int32_t qr;        // fixed point parm value (as needed)
+    int32_t qx0;       // state history (as needed)
+    int32_t qx1;       // state history (as needed)
     chaos_algo_t alg;  // current algorithm
 } chaos_state_t;
 
+// also clears the henon map's history
 void chaos_init(void);
 void chaos_set_val(int16_t);
 int16_t chaos_get_val(void);
@@ -18,6 +18,147 @@ void copy_post_command(tele_command_t *dst, const tele_command_t *src) {
            dst->length * sizeof(tele_data_t));
 }
 
+void command_view(tele_command_view_t *dst, const tele_command_t *src) {
+    dst->data = src->data;
+    dst->length = src->length;
+    dst->separator = src->separator;
+    dst->compiled = NULL;
+}
+
+void post_command_view(tele_command_view_t *dst,
+                       const tele_command_view_t *src) {
+    dst->data = &src->data[src->separator + 1];
+    dst->length = src->length - src->separator - 1;
+    dst->separator = -1;
+    dst->compiled = NULL;
+}
+
+void copy_command_view(tele_command_t *dst, const tele_command_view_t *src) {
+    dst->length = src->length;
+    dst->separator = src->separator;
+    memcpy(dst->data, src->data, src->length * sizeof(tele_data_t));
+    dst->comment = false;
+}
+
+// if the word just added to dst (ending at *length) is an I_GET of a pure op
+// and the words that push its params are all numbers, run the op now and
+// replace them all with a push of the result
+static void fold_constants(tele_compiled_t *dst, uint8_t sub_base,
+                           uint8_t *length) {
+    const tele_compiled_word_t *get = &dst->words[*length - 1];
+    const tele_op_t *op = get->call.op;
+    if (op->effect != OP_PURE || !op->returns) return;
+
+    // each param is one stack value, if they're all pushes they are the words
+    // right before the op
+    if (*length - 1 - sub_base < op->params) return;
+    const uint8_t first = *length - 1 - op->params;
+    for (uint8_t i = first; i < *length - 1; i++)
+        if (dst->words[i].instr != I_PUSH) return;
+
+    command_state_t cs;
+    cs_init(&cs);
+    for (uint8_t i = first; i < *length - 1; i++)
+        cs_push(&cs, dst->words[i].value);
+    op->get(op->data, NULL, NULL, &cs);
+
+    dst->words[first].instr = I_PUSH;
+    dst->words[first].value = cs_pop(&cs);
+    *length = first + 1;
+}
+
+// compiles the SUBs of src->data[start, end) onto the end of dst, returns
+// false if they can't be compiled
+static bool compile_subs(tele_compiled_t *dst, const tele_command_t *src,
+                         int16_t start, int16_t end, uint8_t *length) {
+    int16_t sub_start = start;
+
+    for (int16_t idx = start; idx <= end; idx++) {
+        if (idx < end && src->data[idx].tag != SUB_SEP) continue;
+
+        // found the end of a SUB, skip empty ones like process_command does
+        if (idx > sub_start) {
+            // the set fn is picked by looking at how much is on the stack when
+            // the first word is reached, that is known at compile time
+            int16_t depth = 0;
+            const uint8_t sub_base = *length;
+            for (int16_t w = idx - 1; w >= sub_start; w--) {
+                const tele_word_t tag = src->data[w].tag;
+                const int16_t value = src->data[w].value;
+                tele_compiled_word_t *out = &dst->words[(*length)++];
+                out->value = value;
+
+                if (tag == NUMBER || tag == XNUMBER || tag == BNUMBER ||
+                    tag == RNUMBER) {
+                    out->instr = I_PUSH;
+                    depth++;
+                }
+                else if (tag == OP) {
+                    const tele_op_t *op = tele_ops[value];
+                    out->call.op = op;
+                    // the line would be overwritten while it runs in place
+                    if (op->effect == OP_LOADS_SCRIPTS) return false;
+                    if (op->effect == OP_RUNS_SCRIPTS) dst->runs_scripts = true;
+                    if (w == sub_start && op->set != NULL &&
+                        depth >= op->params + 1) {
+                        out->instr = I_SET;
+                        depth -= op->params + 1;
+                    }
+                    else {
+                        if (depth < op->params) return false;
+                        out->instr = I_GET;
+                        depth += (op->returns ? 1 : 0) - op->params;
+                        fold_constants(dst, sub_base, length);
+                    }
+                }
+                else if (tag == MOD) {
+                    if (w != 0 || src->separator == -1) return false;
+                    if (depth < tele_mods[value]->params) return false;
+                    out->instr = I_MOD;
+                    out->call.mod = tele_mods[value];
+                    depth -= tele_mods[value]->params;
+                    dst->has_mod = true;
+                }
+                else
+                    return false;
+
+                if (depth > STACK_SIZE) return false;
+            }
+
+            dst->sub_end[dst->sub_count++] = *length;
+        }
+
+        sub_start = idx + 1;
+    }
+
+    return true;
+}
+
+// compile src into dst, if src can't be compiled (e.g. it doesn't validate) dst
+// is marked as not ok and false is returned. Pure ops with constant params are
+// folded into a single push, src itself is left as it was typed.
+bool compile_command(tele_compiled_t *dst, const tele_command_t *src) {
+    dst->ok = false;
+    dst->has_mod = false;
+    dst->runs_scripts = false;
+    dst->sub_count = 0;
+
+    const int16_t end = src->separator == -1 ? src->length : src->separator;
+    if (end < 0 || end > src->length) return false;
+
+    uint8_t length = 0;
+    if (!compile_subs(dst, src, 0, end, &length)) return false;
+
+    // the POST part is only run by the MOD, from its own SUBs
+    dst->post_sub = dst->sub_count;
+    if (src->separator != -1 && dst->has_mod &&
+        !compile_subs(dst, src, end + 1, src->length, &length))
+        return false;
+
+    dst->ok = true;
+    return true;
+}
+
 void print_command(const tele_command_t *cmd, char *out) {
     out[0] = 0;
     for (size_t i = 0; i < cmd->length; i++) {
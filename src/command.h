@@ -29,8 +29,54 @@ typedef struct {
     bool comment;
 } tele_command_t;
 
+// A tele_command_t prepared for execution by compile_command. The SUB commands
+// are split out, and the words of each one are stored in the order they run
+// (right to left), with ops already resolved to either their get or set fn.
+// The SUBs of the PRE part come first, then those of the POST part.
+// The op or mod a word runs is looked up in tele_ops or tele_mods when it's
+// compiled, running it then reads its fn straight from the tele_op_t.
+typedef enum { I_PUSH, I_GET, I_SET, I_MOD } tele_instr_t;
+
+struct tele_op_s;
+struct tele_mod_s;
+
+typedef struct {
+    uint8_t instr;  // tele_instr_t
+    int16_t value;  // number to push, or op / mod index
+    union {
+        const struct tele_op_s *op;    // I_GET and I_SET
+        const struct tele_mod_s *mod;  // I_MOD
+    } call;
+} tele_compiled_word_t;
+
+typedef struct {
+    bool ok;  // false if the command must be run with process_command instead
+    bool has_mod;
+    bool runs_scripts;  // uses an OP_RUNS_SCRIPTS op, see process_compiled_command
+    uint8_t sub_count;
+    uint8_t post_sub;                     // the first SUB of the POST part
+    uint8_t sub_end[COMMAND_MAX_LENGTH];  // one past the last word of each SUB
+    tele_compiled_word_t words[COMMAND_MAX_LENGTH];
+} tele_compiled_t;
+
+// A window onto the words of a command, used to hand the POST part of a
+// command to a MOD (and on to process_command_view) without copying it. When
+// the command was compiled, compiled points at it and the POST is run from
+// there.
+typedef struct {
+    const tele_data_t *data;
+    uint8_t length;
+    int8_t separator;
+    const tele_compiled_t *compiled;
+} tele_command_view_t;
+
 void copy_command(tele_command_t *dst, const tele_command_t *src);
 void copy_post_command(tele_command_t *dst, const tele_command_t *src);
+void command_view(tele_command_view_t *dst, const tele_command_t *src);
+void post_command_view(tele_command_view_t *dst,
+                       const tele_command_view_t *src);
+void copy_command_view(tele_command_t *dst, const tele_command_view_t *src);
 void print_command(const tele_command_t *c, char *out);
+bool compile_command(tele_compiled_t *dst, const tele_command_t *src);
 
 #endif
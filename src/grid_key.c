@@ -0,0 +1,190 @@
+#include "grid_key.h"
+
+#include "teletype.h"
+
+#define SG ss->grid
+#define GB ss->grid.button[i]
+#define GBC ss->grid.button[i].common
+#define GF ss->grid.fader[i]
+#define GFC ss->grid.fader[i].common
+#define GXY ss->grid.xypad[i]
+#define GXYC ss->grid.xypad[i].common
+
+bool grid_within_area(uint8_t x, uint8_t y, const grid_common_t *gc) {
+    return x >= gc->x && x < (gc->x + gc->w) && y >= gc->y &&
+           y < (gc->y + gc->h);
+}
+
+static bool grid_control_active(scene_state_t *ss, uint8_t x, uint8_t y,
+                                const grid_common_t *gc) {
+    return gc->enabled && SG.group[gc->group].enabled &&
+           grid_within_area(x, y, gc);
+}
+
+static void grid_mark_scripts(scene_state_t *ss, const grid_common_t *gc,
+                              uint8_t *scripts) {
+    SG.latest_group = gc->group;
+    if (SG.group[gc->group].script != -1)
+        scripts[SG.group[gc->group].script] = 1;
+}
+
+bool grid_key_xypad(scene_state_t *ss, uint8_t i, uint8_t x, uint8_t y,
+                    uint8_t z, uint8_t *scripts) {
+    if (!z || !grid_control_active(ss, x, y, &GXYC)) return false;
+    GXY.value_x = x - GXYC.x;
+    GXY.value_y = y - GXYC.y;
+    if (GXYC.script != -1) scripts[GXYC.script] = 1;
+    grid_mark_scripts(ss, &GXYC, scripts);
+    return true;
+}
+
+// the value of a fine fader for a key between its two end keys
+static uint16_t grid_fine_value(uint16_t pos, uint16_t size, uint16_t level) {
+    uint16_t value = (((pos << 1) + 1) * level) / size;
+    return (value >> 1) + (value & 1);
+}
+
+bool grid_key_fader(scene_state_t *ss, uint8_t i, uint8_t x, uint8_t y,
+                    int16_t held_x, int16_t held_y, uint8_t *scripts) {
+    if (!grid_control_active(ss, x, y, &GFC)) return false;
+
+    bool held = held_x != GRID_KEY_NONE;
+    uint16_t value;
+    switch (GF.type) {
+        case FADER_CH_BAR:
+        case FADER_CH_DOT:
+            if (!held) {
+                GF.slide = 0;
+                GF.value = x - GFC.x;
+            }
+            else {
+                grid_start_slide(ss, i);
+                GF.slide_acc = 0;
+                GF.slide_end = x - GFC.x;
+                GF.slide_delta = 16;
+                GF.slide_dir = GF.slide_end > GF.value;
+            }
+            break;
+        case FADER_CV_BAR:
+        case FADER_CV_DOT:
+            if (!held) {
+                GF.slide = 0;
+                GF.value = GFC.h + GFC.y - y - 1;
+            }
+            else {
+                grid_start_slide(ss, i);
+                GF.slide_acc = 0;
+                GF.slide_end = GFC.h + GFC.y - y - 1;
+                GF.slide_delta = 16;
+                GF.slide_dir = GF.slide_end > GF.value;
+            }
+            break;
+        case FADER_FH_BAR:
+        case FADER_FH_DOT:
+            // holding an end key doesn't slide
+            if (held && (held_x == GFC.x || held_x == (GFC.x + GFC.w - 1)))
+                held = false;
+            if (!held) {
+                GF.slide = 0;
+                if (x == GFC.x) {
+                    if (GF.value) GF.value--;
+                }
+                else if (x == GFC.x + GFC.w - 1) {
+                    if (GF.value < GFC.level) GF.value++;
+                }
+                else
+                    GF.value =
+                        grid_fine_value(x - GFC.x - 1, GFC.w - 2, GFC.level);
+            }
+            else {
+                grid_start_slide(ss, i);
+                GF.slide_acc = 0;
+                if (x == GFC.x)
+                    value = 0;
+                else if (x == (GFC.x + GFC.w - 1))
+                    value = GFC.level;
+                else
+                    value =
+                        grid_fine_value(x - GFC.x - 1, GFC.w - 2, GFC.level);
+                GF.slide_end = value;
+                value = ((GFC.w - 2) << 4) / GFC.level;
+                if (value == 0) value = 1;
+                GF.slide_delta = value;
+                GF.slide_dir = GF.slide_end > GF.value;
+            }
+            break;
+        case FADER_FV_BAR:
+        case FADER_FV_DOT:
+            if (held && (held_y == GFC.y || held_y == (GFC.y + GFC.h - 1)))
+                held = false;
+            if (!held) {
+                GF.slide = 0;
+                if (y == GFC.y) {
+                    if (GF.value < GFC.level) GF.value++;
+                }
+                else if (y == GFC.y + GFC.h - 1) {
+                    if (GF.value) GF.value--;
+                }
+                else
+                    GF.value = grid_fine_value(GFC.h + GFC.y - y - 2,
+                                               GFC.h - 2, GFC.level);
+            }
+            else {
+                grid_start_slide(ss, i);
+                GF.slide_acc = 0;
+                if (y == GFC.y)
+                    value = GFC.level;
+                else if (y == (GFC.y + GFC.h - 1))
+                    value = 0;
+                else
+                    value = grid_fine_value(GFC.h + GFC.y - y - 2, GFC.h - 2,
+                                            GFC.level);
+                GF.slide_end = value;
+                value = ((GFC.h - 2) << 4) / GFC.level;
+                if (value == 0) value = 1;
+                GF.slide_delta = value;
+                GF.slide_dir = GF.slide_end > GF.value;
+            }
+            break;
+    }
+
+    if (GFC.script != -1) scripts[GFC.script] = 1;
+    SG.latest_fader = i;
+    grid_mark_scripts(ss, &GFC, scripts);
+    return true;
+}
+
+bool grid_key_button(scene_state_t *ss, uint16_t i, uint8_t x, uint8_t y,
+                     uint8_t z, uint8_t *scripts) {
+    if (!grid_control_active(ss, x, y, &GBC)) return false;
+    if (GB.latch) {
+        if (z) {
+            GB.state = !GB.state;
+            if (GBC.script != -1) scripts[GBC.script] = 1;
+        }
+    }
+    else {
+        GB.state = z;
+        if (GBC.script != -1) scripts[GBC.script] = 1;
+    }
+    SG.latest_button = i;
+    grid_mark_scripts(ss, &GBC, scripts);
+    return true;
+}
+
+void grid_start_slide(scene_state_t *ss, uint8_t i) {
+    GF.slide = 1;
+    if (GF.slide_listed) return;
+
+    uint8_t *link = &SG.slide_head;
+    while (*link != GRID_FADER_NONE && *link < i)
+        link = &ss->grid.fader[*link].slide_next;
+    GF.slide_next = *link;
+    GF.slide_listed = 1;
+    *link = i;
+}
+
+void grid_key_run_scripts(scene_state_t *ss, const uint8_t *scripts) {
+    for (uint8_t i = 0; i < EDITABLE_SCRIPT_COUNT; i++)
+        if (scripts[i]) run_script(ss, i);
+}
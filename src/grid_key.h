@@ -0,0 +1,36 @@
+#ifndef _GRID_KEY_H_
+#define _GRID_KEY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "state.h"
+
+// What a grid key press does to the grid controls of a scene, shared by
+// module/grid.c and the simulators. The caller finds the controls under the
+// key and hands them over one at a time, each marks the scripts it triggers in
+// scripts, which the caller runs once it has been through all of them.
+
+#define GRID_KEY_NONE -1
+
+bool grid_within_area(uint8_t x, uint8_t y, const grid_common_t *gc);
+
+// each of these returns true if the control is enabled and under the key
+
+bool grid_key_xypad(scene_state_t *ss, uint8_t i, uint8_t x, uint8_t y,
+                    uint8_t z, uint8_t *scripts);
+
+// a key pressed on fader i, held_x and held_y are another key held down on the
+// fader, which makes it slide to the new key, or GRID_KEY_NONE
+bool grid_key_fader(scene_state_t *ss, uint8_t i, uint8_t x, uint8_t y,
+                    int16_t held_x, int16_t held_y, uint8_t *scripts);
+
+bool grid_key_button(scene_state_t *ss, uint16_t i, uint8_t x, uint8_t y,
+                     uint8_t z, uint8_t *scripts);
+
+// sets fader i sliding and adds it to the list walked by the fader timer
+void grid_start_slide(scene_state_t *ss, uint8_t i);
+
+void grid_key_run_scripts(scene_state_t *ss, const uint8_t *scripts);
+
+#endif
@@ -167,3 +167,19 @@ void itoa_rbin(uint16_t value, char *out) {
     }
     out[index + 1] = '\0';
 }
+
+// CRC-32 (IEEE 802.3, as used by zip and png) a nibble at a time, start with
+// 0xFFFFFFFF and invert the result
+uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t length) {
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+        0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+        0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+    while (length--) {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ table[crc & 15];
+        crc = (crc >> 4) ^ table[crc & 15];
+    }
+    return crc;
+}
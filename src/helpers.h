@@ -1,6 +1,7 @@
 #ifndef _HELPERS_H_
 #define _HELPERS_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 // http://stackoverflow.com/questions/3599160/unused-parameter-warnings-in-c-code
@@ -20,5 +21,6 @@ int16_t rev_bitstring_to_int(const char *token);
 void itoa_hex(uint16_t value, char *out);
 void itoa_bin(uint16_t value, char *out);
 void itoa_rbin(uint16_t value, char *out);
+uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t length);
 
 #endif
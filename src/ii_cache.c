@@ -0,0 +1,152 @@
+#include "ii_cache.h"
+
+#include <string.h>  // memcmp, memcpy, memset
+
+#include "ii_queue.h"
+#include "teletype_io.h"
+
+typedef struct {
+    bool used;
+    uint8_t addr;
+    uint8_t tx_l;
+    uint8_t rx_l;
+    uint8_t query[II_CACHE_QUERY_MAX];
+    uint8_t reply[II_CACHE_REPLY_MAX];
+    uint16_t age;   // ms since the reply was read from the bus
+    uint16_t idle;  // ms since ii_read last returned it
+} ii_cache_entry_t;
+
+static ii_cache_entry_t cache[II_CACHE_SIZE];
+static int16_t poll_ms = 0;
+static uint8_t poll_next = 0;  // where the round robin poll looks first
+static uint8_t sync_depth = 0;
+static uint16_t last_age = 0;
+
+// reads straight from the bus, anything queued for the follower is sent first
+// so the reply reflects it
+static void bus_read(uint8_t addr, uint8_t *data, uint8_t tx_l, uint8_t rx_l) {
+    ii_flush();
+    tele_ii_tx(addr, data, tx_l);
+    memset(data, 0, rx_l);
+    tele_ii_rx(addr, data, rx_l);
+}
+
+static ii_cache_entry_t *find(uint8_t addr, const uint8_t *query, uint8_t tx_l,
+                              uint8_t rx_l) {
+    for (uint8_t i = 0; i < II_CACHE_SIZE; i++) {
+        ii_cache_entry_t *e = &cache[i];
+        if (e->used && e->addr == addr && e->tx_l == tx_l &&
+            e->rx_l == rx_l && memcmp(e->query, query, tx_l) == 0)
+            return e;
+    }
+    return NULL;
+}
+
+// a free entry, or the one that has gone unread the longest
+static ii_cache_entry_t *claim() {
+    ii_cache_entry_t *oldest = &cache[0];
+    for (uint8_t i = 0; i < II_CACHE_SIZE; i++) {
+        if (!cache[i].used) return &cache[i];
+        if (cache[i].idle > oldest->idle) oldest = &cache[i];
+    }
+    return oldest;
+}
+
+void ii_read(uint8_t addr, uint8_t *data, uint8_t tx_l, uint8_t rx_l) {
+    last_age = 0;
+    if (poll_ms == 0 || tx_l > II_CACHE_QUERY_MAX ||
+        rx_l > II_CACHE_REPLY_MAX) {
+        bus_read(addr, data, tx_l, rx_l);
+        return;
+    }
+
+    ii_cache_entry_t *e = find(addr, data, tx_l, rx_l);
+    if (e && sync_depth == 0) {
+        memcpy(data, e->reply, rx_l);
+        e->idle = 0;
+        last_age = e->age;
+        return;
+    }
+
+    // not cached yet, or a synchronous read that refreshes it
+    if (!e) {
+        e = claim();
+        e->used = true;
+        e->addr = addr;
+        e->tx_l = tx_l;
+        e->rx_l = rx_l;
+        memcpy(e->query, data, tx_l);
+    }
+    bus_read(addr, data, tx_l, rx_l);
+    memcpy(e->reply, data, rx_l);
+    e->age = e->idle = 0;
+}
+
+void ii_cache_invalidate(uint8_t addr) {
+    for (uint8_t i = 0; i < II_CACHE_SIZE; i++)
+        if (cache[i].addr == addr) cache[i].used = false;
+}
+
+void ii_cache_clear() {
+    memset(cache, 0, sizeof(cache));
+    poll_ms = 0;
+    poll_next = 0;
+    sync_depth = 0;
+    last_age = 0;
+}
+
+static uint16_t add_saturating(uint16_t a, uint8_t b) {
+    return a > UINT16_MAX - b ? UINT16_MAX : a + b;
+}
+
+void ii_cache_tick(uint8_t time) {
+    if (poll_ms == 0) return;
+
+    for (uint8_t i = 0; i < II_CACHE_SIZE; i++) {
+        ii_cache_entry_t *e = &cache[i];
+        if (!e->used) continue;
+        e->age = add_saturating(e->age, time);
+        e->idle = add_saturating(e->idle, time);
+        if (e->idle > II_CACHE_IDLE_MS) e->used = false;
+    }
+}
+
+void ii_cache_refresh() {
+    if (poll_ms == 0) return;
+
+    // one read per call at most, so a full cache can't hold up the event
+    // loop, the next entry that is due after the last one polled goes first
+    for (uint8_t n = 0; n < II_CACHE_SIZE; n++) {
+        uint8_t i = (poll_next + n) % II_CACHE_SIZE;
+        ii_cache_entry_t *e = &cache[i];
+        if (!e->used || e->age < poll_ms) continue;
+        uint8_t buffer[II_CACHE_QUERY_MAX];
+        memcpy(buffer, e->query, e->tx_l);
+        bus_read(e->addr, buffer, e->tx_l, e->rx_l);
+        memcpy(e->reply, buffer, e->rx_l);
+        e->age = 0;
+        poll_next = (i + 1) % II_CACHE_SIZE;
+        return;
+    }
+}
+
+void ii_cache_set_poll(int16_t ms) {
+    if (ms < 0) ms = 0;
+    if (ms == 0) memset(cache, 0, sizeof(cache));
+    poll_ms = ms;
+}
+
+int16_t ii_cache_poll() {
+    return poll_ms;
+}
+
+void ii_cache_sync(bool sync) {
+    if (sync)
+        sync_depth++;
+    else if (sync_depth > 0)
+        sync_depth--;
+}
+
+uint16_t ii_cache_last_age() {
+    return last_age;
+}
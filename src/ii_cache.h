@@ -0,0 +1,51 @@
+#ifndef _II_CACHE_H_
+#define _II_CACHE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Values read back from i2c followers. With polling turned on (II.POLL) a
+// remote getter reads the bus once and then returns the cached value straight
+// away. tele_tick ages the values and ii_cache_refresh, called from a timer of
+// its own, reads the ones older than the poll interval again, one per call in
+// turn. A write
+// to a follower drops its cached values, so reading after writing still goes
+// to the bus. Entries that haven't been read for II_CACHE_IDLE_MS stop being
+// polled.
+
+#define II_CACHE_SIZE 16
+#define II_CACHE_QUERY_MAX 4  // longer queries are never cached
+#define II_CACHE_REPLY_MAX 2  // and so are longer replies
+#define II_CACHE_IDLE_MS 2000
+
+// send the first tx_l bytes of data to addr and read rx_l bytes back into
+// data, from the cache when polling is on and the value is cached
+void ii_read(uint8_t addr, uint8_t *data, uint8_t tx_l, uint8_t rx_l);
+
+// drop every value cached for addr
+void ii_cache_invalidate(uint8_t addr);
+
+// drop everything and stop polling, INIT, INIT.SCENE and loading the live
+// scene do it, ss_init doesn't as it's also used for scenes being saved or
+// loaded over USB
+void ii_cache_clear(void);
+
+// age the cached values by time ms, never touches the bus
+void ii_cache_tick(uint8_t time);
+
+// read the next value that is due from the bus, if there is one. Blocks for
+// that one read, so it isn't called from tele_tick.
+void ii_cache_refresh(void);
+
+// poll interval in ms, 0 turns the cache off and every read goes to the bus
+void ii_cache_set_poll(int16_t ms);
+int16_t ii_cache_poll(void);
+
+// while sync is on every read goes to the bus, calls can be nested
+void ii_cache_sync(bool sync);
+
+// how old in ms the value returned by the last ii_read was, 0 if it came from
+// the bus
+uint16_t ii_cache_last_age(void);
+
+#endif
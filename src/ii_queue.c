@@ -0,0 +1,81 @@
+#include "ii_queue.h"
+
+#include <stdbool.h>
+#include <string.h>  // memcmp, memcpy
+
+#include "ii_cache.h"
+#include "teletype_io.h"
+
+typedef struct {
+    uint8_t addr;
+    uint8_t length;
+    bool value;  // queued by ii_tx_value
+    uint8_t data[II_QUEUE_MSG_MAX];
+} ii_msg_t;
+
+static ii_msg_t queue[II_QUEUE_SIZE];
+static uint8_t queue_length = 0;
+static ii_queue_stats_t stats;
+
+void ii_flush() {
+    for (uint8_t i = 0; i < queue_length; i++)
+        tele_ii_tx(queue[i].addr, queue[i].data, queue[i].length);
+    stats.sent += queue_length;
+    queue_length = 0;
+}
+
+static void push(uint8_t addr, uint8_t *data, uint8_t l, bool value) {
+    ii_cache_invalidate(addr);
+    stats.queued++;
+    if (l > II_QUEUE_MSG_MAX) {
+        ii_flush();
+        tele_ii_tx(addr, data, l);
+        stats.sent++;
+        return;
+    }
+    if (queue_length == II_QUEUE_SIZE) ii_flush();
+
+    ii_msg_t *m = &queue[queue_length++];
+    m->addr = addr;
+    m->length = l;
+    m->value = value;
+    memcpy(m->data, data, l);
+    if (queue_length > stats.max_depth) stats.max_depth = queue_length;
+}
+
+void ii_tx(uint8_t addr, uint8_t *data, uint8_t l) {
+    push(addr, data, l, false);
+}
+
+void ii_tx_value(uint8_t addr, uint8_t *data, uint8_t l) {
+    // only the last write queued for addr can be replaced, anything sent to a
+    // follower in between has to see the old value first
+    for (int16_t i = queue_length - 1; i >= 0; i--) {
+        ii_msg_t *m = &queue[i];
+        if (m->addr != addr) continue;
+        if (m->value && l >= 2 && m->length == l &&
+            memcmp(m->data, data, l - 2) == 0) {
+            m->data[l - 2] = data[l - 2];
+            m->data[l - 1] = data[l - 1];
+            ii_cache_invalidate(addr);
+            stats.queued++;
+            stats.coalesced++;
+            return;
+        }
+        break;
+    }
+    push(addr, data, l, true);
+}
+
+void ii_rx(uint8_t addr, uint8_t *data, uint8_t l) {
+    ii_flush();
+    tele_ii_rx(addr, data, l);
+}
+
+const ii_queue_stats_t *ii_queue_stats() {
+    return &stats;
+}
+
+void ii_queue_stats_reset() {
+    memset(&stats, 0, sizeof(stats));
+}
@@ -0,0 +1,40 @@
+#ifndef _II_QUEUE_H_
+#define _II_QUEUE_H_
+
+#include <stdint.h>
+
+// Outgoing i2c writes made by ops are held here instead of going straight to
+// the bus. They are sent in one burst when the outermost script returns and at
+// the start of every tick (for anything run outside a script). A read, and an
+// op that changes one of teletype's own TR or CV outputs, sends everything
+// queued first, so both still come after the writes before them.
+
+#define II_QUEUE_SIZE 32
+#define II_QUEUE_MSG_MAX 10  // longer messages skip the queue
+
+typedef struct {
+    uint32_t queued;     // writes handed to ii_tx and ii_tx_value
+    uint32_t coalesced;  // of those, ones that replaced a write still queued
+    uint32_t sent;       // messages put on the bus
+    uint8_t max_depth;   // most messages waiting at once
+} ii_queue_stats_t;
+
+// queue a write, it is sent as it is and in order
+void ii_tx(uint8_t addr, uint8_t *data, uint8_t l);
+
+// queue a write that sets a register to a value, the last two bytes are the
+// value and the bytes before them name the register. If the last write queued
+// for addr is to the same register it is updated in place instead, so the last
+// write wins.
+void ii_tx_value(uint8_t addr, uint8_t *data, uint8_t l);
+
+// send anything queued and then read from addr
+void ii_rx(uint8_t addr, uint8_t *data, uint8_t l);
+
+// send everything queued
+void ii_flush(void);
+
+const ii_queue_stats_t *ii_queue_stats(void);
+void ii_queue_stats_reset(void);
+
+#endif
@@ -7,5 +7,6 @@
 #include "command.h"
 
 bool match_token(const char *token, const size_t len, tele_data_t *out);
+bool match_token_span(const char *token, const size_t len, tele_data_t *out);
 
 #endif
@@ -1034,6 +1034,19 @@
         "MI.CLKD"     => { MATCH_OP(E_OP_MI_CLKD); };
         "MI.CLKR"     => { MATCH_OP(E_OP_MI_CLKR); };
 
+        # profiling
+        "PROF.OP"     => { MATCH_OP(E_OP_PROF_OP); };
+        "PROF.US"     => { MATCH_OP(E_OP_PROF_US); };
+        "PROF.CLR"    => { MATCH_OP(E_OP_PROF_CLR); };
+
+        # delay
+        "DEL.KILL"    => { MATCH_OP(E_OP_DEL_KILL); };
+        "DEL.N"       => { MATCH_OP(E_OP_DEL_N); };
+
+        # i2c
+        "II.POLL"     => { MATCH_OP(E_OP_II_POLL); };
+        "II.AGE"      => { MATCH_OP(E_OP_II_AGE); };
+
         # MODS
         # controlflow
         "IF"          => { MATCH_MOD(E_MOD_IF); };
@@ -1070,6 +1083,9 @@
         "CROW3"       => { MATCH_MOD(E_MOD_CROW3); };
         "CROW4"       => { MATCH_MOD(E_MOD_CROW4); };
 
+        # i2c
+        "II.SYNC"     => { MATCH_MOD(E_MOD_II_SYNC); };
+
         # matrixarchate
         "MA.SELECT"   => { MATCH_OP(E_OP_MA_SELECT); };
         "MA.STEP"     => { MATCH_OP(E_OP_MA_STEP); };
@@ -0,0 +1,125 @@
+#include "match_token.h"
+
+#include <limits.h>  // LONG_MAX
+#include <string.h>  // strncmp
+
+#include "match_token_hash.h"
+#include "ops/op.h"
+
+// must match match_hash() in utils/match_token_hash.py
+static uint32_t match_hash(const char *token, size_t len, uint16_t seed) {
+    uint32_t h = 0x811C9DC5 ^ seed;
+    for (size_t i = 0; i < len; i++) {
+        h ^= (uint8_t)token[i];
+        h *= 0x01000193;
+    }
+    return h;
+}
+
+static bool is_digit(char c, uint8_t base) {
+    if (base == 16) return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F');
+    return c >= '0' && c < '0' + base;
+}
+
+// accumulates the digits like strtol would, stopping at the first character
+// that isn't a digit in base and saturating on overflow
+static long parse_digits(const char *token, size_t len, uint8_t base) {
+    long val = 0;
+    for (size_t i = 0; i < len && is_digit(token[i], base); i++) {
+        int8_t d = token[i] <= '9' ? token[i] - '0' : token[i] - 'A' + 10;
+        if (val > (LONG_MAX - d) / base) return LONG_MAX;
+        val = val * base + d;
+    }
+    return val;
+}
+
+// matches the number pattern from match_token.rl and converts it the same way
+// MATCH_NUMBER does, without needing a NUL terminated copy
+static bool match_number(const char *token, size_t len, tele_data_t *out) {
+    const char *digits = token;
+    size_t n = len;
+    uint8_t base = 10;
+    out->tag = NUMBER;
+
+    if (token[0] == 'X') {
+        out->tag = XNUMBER;
+        base = 16;
+    }
+    // the Ragel character class [B|R] also admits '|', which strtol then
+    // reads as 0
+    else if (token[0] == 'B' || token[0] == '|') {
+        out->tag = token[0] == 'B' ? BNUMBER : NUMBER;
+        base = 2;
+    }
+    else if (token[0] == 'R') {
+        out->tag = RNUMBER;
+        base = 2;
+    }
+    else if (token[0] == '-') {
+        digits++;
+        n--;
+    }
+
+    if (base != 10) {
+        digits++;
+        n--;
+    }
+
+    if (n == 0) return false;
+    for (size_t i = 0; i < n; i++)
+        if (!is_digit(digits[i], base)) return false;
+
+    int32_t val;
+    if (out->tag == RNUMBER) {
+        int16_t value = 0;
+        for (size_t i = 0; i < n; i++)
+            if (digits[i] == '1') { value += 1 << i; }
+        val = value;
+    }
+    else if (token[0] == '|') {
+        val = 0;
+    }
+    else if (base != 10) {
+        val = (int16_t)((uint16_t)parse_digits(digits, n, base));
+    }
+    else {
+        // strtol with base 0 reads a leading 0 as octal
+        long v = digits[0] == '0' ? parse_digits(digits, n, 8)
+                                  : parse_digits(digits, n, 10);
+        if (token[0] == '-') v = -v;
+        val = v > INT16_MAX ? INT16_MAX : v < INT16_MIN ? INT16_MIN : v;
+    }
+
+    out->value = val;
+    return true;
+}
+
+// matches a single token using the perfect hash generated from tele_ops and
+// tele_mods, the token does not need to be NUL terminated
+bool match_token_span(const char *token, const size_t len, tele_data_t *out) {
+    if (len == 0) return false;
+    if (match_number(token, len, out)) return true;
+
+    uint32_t bucket = match_hash(token, len, 0) % MATCH_HASH_BUCKETS;
+    uint32_t slot =
+        match_hash(token, len, match_hash_seeds[bucket]) % MATCH_HASH_SIZE;
+    uint16_t entry = match_hash_slots[slot];
+
+    // every slot holds a name, so the token still has to be compared with it
+    const char *name;
+    if (entry & MATCH_HASH_MOD) {
+        entry &= ~MATCH_HASH_MOD;
+        if (entry >= E_MOD__LENGTH) return false;
+        name = tele_mods[entry]->name;
+        out->tag = MOD;
+    }
+    else {
+        if (entry >= E_OP__LENGTH) return false;
+        name = tele_ops[entry]->name;
+        out->tag = OP;
+    }
+    if (strncmp(name, token, len) != 0 || name[len] != '\0') return false;
+
+    out->value = entry;
+    return true;
+}
@@ -0,0 +1,151 @@
+// clang-format off
+
+#ifndef _MATCH_TOKEN_HASH_H_
+#define _MATCH_TOKEN_HASH_H_
+
+// This file has been autogenerated by 'utils/match_token_hash.py'
+
+#include <stdint.h>
+
+#define MATCH_HASH_MOD 0x8000
+#define MATCH_HASH_SIZE 987
+#define MATCH_HASH_BUCKETS 247
+
+static const uint16_t match_hash_seeds[MATCH_HASH_BUCKETS] = {
+    32, 7, 27, 52, 105, 1, 431, 18, 3, 1, 16, 2,
+    98, 2, 71, 212, 16, 13, 95, 4, 237, 58, 90, 69,
+    1, 7, 32, 41, 24, 307, 7, 7, 23, 53, 0, 37,
+    7, 322, 47, 10, 3, 11, 142, 16, 1, 240, 23, 141,
+    1, 12, 1, 51, 2, 61, 1, 1, 0, 1, 307, 381,
+    37, 9, 2, 56, 192, 180, 2, 66, 2, 22, 5, 3,
+    1, 7, 3, 14, 10, 3, 18, 25, 2, 59, 66, 2,
+    491, 95, 37, 42, 4, 201, 21, 15, 5, 56, 36, 143,
+    96, 4, 11, 1, 27, 352, 43, 337, 43, 0, 3, 25,
+    259, 56, 8, 39, 5, 256, 139, 61, 3, 10, 188, 73,
+    81, 34, 35, 110, 64, 48, 54, 3, 842, 81, 77, 13,
+    3, 1, 10, 426, 1, 56, 66, 7, 24, 214, 7, 293,
+    221, 3, 317, 101, 176, 9, 17, 12, 95, 12, 2, 45,
+    465, 414, 127, 223, 5, 3, 28, 40, 287, 85, 63, 242,
+    415, 278, 19, 251, 1, 267, 50, 132, 8, 177, 782, 7,
+    25, 1595, 3, 179, 4, 21, 125, 324, 32, 376, 29, 804,
+    1130, 8, 48, 80, 1, 598, 34, 79, 142, 58, 172, 310,
+    2, 20, 443, 1636, 62, 223, 16, 104, 7, 169, 18, 367,
+    222, 2611, 217, 18, 5, 63, 166, 100, 106, 476, 1168, 235,
+    784, 2, 865, 1, 222, 1174, 1, 7, 396, 115, 80, 11027,
+    111, 2347, 345, 1, 1484, 5, 1080,
+};
+
+static const uint16_t match_hash_slots[MATCH_HASH_SIZE] = {
+    0x01B3, 0x008E, 0x01EC, 0x0262, 0x0392, 0x0156, 0x030B, 0x005E, 0x031E,
+    0x001B, 0x0370, 0x028D, 0x0078, 0x016C, 0x001E, 0x0320, 0x0006, 0x0184,
+    0x017D, 0x0019, 0x0011, 0x009F, 0x030E, 0x03AB, 0x01A7, 0x01D1, 0x0250,
+    0x035D, 0x0271, 0x0220, 0x0379, 0x01D3, 0x0377, 0x01AF, 0x0295, 0x0359,
+    0x0217, 0x02DA, 0x0166, 0x0105, 0x01FC, 0x0254, 0x003B, 0x0365, 0x00E1,
+    0x0089, 0x0044, 0x032D, 0x00E4, 0x0110, 0x016A, 0x801B, 0x0033, 0x017C,
+    0x0321, 0x0297, 0x037D, 0x02DC, 0x0364, 0x0109, 0x034A, 0x026F, 0x02C5,
+    0x0210, 0x0337, 0x012D, 0x01B1, 0x0115, 0x0071, 0x02F1, 0x011B, 0x0305,
+    0x01E0, 0x02B3, 0x02E0, 0x0287, 0x0292, 0x00C7, 0x0277, 0x0243, 0x0057,
+    0x0111, 0x0181, 0x0116, 0x00CA, 0x018C, 0x0085, 0x00FF, 0x01C6, 0x0213,
+    0x00C1, 0x0304, 0x0079, 0x017B, 0x0167, 0x01BE, 0x022B, 0x0148, 0x0374,
+    0x0114, 0x01F8, 0x034F, 0x0299, 0x02E4, 0x0247, 0x03B6, 0x00F2, 0x034B,
+    0x01FB, 0x027A, 0x0258, 0x0241, 0x0004, 0x00A0, 0x8001, 0x0189, 0x0123,
+    0x801C, 0x016D, 0x0313, 0x024C, 0x01C9, 0x0198, 0x0215, 0x015A, 0x0296,
+    0x0384, 0x0399, 0x025C, 0x0270, 0x006E, 0x00F8, 0x03B9, 0x0185, 0x0350,
+    0x0064, 0x0306, 0x0045, 0x0234, 0x01BF, 0x0014, 0x021B, 0x02B9, 0x0043,
+    0x8004, 0x005B, 0x03A5, 0x025D, 0x8012, 0x01C3, 0x0244, 0x01AE, 0x0098,
+    0x0126, 0x0155, 0x00FE, 0x0251, 0x018F, 0x01DC, 0x02E5, 0x0141, 0x01DF,
+    0x0236, 0x01BA, 0x0312, 0x02C8, 0x01AA, 0x0266, 0x0261, 0x0008, 0x0190,
+    0x0391, 0x0159, 0x0062, 0x02F0, 0x00E0, 0x0035, 0x800E, 0x005D, 0x0144,
+    0x03A8, 0x800A, 0x0378, 0x02BB, 0x00A2, 0x007A, 0x004B, 0x016B, 0x02EA,
+    0x00FB, 0x00F1, 0x0150, 0x000C, 0x0139, 0x0056, 0x0163, 0x0178, 0x0235,
+    0x0063, 0x0328, 0x0138, 0x0260, 0x03A0, 0x801A, 0x026E, 0x0024, 0x0353,
+    0x001F, 0x0029, 0x009B, 0x008C, 0x0223, 0x0294, 0x0187, 0x02D1, 0x0131,
+    0x011E, 0x00B7, 0x00BB, 0x0246, 0x018E, 0x02B0, 0x010A, 0x033F, 0x005F,
+    0x029C, 0x02E1, 0x01F9, 0x8008, 0x0140, 0x02D8, 0x00C0, 0x01AC, 0x037E,
+    0x024A, 0x00A5, 0x0048, 0x0293, 0x00D7, 0x0080, 0x02F8, 0x0010, 0x014B,
+    0x00C9, 0x00A3, 0x0231, 0x0129, 0x0161, 0x022A, 0x024D, 0x006D, 0x02D7,
+    0x0317, 0x0176, 0x019B, 0x01E9, 0x022C, 0x01C7, 0x0366, 0x0367, 0x025B,
+    0x02D5, 0x002E, 0x024F, 0x0368, 0x013B, 0x0324, 0x018B, 0x00A7, 0x01CE,
+    0x0263, 0x02ED, 0x0344, 0x0224, 0x0216, 0x020B, 0x02F7, 0x0030, 0x031A,
+    0x0082, 0x01CB, 0x037B, 0x01B2, 0x01BC, 0x01A0, 0x004C, 0x0387, 0x01FD,
+    0x013F, 0x01B6, 0x03AF, 0x0382, 0x02CF, 0x8009, 0x03B0, 0x0095, 0x0053,
+    0x03B2, 0x011C, 0x01B5, 0x0142, 0x0354, 0x0333, 0x01D2, 0x03A6, 0x00B2,
+    0x0121, 0x00EA, 0x02DD, 0x00EB, 0x029E, 0x02A5, 0x00DA, 0x00DB, 0x0303,
+    0x0222, 0x01EA, 0x03B4, 0x0265, 0x019C, 0x032A, 0x0226, 0x0397, 0x00AB,
+    0x8015, 0x00E6, 0x0322, 0x016E, 0x01A3, 0x0070, 0x800C, 0x0003, 0x0352,
+    0x0112, 0x0128, 0x02B2, 0x026C, 0x0331, 0x036A, 0x00A8, 0x8005, 0x0038,
+    0x035F, 0x0068, 0x038C, 0x031C, 0x036B, 0x01CA, 0x0396, 0x00BA, 0x8017,
+    0x00DD, 0x036E, 0x021A, 0x01C4, 0x009D, 0x024E, 0x0152, 0x007E, 0x0174,
+    0x01A5, 0x0264, 0x02A8, 0x00AC, 0x03B1, 0x035E, 0x02D3, 0x00BF, 0x012B,
+    0x036F, 0x0049, 0x0058, 0x0052, 0x000B, 0x03BB, 0x0276, 0x026D, 0x0358,
+    0x0153, 0x0135, 0x00E3, 0x0346, 0x0268, 0x0202, 0x0274, 0x0170, 0x0363,
+    0x0173, 0x0086, 0x00FC, 0x013D, 0x020F, 0x02A0, 0x0201, 0x0083, 0x00C3,
+    0x00B5, 0x0326, 0x004D, 0x00B8, 0x019D, 0x02A6, 0x02F3, 0x036D, 0x030D,
+    0x005C, 0x0282, 0x007F, 0x016F, 0x0067, 0x006F, 0x02B1, 0x0197, 0x01BB,
+    0x03B8, 0x022D, 0x00C6, 0x00D3, 0x800F, 0x02FD, 0x02C7, 0x00CB, 0x0332,
+    0x8010, 0x008F, 0x00F0, 0x03B3, 0x0361, 0x02AF, 0x01CC, 0x03B5, 0x036C,
+    0x008D, 0x01AB, 0x0372, 0x0351, 0x0165, 0x0342, 0x02A9, 0x01F7, 0x0205,
+    0x0315, 0x0092, 0x021D, 0x00A6, 0x0020, 0x01F2, 0x0284, 0x013E, 0x0076,
+    0x033E, 0x02AD, 0x01F0, 0x031D, 0x0300, 0x028F, 0x0158, 0x0046, 0x0191,
+    0x030F, 0x019A, 0x01CD, 0x0040, 0x02CB, 0x00DE, 0x0073, 0x037F, 0x0211,
+    0x0269, 0x03AA, 0x00BE, 0x02BF, 0x020A, 0x0193, 0x023F, 0x00AD, 0x0051,
+    0x0061, 0x03AD, 0x0104, 0x00BD, 0x0188, 0x01B4, 0x02F6, 0x003F, 0x02CD,
+    0x03AE, 0x020C, 0x02C6, 0x0214, 0x00B0, 0x0227, 0x01A9, 0x0204, 0x0289,
+    0x0240, 0x02CC, 0x034E, 0x033D, 0x00D5, 0x00CC, 0x0060, 0x00E7, 0x0192,
+    0x0380, 0x0390, 0x000D, 0x012A, 0x8002, 0x0206, 0x0119, 0x01C0, 0x0066,
+    0x0102, 0x02E6, 0x019E, 0x010C, 0x009C, 0x010F, 0x039D, 0x02FC, 0x00CF,
+    0x0195, 0x0309, 0x00F3, 0x001A, 0x010E, 0x02DE, 0x0108, 0x0347, 0x0118,
+    0x021F, 0x027D, 0x0256, 0x0009, 0x01EE, 0x02EB, 0x0219, 0x0146, 0x0103,
+    0x0047, 0x0319, 0x0242, 0x00ED, 0x00D9, 0x002D, 0x039B, 0x002A, 0x0386,
+    0x038F, 0x0120, 0x012C, 0x0253, 0x022F, 0x0099, 0x00D1, 0x011F, 0x031F,
+    0x01F3, 0x01A6, 0x0385, 0x029F, 0x0329, 0x01B0, 0x0221, 0x02C3, 0x00E9,
+    0x01C1, 0x00E2, 0x01D7, 0x0013, 0x028C, 0x02D6, 0x0225, 0x022E, 0x0180,
+    0x00AA, 0x0218, 0x0145, 0x029B, 0x039C, 0x024B, 0x0207, 0x0032, 0x0355,
+    0x0259, 0x039F, 0x023D, 0x02A7, 0x0323, 0x01A1, 0x039E, 0x0059, 0x01FA,
+    0x02D2, 0x0028, 0x0168, 0x01DA, 0x0327, 0x018A, 0x0088, 0x0050, 0x0018,
+    0x00C4, 0x0345, 0x0318, 0x021C, 0x00C2, 0x035C, 0x014C, 0x0398, 0x02F5,
+    0x015C, 0x0106, 0x0124, 0x00F5, 0x02AC, 0x0203, 0x003C, 0x038A, 0x0252,
+    0x007C, 0x0291, 0x0042, 0x0034, 0x023E, 0x0022, 0x02AE, 0x01C2, 0x0027,
+    0x01E3, 0x00EC, 0x0169, 0x037A, 0x01D4, 0x029D, 0x0335, 0x000E, 0x01FE,
+    0x00B4, 0x0151, 0x01D9, 0x021E, 0x03A3, 0x0394, 0x023B, 0x0065, 0x0388,
+    0x00F7, 0x0194, 0x014A, 0x0208, 0x0395, 0x02B8, 0x01EF, 0x02EC, 0x027F,
+    0x01DE, 0x02FB, 0x031B, 0x0133, 0x0316, 0x010D, 0x005A, 0x03BA, 0x02E7,
+    0x0090, 0x0084, 0x02BA, 0x8014, 0x0077, 0x0175, 0x00E5, 0x01A2, 0x006B,
+    0x007D, 0x032F, 0x02EF, 0x03A4, 0x0255, 0x014E, 0x0245, 0x02E9, 0x01D8,
+    0x0257, 0x01F6, 0x003E, 0x001C, 0x025A, 0x0157, 0x00BC, 0x007B, 0x00D8,
+    0x0154, 0x0196, 0x02FF, 0x017A, 0x02CE, 0x0209, 0x8013, 0x01ED, 0x0134,
+    0x002B, 0x02DB, 0x01D5, 0x02FE, 0x0025, 0x0021, 0x0179, 0x0348, 0x02C1,
+    0x00D6, 0x006A, 0x00EF, 0x0273, 0x0229, 0x00B3, 0x0087, 0x015B, 0x00F6,
+    0x01B7, 0x02C0, 0x004F, 0x0228, 0x01E5, 0x0001, 0x01DD, 0x03A1, 0x0039,
+    0x0093, 0x027E, 0x02B6, 0x0212, 0x000A, 0x0371, 0x02D4, 0x02BE, 0x000F,
+    0x03AC, 0x03A2, 0x0091, 0x8011, 0x015D, 0x030C, 0x0286, 0x00E8, 0x01C5,
+    0x02C9, 0x00A9, 0x0281, 0x00AF, 0x0389, 0x0132, 0x00F9, 0x0301, 0x038E,
+    0x008B, 0x0199, 0x023A, 0x0117, 0x014F, 0x0097, 0x00D0, 0x8018, 0x02C4,
+    0x0357, 0x0054, 0x0238, 0x033B, 0x0017, 0x0200, 0x00B9, 0x02BC, 0x0310,
+    0x01F1, 0x038D, 0x02F4, 0x01F5, 0x0275, 0x0072, 0x0314, 0x0232, 0x025E,
+    0x01AD, 0x02EE, 0x801D, 0x013A, 0x03B7, 0x012F, 0x03A9, 0x8019, 0x0122,
+    0x01D6, 0x0172, 0x01CF, 0x004E, 0x0325, 0x019F, 0x0356, 0x0127, 0x00A1,
+    0x00D4, 0x0360, 0x800D, 0x0237, 0x0302, 0x00B1, 0x0023, 0x0164, 0x009A,
+    0x027C, 0x02BD, 0x02CA, 0x8007, 0x0349, 0x02F2, 0x012E, 0x00DF, 0x026B,
+    0x0069, 0x02A3, 0x032B, 0x0037, 0x0125, 0x01F4, 0x029A, 0x0007, 0x025F,
+    0x02E8, 0x034C, 0x002C, 0x0182, 0x00F4, 0x032E, 0x035B, 0x0338, 0x0373,
+    0x00CD, 0x01A4, 0x0233, 0x01EB, 0x0375, 0x0230, 0x028A, 0x00B6, 0x0149,
+    0x0162, 0x011A, 0x0339, 0x015F, 0x0362, 0x017F, 0x035A, 0x01DB, 0x0267,
+    0x001D, 0x01D0, 0x00A4, 0x03A7, 0x0283, 0x02D0, 0x0081, 0x01E8, 0x0113,
+    0x0383, 0x00C5, 0x02B7, 0x8000, 0x013C, 0x0369, 0x02B4, 0x0343, 0x01E4,
+    0x00FD, 0x010B, 0x034D, 0x01A8, 0x02AA, 0x02E2, 0x02A2, 0x0290, 0x0031,
+    0x02D9, 0x00CE, 0x0041, 0x8016, 0x8006, 0x02A1, 0x0000, 0x003D, 0x0015,
+    0x030A, 0x02F9, 0x0376, 0x033A, 0x008A, 0x0340, 0x0278, 0x0100, 0x0186,
+    0x01C8, 0x00C8, 0x0183, 0x02C2, 0x02A4, 0x0285, 0x004A, 0x0130, 0x0147,
+    0x801E, 0x8003, 0x0393, 0x0094, 0x0307, 0x002F, 0x0334, 0x015E, 0x0012,
+    0x0341, 0x0005, 0x01E1, 0x02DF, 0x00FA, 0x0177, 0x01BD, 0x028B, 0x0298,
+    0x0336, 0x0016, 0x02B5, 0x0101, 0x0171, 0x0096, 0x033C, 0x014D, 0x006C,
+    0x0002, 0x00D2, 0x032C, 0x011D, 0x020D, 0x026A, 0x02AB, 0x037C, 0x01E2,
+    0x009E, 0x0074, 0x038B, 0x003A, 0x0330, 0x0055, 0x028E, 0x018D, 0x01E6,
+    0x00EE, 0x0288, 0x01B9, 0x00DC, 0x0036, 0x02FA, 0x0143, 0x0026, 0x0239,
+    0x020E, 0x01FF, 0x0160, 0x0279, 0x023C, 0x0136, 0x0075, 0x02E3, 0x0280,
+    0x0272, 0x0137, 0x0249, 0x00AE, 0x01E7, 0x0311, 0x01B8, 0x0381, 0x0107,
+    0x017E, 0x039A, 0x027B, 0x0308, 0x0248, 0x800B,
+};
+
+#endif
@@ -0,0 +1,112 @@
+#include "midi_script.h"
+
+#include <stdbool.h>
+
+#include "teletype.h"
+
+static bool midi_script_valid(int8_t script) {
+    return script >= 0 && script < EDITABLE_SCRIPT_COUNT;
+}
+
+static void midi_script_event(scene_state_t *ss, uint8_t event_type,
+                              int8_t script) {
+    ss->midi.last_event_type = event_type;
+    if (midi_script_valid(script)) run_script(ss, script);
+}
+
+void midi_script_note_on(scene_state_t *ss, uint8_t ch, uint8_t num,
+                         uint8_t vel) {
+    scene_midi_t *m = &ss->midi;
+    m->last_event_type = 1;
+    m->last_channel = ch;
+    m->last_note = num;
+    m->last_velocity = vel;
+
+    if (m->on_script != -1 && m->on_count < MAX_MIDI_EVENTS) {
+        m->on_channel[m->on_count] = ch;
+        m->note_on[m->on_count] = num;
+        m->note_vel[m->on_count] = vel;
+        m->on_count++;
+    }
+}
+
+void midi_script_note_off(scene_state_t *ss, uint8_t ch, uint8_t num,
+                          uint8_t vel) {
+    scene_midi_t *m = &ss->midi;
+    m->last_event_type = 2;
+    m->last_channel = ch;
+    m->last_note = num;
+    m->last_velocity = vel;
+
+    if (m->off_script != -1 && m->off_count < MAX_MIDI_EVENTS) {
+        m->off_channel[m->off_count] = ch;
+        m->note_off[m->off_count] = num;
+        m->off_count++;
+    }
+}
+
+void midi_script_cc(scene_state_t *ss, uint8_t ch, uint8_t num, uint8_t val) {
+    scene_midi_t *m = &ss->midi;
+    m->last_event_type = 3;
+    m->last_channel = ch;
+    m->last_controller = num;
+    m->last_cc = val;
+
+    if (m->cc_script == -1) return;
+
+    // only the latest value of each controller is kept
+    for (uint8_t i = 0; i < m->cc_count; i++) {
+        if (m->cn[i] == num && m->cc_channel[i] == ch) {
+            m->cc[i] = val;
+            return;
+        }
+    }
+
+    if (m->cc_count < MAX_MIDI_EVENTS) {
+        m->cc_channel[m->cc_count] = ch;
+        m->cn[m->cc_count] = num;
+        m->cc[m->cc_count] = val;
+        m->cc_count++;
+    }
+}
+
+void midi_script_clock(scene_state_t *ss, uint8_t *counter) {
+    if (++*counter < ss->midi.clock_div) return;
+    *counter = 0;
+    midi_script_event(ss, 4, ss->midi.clk_script);
+}
+
+void midi_script_start(scene_state_t *ss) {
+    midi_script_event(ss, 5, ss->midi.start_script);
+}
+
+void midi_script_stop(scene_state_t *ss) {
+    midi_script_event(ss, 6, ss->midi.stop_script);
+}
+
+void midi_script_continue(scene_state_t *ss) {
+    midi_script_event(ss, 7, ss->midi.continue_script);
+}
+
+void midi_script_run_queued(scene_state_t *ss) {
+    scene_midi_t *m = &ss->midi;
+    bool executed[EDITABLE_SCRIPT_COUNT] = { false };
+
+    if (m->on_count && midi_script_valid(m->on_script)) {
+        run_script(ss, m->on_script);
+        executed[m->on_script] = true;
+    }
+
+    if (m->off_count && midi_script_valid(m->off_script)) {
+        if (!executed[m->off_script]) run_script(ss, m->off_script);
+        executed[m->off_script] = true;
+    }
+
+    if (m->cc_count && midi_script_valid(m->cc_script)) {
+        if (!executed[m->cc_script]) run_script(ss, m->cc_script);
+    }
+
+    m->on_count = 0;
+    m->off_count = 0;
+    m->cc_count = 0;
+}
@@ -0,0 +1,30 @@
+#ifndef _MIDI_SCRIPT_H_
+#define _MIDI_SCRIPT_H_
+
+#include <stdint.h>
+
+#include "state.h"
+
+// What incoming MIDI does to a scene, shared by module/main.c and the
+// simulators. Notes and CCs are queued in ss->midi and their scripts run
+// together from midi_script_run_queued, the clock and transport messages run
+// their scripts straight away.
+
+void midi_script_note_on(scene_state_t *ss, uint8_t ch, uint8_t num,
+                         uint8_t vel);
+void midi_script_note_off(scene_state_t *ss, uint8_t ch, uint8_t num,
+                          uint8_t vel);
+void midi_script_cc(scene_state_t *ss, uint8_t ch, uint8_t num, uint8_t val);
+
+// counter is the caller's count of clock ticks since the last division, which
+// MI.CLKR resets through reset_midi_counter
+void midi_script_clock(scene_state_t *ss, uint8_t *counter);
+void midi_script_start(scene_state_t *ss);
+void midi_script_stop(scene_state_t *ss);
+void midi_script_continue(scene_state_t *ss);
+
+// runs the note on, note off and CC scripts once each if anything is queued
+// for them, then empties the queues
+void midi_script_run_queued(scene_state_t *ss);
+
+#endif
@@ -2,6 +2,8 @@
 
 #include "helpers.h"
 #include "ii.h"
+#include "ii_cache.h"
+#include "ii_queue.h"
 #include "teletype_io.h"
 
 
@@ -234,14 +236,14 @@ static void op_ANS_G_LED_get(const void *NOTUSED(data),
     int16_t y = cs_pop(cs);
 
     uint8_t d[] = { II_GRID_LED | II_GET, x, y };
-    tele_ii_tx(II_KR_ADDR, d, 3);
-    tele_ii_tx(II_MP_ADDR, d, 3);
-    tele_ii_tx(ES, d, 3);
+    ii_tx(II_KR_ADDR, d, 3);
+    ii_tx(II_MP_ADDR, d, 3);
+    ii_tx(ES, d, 3);
 
     d[0] = 0;
-    tele_ii_rx(II_KR_ADDR, d, 1);
-    tele_ii_rx(II_MP_ADDR, d, 1);
-    tele_ii_rx(ES, d, 1);
+    ii_rx(II_KR_ADDR, d, 1);
+    ii_rx(II_MP_ADDR, d, 1);
+    ii_rx(ES, d, 1);
     cs_push(cs, d[0]);
 }
 
@@ -251,14 +253,14 @@ static void op_ANS_G_get(const void *data, scene_state_t *ss, exec_state_t *es,
     int16_t y = cs_pop(cs);
 
     uint8_t d[] = { II_GRID_KEY | II_GET, x, y };
-    tele_ii_tx(II_KR_ADDR, d, 4);
-    tele_ii_tx(II_MP_ADDR, d, 4);
-    tele_ii_tx(ES, d, 4);
+    ii_tx(II_KR_ADDR, d, 4);
+    ii_tx(II_MP_ADDR, d, 4);
+    ii_tx(ES, d, 4);
 
     d[0] = 0;
-    tele_ii_rx(II_KR_ADDR, d, 1);
-    tele_ii_rx(II_MP_ADDR, d, 1);
-    tele_ii_rx(ES, d, 1);
+    ii_rx(II_KR_ADDR, d, 1);
+    ii_rx(II_MP_ADDR, d, 1);
+    ii_rx(ES, d, 1);
     cs_push(cs, d[0]);
 }
 
@@ -269,9 +271,9 @@ static void op_ANS_G_set(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     int16_t z = cs_pop(cs);
 
     uint8_t d[] = { II_GRID_KEY, x, y, z };
-    tele_ii_tx(II_KR_ADDR, d, 4);
-    tele_ii_tx(II_MP_ADDR, d, 4);
-    tele_ii_tx(ES, d, 4);
+    ii_tx(II_KR_ADDR, d, 4);
+    ii_tx(II_MP_ADDR, d, 4);
+    ii_tx(ES, d, 4);
 }
 
 static void op_ANS_G_P_get(const void *NOTUSED(data),
@@ -281,13 +283,13 @@ static void op_ANS_G_P_get(const void *NOTUSED(data),
     int16_t y = cs_pop(cs);
 
     uint8_t d[] = { II_GRID_KEY, x, y, 1 };
-    tele_ii_tx(II_KR_ADDR, d, 4);
-    tele_ii_tx(II_MP_ADDR, d, 4);
-    tele_ii_tx(ES, d, 4);
+    ii_tx(II_KR_ADDR, d, 4);
+    ii_tx(II_MP_ADDR, d, 4);
+    ii_tx(ES, d, 4);
     d[3] = 0;
-    tele_ii_tx(II_KR_ADDR, d, 4);
-    tele_ii_tx(II_MP_ADDR, d, 4);
-    tele_ii_tx(ES, d, 4);
+    ii_tx(II_KR_ADDR, d, 4);
+    ii_tx(II_MP_ADDR, d, 4);
+    ii_tx(ES, d, 4);
 }
 
 static void op_ANS_A_LED_get(const void *NOTUSED(data),
@@ -297,11 +299,11 @@ static void op_ANS_A_LED_get(const void *NOTUSED(data),
     int16_t i = cs_pop(cs);
 
     uint8_t d[] = { II_ARC_LED | II_GET, n, i };
-    tele_ii_tx(II_LV_ADDR, d, 3);
-    tele_ii_tx(II_CY_ADDR, d, 3);
+    ii_tx(II_LV_ADDR, d, 3);
+    ii_tx(II_CY_ADDR, d, 3);
     d[0] = 0;
-    tele_ii_rx(II_LV_ADDR, d, 1);
-    tele_ii_rx(II_CY_ADDR, d, 1);
+    ii_rx(II_LV_ADDR, d, 1);
+    ii_rx(II_CY_ADDR, d, 1);
     cs_push(cs, d[0]);
 }
 
@@ -311,32 +313,32 @@ static void op_ANS_A_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     int16_t delta = cs_pop(cs);
 
     uint8_t d[] = { II_ARC_ENC, n, delta };
-    tele_ii_tx(II_LV_ADDR, d, 3);
-    tele_ii_tx(II_CY_ADDR, d, 3);
+    ii_tx(II_LV_ADDR, d, 3);
+    ii_tx(II_CY_ADDR, d, 3);
 }
 
 static void op_ANS_APP_get(const void *NOTUSED(data),
                            scene_state_t *NOTUSED(ss),
                            exec_state_t *NOTUSED(es), command_state_t *cs) {
     uint8_t d[] = { II_ANSIBLE_APP | II_GET };
-    tele_ii_tx(II_ANSIBLE_ADDR, d, 1);
-    tele_ii_tx(II_LV_ADDR, d, 1);
-    tele_ii_tx(II_CY_ADDR, d, 1);
-    tele_ii_tx(II_MP_ADDR, d, 1);
-    tele_ii_tx(II_KR_ADDR, d, 1);
-    tele_ii_tx(II_MID_ADDR, d, 1);
-    tele_ii_tx(II_ARP_ADDR, d, 1);
-    tele_ii_tx(ES, d, 1);
+    ii_tx(II_ANSIBLE_ADDR, d, 1);
+    ii_tx(II_LV_ADDR, d, 1);
+    ii_tx(II_CY_ADDR, d, 1);
+    ii_tx(II_MP_ADDR, d, 1);
+    ii_tx(II_KR_ADDR, d, 1);
+    ii_tx(II_MID_ADDR, d, 1);
+    ii_tx(II_ARP_ADDR, d, 1);
+    ii_tx(ES, d, 1);
 
     d[0] = 0;
-    tele_ii_rx(II_ANSIBLE_ADDR, d, 1);
-    tele_ii_rx(II_LV_ADDR, d, 1);
-    tele_ii_rx(II_CY_ADDR, d, 1);
-    tele_ii_rx(II_KR_ADDR, d, 1);
-    tele_ii_rx(II_MP_ADDR, d, 1);
-    tele_ii_rx(II_MID_ADDR, d, 1);
-    tele_ii_rx(II_ARP_ADDR, d, 1);
-    tele_ii_rx(ES, d, 1);
+    ii_rx(II_ANSIBLE_ADDR, d, 1);
+    ii_rx(II_LV_ADDR, d, 1);
+    ii_rx(II_CY_ADDR, d, 1);
+    ii_rx(II_KR_ADDR, d, 1);
+    ii_rx(II_MP_ADDR, d, 1);
+    ii_rx(II_MID_ADDR, d, 1);
+    ii_rx(II_ARP_ADDR, d, 1);
+    ii_rx(ES, d, 1);
     cs_push(cs, d[0]);
 }
 
@@ -346,30 +348,28 @@ static void op_ANS_APP_set(const void *NOTUSED(data),
     int16_t n = cs_pop(cs);
 
     uint8_t d[] = { II_ANSIBLE_APP, n };
-    tele_ii_tx(II_ANSIBLE_ADDR, d, 2);
-    tele_ii_tx(II_LV_ADDR, d, 2);
-    tele_ii_tx(II_CY_ADDR, d, 2);
-    tele_ii_tx(II_KR_ADDR, d, 2);
-    tele_ii_tx(II_MP_ADDR, d, 2);
-    tele_ii_tx(II_MID_ADDR, d, 2);
-    tele_ii_tx(II_ARP_ADDR, d, 2);
-    tele_ii_tx(ES, d, 2);
+    ii_tx(II_ANSIBLE_ADDR, d, 2);
+    ii_tx(II_LV_ADDR, d, 2);
+    ii_tx(II_CY_ADDR, d, 2);
+    ii_tx(II_KR_ADDR, d, 2);
+    ii_tx(II_MP_ADDR, d, 2);
+    ii_tx(II_MID_ADDR, d, 2);
+    ii_tx(II_ARP_ADDR, d, 2);
+    ii_tx(ES, d, 2);
 }
 
 static void op_KR_PRE_set(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                           exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_KR_PRESET, a };
-    tele_ii_tx(II_KR_ADDR, d, 2);
+    ii_tx(II_KR_ADDR, d, 2);
 }
 
 static void op_KR_PRE_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                           exec_state_t *NOTUSED(es), command_state_t *cs) {
     uint8_t d[] = { II_KR_PRESET | II_GET };
     uint8_t addr = II_KR_ADDR;
-    tele_ii_tx(addr, d, 1);
-    d[0] = 0;
-    tele_ii_rx(addr, d, 1);
+    ii_read(addr, d, 1, 1);
     cs_push(cs, d[0]);
 }
 
@@ -377,16 +377,14 @@ static void op_KR_PAT_set(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                           exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_KR_PATTERN, a };
-    tele_ii_tx(II_KR_ADDR, d, 2);
+    ii_tx(II_KR_ADDR, d, 2);
 }
 
 static void op_KR_PAT_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                           exec_state_t *NOTUSED(es), command_state_t *cs) {
     uint8_t d[] = { II_KR_PATTERN | II_GET };
     uint8_t addr = II_KR_ADDR;
-    tele_ii_tx(addr, d, 1);
-    d[0] = 0;
-    tele_ii_rx(addr, d, 1);
+    ii_read(addr, d, 1, 1);
     cs_push(cs, d[0]);
 }
 
@@ -395,7 +393,7 @@ static void op_KR_SCALE_set(const void *NOTUSED(data),
                             exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_KR_SCALE, a };
-    tele_ii_tx(II_KR_ADDR, d, 2);
+    ii_tx(II_KR_ADDR, d, 2);
 }
 
 static void op_KR_SCALE_get(const void *NOTUSED(data),
@@ -403,9 +401,7 @@ static void op_KR_SCALE_get(const void *NOTUSED(data),
                             exec_state_t *NOTUSED(es), command_state_t *cs) {
     uint8_t d[] = { II_KR_SCALE | II_GET };
     uint8_t addr = II_KR_ADDR;
-    tele_ii_tx(addr, d, 1);
-    d[0] = 0;
-    tele_ii_rx(addr, d, 1);
+    ii_read(addr, d, 1, 1);
     cs_push(cs, d[0]);
 }
 
@@ -414,7 +410,7 @@ static void op_KR_PERIOD_set(const void *NOTUSED(data),
                              exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_KR_PERIOD, a >> 8, a & 0xff };
-    tele_ii_tx(II_KR_ADDR, d, 3);
+    ii_tx(II_KR_ADDR, d, 3);
 }
 
 static void op_KR_PERIOD_get(const void *NOTUSED(data),
@@ -422,10 +418,7 @@ static void op_KR_PERIOD_get(const void *NOTUSED(data),
                              exec_state_t *NOTUSED(es), command_state_t *cs) {
     uint8_t d[] = { II_KR_PERIOD | II_GET, 0 };
     uint8_t addr = II_KR_ADDR;
-    tele_ii_tx(addr, d, 1);
-    d[0] = 0;
-    d[1] = 0;
-    tele_ii_rx(addr, d, 2);
+    ii_read(addr, d, 1, 2);
     cs_push(cs, (d[0] << 8) + d[1]);
 }
 
@@ -435,7 +428,7 @@ static void op_KR_POS_set(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     int16_t b = cs_pop(cs);
     int16_t c = cs_pop(cs);
     uint8_t d[] = { II_KR_POS, a, b, c };
-    tele_ii_tx(II_KR_ADDR, d, 4);
+    ii_tx(II_KR_ADDR, d, 4);
 }
 
 static void op_KR_POS_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
@@ -444,9 +437,7 @@ static void op_KR_POS_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     int16_t b = cs_pop(cs);
     uint8_t d[] = { II_KR_POS | II_GET, a, b };
     uint8_t addr = II_KR_ADDR;
-    tele_ii_tx(addr, d, 3);
-    d[0] = 0;
-    tele_ii_rx(addr, d, 1);
+    ii_read(addr, d, 3, 1);
     cs_push(cs, d[0]);
 }
 
@@ -457,7 +448,7 @@ static void op_KR_L_ST_set(const void *NOTUSED(data),
     int16_t b = cs_pop(cs);
     int16_t c = cs_pop(cs);
     uint8_t d[] = { II_KR_LOOP_ST, a, b, c };
-    tele_ii_tx(II_KR_ADDR, d, 4);
+    ii_tx(II_KR_ADDR, d, 4);
 }
 
 static void op_KR_L_ST_get(const void *NOTUSED(data),
@@ -467,9 +458,7 @@ static void op_KR_L_ST_get(const void *NOTUSED(data),
     int16_t b = cs_pop(cs);
     uint8_t d[] = { II_KR_LOOP_ST | II_GET, a, b };
     uint8_t addr = II_KR_ADDR;
-    tele_ii_tx(addr, d, 3);
-    d[0] = 0;
-    tele_ii_rx(addr, d, 1);
+    ii_read(addr, d, 3, 1);
     cs_push(cs, d[0]);
 }
 
@@ -480,7 +469,7 @@ static void op_KR_L_LEN_set(const void *NOTUSED(data),
     int16_t b = cs_pop(cs);
     int16_t c = cs_pop(cs);
     uint8_t d[] = { II_KR_LOOP_LEN, a, b, c };
-    tele_ii_tx(II_KR_ADDR, d, 4);
+    ii_tx(II_KR_ADDR, d, 4);
 }
 
 static void op_KR_L_LEN_get(const void *NOTUSED(data),
@@ -490,9 +479,7 @@ static void op_KR_L_LEN_get(const void *NOTUSED(data),
     int16_t b = cs_pop(cs);
     uint8_t d[] = { II_KR_LOOP_LEN | II_GET, a, b };
     uint8_t addr = II_KR_ADDR;
-    tele_ii_tx(addr, d, 3);
-    d[0] = 0;
-    tele_ii_rx(addr, d, 1);
+    ii_read(addr, d, 3, 1);
     cs_push(cs, d[0]);
 }
 
@@ -501,7 +488,7 @@ static void op_KR_RES_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     int16_t a = cs_pop(cs);
     int16_t b = cs_pop(cs);
     uint8_t d[] = { II_KR_RESET, a, b };
-    tele_ii_tx(II_KR_ADDR, d, 3);
+    ii_tx(II_KR_ADDR, d, 3);
 }
 
 static void op_KR_CV_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
@@ -510,10 +497,7 @@ static void op_KR_CV_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     a--;
     uint8_t d[] = { II_KR_CV | II_GET, a & 0x3 };
     uint8_t addr = II_KR_ADDR;
-    tele_ii_tx(addr, d, 2);
-    d[0] = 0;
-    d[1] = 0;
-    tele_ii_rx(addr, d, 2);
+    ii_read(addr, d, 2, 2);
     cs_push(cs, (d[0] << 8) + d[1]);
 }
 
@@ -523,7 +507,7 @@ static void op_KR_MUTE_set(const void *NOTUSED(data),
     int16_t a = cs_pop(cs);
     int16_t b = cs_pop(cs);
     uint8_t d[] = { II_KR_MUTE, a, b };
-    tele_ii_tx(II_KR_ADDR, d, 3);
+    ii_tx(II_KR_ADDR, d, 3);
 }
 
 static void op_KR_MUTE_get(const void *NOTUSED(data),
@@ -532,9 +516,7 @@ static void op_KR_MUTE_get(const void *NOTUSED(data),
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_KR_MUTE | II_GET, a };
     uint8_t addr = II_KR_ADDR;
-    tele_ii_tx(addr, d, 2);
-    d[0] = 0;
-    tele_ii_rx(addr, d, 1);
+    ii_read(addr, d, 2, 1);
     cs_push(cs, d[0]);
 }
 
@@ -543,24 +525,21 @@ static void op_KR_TMUTE_get(const void *NOTUSED(data),
                             exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_KR_TMUTE, a };
-    tele_ii_tx(II_KR_ADDR, d, 2);
+    ii_tx(II_KR_ADDR, d, 2);
 }
 
 static void op_KR_CLK_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                           exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_KR_CLK, a };
-    tele_ii_tx(II_KR_ADDR, d, 2);
+    ii_tx(II_KR_ADDR, d, 2);
 }
 
 
 static void op_KR_PG_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                          exec_state_t *NOTUSED(es), command_state_t *cs) {
     uint8_t d[] = { II_KR_PAGE | II_GET };
-    tele_ii_tx(II_KR_ADDR, d, 1);
-
-    d[0] = 0;
-    tele_ii_rx(II_KR_ADDR, d, 1);
+    ii_read(II_KR_ADDR, d, 1, 1);
     cs_push(cs, d[0]);
 }
 
@@ -569,16 +548,13 @@ static void op_KR_PG_set(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     int16_t n = cs_pop(cs);
 
     uint8_t d[] = { II_KR_PAGE, n };
-    tele_ii_tx(II_KR_ADDR, d, 2);
+    ii_tx(II_KR_ADDR, d, 2);
 }
 
 static void op_KR_CUE_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                           exec_state_t *NOTUSED(es), command_state_t *cs) {
     uint8_t d[] = { II_KR_CUE | II_GET };
-    tele_ii_tx(II_KR_ADDR, d, 1);
-
-    d[0] = 0;
-    tele_ii_rx(II_KR_ADDR, d, 1);
+    ii_read(II_KR_ADDR, d, 1, 1);
     cs_push(cs, (int8_t)d[0]);
 }
 
@@ -587,17 +563,14 @@ static void op_KR_CUE_set(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     uint8_t pat = cs_pop(cs);
 
     uint8_t d[] = { II_KR_CUE, pat };
-    tele_ii_tx(II_KR_ADDR, d, 2);
+    ii_tx(II_KR_ADDR, d, 2);
 }
 
 static void op_KR_DIR_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                           exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t n = cs_pop(cs);
     uint8_t d[] = { II_KR_DIR | II_GET, n };
-    tele_ii_tx(II_KR_ADDR, d, 2);
-
-    d[0] = 0;
-    tele_ii_rx(II_KR_ADDR, d, 1);
+    ii_read(II_KR_ADDR, d, 2, 1);
     cs_push(cs, d[0]);
 }
 
@@ -607,7 +580,7 @@ static void op_KR_DIR_set(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     int16_t x = cs_pop(cs);
 
     uint8_t d[] = { II_KR_DIR, n, x };
-    tele_ii_tx(II_KR_ADDR, d, 3);
+    ii_tx(II_KR_ADDR, d, 3);
 }
 
 static void op_KR_DUR_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
@@ -616,10 +589,7 @@ static void op_KR_DUR_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     a--;
     uint8_t d[] = { II_KR_DURATION | II_GET, a & 0x3 };
     uint8_t addr = II_KR_ADDR;
-    tele_ii_tx(addr, d, 2);
-    d[0] = 0;
-    d[1] = 0;
-    tele_ii_rx(addr, d, 2);
+    ii_read(addr, d, 2, 2);
     cs_push(cs, (d[0] << 8) + d[1]);
 }
 
@@ -628,16 +598,14 @@ static void op_ME_PRE_set(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                           exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_MP_PRESET, a };
-    tele_ii_tx(II_MP_ADDR, d, 2);
+    ii_tx(II_MP_ADDR, d, 2);
 }
 
 static void op_ME_PRE_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                           exec_state_t *NOTUSED(es), command_state_t *cs) {
     uint8_t d[] = { II_MP_PRESET | II_GET };
     uint8_t addr = II_MP_ADDR;
-    tele_ii_tx(addr, d, 1);
-    d[0] = 0;
-    tele_ii_rx(addr, d, 1);
+    ii_read(addr, d, 1, 1);
     cs_push(cs, d[0]);
 }
 
@@ -645,7 +613,7 @@ static void op_ME_RES_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                           exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_MP_RESET, a };
-    tele_ii_tx(II_MP_ADDR, d, 2);
+    ii_tx(II_MP_ADDR, d, 2);
 }
 
 static void op_ME_STOP_get(const void *NOTUSED(data),
@@ -653,7 +621,7 @@ static void op_ME_STOP_get(const void *NOTUSED(data),
                            exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_MP_STOP, a };
-    tele_ii_tx(II_MP_ADDR, d, 2);
+    ii_tx(II_MP_ADDR, d, 2);
 }
 
 static void op_ME_SCALE_set(const void *NOTUSED(data),
@@ -661,7 +629,7 @@ static void op_ME_SCALE_set(const void *NOTUSED(data),
                             exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_MP_SCALE, a };
-    tele_ii_tx(II_MP_ADDR, d, 2);
+    ii_tx(II_MP_ADDR, d, 2);
 }
 
 static void op_ME_SCALE_get(const void *NOTUSED(data),
@@ -669,9 +637,7 @@ static void op_ME_SCALE_get(const void *NOTUSED(data),
                             exec_state_t *NOTUSED(es), command_state_t *cs) {
     uint8_t d[] = { II_MP_SCALE | II_GET };
     uint8_t addr = II_MP_ADDR;
-    tele_ii_tx(addr, d, 1);
-    d[0] = 0;
-    tele_ii_rx(addr, d, 1);
+    ii_read(addr, d, 1, 1);
     cs_push(cs, d[0]);
 }
 
@@ -680,7 +646,7 @@ static void op_ME_PERIOD_set(const void *NOTUSED(data),
                              exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_MP_PERIOD, a >> 8, a & 0xff };
-    tele_ii_tx(II_MP_ADDR, d, 3);
+    ii_tx(II_MP_ADDR, d, 3);
 }
 
 static void op_ME_PERIOD_get(const void *NOTUSED(data),
@@ -688,10 +654,7 @@ static void op_ME_PERIOD_get(const void *NOTUSED(data),
                              exec_state_t *NOTUSED(es), command_state_t *cs) {
     uint8_t d[] = { II_MP_PERIOD | II_GET, 0 };
     uint8_t addr = II_MP_ADDR;
-    tele_ii_tx(addr, d, 1);
-    d[0] = 0;
-    d[1] = 0;
-    tele_ii_rx(addr, d, 2);
+    ii_read(addr, d, 1, 2);
     cs_push(cs, (d[0] << 8) + d[1]);
 }
 
@@ -701,10 +664,7 @@ static void op_ME_CV_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     a--;
     uint8_t d[] = { II_MP_CV | II_GET, a & 0x3 };
     uint8_t addr = II_MP_ADDR;
-    tele_ii_tx(addr, d, 2);
-    d[0] = 0;
-    d[1] = 0;
-    tele_ii_rx(addr, d, 2);
+    ii_read(addr, d, 2, 2);
     cs_push(cs, (d[0] << 8) + d[1]);
 }
 
@@ -712,16 +672,14 @@ static void op_LV_PRE_set(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                           exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_LV_PRESET, a };
-    tele_ii_tx(II_LV_ADDR, d, 2);
+    ii_tx(II_LV_ADDR, d, 2);
 }
 
 static void op_LV_PRE_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                           exec_state_t *NOTUSED(es), command_state_t *cs) {
     uint8_t d[] = { II_LV_PRESET | II_GET };
     uint8_t addr = II_LV_ADDR;
-    tele_ii_tx(addr, d, 1);
-    d[0] = 0;
-    tele_ii_rx(addr, d, 1);
+    ii_read(addr, d, 1, 1);
     cs_push(cs, d[0]);
 }
 
@@ -729,23 +687,21 @@ static void op_LV_RES_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                           exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_LV_RESET, a };
-    tele_ii_tx(II_LV_ADDR, d, 2);
+    ii_tx(II_LV_ADDR, d, 2);
 }
 
 static void op_LV_POS_set(const void *data, scene_state_t *ss, exec_state_t *es,
                           command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_LV_POS, a };
-    tele_ii_tx(II_LV_ADDR, d, 2);
+    ii_tx(II_LV_ADDR, d, 2);
 }
 
 static void op_LV_POS_get(const void *data, scene_state_t *ss, exec_state_t *es,
                           command_state_t *cs) {
     uint8_t d[] = { II_LV_POS | II_GET };
     uint8_t addr = II_LV_ADDR;
-    tele_ii_tx(addr, d, 1);
-    d[0] = 0;
-    tele_ii_rx(addr, d, 1);
+    ii_read(addr, d, 1, 1);
     cs_push(cs, d[0]);
 }
 
@@ -753,16 +709,14 @@ static void op_LV_L_ST_set(const void *data, scene_state_t *ss,
                            exec_state_t *es, command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_LV_L_ST, a };
-    tele_ii_tx(II_LV_ADDR, d, 2);
+    ii_tx(II_LV_ADDR, d, 2);
 }
 
 static void op_LV_L_ST_get(const void *data, scene_state_t *ss,
                            exec_state_t *es, command_state_t *cs) {
     uint8_t d[] = { II_LV_L_ST | II_GET };
     uint8_t addr = II_LV_ADDR;
-    tele_ii_tx(addr, d, 1);
-    d[0] = 0;
-    tele_ii_rx(addr, d, 1);
+    ii_read(addr, d, 1, 1);
     cs_push(cs, d[0]);
 }
 
@@ -770,16 +724,14 @@ static void op_LV_L_LEN_set(const void *data, scene_state_t *ss,
                             exec_state_t *es, command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_LV_L_LEN, a };
-    tele_ii_tx(II_LV_ADDR, d, 2);
+    ii_tx(II_LV_ADDR, d, 2);
 }
 
 static void op_LV_L_LEN_get(const void *data, scene_state_t *ss,
                             exec_state_t *es, command_state_t *cs) {
     uint8_t d[] = { II_LV_L_LEN | II_GET };
     uint8_t addr = II_LV_ADDR;
-    tele_ii_tx(addr, d, 1);
-    d[0] = 0;
-    tele_ii_rx(addr, d, 1);
+    ii_read(addr, d, 1, 1);
     cs_push(cs, d[0]);
 }
 
@@ -787,16 +739,14 @@ static void op_LV_L_DIR_set(const void *data, scene_state_t *ss,
                             exec_state_t *es, command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_LV_L_DIR, a };
-    tele_ii_tx(II_LV_ADDR, d, 2);
+    ii_tx(II_LV_ADDR, d, 2);
 }
 
 static void op_LV_L_DIR_get(const void *data, scene_state_t *ss,
                             exec_state_t *es, command_state_t *cs) {
     uint8_t d[] = { II_LV_L_DIR | II_GET };
     uint8_t addr = II_LV_ADDR;
-    tele_ii_tx(addr, d, 1);
-    d[0] = 0;
-    tele_ii_rx(addr, d, 1);
+    ii_read(addr, d, 1, 1);
     cs_push(cs, d[0]);
 }
 
@@ -806,10 +756,7 @@ static void op_LV_CV_get(const void *data, scene_state_t *ss, exec_state_t *es,
     a--;
     uint8_t d[] = { II_LV_CV | II_GET, a & 0x3 };
     uint8_t addr = II_LV_ADDR;
-    tele_ii_tx(addr, d, 2);
-    d[0] = 0;
-    d[1] = 0;
-    tele_ii_rx(addr, d, 2);
+    ii_read(addr, d, 2, 2);
     cs_push(cs, (d[0] << 8) + d[1]);
 }
 
@@ -817,16 +764,14 @@ static void op_CY_PRE_set(const void *data, scene_state_t *ss, exec_state_t *es,
                           command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_CY_PRESET, a };
-    tele_ii_tx(II_CY_ADDR, d, 2);
+    ii_tx(II_CY_ADDR, d, 2);
 }
 
 static void op_CY_PRE_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                           exec_state_t *NOTUSED(es), command_state_t *cs) {
     uint8_t d[] = { II_CY_PRESET | II_GET };
     uint8_t addr = II_CY_ADDR;
-    tele_ii_tx(addr, d, 1);
-    d[0] = 0;
-    tele_ii_rx(addr, d, 1);
+    ii_read(addr, d, 1, 1);
     cs_push(cs, d[0]);
 }
 
@@ -834,7 +779,7 @@ static void op_CY_RES_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                           exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_CY_RESET, a };
-    tele_ii_tx(II_CY_ADDR, d, 2);
+    ii_tx(II_CY_ADDR, d, 2);
 }
 
 static void op_CY_POS_set(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
@@ -842,7 +787,7 @@ static void op_CY_POS_set(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     int16_t a = cs_pop(cs);
     int16_t b = cs_pop(cs);
     uint8_t d[] = { II_CY_POS, a, b };
-    tele_ii_tx(II_CY_ADDR, d, 3);
+    ii_tx(II_CY_ADDR, d, 3);
 }
 
 static void op_CY_POS_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
@@ -850,9 +795,7 @@ static void op_CY_POS_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_CY_POS | II_GET, a };
     uint8_t addr = II_CY_ADDR;
-    tele_ii_tx(addr, d, 2);
-    d[0] = 0;
-    tele_ii_rx(addr, d, 1);
+    ii_read(addr, d, 2, 1);
     cs_push(cs, d[0]);
 }
 
@@ -860,7 +803,7 @@ static void op_CY_REV_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                           exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_CY_REV, a };
-    tele_ii_tx(II_CY_ADDR, d, 2);
+    ii_tx(II_CY_ADDR, d, 2);
 }
 
 static void op_CY_CV_get(const void *data, scene_state_t *ss, exec_state_t *es,
@@ -869,10 +812,7 @@ static void op_CY_CV_get(const void *data, scene_state_t *ss, exec_state_t *es,
     a--;
     uint8_t d[] = { II_CY_CV | II_GET, a & 0x3 };
     uint8_t addr = II_CY_ADDR;
-    tele_ii_tx(addr, d, 2);
-    d[0] = 0;
-    d[1] = 0;
-    tele_ii_rx(addr, d, 2);
+    ii_read(addr, d, 2, 2);
     cs_push(cs, (d[0] << 8) + d[1]);
 }
 
@@ -881,7 +821,7 @@ static void op_MID_SHIFT_get(const void *NOTUSED(data),
                              exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_MID_SHIFT, a >> 8, a & 0xff };
-    tele_ii_tx(II_MID_ADDR, d, 3);
+    ii_tx(II_MID_ADDR, d, 3);
 }
 
 static void op_MID_SLEW_get(const void *NOTUSED(data),
@@ -889,7 +829,7 @@ static void op_MID_SLEW_get(const void *NOTUSED(data),
                             exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_MID_SLEW, a >> 8, a & 0xff };
-    tele_ii_tx(II_MID_ADDR, d, 3);
+    ii_tx(II_MID_ADDR, d, 3);
 }
 
 static void op_ARP_STY_get(const void *NOTUSED(data),
@@ -897,7 +837,7 @@ static void op_ARP_STY_get(const void *NOTUSED(data),
                            exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_ARP_STYLE, a };
-    tele_ii_tx(II_ARP_ADDR, d, 2);
+    ii_tx(II_ARP_ADDR, d, 2);
 }
 
 static void op_ARP_HLD_get(const void *NOTUSED(data),
@@ -905,7 +845,7 @@ static void op_ARP_HLD_get(const void *NOTUSED(data),
                            exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_ARP_HOLD, a & 0xff };
-    tele_ii_tx(II_ARP_ADDR, d, 2);
+    ii_tx(II_ARP_ADDR, d, 2);
 }
 
 static void op_ARP_RPT_get(const void *NOTUSED(data),
@@ -915,7 +855,7 @@ static void op_ARP_RPT_get(const void *NOTUSED(data),
     int16_t b = cs_pop(cs);
     int16_t c = cs_pop(cs);
     uint8_t d[] = { II_ARP_RPT, a, b, c >> 8, c & 0xff };
-    tele_ii_tx(II_ARP_ADDR, d, 5);
+    ii_tx(II_ARP_ADDR, d, 5);
 }
 
 static void op_ARP_GT_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
@@ -923,7 +863,7 @@ static void op_ARP_GT_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     int16_t a = cs_pop(cs);
     int16_t b = cs_pop(cs);
     uint8_t d[] = { II_ARP_GATE, a & 0xff, b & 0xff };
-    tele_ii_tx(II_ARP_ADDR, d, 3);
+    ii_tx(II_ARP_ADDR, d, 3);
 }
 
 static void op_ARP_DIV_get(const void *NOTUSED(data),
@@ -932,7 +872,7 @@ static void op_ARP_DIV_get(const void *NOTUSED(data),
     int16_t a = cs_pop(cs);
     int16_t b = cs_pop(cs);
     uint8_t d[] = { II_ARP_DIV, a & 0xff, b & 0xff };
-    tele_ii_tx(II_ARP_ADDR, d, 3);
+    ii_tx(II_ARP_ADDR, d, 3);
 }
 
 static void op_ARP_RES_get(const void *NOTUSED(data),
@@ -940,7 +880,7 @@ static void op_ARP_RES_get(const void *NOTUSED(data),
                            exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { II_ARP_RESET, a };
-    tele_ii_tx(II_ARP_ADDR, d, 2);
+    ii_tx(II_ARP_ADDR, d, 2);
 }
 
 static void op_ARP_SHIFT_get(const void *NOTUSED(data),
@@ -949,7 +889,7 @@ static void op_ARP_SHIFT_get(const void *NOTUSED(data),
     int16_t a = cs_pop(cs);
     int16_t b = cs_pop(cs);
     uint8_t d[] = { II_ARP_SHIFT, a, b >> 8, b & 0xff };
-    tele_ii_tx(II_ARP_ADDR, d, 4);
+    ii_tx(II_ARP_ADDR, d, 4);
 }
 
 static void op_ARP_SLEW_get(const void *NOTUSED(data),
@@ -958,7 +898,7 @@ static void op_ARP_SLEW_get(const void *NOTUSED(data),
     int16_t a = cs_pop(cs);
     int16_t b = cs_pop(cs);
     uint8_t d[] = { II_ARP_SLEW, a, b >> 8, b & 0xff };
-    tele_ii_tx(II_ARP_ADDR, d, 4);
+    ii_tx(II_ARP_ADDR, d, 4);
 }
 
 static void op_ARP_FIL_get(const void *NOTUSED(data),
@@ -967,7 +907,7 @@ static void op_ARP_FIL_get(const void *NOTUSED(data),
     int16_t a = cs_pop(cs);
     int16_t b = cs_pop(cs);
     uint8_t d[] = { II_ARP_FILL, a, b };
-    tele_ii_tx(II_ARP_ADDR, d, 3);
+    ii_tx(II_ARP_ADDR, d, 3);
 }
 
 static void op_ARP_ROT_get(const void *NOTUSED(data),
@@ -976,7 +916,7 @@ static void op_ARP_ROT_get(const void *NOTUSED(data),
     int16_t a = cs_pop(cs);
     int16_t b = cs_pop(cs);
     uint8_t d[] = { II_ARP_ROT, a, b >> 8, b & 0xff };
-    tele_ii_tx(II_ARP_ADDR, d, 4);
+    ii_tx(II_ARP_ADDR, d, 4);
 }
 
 static void op_ARP_ER_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
@@ -986,5 +926,5 @@ static void op_ARP_ER_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     int16_t c = cs_pop(cs);
     int16_t e = cs_pop(cs);
     uint8_t d[] = { II_ARP_ER, a, b, c, e >> 8, e & 0xff };
-    tele_ii_tx(II_ARP_ADDR, d, 6);
+    ii_tx(II_ARP_ADDR, d, 6);
 }
@@ -1,35 +1,36 @@
 #include "ops/controlflow.h"
 
 #include "helpers.h"
+#include "ii_queue.h"
 #include "random.h"
 #include "teletype.h"
 #include "teletype_io.h"
 
 static void mod_PROB_func(scene_state_t *ss, exec_state_t *es,
                           command_state_t *cs,
-                          const tele_command_t *post_command);
+                          const tele_command_view_t *post_command);
 static void mod_IF_func(scene_state_t *ss, exec_state_t *es,
                         command_state_t *cs,
-                        const tele_command_t *post_command);
+                        const tele_command_view_t *post_command);
 static void mod_ELIF_func(scene_state_t *ss, exec_state_t *es,
                           command_state_t *cs,
-                          const tele_command_t *post_command);
+                          const tele_command_view_t *post_command);
 static void mod_ELSE_func(scene_state_t *ss, exec_state_t *es,
                           command_state_t *cs,
-                          const tele_command_t *post_command);
+                          const tele_command_view_t *post_command);
 static void mod_L_func(scene_state_t *ss, exec_state_t *es, command_state_t *cs,
-                       const tele_command_t *post_command);
+                       const tele_command_view_t *post_command);
 static void mod_W_func(scene_state_t *ss, exec_state_t *es, command_state_t *cs,
-                       const tele_command_t *post_command);
+                       const tele_command_view_t *post_command);
 static void mod_EVERY_func(scene_state_t *ss, exec_state_t *es,
                            command_state_t *cs,
-                           const tele_command_t *post_command);
+                           const tele_command_view_t *post_command);
 static void mod_SKIP_func(scene_state_t *ss, exec_state_t *es,
                           command_state_t *cs,
-                          const tele_command_t *post_command);
+                          const tele_command_view_t *post_command);
 static void mod_OTHER_func(scene_state_t *ss, exec_state_t *es,
                            command_state_t *cs,
-                           const tele_command_t *post_command);
+                           const tele_command_view_t *post_command);
 
 static void op_SCENE_get(const void *data, scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs);
@@ -93,27 +94,27 @@ const tele_mod_t mod_EV = MAKE_MOD(EV, mod_EVERY_func, 1);
 const tele_mod_t mod_SKIP = MAKE_MOD(SKIP, mod_SKIP_func, 1);
 const tele_mod_t mod_OTHER = MAKE_MOD(OTHER, mod_OTHER_func, 0);
 
-const tele_op_t op_SCRIPT = MAKE_GET_SET_OP(SCRIPT, op_SCRIPT_get, op_SCRIPT_set, 0, true);
-const tele_op_t op_SYM_DOLLAR = MAKE_ALIAS_OP($, op_SCRIPT_get, op_SCRIPT_set, 0, true);
-const tele_op_t op_SCRIPT_POL = MAKE_GET_SET_OP(SCRIPT.POL, op_SCRIPT_POL_get, op_SCRIPT_POL_set, 1, true);
-const tele_op_t op_SYM_DOLLAR_POL = MAKE_ALIAS_OP($.POL, op_SCRIPT_POL_get, op_SCRIPT_POL_set, 1, true);
+const tele_op_t op_SCRIPT = MAKE_RUN_OP(SCRIPT, op_SCRIPT_get, op_SCRIPT_set, 0, true);
+const tele_op_t op_SYM_DOLLAR = MAKE_RUN_OP($, op_SCRIPT_get, op_SCRIPT_set, 0, true);
+const tele_op_t op_SCRIPT_POL = MAKE_RUN_OP(SCRIPT.POL, op_SCRIPT_POL_get, op_SCRIPT_POL_set, 1, true);
+const tele_op_t op_SYM_DOLLAR_POL = MAKE_RUN_OP($.POL, op_SCRIPT_POL_get, op_SCRIPT_POL_set, 1, true);
 const tele_op_t op_KILL = MAKE_GET_OP(KILL, op_KILL_get, 0, false);
-const tele_op_t op_SCENE_G = MAKE_GET_OP(SCENE.G, op_SCENE_G_get, 1, false);
-const tele_op_t op_SCENE_P = MAKE_GET_OP(SCENE.P, op_SCENE_P_get, 1, false);
-const tele_op_t op_SCENE = MAKE_GET_SET_OP(SCENE, op_SCENE_get, op_SCENE_set, 0, true);
+const tele_op_t op_SCENE_G = MAKE_LOAD_OP(SCENE.G, op_SCENE_G_get, NULL, 1, false);
+const tele_op_t op_SCENE_P = MAKE_LOAD_OP(SCENE.P, op_SCENE_P_get, NULL, 1, false);
+const tele_op_t op_SCENE = MAKE_LOAD_OP(SCENE, op_SCENE_get, op_SCENE_set, 0, true);
 const tele_op_t op_BREAK = MAKE_GET_OP(BREAK, op_BREAK_get, 0, false);
 const tele_op_t op_BRK = MAKE_ALIAS_OP(BRK, op_BREAK_get, NULL, 0, false);
 const tele_op_t op_SYNC = MAKE_GET_OP(SYNC, op_SYNC_get, 1, false);
 
-const tele_op_t op_SYM_DOLLAR_F  = MAKE_GET_OP($F,  op_SYM_DOLLAR_F_get, 1, true);
-const tele_op_t op_SYM_DOLLAR_F1 = MAKE_GET_OP($F1, op_SYM_DOLLAR_F1_get, 2, true);
-const tele_op_t op_SYM_DOLLAR_F2 = MAKE_GET_OP($F2, op_SYM_DOLLAR_F2_get, 3, true);
-const tele_op_t op_SYM_DOLLAR_L  = MAKE_GET_OP($L,  op_SYM_DOLLAR_L_get, 2, true);
-const tele_op_t op_SYM_DOLLAR_L1 = MAKE_GET_OP($L1, op_SYM_DOLLAR_L1_get, 3, true);
-const tele_op_t op_SYM_DOLLAR_L2 = MAKE_GET_OP($L2, op_SYM_DOLLAR_L2_get, 4, true);
-const tele_op_t op_SYM_DOLLAR_S  = MAKE_GET_OP($S,  op_SYM_DOLLAR_S_get, 1, true);
-const tele_op_t op_SYM_DOLLAR_S1 = MAKE_GET_OP($S1, op_SYM_DOLLAR_S1_get, 2, true);
-const tele_op_t op_SYM_DOLLAR_S2 = MAKE_GET_OP($S2, op_SYM_DOLLAR_S2_get, 3, true);
+const tele_op_t op_SYM_DOLLAR_F  = MAKE_RUN_OP($F,  op_SYM_DOLLAR_F_get, NULL, 1, true);
+const tele_op_t op_SYM_DOLLAR_F1 = MAKE_RUN_OP($F1, op_SYM_DOLLAR_F1_get, NULL, 2, true);
+const tele_op_t op_SYM_DOLLAR_F2 = MAKE_RUN_OP($F2, op_SYM_DOLLAR_F2_get, NULL, 3, true);
+const tele_op_t op_SYM_DOLLAR_L  = MAKE_RUN_OP($L,  op_SYM_DOLLAR_L_get, NULL, 2, true);
+const tele_op_t op_SYM_DOLLAR_L1 = MAKE_RUN_OP($L1, op_SYM_DOLLAR_L1_get, NULL, 3, true);
+const tele_op_t op_SYM_DOLLAR_L2 = MAKE_RUN_OP($L2, op_SYM_DOLLAR_L2_get, NULL, 4, true);
+const tele_op_t op_SYM_DOLLAR_S  = MAKE_RUN_OP($S,  op_SYM_DOLLAR_S_get, NULL, 1, true);
+const tele_op_t op_SYM_DOLLAR_S1 = MAKE_RUN_OP($S1, op_SYM_DOLLAR_S1_get, NULL, 2, true);
+const tele_op_t op_SYM_DOLLAR_S2 = MAKE_RUN_OP($S2, op_SYM_DOLLAR_S2_get, NULL, 3, true);
 const tele_op_t op_I1            = MAKE_GET_OP(I1,  op_I1_get, 0, true);
 const tele_op_t op_I2            = MAKE_GET_OP(I2,  op_I2_get, 0, true);
 const tele_op_t op_FR            = MAKE_GET_SET_OP(FR, op_FR_get, op_FR_set, 0, true);
@@ -122,49 +123,51 @@ const tele_op_t op_FR            = MAKE_GET_SET_OP(FR, op_FR_get, op_FR_set, 0,
 
 static void mod_PROB_func(scene_state_t *ss, exec_state_t *es,
                           command_state_t *cs,
-                          const tele_command_t *post_command) {
+                          const tele_command_view_t *post_command) {
     int16_t a = cs_pop(cs);
     random_state_t *r = &ss->rand_states.s.prob.rand;
 
-    if (random_next(r) % 100 < a) { process_command(ss, es, post_command); }
+    if (random_next(r) % 100 < a) {
+        process_command_view(ss, es, post_command);
+    }
 }
 
 static void mod_IF_func(scene_state_t *ss, exec_state_t *es,
                         command_state_t *cs,
-                        const tele_command_t *post_command) {
+                        const tele_command_view_t *post_command) {
     int16_t a = cs_pop(cs);
 
     es_variables(es)->if_else_condition = false;
     if (a) {
         es_variables(es)->if_else_condition = true;
-        process_command(ss, es, post_command);
+        process_command_view(ss, es, post_command);
     }
 }
 
 static void mod_ELIF_func(scene_state_t *ss, exec_state_t *es,
                           command_state_t *cs,
-                          const tele_command_t *post_command) {
+                          const tele_command_view_t *post_command) {
     int16_t a = cs_pop(cs);
 
     if (!es_variables(es)->if_else_condition) {
         if (a) {
             es_variables(es)->if_else_condition = true;
-            process_command(ss, es, post_command);
+            process_command_view(ss, es, post_command);
         }
     }
 }
 
 static void mod_ELSE_func(scene_state_t *ss, exec_state_t *es,
                           command_state_t *NOTUSED(cs),
-                          const tele_command_t *post_command) {
+                          const tele_command_view_t *post_command) {
     if (!es_variables(es)->if_else_condition) {
         es_variables(es)->if_else_condition = true;
-        process_command(ss, es, post_command);
+        process_command_view(ss, es, post_command);
     }
 }
 
 static void mod_L_func(scene_state_t *ss, exec_state_t *es, command_state_t *cs,
-                       const tele_command_t *post_command) {
+                       const tele_command_view_t *post_command) {
     int16_t a = cs_pop(cs);
     int16_t b = cs_pop(cs);
 
@@ -180,7 +183,7 @@ static void mod_L_func(scene_state_t *ss, exec_state_t *es, command_state_t *cs,
 
         // iterate with higher precision to account for b == 32767
         for (int32_t l = a; l <= b; l++) {
-            process_command(ss, es, post_command);
+            process_command_view(ss, es, post_command);
             if (es_variables(es)->breaking) break;
             // the increment statement has careful syntax, because the
             // ++ operator has precedence over the dereference * operator
@@ -193,7 +196,7 @@ static void mod_L_func(scene_state_t *ss, exec_state_t *es, command_state_t *cs,
     // Reverse loop (also works for equal values (either loop would))
     else {
         for (int32_t l = a; l >= b && !es_variables(es)->breaking; l--) {
-            process_command(ss, es, post_command);
+            process_command_view(ss, es, post_command);
             (*i)--;
         }
         if (!es_variables(es)->breaking) (*i)++;
@@ -201,10 +204,10 @@ static void mod_L_func(scene_state_t *ss, exec_state_t *es, command_state_t *cs,
 }
 
 static void mod_W_func(scene_state_t *ss, exec_state_t *es, command_state_t *cs,
-                       const tele_command_t *post_command) {
+                       const tele_command_view_t *post_command) {
     int16_t a = cs_pop(cs);
     if (a) {
-        process_command(ss, es, post_command);
+        process_command_view(ss, es, post_command);
         es_variables(es)->while_depth++;
         if (es_variables(es)->while_depth < WHILE_DEPTH)
             es_variables(es)->while_continue = true;
@@ -217,7 +220,7 @@ static void mod_W_func(scene_state_t *ss, exec_state_t *es, command_state_t *cs,
 
 static void mod_EVERY_func(scene_state_t *ss, exec_state_t *es,
                            command_state_t *cs,
-                           const tele_command_t *post_command) {
+                           const tele_command_view_t *post_command) {
     int16_t mod = cs_pop(cs);
 
     if (es_variables(es)->script_number >= TOTAL_SCRIPT_COUNT) return;
@@ -227,12 +230,12 @@ static void mod_EVERY_func(scene_state_t *ss, exec_state_t *es,
     every_set_skip(every, false);
     every_set_mod(every, mod);
     every_tick(every);
-    if (every_is_now(ss, every)) process_command(ss, es, post_command);
+    if (every_is_now(ss, every)) process_command_view(ss, es, post_command);
 }
 
 static void mod_SKIP_func(scene_state_t *ss, exec_state_t *es,
                           command_state_t *cs,
-                          const tele_command_t *post_command) {
+                          const tele_command_view_t *post_command) {
     int16_t mod = cs_pop(cs);
 
     if (es_variables(es)->script_number >= TOTAL_SCRIPT_COUNT) return;
@@ -242,13 +245,13 @@ static void mod_SKIP_func(scene_state_t *ss, exec_state_t *es,
     every_set_skip(every, true);
     every_set_mod(every, mod);
     every_tick(every);
-    if (skip_is_now(ss, every)) process_command(ss, es, post_command);
+    if (skip_is_now(ss, every)) process_command_view(ss, es, post_command);
 }
 
 static void mod_OTHER_func(scene_state_t *ss, exec_state_t *es,
                            command_state_t *NOTUSED(cs),
-                           const tele_command_t *post_command) {
-    if (!ss->every_last) process_command(ss, es, post_command);
+                           const tele_command_view_t *post_command) {
+    if (!ss->every_last) process_command_view(ss, es, post_command);
 }
 
 
@@ -348,6 +351,7 @@ static void op_KILL_get(const void *NOTUSED(data), scene_state_t *ss,
     ss->variables.m_act = 0;
     tele_metro_updated();
     clear_delays(ss);
+    ii_flush();
     tele_kill();
 }
 
@@ -3,6 +3,7 @@
 #include "helpers.h"
 #include "i2c.h"
 #include "ii.h"
+#include "ii_queue.h"
 #include "teletype.h"
 #include "teletype_io.h"
 
@@ -10,7 +11,7 @@
 // helper macros for terse inline defns
 #define CR_PROTO_MOD(name)                                                     \
     static void name(scene_state_t *ss, exec_state_t *es, command_state_t *cs, \
-                     const tele_command_t *post_command)
+                     const tele_command_view_t *post_command)
 #define CR_PROTO_GET(name)                                                  \
     static void name(const void *data, scene_state_t *ss, exec_state_t *es, \
                      command_state_t *cs)
@@ -23,37 +24,37 @@ static u8 unit = CROW_ADDR_0;
 CR_PROTO_MOD(mod_CROWALL_func) {
     u8 u = unit;
     unit = CROW_ADDR_0;
-    process_command(ss, es, post_command);
+    process_command_view(ss, es, post_command);
     unit = CROW_ADDR_1;
-    process_command(ss, es, post_command);
+    process_command_view(ss, es, post_command);
     unit = CROW_ADDR_2;
-    process_command(ss, es, post_command);
+    process_command_view(ss, es, post_command);
     unit = CROW_ADDR_3;
-    process_command(ss, es, post_command);
+    process_command_view(ss, es, post_command);
     unit = u;
 }
 CR_PROTO_MOD(mod_CROW1_func) {
     u8 u = unit;
     unit = CROW_ADDR_0;
-    process_command(ss, es, post_command);
+    process_command_view(ss, es, post_command);
     unit = u;
 }
 CR_PROTO_MOD(mod_CROW2_func) {
     u8 u = unit;
     unit = CROW_ADDR_1;
-    process_command(ss, es, post_command);
+    process_command_view(ss, es, post_command);
     unit = u;
 }
 CR_PROTO_MOD(mod_CROW3_func) {
     u8 u = unit;
     unit = CROW_ADDR_2;
-    process_command(ss, es, post_command);
+    process_command_view(ss, es, post_command);
     unit = u;
 }
 CR_PROTO_MOD(mod_CROW4_func) {
     u8 u = unit;
     unit = CROW_ADDR_3;
-    process_command(ss, es, post_command);
+    process_command_view(ss, es, post_command);
     unit = u;
 }
 CR_PROTO_GET(op_CROW_SEL_get) {
@@ -98,7 +99,7 @@ CR_PROTO_GET(op_CROW_CALL3_get) {
     int16_t c = cs_pop(cs);
     uint8_t d[] = { CROW_CALL3, a >> 8, a & 0xff, b >> 8,
                     b & 0xff,   c >> 8, c & 0xFF };
-    tele_ii_tx(unit, d, 7);
+    ii_tx(unit, d, 7);
 }
 CR_PROTO_GET(op_CROW_CALL4_get) {
     int16_t a = cs_pop(cs);
@@ -107,7 +108,7 @@ CR_PROTO_GET(op_CROW_CALL4_get) {
     int16_t e = cs_pop(cs);
     uint8_t d[] = { CROW_CALL4, a >> 8,   a & 0xff, b >> 8,  b & 0xff,
                     c >> 8,     c & 0xFF, e >> 8,   e & 0xFF };
-    tele_ii_tx(unit, d, 9);
+    ii_tx(unit, d, 9);
 }
 CR_PROTO_GET(op_CROW_RESET_get) {
     i2c_write_0(cs, unit, CROW_RESET);
@@ -118,7 +119,7 @@ CR_PROTO_GET(op_CROW_PULSE_get) {
     int16_t c = cs_pop(cs);
     int16_t e = cs_pop(cs);
     uint8_t d[] = { CROW_PULSE, a, b >> 8, b & 0xff, c >> 8, c & 0xFF, e };
-    tele_ii_tx(unit, d, 7);
+    ii_tx(unit, d, 7);
 }
 CR_PROTO_GET(op_CROW_AR_get) {
     int16_t a = cs_pop(cs);
@@ -127,7 +128,7 @@ CR_PROTO_GET(op_CROW_AR_get) {
     int16_t e = cs_pop(cs);
     uint8_t d[] = { CROW_AR, a,        b >> 8, b & 0xff,
                     c >> 8,  c & 0xFF, e >> 8, e & 0xFF };
-    tele_ii_tx(unit, d, 8);
+    ii_tx(unit, d, 8);
 }
 CR_PROTO_GET(op_CROW_LFO_get) {
     int16_t a = cs_pop(cs);
@@ -136,7 +137,7 @@ CR_PROTO_GET(op_CROW_LFO_get) {
     int16_t e = cs_pop(cs);
     uint8_t d[] = { CROW_LFO, a,        b >> 8, b & 0xff,
                     c >> 8,   c & 0xFF, e >> 8, e & 0xFF };
-    tele_ii_tx(unit, d, 8);
+    ii_tx(unit, d, 8);
 }
 
 
@@ -144,40 +145,40 @@ CR_PROTO_GET(op_CROW_LFO_get) {
 
 CR_PROTO_GET(op_CROW_IN_get) {
     u8 d[] = { CROW_IN, cs_pop(cs) };
-    tele_ii_tx(unit, d, 2);
+    ii_tx(unit, d, 2);
     u8 r[2];
-    tele_ii_rx(unit, r, 2);
+    ii_rx(unit, r, 2);
     cs_push(cs, (r[0] << 8) + r[1]);
 }
 CR_PROTO_GET(op_CROW_OUT_get) {
     u8 d[] = { CROW_OUT, cs_pop(cs) };
-    tele_ii_tx(unit, d, 2);
+    ii_tx(unit, d, 2);
     u8 r[2];
-    tele_ii_rx(unit, r, 2);
+    ii_rx(unit, r, 2);
     cs_push(cs, (r[0] << 8) + r[1]);
 }
 CR_PROTO_GET(op_CROW_Q0_get) {
     u8 d[] = { CROW_QUERY0 };
-    tele_ii_tx(unit, d, 1);
+    ii_tx(unit, d, 1);
     u8 r[2];
-    tele_ii_rx(unit, r, 2);
+    ii_rx(unit, r, 2);
     cs_push(cs, (r[0] << 8) + r[1]);
 }
 CR_PROTO_GET(op_CROW_Q1_get) {
     u16 a = cs_pop(cs);
     u8 d[] = { CROW_QUERY1, a >> 8, a & 0xFF };
-    tele_ii_tx(unit, d, 3);
+    ii_tx(unit, d, 3);
     u8 r[2];
-    tele_ii_rx(unit, r, 2);
+    ii_rx(unit, r, 2);
     cs_push(cs, (r[0] << 8) + r[1]);
 }
 CR_PROTO_GET(op_CROW_Q2_get) {
     u16 a = cs_pop(cs);
     u16 b = cs_pop(cs);
     u8 d[] = { CROW_QUERY2, a >> 8, a & 0xFF, b >> 8, b & 0xFF };
-    tele_ii_tx(unit, d, 5);
+    ii_tx(unit, d, 5);
     u8 r[2];
-    tele_ii_rx(unit, r, 2);
+    ii_rx(unit, r, 2);
     cs_push(cs, (r[0] << 8) + r[1]);
 }
 CR_PROTO_GET(op_CROW_Q3_get) {
@@ -187,9 +188,9 @@ CR_PROTO_GET(op_CROW_Q3_get) {
     u8 d[] = {
         CROW_QUERY3, a >> 8, a & 0xFF, b >> 8, b & 0xFF, c >> 8, c & 0xFF
     };
-    tele_ii_tx(unit, d, 7);
+    ii_tx(unit, d, 7);
     u8 r[2];
-    tele_ii_rx(unit, r, 2);
+    ii_rx(unit, r, 2);
     cs_push(cs, (r[0] << 8) + r[1]);
 }
 
@@ -6,33 +6,41 @@
 
 static bool delay_common_add(scene_state_t *ss, exec_state_t *es,
                              int16_t delay_time,
-                             const tele_command_t *post_command);
+                             const tele_command_view_t *post_command);
 
 static void mod_DEL_func(scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs,
-                         const tele_command_t *post_command);
+                         const tele_command_view_t *post_command);
 
 static void op_DEL_CLR_get(const void *data, scene_state_t *ss,
                            exec_state_t *es, command_state_t *cs);
 
+static void op_DEL_KILL_get(const void *data, scene_state_t *ss,
+                            exec_state_t *es, command_state_t *cs);
+
+static void op_DEL_N_get(const void *data, scene_state_t *ss,
+                         exec_state_t *es, command_state_t *cs);
+
 static void mod_DEL_X_func(scene_state_t *ss, exec_state_t *es,
                            command_state_t *cs,
-                           const tele_command_t *post_command);
+                           const tele_command_view_t *post_command);
 
 static void mod_DEL_R_func(scene_state_t *ss, exec_state_t *es,
                            command_state_t *cs,
-                           const tele_command_t *post_command);
+                           const tele_command_view_t *post_command);
 
 static void mod_DEL_G_func(scene_state_t *ss, exec_state_t *es,
                            command_state_t *cs,
-                           const tele_command_t *post_command);
+                           const tele_command_view_t *post_command);
 
 static void mod_DEL_B_func(scene_state_t *ss, exec_state_t *es,
                            command_state_t *cs,
-                           const tele_command_t *post_command);
+                           const tele_command_view_t *post_command);
 
 const tele_mod_t mod_DEL = MAKE_MOD(DEL, mod_DEL_func, 1);
 const tele_op_t op_DEL_CLR = MAKE_GET_OP(DEL.CLR, op_DEL_CLR_get, 0, false);
+const tele_op_t op_DEL_KILL = MAKE_GET_OP(DEL.KILL, op_DEL_KILL_get, 1, false);
+const tele_op_t op_DEL_N = MAKE_GET_OP(DEL.N, op_DEL_N_get, 1, true);
 const tele_mod_t mod_DEL_X = MAKE_MOD(DEL.X, mod_DEL_X_func, 2);
 const tele_mod_t mod_DEL_R = MAKE_MOD(DEL.R, mod_DEL_R_func, 2);
 const tele_mod_t mod_DEL_G = MAKE_MOD(DEL.G, mod_DEL_G_func, 4);
@@ -42,31 +50,14 @@ const tele_mod_t mod_DEL_B = MAKE_MOD(DEL.B, mod_DEL_B_func, 2);
 // NOTE it is the responsibility of the callee to call tele_has_delays
 static bool delay_common_add(scene_state_t *ss, exec_state_t *es,
                              int16_t delay_time,
-                             const tele_command_t *post_command) {
-    int16_t i = 0;
-
-    // 0 is the magic number for an empty slot.
-    // Be careful not to set delay.time[i] to 0 before calling this function.
-    while (ss->delay.time[i] != 0 && i != DELAY_SIZE) i++;
-
-    if (delay_time < 1) delay_time = 1;
-
-    if (i < DELAY_SIZE) {
-        ss->delay.count++;
-        ss->delay.time[i] = delay_time;
-        ss->delay.origin_script[i] = es_variables(es)->script_number;
-        ss->delay.origin_i[i] = es_variables(es)->i;
-        copy_command(&ss->delay.commands[i], post_command);
-
-        return true;
-    }
-
-    return false;
+                             const tele_command_view_t *post_command) {
+    return ss_delay_schedule(ss, delay_time, es_variables(es)->script_number,
+                             es_variables(es)->i, post_command) >= 0;
 }
 
 static void mod_DEL_func(scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs,
-                         const tele_command_t *post_command) {
+                         const tele_command_view_t *post_command) {
     int16_t delay_time = cs_pop(cs);
 
     delay_common_add(ss, es, delay_time, post_command);
@@ -79,9 +70,28 @@ static void op_DEL_CLR_get(const void *NOTUSED(data), scene_state_t *ss,
     clear_delays(ss);
 }
 
+// scripts are numbered like SCRIPT does, 1 - 10 with 0 for the live prompt,
+// anything else maps past NO_SCRIPT and matches no delays
+static uint8_t delay_script(int16_t script) {
+    if (script == 0) return LIVE_SCRIPT;
+    if (script < 1 || script > EDITABLE_SCRIPT_COUNT) return NO_SCRIPT + 1;
+    return script - 1;
+}
+
+static void op_DEL_KILL_get(const void *NOTUSED(data), scene_state_t *ss,
+                            exec_state_t *NOTUSED(es), command_state_t *cs) {
+    ss_delay_cancel_script(ss, delay_script(cs_pop(cs)));
+    tele_has_delays(ss->delay.count > 0);
+}
+
+static void op_DEL_N_get(const void *NOTUSED(data), scene_state_t *ss,
+                         exec_state_t *NOTUSED(es), command_state_t *cs) {
+    cs_push(cs, ss_delay_script_count(ss, delay_script(cs_pop(cs))));
+}
+
 static void mod_DEL_X_func(scene_state_t *ss, exec_state_t *es,
                            command_state_t *cs,
-                           const tele_command_t *post_command) {
+                           const tele_command_view_t *post_command) {
     int16_t num_delays = cs_pop(cs);
     int16_t delay_time = cs_pop(cs);
     int16_t delay_time_next;
@@ -106,7 +116,7 @@ static void mod_DEL_X_func(scene_state_t *ss, exec_state_t *es,
 
 static void mod_DEL_R_func(scene_state_t *ss, exec_state_t *es,
                            command_state_t *cs,
-                           const tele_command_t *post_command) {
+                           const tele_command_view_t *post_command) {
     int16_t num_delays = cs_pop(cs);
     int16_t delay_time = cs_pop(cs);
     int16_t delay_time_next;
@@ -131,7 +141,7 @@ static void mod_DEL_R_func(scene_state_t *ss, exec_state_t *es,
 
 static void mod_DEL_G_func(scene_state_t *ss, exec_state_t *es,
                            command_state_t *cs,
-                           const tele_command_t *post_command) {
+                           const tele_command_view_t *post_command) {
     int16_t num_delays = cs_pop(cs);
     int16_t delay_time = cs_pop(cs);
     int16_t delay_mult_num = cs_pop(cs);
@@ -159,7 +169,7 @@ static void mod_DEL_G_func(scene_state_t *ss, exec_state_t *es,
 
 static void mod_DEL_B_func(scene_state_t *ss, exec_state_t *es,
                            command_state_t *cs,
-                           const tele_command_t *post_command) {
+                           const tele_command_view_t *post_command) {
     int16_t base_time = cs_pop(cs);
     if (base_time < 1) base_time = 1;
     int16_t mask = cs_pop(cs);
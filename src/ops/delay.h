@@ -5,6 +5,8 @@
 
 extern const tele_mod_t mod_DEL;
 extern const tele_op_t op_DEL_CLR;
+extern const tele_op_t op_DEL_KILL;
+extern const tele_op_t op_DEL_N;
 extern const tele_mod_t mod_DEL_X;
 extern const tele_mod_t mod_DEL_R;
 extern const tele_mod_t mod_DEL_G;
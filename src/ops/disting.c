@@ -2,21 +2,22 @@
 
 #include "helpers.h"
 #include "ii.h"
+#include "ii_queue.h"
 #include "teletype.h"
 #include "teletype_io.h"
 
 static void mod_EX1_func(scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs,
-                         const tele_command_t *post_command);
+                         const tele_command_view_t *post_command);
 static void mod_EX2_func(scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs,
-                         const tele_command_t *post_command);
+                         const tele_command_view_t *post_command);
 static void mod_EX3_func(scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs,
-                         const tele_command_t *post_command);
+                         const tele_command_view_t *post_command);
 static void mod_EX4_func(scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs,
-                         const tele_command_t *post_command);
+                         const tele_command_view_t *post_command);
 static void op_EX_get(const void *data, scene_state_t *ss, exec_state_t *es,
                       command_state_t *cs);
 static void op_EX_set(const void *data, scene_state_t *ss, exec_state_t *es,
@@ -291,20 +292,20 @@ static u8 data[4];
 
 static inline void send1(u8 cmd) {
     data[0] = cmd;
-    tele_ii_tx(DISTING_EX_1 + unit, data, 1);
+    ii_tx(DISTING_EX_1 + unit, data, 1);
 }
 
 static inline void send2(u8 cmd, u8 b1) {
     data[0] = cmd;
     data[1] = b1;
-    tele_ii_tx(DISTING_EX_1 + unit, data, 2);
+    ii_tx(DISTING_EX_1 + unit, data, 2);
 }
 
 static inline void send3(u8 cmd, u8 b1, u8 b2) {
     data[0] = cmd;
     data[1] = b1;
     data[2] = b2;
-    tele_ii_tx(DISTING_EX_1 + unit, data, 3);
+    ii_tx(DISTING_EX_1 + unit, data, 3);
 }
 
 static inline void send4(u8 cmd, u8 b1, u8 b2, u8 b3) {
@@ -312,42 +313,42 @@ static inline void send4(u8 cmd, u8 b1, u8 b2, u8 b3) {
     data[1] = b1;
     data[2] = b2;
     data[3] = b3;
-    tele_ii_tx(DISTING_EX_1 + unit, data, 4);
+    ii_tx(DISTING_EX_1 + unit, data, 4);
 }
 
 static void mod_EX1_func(scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs,
-                         const tele_command_t *post_command) {
+                         const tele_command_view_t *post_command) {
     u8 u = unit;
     unit = 0;
-    process_command(ss, es, post_command);
+    process_command_view(ss, es, post_command);
     unit = u;
 }
 
 static void mod_EX2_func(scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs,
-                         const tele_command_t *post_command) {
+                         const tele_command_view_t *post_command) {
     u8 u = unit;
     unit = 1;
-    process_command(ss, es, post_command);
+    process_command_view(ss, es, post_command);
     unit = u;
 }
 
 static void mod_EX3_func(scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs,
-                         const tele_command_t *post_command) {
+                         const tele_command_view_t *post_command) {
     u8 u = unit;
     unit = 2;
-    process_command(ss, es, post_command);
+    process_command_view(ss, es, post_command);
     unit = u;
 }
 
 static void mod_EX4_func(scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs,
-                         const tele_command_t *post_command) {
+                         const tele_command_view_t *post_command) {
     u8 u = unit;
     unit = 3;
-    process_command(ss, es, post_command);
+    process_command_view(ss, es, post_command);
     unit = u;
 }
 
@@ -368,7 +369,7 @@ static void op_EX_PRESET_get(const void *NOTUSED(data), scene_state_t *ss,
     send1(0x43);
 
     data[0] = data[1] = 0;
-    tele_ii_rx(DISTING_EX_1 + unit, data, 2);
+    ii_rx(DISTING_EX_1 + unit, data, 2);
 
     cs_push(cs, (data[0] << 8) + data[1]);
 }
@@ -395,7 +396,7 @@ static void op_EX_ALG_get(const void *NOTUSED(data), scene_state_t *ss,
     send1(0x45);
 
     data[0] = 0;
-    tele_ii_rx(DISTING_EX_1 + unit, data, 1);
+    ii_rx(DISTING_EX_1 + unit, data, 1);
     cs_push(cs, data[0]);
 }
 
@@ -418,7 +419,7 @@ static void op_EX_PARAM_get(const void *NOTUSED(data), scene_state_t *ss,
     send2(0x48, param);
 
     data[0] = data[1] = 0;
-    tele_ii_rx(DISTING_EX_1 + unit, data, 2);
+    ii_rx(DISTING_EX_1 + unit, data, 2);
     u16 value = (data[0] << 8) + data[1];
     cs_push(cs, (s16)value);
 }
@@ -443,7 +444,7 @@ static void op_EX_MIN_get(const void *NOTUSED(data), scene_state_t *ss,
     send2(0x49, param);
 
     data[0] = data[1] = 0;
-    tele_ii_rx(DISTING_EX_1 + unit, data, 2);
+    ii_rx(DISTING_EX_1 + unit, data, 2);
     u16 value = (data[0] << 8) + data[1];
     cs_push(cs, (s16)value);
 }
@@ -454,7 +455,7 @@ static void op_EX_MAX_get(const void *NOTUSED(data), scene_state_t *ss,
     send2(0x4A, param);
 
     data[0] = data[1] = 0;
-    tele_ii_rx(DISTING_EX_1 + unit, data, 2);
+    ii_rx(DISTING_EX_1 + unit, data, 2);
     u16 value = (data[0] << 8) + data[1];
     cs_push(cs, (s16)value);
 }
@@ -793,7 +794,7 @@ static void op_EX_LP_CLR_get(const void *NOTUSED(data), scene_state_t *ss,
 static u8 get_looper_state(u8 loop) {
     send2(0x59, loop);
     data[0] = 0;
-    tele_ii_rx(DISTING_EX_1 + unit, data, 1);
+    ii_rx(DISTING_EX_1 + unit, data, 1);
     return data[0];
 }
 
@@ -834,7 +835,7 @@ static void op_EX_A1_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                          exec_state_t *NOTUSED(es), command_state_t *cs) {
     send2(0x5F, 0);
     data[0] = 0;
-    tele_ii_rx(DISTING_EX_1 + unit, data, 1);
+    ii_rx(DISTING_EX_1 + unit, data, 1);
     cs_push(cs, data[0] + 1);
 }
 
@@ -849,7 +850,7 @@ static void op_EX_A2_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                          exec_state_t *NOTUSED(es), command_state_t *cs) {
     send2(0x5F, 1);
     data[0] = 0;
-    tele_ii_rx(DISTING_EX_1 + unit, data, 1);
+    ii_rx(DISTING_EX_1 + unit, data, 1);
     cs_push(cs, data[0] + 1);
 }
 
@@ -874,7 +875,7 @@ static void op_EX_P1_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     send2(0x5A, param);
 
     data[0] = 0;
-    tele_ii_rx(DISTING_EX_1 + unit, data, 1);
+    ii_rx(DISTING_EX_1 + unit, data, 1);
     cs_push(cs, (s8)data[0]);
 }
 
@@ -891,7 +892,7 @@ static void op_EX_P2_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     send2(0x5A, param | 0b10000);
 
     data[0] = 0;
-    tele_ii_rx(DISTING_EX_1 + unit, data, 1);
+    ii_rx(DISTING_EX_1 + unit, data, 1);
     cs_push(cs, (s8)data[0]);
 }
 
@@ -923,7 +924,7 @@ static void op_EX_MIN1_get(const void *NOTUSED(data),
     send2(0x5B, param);
 
     data[0] = 0;
-    tele_ii_rx(DISTING_EX_1 + unit, data, 1);
+    ii_rx(DISTING_EX_1 + unit, data, 1);
     cs_push(cs, (s8)data[0]);
 }
 
@@ -934,7 +935,7 @@ static void op_EX_MIN2_get(const void *NOTUSED(data),
     send2(0x5B, param | 0b10000);
 
     data[0] = 0;
-    tele_ii_rx(DISTING_EX_1 + unit, data, 1);
+    ii_rx(DISTING_EX_1 + unit, data, 1);
     cs_push(cs, (s8)data[0]);
 }
 
@@ -945,7 +946,7 @@ static void op_EX_MAX1_get(const void *NOTUSED(data),
     send2(0x5C, param);
 
     data[0] = 0;
-    tele_ii_rx(DISTING_EX_1 + unit, data, 1);
+    ii_rx(DISTING_EX_1 + unit, data, 1);
     cs_push(cs, (s8)data[0]);
 }
 
@@ -956,7 +957,7 @@ static void op_EX_MAX2_get(const void *NOTUSED(data),
     send2(0x5C, param | 0b10000);
 
     data[0] = 0;
-    tele_ii_rx(DISTING_EX_1 + unit, data, 1);
+    ii_rx(DISTING_EX_1 + unit, data, 1);
     cs_push(cs, (s8)data[0]);
 }
 
@@ -993,7 +994,7 @@ static void op_EX_Z1_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     send1(0x66);
 
     data[0] = data[1] = data[2] = data[3] = 0;
-    tele_ii_rx(DISTING_EX_1 + unit, data, 4);
+    ii_rx(DISTING_EX_1 + unit, data, 4);
     u16 value = (data[0] << 8) + data[1];
     cs_push(cs, value >> 8);
 }
@@ -1010,7 +1011,7 @@ static void op_EX_Z2_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     send1(0x66);
 
     data[0] = data[1] = data[2] = data[3] = 0;
-    tele_ii_rx(DISTING_EX_1 + unit, data, 4);
+    ii_rx(DISTING_EX_1 + unit, data, 4);
     u16 value = (data[2] << 8) + data[3];
     cs_push(cs, (s16)value >> 8);
 }
@@ -2,6 +2,7 @@
 
 #include "helpers.h"
 #include "ii.h"
+#include "ii_queue.h"
 #include "teletype_io.h"
 
 static void op_ES_CV_get(const void *data, scene_state_t *ss, exec_state_t *es,
@@ -24,9 +25,9 @@ static void op_ES_CV_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     a--;
     uint8_t d[] = { ES_CV | II_GET, a & 0x3 };
     uint8_t addr = ES;
-    tele_ii_tx(addr, d, 2);
+    ii_tx(addr, d, 2);
     d[0] = 0;
     d[1] = 0;
-    tele_ii_rx(addr, d, 2);
+    ii_rx(addr, d, 2);
     cs_push(cs, (d[0] << 8) + d[1]);
 }
@@ -154,7 +154,7 @@ const tele_op_t op_G_RST     = MAKE_GET_OP(G.RST, op_G_RST_get, 0, false);
 const tele_op_t op_G_ROTATE  = MAKE_GET_OP(G.ROTATE, op_G_ROTATE_get, 1, false);
 const tele_op_t op_G_DIM     = MAKE_GET_OP(G.DIM, op_G_DIM_get, 1, false);
 const tele_op_t op_G_CLR     = MAKE_GET_OP(G.CLR, op_G_CLR_get, 0, false);
-const tele_op_t op_G_KEY     = MAKE_GET_OP(G.KEY, op_G_KEY_get, 3, false);
+const tele_op_t op_G_KEY     = MAKE_RUN_OP(G.KEY, op_G_KEY_get, NULL, 3, false);
 
 const tele_op_t op_G_GRP     = MAKE_GET_SET_OP(G.GRP, op_G_GRP_get, op_G_GRP_set, 0, true);
 const tele_op_t op_G_GRP_EN  = MAKE_GET_SET_OP(G.GRP.EN, op_G_GRP_EN_get, op_G_GRP_EN_set, 1, true);
@@ -183,7 +183,7 @@ const tele_op_t op_G_BTNL    = MAKE_GET_SET_OP(G.BTNL, op_G_BTNL_get, op_G_BTNL_
 const tele_op_t op_G_BTNX    = MAKE_GET_SET_OP(G.BTNX, op_G_BTNX_get, op_G_BTNX_set, 0, true);
 const tele_op_t op_G_BTNY    = MAKE_GET_SET_OP(G.BTNY, op_G_BTNY_get, op_G_BTNY_set, 0, true);
 const tele_op_t op_G_BTN_SW  = MAKE_GET_OP(G.BTN.SW, op_G_BTN_SW_get, 1, false);
-const tele_op_t op_G_BTN_PR  = MAKE_GET_OP(G.BTN.PR, op_G_BTN_PR_get, 2, false);
+const tele_op_t op_G_BTN_PR  = MAKE_RUN_OP(G.BTN.PR, op_G_BTN_PR_get, NULL, 2, false);
 const tele_op_t op_G_GBTN_V  = MAKE_GET_OP(G.GBTN.V, op_G_GBTN_V_get, 2, false);
 const tele_op_t op_G_GBTN_L  = MAKE_GET_OP(G.GBTN.L, op_G_GBTN_L_get, 3, false);
 const tele_op_t op_G_GBTN_C  = MAKE_GET_OP(G.GBTN.C, op_G_GBTN_C_get, 1, true);
@@ -211,7 +211,7 @@ const tele_op_t op_G_FDRN    = MAKE_GET_SET_OP(G.FDRN, op_G_FDRN_get, op_G_FDRN_
 const tele_op_t op_G_FDRL    = MAKE_GET_SET_OP(G.FDRL, op_G_FDRL_get, op_G_FDRL_set, 0, true);
 const tele_op_t op_G_FDRX    = MAKE_GET_SET_OP(G.FDRX, op_G_FDRX_get, op_G_FDRX_set, 0, true);
 const tele_op_t op_G_FDRY    = MAKE_GET_SET_OP(G.FDRY, op_G_FDRY_get, op_G_FDRY_set, 0, true);
-const tele_op_t op_G_FDR_PR  = MAKE_GET_OP(G.FDR.PR, op_G_FDR_PR_get, 2, false);
+const tele_op_t op_G_FDR_PR  = MAKE_RUN_OP(G.FDR.PR, op_G_FDR_PR_get, NULL, 2, false);
 const tele_op_t op_G_GFDR_V  = MAKE_GET_OP(G.GFDR.V, op_G_GFDR_V_get, 2, false);
 const tele_op_t op_G_GFDR_N  = MAKE_GET_OP(G.GFDR.N, op_G_GFDR_N_get, 2, false);
 const tele_op_t op_G_GFDR_L  = MAKE_GET_OP(G.GFDR.L, op_G_GFDR_L_get, 3, false);
@@ -263,7 +263,7 @@ static void op_G_RST_get(const void *NOTUSED(data), scene_state_t *ss,
         GXY.value_y = 0;
     }
 
-    SG.scr_dirty = SG.grid_dirty = 1;
+    SG.scr_dirty = SG.grid_dirty = SG.index_dirty = 1;
 }
 
 static void op_G_CLR_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -325,7 +325,7 @@ static void op_G_GRP_EN_set(const void *NOTUSED(data), scene_state_t *ss,
     s16 en = cs_pop(cs);
     if (group < (s16)0 || group >= (s16)GRID_GROUP_COUNT) return;
     SG.group[group].enabled = en != 0;
-    SG.scr_dirty = SG.grid_dirty = 1;
+    SG.scr_dirty = SG.grid_dirty = SG.index_dirty = 1;
 }
 
 static void op_G_GRP_RST_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -360,7 +360,7 @@ static void op_G_GRP_RST_get(const void *NOTUSED(data), scene_state_t *ss,
             GXY.value_y = 0;
         }
 
-    SG.scr_dirty = SG.grid_dirty = 1;
+    SG.scr_dirty = SG.grid_dirty = SG.index_dirty = 1;
 }
 
 static void op_G_GRP_SW_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -371,7 +371,7 @@ static void op_G_GRP_SW_get(const void *NOTUSED(data), scene_state_t *ss,
     for (u8 i = 0; i < GRID_GROUP_COUNT; i++) SG.group[i].enabled = false;
     SG.group[group].enabled = true;
 
-    SG.scr_dirty = SG.grid_dirty = 1;
+    SG.scr_dirty = SG.grid_dirty = SG.index_dirty = 1;
 }
 
 static void op_G_GRP_SC_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -568,7 +568,7 @@ static void op_G_BTN_EN_set(const void *NOTUSED(data), scene_state_t *ss,
 
     if (i < (s16)0 || i >= (s16)GRID_BUTTON_COUNT) return;
     GBC.enabled = en;
-    SG.scr_dirty = SG.grid_dirty = 1;
+    SG.scr_dirty = SG.grid_dirty = SG.index_dirty = 1;
 }
 
 static void op_G_BTN_V_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -622,7 +622,7 @@ static void op_G_BTN_X_set(const void *NOTUSED(data), scene_state_t *ss,
     GBC.y = y;
     GBC.w = w;
     GBC.h = h;
-    SG.scr_dirty = SG.grid_dirty = 1;
+    SG.scr_dirty = SG.grid_dirty = SG.index_dirty = 1;
 }
 
 static void op_G_BTN_Y_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -646,7 +646,7 @@ static void op_G_BTN_Y_set(const void *NOTUSED(data), scene_state_t *ss,
     GBC.y = y;
     GBC.w = w;
     GBC.h = h;
-    SG.scr_dirty = SG.grid_dirty = 1;
+    SG.scr_dirty = SG.grid_dirty = SG.index_dirty = 1;
 }
 
 static void op_G_BTNI_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -697,7 +697,7 @@ static void op_G_BTNX_set(const void *NOTUSED(data), scene_state_t *ss,
     GBC.y = y;
     GBC.w = w;
     GBC.h = h;
-    SG.scr_dirty = SG.grid_dirty = 1;
+    SG.scr_dirty = SG.grid_dirty = SG.index_dirty = 1;
 }
 
 static void op_G_BTNY_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -719,7 +719,7 @@ static void op_G_BTNY_set(const void *NOTUSED(data), scene_state_t *ss,
     GBC.y = y;
     GBC.w = w;
     GBC.h = h;
-    SG.scr_dirty = SG.grid_dirty = 1;
+    SG.scr_dirty = SG.grid_dirty = SG.index_dirty = 1;
 }
 
 static void op_G_BTN_SW_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -1047,7 +1047,7 @@ static void op_G_FDR_EN_set(const void *NOTUSED(data), scene_state_t *ss,
 
     if (i < (s16)0 || i >= (s16)GRID_FADER_COUNT) return;
     GFC.enabled = en;
-    SG.scr_dirty = SG.grid_dirty = 1;
+    SG.scr_dirty = SG.grid_dirty = SG.index_dirty = 1;
 }
 
 static void op_G_FDR_V_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -1144,7 +1144,7 @@ static void op_G_FDR_X_set(const void *NOTUSED(data), scene_state_t *ss,
     GFC.y = y;
     GFC.w = w;
     GFC.h = h;
-    SG.scr_dirty = SG.grid_dirty = 1;
+    SG.scr_dirty = SG.grid_dirty = SG.index_dirty = 1;
 }
 
 static void op_G_FDR_Y_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -1168,7 +1168,7 @@ static void op_G_FDR_Y_set(const void *NOTUSED(data), scene_state_t *ss,
     GFC.y = y;
     GFC.w = w;
     GFC.h = h;
-    SG.scr_dirty = SG.grid_dirty = 1;
+    SG.scr_dirty = SG.grid_dirty = SG.index_dirty = 1;
 }
 
 static void op_G_FDRI_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -1258,7 +1258,7 @@ static void op_G_FDRX_set(const void *NOTUSED(data), scene_state_t *ss,
     GFC.y = y;
     GFC.w = w;
     GFC.h = h;
-    SG.scr_dirty = SG.grid_dirty = 1;
+    SG.scr_dirty = SG.grid_dirty = SG.index_dirty = 1;
 }
 
 static void op_G_FDRY_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -1280,7 +1280,7 @@ static void op_G_FDRY_set(const void *NOTUSED(data), scene_state_t *ss,
     GFC.y = y;
     GFC.w = w;
     GFC.h = h;
-    SG.scr_dirty = SG.grid_dirty = 1;
+    SG.scr_dirty = SG.grid_dirty = SG.index_dirty = 1;
 }
 
 static void op_G_FDR_PR_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -1411,7 +1411,7 @@ static void op_G_XYP_get(const void *NOTUSED(data), scene_state_t *ss,
     GXY.value_x = 0;
     GXY.value_y = 0;
 
-    SG.scr_dirty = SG.grid_dirty = 1;
+    SG.scr_dirty = SG.grid_dirty = SG.index_dirty = 1;
 }
 
 static void op_G_XYP_X_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -1513,6 +1513,7 @@ static void grid_init_button(scene_state_t *ss, s16 group, s16 i, s16 x, s16 y,
     GBC.script = script;
     GB.latch = latch != 0;
     if (!GB.latch) GB.state = 0;
+    SG.index_dirty = 1;
 }
 
 static void grid_init_fader(scene_state_t *ss, s16 group, s16 i, s16 x, s16 y,
@@ -1548,6 +1549,7 @@ static void grid_init_fader(scene_state_t *ss, s16 group, s16 i, s16 x, s16 y,
     GFC.level = level;
     GFC.script = script;
     GF.type = type;
+    SG.index_dirty = 1;
 }
 
 static s16 grid_fader_max_value(scene_state_t *ss, u16 i) {
@@ -2,6 +2,8 @@
 
 #include "helpers.h"
 #include "ii.h"
+#include "ii_cache.h"
+#include "ii_queue.h"
 #include "teletype_io.h"
 
 static void op_CV_get(const void *data, scene_state_t *ss, exec_state_t *es,
@@ -130,10 +132,7 @@ static void op_CV_get(const void *NOTUSED(data), scene_state_t *ss,
     else if (a < 20) {
         uint8_t d[] = { II_ANSIBLE_CV | II_GET, a & 0x3 };
         uint8_t addr = II_ANSIBLE_ADDR + (((a - 4) >> 2) << 1);
-        tele_ii_tx(addr, d, 2);
-        d[0] = 0;
-        d[1] = 0;
-        tele_ii_rx(addr, d, 2);
+        ii_read(addr, d, 2, 2);
         cs_push(cs, (d[0] << 8) + d[1]);
     }
     else
@@ -150,13 +149,16 @@ static void op_CV_set(const void *NOTUSED(data), scene_state_t *ss,
         return;
     else if (a < 4) {
         ss->variables.cv[a] = b;
+        // follower writes queued before this go out first, so local and
+        // remote outputs change in the order the script set them
+        ii_flush();
         tele_cv(a, b, 1);
     }
     else if (a < 20) {
         uint8_t d[] = { II_ANSIBLE_CV, a & 0x3, b >> 8, b & 0xff };
         uint8_t addr = II_ANSIBLE_ADDR + (((a - 4) >> 2) << 1);
 
-        tele_ii_tx(addr, d, 4);
+        ii_tx_value(addr, d, 4);
     }
 }
 
@@ -171,10 +173,7 @@ static void op_CV_SLEW_get(const void *NOTUSED(data), scene_state_t *ss,
     else if (a < 20) {
         uint8_t d[] = { II_ANSIBLE_CV_SLEW | II_GET, a & 0x3 };
         uint8_t addr = II_ANSIBLE_ADDR + (((a - 4) >> 2) << 1);
-        tele_ii_tx(addr, d, 2);
-        d[0] = 0;
-        d[1] = 0;
-        tele_ii_rx(addr, d, 2);
+        ii_read(addr, d, 2, 2);
         cs_push(cs, (d[0] << 8) + d[1]);
     }
     else
@@ -191,12 +190,13 @@ static void op_CV_SLEW_set(const void *NOTUSED(data), scene_state_t *ss,
         return;
     else if (a < 4) {
         ss->variables.cv_slew[a] = b;
+        ii_flush();
         tele_cv_slew(a, b);
     }
     else if (a < 20) {
         uint8_t d[] = { II_ANSIBLE_CV_SLEW, a & 0x3, b >> 8, b & 0xff };
         uint8_t addr = II_ANSIBLE_ADDR + (((a - 4) >> 2) << 1);
-        tele_ii_tx(addr, d, 4);
+        ii_tx_value(addr, d, 4);
     }
 }
 
@@ -211,10 +211,7 @@ static void op_CV_OFF_get(const void *NOTUSED(data), scene_state_t *ss,
     else if (a < 20) {
         uint8_t d[] = { II_ANSIBLE_CV_OFF | II_GET, a & 0x3 };
         uint8_t addr = II_ANSIBLE_ADDR + (((a - 4) >> 2) << 1);
-        tele_ii_tx(addr, d, 2);
-        d[0] = 0;
-        d[1] = 0;
-        tele_ii_rx(addr, d, 2);
+        ii_read(addr, d, 2, 2);
         cs_push(cs, (d[0] << 8) + d[1]);
     }
     else
@@ -230,13 +227,14 @@ static void op_CV_OFF_set(const void *NOTUSED(data), scene_state_t *ss,
         return;
     else if (a < 4) {
         ss->variables.cv_off[a] = b;
+        ii_flush();
         tele_cv_off(a, b);
         tele_cv(a, ss->variables.cv[a], 1);
     }
     else if (a < 20) {
         uint8_t d[] = { II_ANSIBLE_CV_OFF, a & 0x3, b >> 8, b & 0xff };
         uint8_t addr = II_ANSIBLE_ADDR + (((a - 4) >> 2) << 1);
-        tele_ii_tx(addr, d, 4);
+        ii_tx_value(addr, d, 4);
     }
 }
 
@@ -316,9 +314,7 @@ static void op_TR_get(const void *NOTUSED(data), scene_state_t *ss,
     else if (a < 20) {
         uint8_t d[] = { II_ANSIBLE_TR | II_GET, a & 0x3 };
         uint8_t addr = II_ANSIBLE_ADDR + (((a - 4) >> 2) << 1);
-        tele_ii_tx(addr, d, 2);
-        d[0] = 0;
-        tele_ii_rx(addr, d, 1);
+        ii_read(addr, d, 2, 1);
         cs_push(cs, d[0]);
     }
     else
@@ -334,12 +330,13 @@ static void op_TR_set(const void *NOTUSED(data), scene_state_t *ss,
         return;
     else if (a < 4) {
         ss->variables.tr[a] = b != 0;
+        ii_flush();
         tele_tr(a, b);
     }
     else if (a < 20) {
         uint8_t d[] = { II_ANSIBLE_TR, a & 0x3, b };
         uint8_t addr = II_ANSIBLE_ADDR + (((a - 4) >> 2) << 1);
-        tele_ii_tx(addr, d, 3);
+        ii_tx(addr, d, 3);
     }
 }
 
@@ -354,9 +351,7 @@ static void op_TR_POL_get(const void *NOTUSED(data), scene_state_t *ss,
     else if (a < 20) {
         uint8_t d[] = { II_ANSIBLE_TR_POL | II_GET, a & 0x3 };
         uint8_t addr = II_ANSIBLE_ADDR + (((a - 4) >> 2) << 1);
-        tele_ii_tx(addr, d, 2);
-        d[0] = 0;
-        tele_ii_rx(addr, d, 1);
+        ii_read(addr, d, 2, 1);
         cs_push(cs, d[0]);
     }
     else
@@ -374,7 +369,7 @@ static void op_TR_POL_set(const void *NOTUSED(data), scene_state_t *ss,
     else if (a < 20) {
         uint8_t d[] = { II_ANSIBLE_TR_POL, a & 0x3, b > 0 };
         uint8_t addr = II_ANSIBLE_ADDR + (((a - 4) >> 2) << 1);
-        tele_ii_tx(addr, d, 3);
+        ii_tx(addr, d, 3);
     }
 }
 
@@ -389,10 +384,7 @@ static void op_TR_TIME_get(const void *NOTUSED(data), scene_state_t *ss,
     else if (a < 20) {
         uint8_t d[] = { II_ANSIBLE_TR_TIME | II_GET, a & 0x3 };
         uint8_t addr = II_ANSIBLE_ADDR + (((a - 4) >> 2) << 1);
-        tele_ii_tx(addr, d, 2);
-        d[0] = 0;
-        d[1] = 0;
-        tele_ii_rx(addr, d, 2);
+        ii_read(addr, d, 2, 2);
         cs_push(cs, (d[0] << 8) + d[1]);
     }
     else
@@ -414,7 +406,7 @@ static void op_TR_TIME_set(const void *NOTUSED(data), scene_state_t *ss,
     else if (a < 20) {
         uint8_t d[] = { II_ANSIBLE_TR_TIME, a & 0x3, b >> 8, b & 0xff };
         uint8_t addr = II_ANSIBLE_ADDR + (((a - 4) >> 2) << 1);
-        tele_ii_tx(addr, d, 4);
+        ii_tx(addr, d, 4);
     }
 }
 
@@ -429,12 +421,13 @@ static void op_TR_TOG_get(const void *NOTUSED(data), scene_state_t *ss,
             ss->variables.tr[a] = 0;
         else
             ss->variables.tr[a] = 1;
+        ii_flush();
         tele_tr(a, ss->variables.tr[a]);
     }
     else if (a < 20) {
         uint8_t d[] = { II_ANSIBLE_TR_TOG, a & 0x3 };
         uint8_t addr = II_ANSIBLE_ADDR + (((a - 4) >> 2) << 1);
-        tele_ii_tx(addr, d, 2);
+        ii_tx(addr, d, 2);
     }
 }
 
@@ -448,13 +441,14 @@ static void op_TR_PULSE_get(const void *NOTUSED(data), scene_state_t *ss,
         int16_t time = ss->variables.tr_time[a];  // pulse time
         if (time <= 0) return;  // if time <= 0 don't do anything
         ss->variables.tr[a] = ss->variables.tr_pol[a];
+        ii_flush();
         tele_tr(a, ss->variables.tr[a]);
         tele_tr_pulse(a, time);
     }
     else if (a < 20) {
         uint8_t d[] = { II_ANSIBLE_TR_PULSE, a & 0x3 };
         uint8_t addr = II_ANSIBLE_ADDR + (((a - 4) >> 2) << 1);
-        tele_ii_tx(addr, d, 2);
+        ii_tx(addr, d, 2);
     }
 }
 
@@ -479,12 +473,13 @@ static void op_CV_SET_get(const void *NOTUSED(data), scene_state_t *ss,
         return;
     else if (a < 4) {
         ss->variables.cv[a] = b;
+        ii_flush();
         tele_cv(a, b, 0);
     }
     else if (a < 20) {
         uint8_t d[] = { II_ANSIBLE_CV_SET, a & 0x3, b >> 8, b & 0xff };
         uint8_t addr = II_ANSIBLE_ADDR + (((a - 4) >> 2) << 1);
-        tele_ii_tx(addr, d, 4);
+        ii_tx(addr, d, 4);
     }
 }
 
@@ -513,9 +508,7 @@ static void op_STATE_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     else if (a < 24) {
         uint8_t d[] = { II_ANSIBLE_INPUT | II_GET, a & 0x3 };
         uint8_t addr = II_ANSIBLE_ADDR + (((a - 8) >> 2) << 1);
-        tele_ii_tx(addr, d, 2);
-        d[0] = 0;
-        tele_ii_rx(addr, d, 1);
+        ii_read(addr, d, 2, 1);
         cs_push(cs, d[0]);
     }
     else
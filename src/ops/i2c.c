@@ -3,6 +3,9 @@
 #include <stdarg.h>
 
 #include "helpers.h"
+#include "ii_cache.h"
+#include "ii_queue.h"
+#include "teletype.h"
 #include "teletype_io.h"
 
 static void op_IIA_get(const void *data, scene_state_t *ss, exec_state_t *es,
@@ -51,6 +54,15 @@ static void op_IIBB2_get(const void *data, scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs);
 static void op_IIBB3_get(const void *data, scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs);
+static void op_II_POLL_get(const void *data, scene_state_t *ss,
+                           exec_state_t *es, command_state_t *cs);
+static void op_II_POLL_set(const void *data, scene_state_t *ss,
+                           exec_state_t *es, command_state_t *cs);
+static void op_II_AGE_get(const void *data, scene_state_t *ss, exec_state_t *es,
+                          command_state_t *cs);
+static void mod_II_SYNC_func(scene_state_t *ss, exec_state_t *es,
+                             command_state_t *cs,
+                             const tele_command_view_t *post_command);
 
 const tele_op_t op_IIA = MAKE_GET_SET_OP(IIA, op_IIA_get, op_IIA_set, 0, true);
 const tele_op_t op_IIS = MAKE_GET_OP(IIS, op_IIS_get, 1, false);
@@ -74,6 +86,11 @@ const tele_op_t op_IIB3 = MAKE_GET_OP(IIB3, op_IIB3_get, 4, true);
 const tele_op_t op_IIBB1 = MAKE_GET_OP(IIBB1, op_IIBB1_get, 2, true);
 const tele_op_t op_IIBB2 = MAKE_GET_OP(IIBB2, op_IIBB2_get, 3, true);
 const tele_op_t op_IIBB3 = MAKE_GET_OP(IIBB3, op_IIBB3_get, 4, true);
+const tele_op_t op_II_POLL =
+    MAKE_GET_SET_OP(II.POLL, op_II_POLL_get, op_II_POLL_set, 0, true);
+const tele_op_t op_II_AGE = MAKE_GET_OP(II.AGE, op_II_AGE_get, 0, true);
+
+const tele_mod_t mod_II_SYNC = MAKE_MOD(II.SYNC, mod_II_SYNC_func, 0);
 
 static void send_words(scene_state_t *ss, command_state_t *cs, uint8_t count) {
     uint8_t length = (count << 1) + 1;
@@ -90,7 +107,7 @@ static void send_words(scene_state_t *ss, command_state_t *cs, uint8_t count) {
     }
 
     if (ss->i2c_op_address == -1) return;
-    tele_ii_tx(ss->i2c_op_address, d, length);
+    ii_tx(ss->i2c_op_address, d, length);
 }
 
 static void send_bytes(scene_state_t *ss, command_state_t *cs, uint8_t count) {
@@ -107,7 +124,7 @@ static void send_bytes(scene_state_t *ss, command_state_t *cs, uint8_t count) {
     }
 
     if (ss->i2c_op_address == -1) return;
-    tele_ii_tx(ss->i2c_op_address, d, length);
+    ii_tx(ss->i2c_op_address, d, length);
 }
 
 static void query_word(scene_state_t *ss, command_state_t *cs) {
@@ -117,7 +134,7 @@ static void query_word(scene_state_t *ss, command_state_t *cs) {
     }
 
     uint8_t buffer[2] = { 0 };
-    tele_ii_rx(ss->i2c_op_address, buffer, 2);
+    ii_rx(ss->i2c_op_address, buffer, 2);
     int16_t value = (buffer[0] << 8) + buffer[1];
     cs_push(cs, value);
 }
@@ -129,7 +146,7 @@ static void query_byte(scene_state_t *ss, command_state_t *cs) {
     }
 
     uint8_t buffer[1] = { 0 };
-    tele_ii_rx(ss->i2c_op_address, buffer, 1);
+    ii_rx(ss->i2c_op_address, buffer, 1);
     int16_t value = buffer[0];
     cs_push(cs, value);
 }
@@ -264,29 +281,55 @@ static void op_IIBB3_get(const void *NOTUSED(data), scene_state_t *ss,
     query_byte(ss, cs);
 }
 
+static void op_II_POLL_get(const void *NOTUSED(data),
+                           scene_state_t *NOTUSED(ss),
+                           exec_state_t *NOTUSED(es), command_state_t *cs) {
+    cs_push(cs, ii_cache_poll());
+}
+
+static void op_II_POLL_set(const void *NOTUSED(data),
+                           scene_state_t *NOTUSED(ss),
+                           exec_state_t *NOTUSED(es), command_state_t *cs) {
+    ii_cache_set_poll(cs_pop(cs));
+}
+
+static void op_II_AGE_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
+                          exec_state_t *NOTUSED(es), command_state_t *cs) {
+    uint16_t age = ii_cache_last_age();
+    cs_push(cs, age > INT16_MAX ? INT16_MAX : age);
+}
+
+static void mod_II_SYNC_func(scene_state_t *ss, exec_state_t *es,
+                             command_state_t *NOTUSED(cs),
+                             const tele_command_view_t *post_command) {
+    ii_cache_sync(true);
+    process_command_view(ss, es, post_command);
+    ii_cache_sync(false);
+}
+
 void i2c_write_0(command_state_t *cs, uint8_t addr, uint8_t cmd) {
     uint8_t d[] = { cmd };
-    tele_ii_tx(addr, d, 1);
+    ii_tx(addr, d, 1);
 }
 
 void i2c_write_8(command_state_t *cs, uint8_t addr, uint8_t cmd) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { cmd, (uint8_t)(a & 0xff) };
-    tele_ii_tx(addr, d, 2);
+    ii_tx(addr, d, 2);
 }
 
 void i2c_write_8_8(command_state_t *cs, uint8_t addr, uint8_t cmd) {
     int16_t a = cs_pop(cs);
     int16_t b = cs_pop(cs);
     uint8_t d[] = { cmd, (uint8_t)(a & 0xff), (uint8_t)(b & 0xff) };
-    tele_ii_tx(addr, d, 3);
+    ii_tx(addr, d, 3);
 }
 
 void i2c_write_8_16(command_state_t *cs, uint8_t addr, uint8_t cmd) {
     int16_t a = cs_pop(cs);
     int16_t b = cs_pop(cs);
     uint8_t d[] = { cmd, (uint8_t)(a & 0xff), b >> 8, b & 0xff };
-    tele_ii_tx(addr, d, 4);
+    ii_tx(addr, d, 4);
 }
 
 void i2c_write_8_16_16(command_state_t *cs, uint8_t addr, uint8_t cmd) {
@@ -296,20 +339,20 @@ void i2c_write_8_16_16(command_state_t *cs, uint8_t addr, uint8_t cmd) {
     uint8_t d[] = {
         cmd, (uint8_t)(a & 0xff), b >> 8, b & 0xff, c >> 8, c & 0xff
     };
-    tele_ii_tx(addr, d, 6);
+    ii_tx(addr, d, 6);
 }
 
 void i2c_write_16(command_state_t *cs, uint8_t addr, uint8_t cmd) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { cmd, a >> 8, a & 0xff };
-    tele_ii_tx(addr, d, 3);
+    ii_tx(addr, d, 3);
 }
 
 void i2c_write_16_16(command_state_t *cs, uint8_t addr, uint8_t cmd) {
     int16_t a = cs_pop(cs);
     int16_t b = cs_pop(cs);
     uint8_t d[] = { cmd, a >> 8, a & 0xff, b >> 8, b & 0xff };
-    tele_ii_tx(addr, d, 5);
+    ii_tx(addr, d, 5);
 }
 
 void i2c_write_32(command_state_t *cs, uint8_t addr, uint8_t cmd) {
@@ -317,13 +360,13 @@ void i2c_write_32(command_state_t *cs, uint8_t addr, uint8_t cmd) {
     uint8_t d[] = { cmd, a >> 8, a & 0xff, 0,
                     0 };  // currently used only for w/s.t which uses to last
                           // bytes to pass subseconds precission
-    tele_ii_tx(addr, d, 5);
+    ii_tx(addr, d, 5);
 }
 
 void i2c_recv_8(command_state_t *cs, uint8_t addr, uint8_t cmd) {
     i2c_write_0(cs, addr, cmd + 0x80);
     uint8_t buffer[1] = { 0 };
-    tele_ii_rx(addr, buffer, 1);
+    ii_rx(addr, buffer, 1);
     int16_t value = buffer[0];
     cs_push(cs, value);
 }
@@ -331,7 +374,7 @@ void i2c_recv_8(command_state_t *cs, uint8_t addr, uint8_t cmd) {
 void i2c_recv_16(command_state_t *cs, uint8_t addr, uint8_t cmd) {
     i2c_write_0(cs, addr, cmd + 0x80);
     uint8_t buffer[2] = { 0 };
-    tele_ii_rx(addr, buffer, 2);
+    ii_rx(addr, buffer, 2);
     int16_t value = (buffer[0] << 8) + buffer[1];
     cs_push(cs, value);
 }
\ No newline at end of file
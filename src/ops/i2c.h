@@ -25,6 +25,10 @@ extern const tele_op_t op_IIB3;
 extern const tele_op_t op_IIBB1;
 extern const tele_op_t op_IIBB2;
 extern const tele_op_t op_IIBB3;
+extern const tele_op_t op_II_POLL;
+extern const tele_op_t op_II_AGE;
+
+extern const tele_mod_t mod_II_SYNC;
 
 extern void i2c_write_0(command_state_t *cs, uint8_t addr, uint8_t cmd);
 extern void i2c_write_8(command_state_t *cs, uint8_t addr, uint8_t cmd);
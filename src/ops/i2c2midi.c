@@ -1,6 +1,7 @@
 #include "ops/i2c2midi.h"
 
 #include "helpers.h"
+#include "ii_queue.h"
 #include "teletype.h"
 #include "teletype_io.h"
 
@@ -255,25 +256,25 @@ static u8 d[7];
 
 #define SEND_CMD(cmd) \
     d[0] = cmd;       \
-    tele_ii_tx(I2C2MIDI, d, 1);
+    ii_tx(I2C2MIDI, d, 1);
 
 #define SEND_B1(cmd, b) \
     d[0] = cmd;         \
     d[1] = b;           \
-    tele_ii_tx(I2C2MIDI, d, 2);
+    ii_tx(I2C2MIDI, d, 2);
 
 #define SEND_B2(cmd, b1, b2) \
     d[0] = cmd;              \
     d[1] = b1;               \
     d[2] = b2;               \
-    tele_ii_tx(I2C2MIDI, d, 3);
+    ii_tx(I2C2MIDI, d, 3);
 
 #define SEND_B3(cmd, b1, b2, b3) \
     d[0] = cmd;                  \
     d[1] = b1;                   \
     d[2] = b2;                   \
     d[3] = b3;                   \
-    tele_ii_tx(I2C2MIDI, d, 4);
+    ii_tx(I2C2MIDI, d, 4);
 
 #define SEND_B4(cmd, b1, b2, b3, b4) \
     d[0] = cmd;                      \
@@ -281,7 +282,7 @@ static u8 d[7];
     d[2] = b2;                       \
     d[3] = b3;                       \
     d[4] = b4;                       \
-    tele_ii_tx(I2C2MIDI, d, 5);
+    ii_tx(I2C2MIDI, d, 5);
 
 #define SEND_B5(cmd, b1, b2, b3, b4, b5) \
     d[0] = cmd;                          \
@@ -290,7 +291,7 @@ static u8 d[7];
     d[3] = b3;                           \
     d[4] = b4;                           \
     d[5] = b5;                           \
-    tele_ii_tx(I2C2MIDI, d, 6);
+    ii_tx(I2C2MIDI, d, 6);
 
 #define SEND_B6(cmd, b1, b2, b3, b4, b5, b6) \
     d[0] = cmd;                              \
@@ -300,21 +301,21 @@ static u8 d[7];
     d[4] = b4;                               \
     d[5] = b5;                               \
     d[6] = b6;                               \
-    tele_ii_tx(I2C2MIDI, d, 7);
+    ii_tx(I2C2MIDI, d, 7);
 
-#define RECEIVE_AND_PUSH_S8     \
-    d[0] = 0;                   \
-    tele_ii_rx(I2C2MIDI, d, 1); \
+#define RECEIVE_AND_PUSH_S8 \
+    d[0] = 0;               \
+    ii_rx(I2C2MIDI, d, 1);  \
     cs_push(cs, (s8)d[0]);
 
-#define RECEIVE_AND_PUSH_S16    \
-    d[0] = d[1] = 0;            \
-    tele_ii_rx(I2C2MIDI, d, 2); \
+#define RECEIVE_AND_PUSH_S16 \
+    d[0] = d[1] = 0;         \
+    ii_rx(I2C2MIDI, d, 2);   \
     cs_push(cs, (d[0] << 8) + d[1]);
 
-#define RECEIVE_AND_PUSH_S16_7  \
-    d[0] = d[1] = 0;            \
-    tele_ii_rx(I2C2MIDI, d, 2); \
+#define RECEIVE_AND_PUSH_S16_7 \
+    d[0] = d[1] = 0;           \
+    ii_rx(I2C2MIDI, d, 2);     \
     cs_push(cs, (d[0] << 7) + d[1]);
 
 #define RETURN_IF_OUT_OF_RANGE(value, min, max) \
@@ -764,7 +765,7 @@ static void op_I2M_C_QN_get(const void *data, scene_state_t *ss,
 
     SEND_B3(166, chord, note, index);
     d[0] = d[1] = 0;
-    tele_ii_rx(I2C2MIDI, d, 2);
+    ii_rx(I2C2MIDI, d, 2);
     s16 qn = (d[0] << 8) | d[1];
     cs_push(cs, qn);
 }
@@ -781,7 +782,7 @@ static void op_I2M_C_QV_get(const void *data, scene_state_t *ss,
 
     SEND_B3(167, chord, velocity, index);
     d[0] = d[1] = 0;
-    tele_ii_rx(I2C2MIDI, d, 2);
+    ii_rx(I2C2MIDI, d, 2);
     s16 qv = (d[0] << 8) | d[1];
     cs_push(cs, qv);
 }
@@ -835,7 +836,7 @@ static void op_I2M_CC_OFF_get(const void *data, scene_state_t *ss,
     else {
         SEND_B2(41, midi_channel, controller);
         d[0] = d[1] = 0;
-        tele_ii_rx(I2C2MIDI, d, 2);
+        ii_rx(I2C2MIDI, d, 2);
         s16 offset = (d[0] << 8) | d[1];
         offset = (offset << 1) / 129;
         offset = (offset >> 1) + (offset & 1);
@@ -864,7 +865,7 @@ static void op_I2M_CC_OFF_POUND_get(const void *data, scene_state_t *ss,
     else {
         SEND_B2(41, channel - 1, controller);
         d[0] = d[1] = 0;
-        tele_ii_rx(I2C2MIDI, d, 2);
+        ii_rx(I2C2MIDI, d, 2);
         s16 offset = (d[0] << 8) | d[1];
         offset = (offset << 1) / 129;
         offset = (offset >> 1) + (offset & 1);
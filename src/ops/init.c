@@ -3,6 +3,8 @@
 #include <string.h>  // memset()
 
 #include "helpers.h"
+#include "ii_cache.h"
+#include "ii_queue.h"
 #include "ops/op.h"
 #include "teletype.h"
 #include "teletype_io.h"
@@ -32,13 +34,13 @@ static void op_INIT_DATA_get(const void *data, scene_state_t *ss,
 static void op_INIT_TIME_get(const void *data, scene_state_t *ss,
                              exec_state_t *es, command_state_t *cs);
 
-const tele_op_t op_INIT = MAKE_GET_OP(INIT, op_INIT_get, 0, false);
+const tele_op_t op_INIT = MAKE_LOAD_OP(INIT, op_INIT_get, NULL, 0, false);
 const tele_op_t op_INIT_SCENE =
-    MAKE_GET_OP(INIT.SCENE, op_INIT_SCENE_get, 0, false);
+    MAKE_LOAD_OP(INIT.SCENE, op_INIT_SCENE_get, NULL, 0, false);
 const tele_op_t op_INIT_SCRIPT =
-    MAKE_GET_OP(INIT.SCRIPT, op_INIT_SCRIPT_get, 1, false);
+    MAKE_LOAD_OP(INIT.SCRIPT, op_INIT_SCRIPT_get, NULL, 1, false);
 const tele_op_t op_INIT_SCRIPT_ALL =
-    MAKE_GET_OP(INIT.SCRIPT.ALL, op_INIT_SCRIPT_ALL_get, 0, false);
+    MAKE_LOAD_OP(INIT.SCRIPT.ALL, op_INIT_SCRIPT_ALL_get, NULL, 0, false);
 const tele_op_t op_INIT_P = MAKE_GET_OP(INIT.P, op_INIT_P_get, 1, false);
 const tele_op_t op_INIT_P_ALL =
     MAKE_GET_OP(INIT.P.ALL, op_INIT_P_ALL_get, 0, false);
@@ -59,10 +61,19 @@ static void op_INIT_get(const void *NOTUSED(data), scene_state_t *ss,
                         exec_state_t *NOTUSED(es),
                         command_state_t *NOTUSED(cs)) {
     // Because we can't see the flash from this context, we cache calibration
+    // and save any change that's still waiting, ss_init forgets about it
+    ss_cal_commit(ss);
     cal_data_t caldata = ss->cal;
+    // keep the delay epoch counting up, a delayed INIT stops the rest of the
+    // tick's delays by it
+    uint8_t epoch = ss->delay.epoch;
     // At boot, all data is zeroed
     memset(ss, 0, sizeof(scene_state_t));
+    ss->delay.epoch = epoch;
     ss_init(ss);
+    // only the live scene is INITed, a scene used to save or load doesn't
+    // touch the followers cached for it
+    ii_cache_clear();
 
     ss->cal = caldata;
     // Once calibration data is loaded, the scales need to be reset
@@ -77,9 +88,13 @@ static void op_INIT_get(const void *NOTUSED(data), scene_state_t *ss,
 static void op_INIT_SCENE_get(const void *NOTUSED(data), scene_state_t *ss,
                               exec_state_t *NOTUSED(es),
                               command_state_t *NOTUSED(cs)) {
+    ss_cal_commit(ss);
     cal_data_t caldata = ss->cal;
+    uint8_t epoch = ss->delay.epoch;
     memset(ss, 0, sizeof(scene_state_t));
+    ss->delay.epoch = epoch;
     ss_init(ss);
+    ii_cache_clear();
     ss->cal = caldata;
     ss_update_param_scale(ss);
     ss_update_in_scale(ss);
@@ -123,6 +138,7 @@ static void op_INIT_CV_get(const void *NOTUSED(data), scene_state_t *ss,
         ss->variables.cv[v] = 0;
         ss->variables.cv_off[v] = 0;
         ss->variables.cv_slew[v] = 1;
+        ii_flush();
         tele_cv(v, 0, 1);
     }
 }
@@ -130,6 +146,7 @@ static void op_INIT_CV_get(const void *NOTUSED(data), scene_state_t *ss,
 static void op_INIT_CV_ALL_get(const void *NOTUSED(data), scene_state_t *ss,
                                exec_state_t *NOTUSED(es),
                                command_state_t *NOTUSED(cs)) {
+    ii_flush();
     for (size_t i = 0; i < TR_COUNT; i++) {
         ss->variables.cv[i] = 0;
         ss->variables.cv_off[i] = 0;
@@ -145,6 +162,7 @@ static void op_INIT_TR_get(const void *NOTUSED(data), scene_state_t *ss,
         ss->variables.tr[v] = 0;
         ss->variables.tr_pol[v] = 1;
         ss->variables.tr_time[v] = 100;
+        ii_flush();
         tele_tr_pulse_clear(v);
         tele_tr(v, 0);
     }
@@ -153,6 +171,7 @@ static void op_INIT_TR_get(const void *NOTUSED(data), scene_state_t *ss,
 static void op_INIT_TR_ALL_get(const void *NOTUSED(data), scene_state_t *ss,
                                exec_state_t *NOTUSED(es),
                                command_state_t *NOTUSED(cs)) {
+    ii_flush();
     for (size_t i = 0; i < TR_COUNT; i++) {
         ss->variables.tr[i] = 0;
         ss->variables.tr_pol[i] = 1;
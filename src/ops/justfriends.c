@@ -2,18 +2,19 @@
 
 #include "helpers.h"
 #include "ii.h"
+#include "ii_queue.h"
 #include "teletype.h"
 #include "teletype_io.h"
 
 static void mod_JF0_func(scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs,
-                         const tele_command_t *post_command);
+                         const tele_command_view_t *post_command);
 static void mod_JF1_func(scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs,
-                         const tele_command_t *post_command);
+                         const tele_command_view_t *post_command);
 static void mod_JF2_func(scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs,
-                         const tele_command_t *post_command);
+                         const tele_command_view_t *post_command);
 static void op_JF_TR_get(const void *data, scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs);
 static void op_JF_RMODE_get(const void *data, scene_state_t *ss,
@@ -98,29 +99,29 @@ static u8 note_count = 1;
 
 static void mod_JF0_func(scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs,
-                         const tele_command_t *post_command) {
+                         const tele_command_view_t *post_command) {
     u8 u = unit;
-    process_command(ss, es, post_command);
+    process_command_view(ss, es, post_command);
     unit = (u == JF_ADDR) ? JF_ADDR_2 : JF_ADDR;
-    process_command(ss, es, post_command);
+    process_command_view(ss, es, post_command);
     unit = u;
 }
 
 static void mod_JF1_func(scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs,
-                         const tele_command_t *post_command) {
+                         const tele_command_view_t *post_command) {
     u8 u = unit;
     unit = JF_ADDR;
-    process_command(ss, es, post_command);
+    process_command_view(ss, es, post_command);
     unit = u;
 }
 
 static void mod_JF2_func(scene_state_t *ss, exec_state_t *es,
                          command_state_t *cs,
-                         const tele_command_t *post_command) {
+                         const tele_command_view_t *post_command) {
     u8 u = unit;
     unit = JF_ADDR_2;
-    process_command(ss, es, post_command);
+    process_command_view(ss, es, post_command);
     unit = u;
 }
 
@@ -136,18 +137,18 @@ static void op_JF_TR_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     int16_t b = cs_pop(cs);
     if (a == -1) {
         uint8_t d[] = { JF_TR, 0, b };
-        tele_ii_tx(JF_ADDR, d, 3);
-        tele_ii_tx(JF_ADDR_2, d, 3);
+        ii_tx(JF_ADDR, d, 3);
+        ii_tx(JF_ADDR_2, d, 3);
     }
     else if (a >= 7) {
         a = a - 6;
         uint8_t d[] = { JF_TR, a, b };
-        if (unit == JF_ADDR) { tele_ii_tx(JF_ADDR_2, d, 3); }
-        else { tele_ii_tx(JF_ADDR, d, 3); }
+        if (unit == JF_ADDR) { ii_tx(JF_ADDR_2, d, 3); }
+        else { ii_tx(JF_ADDR, d, 3); }
     }
     else {
         uint8_t d[] = { JF_TR, a, b };
-        tele_ii_tx(unit, d, 3);
+        ii_tx(unit, d, 3);
     }
 }
 
@@ -156,14 +157,14 @@ static void op_JF_RMODE_get(const void *NOTUSED(data),
                             exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { JF_RMODE, a };
-    tele_ii_tx(unit, d, 2);
+    ii_tx(unit, d, 2);
 }
 
 static void op_JF_RUN_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                           exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { JF_RUN, a >> 8, a & 0xff };
-    tele_ii_tx(unit, d, 3);
+    ii_tx(unit, d, 3);
 }
 
 static void op_JF_SHIFT_get(const void *NOTUSED(data),
@@ -171,7 +172,7 @@ static void op_JF_SHIFT_get(const void *NOTUSED(data),
                             exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { JF_SHIFT, a >> 8, a & 0xff };
-    tele_ii_tx(unit, d, 3);
+    ii_tx(unit, d, 3);
 }
 
 static void op_JF_VTR_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
@@ -180,18 +181,18 @@ static void op_JF_VTR_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     int16_t b = cs_pop(cs);
     if (a == -1) {
         uint8_t d[] = { JF_VTR, 0, b >> 8, b & 0xff };
-        tele_ii_tx(JF_ADDR, d, 4);
-        tele_ii_tx(JF_ADDR_2, d, 4);
+        ii_tx(JF_ADDR, d, 4);
+        ii_tx(JF_ADDR_2, d, 4);
     }
     else if (a >= 7) {
         a = a - 6;
         uint8_t d[] = { JF_VTR, a, b >> 8, b & 0xff };
-        if (unit == JF_ADDR) { tele_ii_tx(JF_ADDR_2, d, 4); }
-        else { tele_ii_tx(JF_ADDR, d, 4); }
+        if (unit == JF_ADDR) { ii_tx(JF_ADDR_2, d, 4); }
+        else { ii_tx(JF_ADDR, d, 4); }
     }
     else {
         uint8_t d[] = { JF_VTR, a, b >> 8, b & 0xff };
-        tele_ii_tx(unit, d, 4);
+        ii_tx(unit, d, 4);
     }
 }
 
@@ -200,7 +201,7 @@ static void op_JF_MODE_get(const void *NOTUSED(data),
                            exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { JF_MODE, a };
-    tele_ii_tx(unit, d, 2);
+    ii_tx(unit, d, 2);
 }
 
 static void op_JF_TICK_get(const void *NOTUSED(data),
@@ -208,7 +209,7 @@ static void op_JF_TICK_get(const void *NOTUSED(data),
                            exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { JF_TICK, a };
-    tele_ii_tx(unit, d, 2);
+    ii_tx(unit, d, 2);
 }
 
 static void op_JF_VOX_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
@@ -218,18 +219,18 @@ static void op_JF_VOX_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
     int16_t c = cs_pop(cs);
     if (a == -1) {
         uint8_t d[] = { JF_VOX, 0, b >> 8, b & 0xff, c >> 8, c & 0xff };
-        tele_ii_tx(JF_ADDR, d, 6);
-        tele_ii_tx(JF_ADDR_2, d, 6);
+        ii_tx(JF_ADDR, d, 6);
+        ii_tx(JF_ADDR_2, d, 6);
     }
     else if (a >= 7) {
         a = a - 6;
         uint8_t d[] = { JF_VOX, a, b >> 8, b & 0xff, c >> 8, c & 0xff };
-        if (unit == JF_ADDR) { tele_ii_tx(JF_ADDR_2, d, 6); }
-        else { tele_ii_tx(JF_ADDR, d, 6); }
+        if (unit == JF_ADDR) { ii_tx(JF_ADDR_2, d, 6); }
+        else { ii_tx(JF_ADDR, d, 6); }
     }
     else {
         uint8_t d[] = { JF_VOX, a, b >> 8, b & 0xff, c >> 8, c & 0xff };
-        tele_ii_tx(unit, d, 6);
+        ii_tx(unit, d, 6);
     }
 }
 
@@ -239,7 +240,7 @@ static void op_JF_NOTE_get(const void *NOTUSED(data),
     int16_t a = cs_pop(cs);
     int16_t b = cs_pop(cs);
     uint8_t d[] = { JF_NOTE, a >> 8, a & 0xff, b >> 8, b & 0xff };
-    tele_ii_tx(unit, d, 5);
+    ii_tx(unit, d, 5);
 }
 
 static void op_JF_POLY_get(const void *NOTUSED(data),
@@ -249,12 +250,12 @@ static void op_JF_POLY_get(const void *NOTUSED(data),
     int16_t b = cs_pop(cs);
     uint8_t d[] = { JF_NOTE, a >> 8, a & 0xff, b >> 8, b & 0xff };
     if (note_count < 7) {
-        tele_ii_tx(unit, d, 5);
+        ii_tx(unit, d, 5);
         note_count++;
     }
     else {
-        if (unit == JF_ADDR) { tele_ii_tx(JF_ADDR_2, d, 5); }
-        else { tele_ii_tx(JF_ADDR, d, 5); }
+        if (unit == JF_ADDR) { ii_tx(JF_ADDR_2, d, 5); }
+        else { ii_tx(JF_ADDR, d, 5); }
         note_count++;
         if (note_count > 12) { note_count = 1; }
     }
@@ -271,7 +272,7 @@ static void op_JF_GOD_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                           exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { JF_GOD, a };
-    tele_ii_tx(unit, d, 2);
+    ii_tx(unit, d, 2);
 }
 
 static void op_JF_TUNE_get(const void *NOTUSED(data),
@@ -282,18 +283,18 @@ static void op_JF_TUNE_get(const void *NOTUSED(data),
     int16_t c = cs_pop(cs);
     if (a == -1) {
         uint8_t d[] = { JF_TUNE, 0, b, c };
-        tele_ii_tx(JF_ADDR, d, 4);
-        tele_ii_tx(JF_ADDR_2, d, 4);
+        ii_tx(JF_ADDR, d, 4);
+        ii_tx(JF_ADDR_2, d, 4);
     }
     else if (a >= 7) {
         a = a - 6;
         uint8_t d[] = { JF_TUNE, a, b, c };
-        if (unit == JF_ADDR) { tele_ii_tx(JF_ADDR_2, d, 4); }
-        else { tele_ii_tx(JF_ADDR, d, 4); }
+        if (unit == JF_ADDR) { ii_tx(JF_ADDR_2, d, 4); }
+        else { ii_tx(JF_ADDR, d, 4); }
     }
     else {
         uint8_t d[] = { JF_TUNE, a, b, c };
-        tele_ii_tx(unit, d, 4);
+        ii_tx(unit, d, 4);
     }
 }
 
@@ -301,7 +302,7 @@ static void op_JF_QT_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                          exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { JF_QT, a };
-    tele_ii_tx(unit, d, 2);
+    ii_tx(unit, d, 2);
 }
 
 static void op_JF_ADDR_get(const void *NOTUSED(data),
@@ -309,7 +310,7 @@ static void op_JF_ADDR_get(const void *NOTUSED(data),
                            exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t a = cs_pop(cs);
     uint8_t d[] = { JF_ADDRESS, a };
-    tele_ii_tx(unit, d, 2);
+    ii_tx(unit, d, 2);
 }
 
 static void op_JF_PITCH_get(const void *NOTUSED(data),
@@ -319,18 +320,18 @@ static void op_JF_PITCH_get(const void *NOTUSED(data),
     int16_t b = cs_pop(cs);
     if (a == -1) {
         uint8_t d[] = { JF_PITCH, 0, b >> 8, b & 0xff };
-        tele_ii_tx(JF_ADDR, d, 4);
-        tele_ii_tx(JF_ADDR_2, d, 4);
+        ii_tx(JF_ADDR, d, 4);
+        ii_tx(JF_ADDR_2, d, 4);
     }
     else if (a >= 7) {
         a = a - 6;
         uint8_t d[] = { JF_PITCH, a, b >> 8, b & 0xff };
-        if (unit == JF_ADDR) { tele_ii_tx(JF_ADDR_2, d, 6); }
-        else { tele_ii_tx(JF_ADDR, d, 6); }
+        if (unit == JF_ADDR) { ii_tx(JF_ADDR_2, d, 6); }
+        else { ii_tx(JF_ADDR, d, 6); }
     }
     else {
         uint8_t d[] = { JF_PITCH, a, b >> 8, b & 0xff };
-        tele_ii_tx(unit, d, 6);
+        ii_tx(unit, d, 6);
     }
 }
 
@@ -338,66 +339,66 @@ static void op_JF_SPEED_get(const void *NOTUSED(data),
                             scene_state_t *NOTUSED(ss),
                             exec_state_t *NOTUSED(es), command_state_t *cs) {
     uint8_t d[] = { JF_SPEED | II_GET };
-    tele_ii_tx(unit, d, 1);
+    ii_tx(unit, d, 1);
     d[0] = 0;
-    tele_ii_rx(unit, d, 1);
+    ii_rx(unit, d, 1);
     cs_push(cs, d[0]);
 }
 
 static void op_JF_TSC_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                           exec_state_t *NOTUSED(es), command_state_t *cs) {
     uint8_t d[] = { JF_TSC | II_GET };
-    tele_ii_tx(unit, d, 1);
+    ii_tx(unit, d, 1);
     d[0] = 0;
-    tele_ii_rx(unit, d, 1);
+    ii_rx(unit, d, 1);
     cs_push(cs, d[0]);
 }
 
 static void op_JF_RAMP_get(const void *NOTUSED(data),
                            scene_state_t *NOTUSED(ss),
                            exec_state_t *NOTUSED(es), command_state_t *cs) {
-    uint8_t d[] = { JF_RAMP | II_GET };
-    tele_ii_tx(unit, d, 1);
+    uint8_t d[] = { JF_RAMP | II_GET, 0 };
+    ii_tx(unit, d, 1);
     d[0] = 0;
-    tele_ii_rx(unit, d, 2);
+    ii_rx(unit, d, 2);
     cs_push(cs, (d[0] << 8) + d[1]);
 }
 
 static void op_JF_CURVE_get(const void *NOTUSED(data),
                             scene_state_t *NOTUSED(ss),
                             exec_state_t *NOTUSED(es), command_state_t *cs) {
-    uint8_t d[] = { JF_CURVE | II_GET };
-    tele_ii_tx(unit, d, 1);
+    uint8_t d[] = { JF_CURVE | II_GET, 0 };
+    ii_tx(unit, d, 1);
     d[0] = 0;
-    tele_ii_rx(unit, d, 2);
+    ii_rx(unit, d, 2);
     cs_push(cs, (d[0] << 8) + d[1]);
 }
 
 static void op_JF_FM_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                          exec_state_t *NOTUSED(es), command_state_t *cs) {
-    uint8_t d[] = { JF_FM | II_GET };
-    tele_ii_tx(unit, d, 1);
+    uint8_t d[] = { JF_FM | II_GET, 0 };
+    ii_tx(unit, d, 1);
     d[0] = 0;
-    tele_ii_rx(unit, d, 2);
+    ii_rx(unit, d, 2);
     cs_push(cs, (d[0] << 8) + d[1]);
 }
 
 static void op_JF_TIME_get(const void *NOTUSED(data),
                            scene_state_t *NOTUSED(ss),
                            exec_state_t *NOTUSED(es), command_state_t *cs) {
-    uint8_t d[] = { JF_TIME | II_GET };
-    tele_ii_tx(unit, d, 1);
+    uint8_t d[] = { JF_TIME | II_GET, 0 };
+    ii_tx(unit, d, 1);
     d[0] = 0;
-    tele_ii_rx(unit, d, 2);
+    ii_rx(unit, d, 2);
     cs_push(cs, (d[0] << 8) + d[1]);
 }
 
 static void op_JF_INTONE_get(const void *NOTUSED(data),
                              scene_state_t *NOTUSED(ss),
                              exec_state_t *NOTUSED(es), command_state_t *cs) {
-    uint8_t d[] = { JF_INTONE | II_GET };
-    tele_ii_tx(unit, d, 1);
+    uint8_t d[] = { JF_INTONE | II_GET, 0 };
+    ii_tx(unit, d, 1);
     d[0] = 0;
-    tele_ii_rx(unit, d, 2);
+    ii_rx(unit, d, 2);
     cs_push(cs, (d[0] << 8) + d[1]);
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "drum_helpers.h"
 #include "euclidean/euclidean.h"
 #include "helpers.h"
+#include "quantize.h"
 #include "random.h"
 #include "table.h"
 
@@ -183,11 +184,11 @@ static void op_TIF_get(const void *data, scene_state_t *ss, exec_state_t *es,
                        command_state_t *cs);
 
 // clang-format off
-const tele_op_t op_ADD   = MAKE_GET_OP(ADD     , op_ADD_get     , 2, true);
-const tele_op_t op_SUB   = MAKE_GET_OP(SUB     , op_SUB_get     , 2, true);
-const tele_op_t op_MUL   = MAKE_GET_OP(MUL     , op_MUL_get     , 2, true);
-const tele_op_t op_DIV   = MAKE_GET_OP(DIV     , op_DIV_get     , 2, true);
-const tele_op_t op_MOD   = MAKE_GET_OP(MOD     , op_MOD_get     , 2, true);
+const tele_op_t op_ADD   = MAKE_PURE_OP(ADD     , op_ADD_get     , 2, true);
+const tele_op_t op_SUB   = MAKE_PURE_OP(SUB     , op_SUB_get     , 2, true);
+const tele_op_t op_MUL   = MAKE_PURE_OP(MUL     , op_MUL_get     , 2, true);
+const tele_op_t op_DIV   = MAKE_PURE_OP(DIV     , op_DIV_get     , 2, true);
+const tele_op_t op_MOD   = MAKE_PURE_OP(MOD     , op_MOD_get     , 2, true);
 const tele_op_t op_RAND  = MAKE_GET_OP(RAND    , op_RAND_get    , 1, true);
 const tele_op_t op_RND   = MAKE_GET_OP(RND     , op_RAND_get    , 1, true);
 const tele_op_t op_RRAND = MAKE_GET_OP(RRAND   , op_RRAND_get   , 2, true);
@@ -196,105 +197,105 @@ const tele_op_t op_R = MAKE_GET_SET_OP(R, op_R_get, op_R_set, 0, true);
 const tele_op_t op_R_MIN = MAKE_GET_SET_OP(R.MIN, op_R_MIN_get, op_R_MIN_set, 0, true);
 const tele_op_t op_R_MAX = MAKE_GET_SET_OP(R.MAX, op_R_MAX_get, op_R_MAX_set, 0, true);
 const tele_op_t op_TOSS  = MAKE_GET_OP(TOSS    , op_TOSS_get    , 0, true);
-const tele_op_t op_MIN   = MAKE_GET_OP(MIN     , op_MIN_get     , 2, true);
-const tele_op_t op_MAX   = MAKE_GET_OP(MAX     , op_MAX_get     , 2, true);
-const tele_op_t op_LIM   = MAKE_GET_OP(LIM     , op_LIM_get     , 3, true);
-const tele_op_t op_WRAP  = MAKE_GET_OP(WRAP    , op_WRAP_get    , 3, true);
-const tele_op_t op_WRP   = MAKE_GET_OP(WRP     , op_WRAP_get    , 3, true);
-const tele_op_t op_QT    = MAKE_GET_OP(QT      , op_QT_get      , 2, true);
+const tele_op_t op_MIN   = MAKE_PURE_OP(MIN     , op_MIN_get     , 2, true);
+const tele_op_t op_MAX   = MAKE_PURE_OP(MAX     , op_MAX_get     , 2, true);
+const tele_op_t op_LIM   = MAKE_PURE_OP(LIM     , op_LIM_get     , 3, true);
+const tele_op_t op_WRAP  = MAKE_PURE_OP(WRAP    , op_WRAP_get    , 3, true);
+const tele_op_t op_WRP   = MAKE_PURE_OP(WRP     , op_WRAP_get    , 3, true);
+const tele_op_t op_QT    = MAKE_PURE_OP(QT      , op_QT_get      , 2, true);
 const tele_op_t op_QT_S  = MAKE_GET_OP(QT.S    , op_QT_S_get    , 3, true);
-const tele_op_t op_QT_CS = MAKE_GET_OP(QT.CS   , op_QT_CS_get   , 5, true);
+const tele_op_t op_QT_CS = MAKE_PURE_OP(QT.CS   , op_QT_CS_get   , 5, true);
 const tele_op_t op_QT_B  = MAKE_GET_OP(QT.B    , op_QT_B_get    , 1, true);
 const tele_op_t op_QT_BX = MAKE_GET_OP(QT.BX   , op_QT_BX_get   , 2, true);
-const tele_op_t op_AVG   = MAKE_GET_OP(AVG     , op_AVG_get     , 2, true);
-const tele_op_t op_EQ    = MAKE_GET_OP(EQ      , op_EQ_get      , 2, true);
-const tele_op_t op_NE    = MAKE_GET_OP(NE      , op_NE_get      , 2, true);
-const tele_op_t op_LT    = MAKE_GET_OP(LT      , op_LT_get      , 2, true);
-const tele_op_t op_GT    = MAKE_GET_OP(GT      , op_GT_get      , 2, true);
-const tele_op_t op_LTE   = MAKE_GET_OP(LTE     , op_LTE_get     , 2, true);
-const tele_op_t op_GTE   = MAKE_GET_OP(GTE     , op_GTE_get     , 2, true);
-const tele_op_t op_INR   = MAKE_GET_OP(INR     , op_INR_get     , 3, true);
-const tele_op_t op_OUTR  = MAKE_GET_OP(OUTR    , op_OUTR_get    , 3, true);
-const tele_op_t op_INRI  = MAKE_GET_OP(INRI    , op_INRI_get    , 3, true);
-const tele_op_t op_OUTRI = MAKE_GET_OP(OUTRI   , op_OUTRI_get   , 3, true);
-const tele_op_t op_NZ    = MAKE_GET_OP(NZ      , op_NZ_get      , 1, true);
-const tele_op_t op_EZ    = MAKE_GET_OP(EZ      , op_EZ_get      , 1, true);
-const tele_op_t op_RSH   = MAKE_GET_OP(RSH     , op_RSH_get     , 2, true);
-const tele_op_t op_LSH   = MAKE_GET_OP(LSH     , op_LSH_get     , 2, true);
-const tele_op_t op_RROT  = MAKE_GET_OP(RROT    , op_RROT_get    , 2, true);
-const tele_op_t op_LROT  = MAKE_GET_OP(LROT    , op_LROT_get    , 2, true);
-const tele_op_t op_EXP   = MAKE_GET_OP(EXP     , op_EXP_get     , 1, true);
-const tele_op_t op_ABS   = MAKE_GET_OP(ABS     , op_ABS_get     , 1, true);
-const tele_op_t op_SGN   = MAKE_GET_OP(SGN     , op_SGN_get     , 1, true);
-const tele_op_t op_AND   = MAKE_GET_OP(AND     , op_AND_get     , 2, true);
-const tele_op_t op_OR    = MAKE_GET_OP(OR      , op_OR_get      , 2, true);
-const tele_op_t op_AND3  = MAKE_GET_OP(AND3    , op_AND3_get    , 3, true);
-const tele_op_t op_OR3   = MAKE_GET_OP(OR3     , op_OR3_get     , 3, true);
-const tele_op_t op_AND4  = MAKE_GET_OP(AND4    , op_AND4_get    , 4, true);
-const tele_op_t op_OR4   = MAKE_GET_OP(OR4     , op_OR4_get     , 4, true);
-const tele_op_t op_JI    = MAKE_GET_OP(JI      , op_JI_get      , 2, true);
-const tele_op_t op_SCALE = MAKE_GET_OP(SCALE   , op_SCALE_get   , 5, true);
-const tele_op_t op_SCL   = MAKE_GET_OP(SCL     , op_SCALE_get   , 5, true);
-const tele_op_t op_SCALE0 = MAKE_GET_OP(SCALE0 , op_SCALE0_get  , 3, true);
-const tele_op_t op_SCL0  = MAKE_GET_OP(SCL0    , op_SCALE0_get  , 3, true);
-const tele_op_t op_N     = MAKE_GET_OP(N       , op_N_get       , 1, true);
-const tele_op_t op_VN    = MAKE_GET_OP(VN      , op_VN_get      , 1, true);
-const tele_op_t op_HZ    = MAKE_GET_OP(HZ      , op_HZ_get      , 1, true);
-const tele_op_t op_N_S   = MAKE_GET_OP(N.S      , op_N_S_get    , 3, true);
-const tele_op_t op_N_C   = MAKE_GET_OP(N.C      , op_N_C_get    , 3, true);
-const tele_op_t op_N_CS  = MAKE_GET_OP(N.CS     , op_N_CS_get   , 4, true);
+const tele_op_t op_AVG   = MAKE_PURE_OP(AVG     , op_AVG_get     , 2, true);
+const tele_op_t op_EQ    = MAKE_PURE_OP(EQ      , op_EQ_get      , 2, true);
+const tele_op_t op_NE    = MAKE_PURE_OP(NE      , op_NE_get      , 2, true);
+const tele_op_t op_LT    = MAKE_PURE_OP(LT      , op_LT_get      , 2, true);
+const tele_op_t op_GT    = MAKE_PURE_OP(GT      , op_GT_get      , 2, true);
+const tele_op_t op_LTE   = MAKE_PURE_OP(LTE     , op_LTE_get     , 2, true);
+const tele_op_t op_GTE   = MAKE_PURE_OP(GTE     , op_GTE_get     , 2, true);
+const tele_op_t op_INR   = MAKE_PURE_OP(INR     , op_INR_get     , 3, true);
+const tele_op_t op_OUTR  = MAKE_PURE_OP(OUTR    , op_OUTR_get    , 3, true);
+const tele_op_t op_INRI  = MAKE_PURE_OP(INRI    , op_INRI_get    , 3, true);
+const tele_op_t op_OUTRI = MAKE_PURE_OP(OUTRI   , op_OUTRI_get   , 3, true);
+const tele_op_t op_NZ    = MAKE_PURE_OP(NZ      , op_NZ_get      , 1, true);
+const tele_op_t op_EZ    = MAKE_PURE_OP(EZ      , op_EZ_get      , 1, true);
+const tele_op_t op_RSH   = MAKE_PURE_OP(RSH     , op_RSH_get     , 2, true);
+const tele_op_t op_LSH   = MAKE_PURE_OP(LSH     , op_LSH_get     , 2, true);
+const tele_op_t op_RROT  = MAKE_PURE_OP(RROT    , op_RROT_get    , 2, true);
+const tele_op_t op_LROT  = MAKE_PURE_OP(LROT    , op_LROT_get    , 2, true);
+const tele_op_t op_EXP   = MAKE_PURE_OP(EXP     , op_EXP_get     , 1, true);
+const tele_op_t op_ABS   = MAKE_PURE_OP(ABS     , op_ABS_get     , 1, true);
+const tele_op_t op_SGN   = MAKE_PURE_OP(SGN     , op_SGN_get     , 1, true);
+const tele_op_t op_AND   = MAKE_PURE_OP(AND     , op_AND_get     , 2, true);
+const tele_op_t op_OR    = MAKE_PURE_OP(OR      , op_OR_get      , 2, true);
+const tele_op_t op_AND3  = MAKE_PURE_OP(AND3    , op_AND3_get    , 3, true);
+const tele_op_t op_OR3   = MAKE_PURE_OP(OR3     , op_OR3_get     , 3, true);
+const tele_op_t op_AND4  = MAKE_PURE_OP(AND4    , op_AND4_get    , 4, true);
+const tele_op_t op_OR4   = MAKE_PURE_OP(OR4     , op_OR4_get     , 4, true);
+const tele_op_t op_JI    = MAKE_PURE_OP(JI      , op_JI_get      , 2, true);
+const tele_op_t op_SCALE = MAKE_PURE_OP(SCALE   , op_SCALE_get   , 5, true);
+const tele_op_t op_SCL   = MAKE_PURE_OP(SCL     , op_SCALE_get   , 5, true);
+const tele_op_t op_SCALE0 = MAKE_PURE_OP(SCALE0 , op_SCALE0_get  , 3, true);
+const tele_op_t op_SCL0  = MAKE_PURE_OP(SCL0    , op_SCALE0_get  , 3, true);
+const tele_op_t op_N     = MAKE_PURE_OP(N       , op_N_get       , 1, true);
+const tele_op_t op_VN    = MAKE_PURE_OP(VN      , op_VN_get      , 1, true);
+const tele_op_t op_HZ    = MAKE_PURE_OP(HZ      , op_HZ_get      , 1, true);
+const tele_op_t op_N_S   = MAKE_PURE_OP(N.S      , op_N_S_get    , 3, true);
+const tele_op_t op_N_C   = MAKE_PURE_OP(N.C      , op_N_C_get    , 3, true);
+const tele_op_t op_N_CS  = MAKE_PURE_OP(N.CS     , op_N_CS_get   , 4, true);
 const tele_op_t op_N_B   = MAKE_GET_SET_OP(N.B, op_N_B_get,op_N_B_set, 1, true);
 const tele_op_t op_N_BX  = MAKE_GET_SET_OP(N.BX, op_N_BX_get, op_N_BX_set, 2, true);
-const tele_op_t op_V     = MAKE_GET_OP(V       , op_V_get       , 1, true);
-const tele_op_t op_VV    = MAKE_GET_OP(VV      , op_VV_get      , 1, true);
-const tele_op_t op_ER    = MAKE_GET_OP(ER      , op_ER_get      , 3, true);
-const tele_op_t op_NR    = MAKE_GET_OP(NR      , op_NR_get      , 4, true);
-const tele_op_t op_DR_T  = MAKE_GET_OP(DR.T    , op_DR_T_get    , 5, true);
-const tele_op_t op_DR_P  = MAKE_GET_OP(DR.P    , op_DR_P_get    , 3, true);
-const tele_op_t op_DR_V  = MAKE_GET_OP(DR.V    , op_DR_V_get    , 2, true);
-const tele_op_t op_BPM   = MAKE_GET_OP(BPM     , op_BPM_get     , 1, true);
-const tele_op_t op_BIT_OR  = MAKE_GET_OP(|, op_BIT_OR_get  , 2, true);
-const tele_op_t op_BIT_AND = MAKE_GET_OP(&, op_BIT_AND_get, 2, true);
-const tele_op_t op_BIT_NOT  = MAKE_GET_OP(~, op_BIT_NOT_get  , 1, true);
-const tele_op_t op_BIT_XOR = MAKE_GET_OP(^, op_BIT_XOR_get, 2, true);
-const tele_op_t op_BSET  = MAKE_GET_OP(BSET    , op_BSET_get    , 2, true);
-const tele_op_t op_BGET  = MAKE_GET_OP(BGET    , op_BGET_get    , 2, true);
-const tele_op_t op_BCLR  = MAKE_GET_OP(BCLR    , op_BCLR_get    , 2, true);
-const tele_op_t op_BTOG  = MAKE_GET_OP(BTOG    , op_BTOG_get    , 2, true);
-const tele_op_t op_BREV  = MAKE_GET_OP(BREV    , op_BREV_get    , 1, true);
+const tele_op_t op_V     = MAKE_PURE_OP(V       , op_V_get       , 1, true);
+const tele_op_t op_VV    = MAKE_PURE_OP(VV      , op_VV_get      , 1, true);
+const tele_op_t op_ER    = MAKE_PURE_OP(ER      , op_ER_get      , 3, true);
+const tele_op_t op_NR    = MAKE_PURE_OP(NR      , op_NR_get      , 4, true);
+const tele_op_t op_DR_T  = MAKE_PURE_OP(DR.T    , op_DR_T_get    , 5, true);
+const tele_op_t op_DR_P  = MAKE_PURE_OP(DR.P    , op_DR_P_get    , 3, true);
+const tele_op_t op_DR_V  = MAKE_PURE_OP(DR.V    , op_DR_V_get    , 2, true);
+const tele_op_t op_BPM   = MAKE_PURE_OP(BPM     , op_BPM_get     , 1, true);
+const tele_op_t op_BIT_OR  = MAKE_PURE_OP(|, op_BIT_OR_get  , 2, true);
+const tele_op_t op_BIT_AND = MAKE_PURE_OP(&, op_BIT_AND_get, 2, true);
+const tele_op_t op_BIT_NOT  = MAKE_PURE_OP(~, op_BIT_NOT_get  , 1, true);
+const tele_op_t op_BIT_XOR = MAKE_PURE_OP(^, op_BIT_XOR_get, 2, true);
+const tele_op_t op_BSET  = MAKE_PURE_OP(BSET    , op_BSET_get    , 2, true);
+const tele_op_t op_BGET  = MAKE_PURE_OP(BGET    , op_BGET_get    , 2, true);
+const tele_op_t op_BCLR  = MAKE_PURE_OP(BCLR    , op_BCLR_get    , 2, true);
+const tele_op_t op_BTOG  = MAKE_PURE_OP(BTOG    , op_BTOG_get    , 2, true);
+const tele_op_t op_BREV  = MAKE_PURE_OP(BREV    , op_BREV_get    , 1, true);
 const tele_op_t op_CHAOS   = MAKE_GET_SET_OP(CHAOS,   op_CHAOS_get,   op_CHAOS_set, 0, true);
 const tele_op_t op_CHAOS_R = MAKE_GET_SET_OP(CHAOS.R, op_CHAOS_R_get, op_CHAOS_R_set, 0, true);
 const tele_op_t op_CHAOS_ALG = MAKE_GET_SET_OP(CHAOS.ALG, op_CHAOS_ALG_get, op_CHAOS_ALG_set, 0, true);
-const tele_op_t op_TIF = MAKE_GET_OP(?, op_TIF_get, 3, true);
-
-const tele_op_t op_XOR   = MAKE_ALIAS_OP(XOR, op_NE_get, NULL, 2, true);
-
-const tele_op_t op_SYM_PLUS               = MAKE_ALIAS_OP(+ ,  op_ADD_get,  NULL, 2, true);
-const tele_op_t op_SYM_DASH               = MAKE_ALIAS_OP(- ,  op_SUB_get,  NULL, 2, true);
-const tele_op_t op_SYM_STAR               = MAKE_ALIAS_OP(* ,  op_MUL_get,  NULL, 2, true);
-const tele_op_t op_SYM_FORWARD_SLASH      = MAKE_ALIAS_OP(/ ,  op_DIV_get,  NULL, 2, true);
-const tele_op_t op_SYM_PERCENTAGE         = MAKE_ALIAS_OP(% ,  op_MOD_get,  NULL, 2, true);
-const tele_op_t op_SYM_EQUAL_x2           = MAKE_ALIAS_OP(==,  op_EQ_get ,  NULL, 2, true);
-const tele_op_t op_SYM_EXCLAMATION_EQUAL  = MAKE_ALIAS_OP(!=,  op_NE_get ,  NULL, 2, true);
-const tele_op_t op_SYM_LEFT_ANGLED        = MAKE_ALIAS_OP(< ,  op_LT_get ,  NULL, 2, true);
-const tele_op_t op_SYM_RIGHT_ANGLED       = MAKE_ALIAS_OP(> ,  op_GT_get ,  NULL, 2, true);
-const tele_op_t op_SYM_LEFT_ANGLED_EQUAL  = MAKE_ALIAS_OP(<=,  op_LTE_get,  NULL, 2, true);
-const tele_op_t op_SYM_RIGHT_ANGLED_EQUAL = MAKE_ALIAS_OP(>=,  op_GTE_get,  NULL, 2, true);
-const tele_op_t op_SYM_RIGHT_ANGLED_LEFT_ANGLED = MAKE_ALIAS_OP(><,  op_INR_get,  NULL, 3, true);
-const tele_op_t op_SYM_LEFT_ANGLED_RIGHT_ANGLED = MAKE_ALIAS_OP(<>,  op_OUTR_get,  NULL, 3, true);
-const tele_op_t op_SYM_RIGHT_ANGLED_EQUAL_LEFT_ANGLED = MAKE_ALIAS_OP(>=<,  op_INRI_get,  NULL, 3, true);
-const tele_op_t op_SYM_LEFT_ANGLED_EQUAL_RIGHT_ANGLED = MAKE_ALIAS_OP(<=>,  op_OUTRI_get,  NULL, 3, true);
-const tele_op_t op_SYM_EXCLAMATION        = MAKE_ALIAS_OP(! ,  op_EZ_get ,  NULL, 1, true);
-const tele_op_t op_SYM_LEFT_ANGLED_x2     = MAKE_ALIAS_OP(<<,  op_LSH_get,  NULL, 2, true);
-const tele_op_t op_SYM_RIGHT_ANGLED_x2    = MAKE_ALIAS_OP(>>,  op_RSH_get,  NULL, 2, true);
-const tele_op_t op_SYM_LEFT_ANGLED_x3     = MAKE_ALIAS_OP(<<<, op_LROT_get, NULL, 2, true);
-const tele_op_t op_SYM_RIGHT_ANGLED_x3    = MAKE_ALIAS_OP(>>>, op_RROT_get, NULL, 2, true);
-const tele_op_t op_SYM_AMPERSAND_x2       = MAKE_ALIAS_OP(&&,  op_AND_get,  NULL, 2, true);
-const tele_op_t op_SYM_PIPE_x2            = MAKE_ALIAS_OP(||,  op_OR_get ,  NULL, 2, true);
-const tele_op_t op_SYM_AMPERSAND_x3       = MAKE_ALIAS_OP(&&&, op_AND3_get, NULL, 3, true);
-const tele_op_t op_SYM_PIPE_x3            = MAKE_ALIAS_OP(|||, op_OR3_get , NULL, 3, true);
-const tele_op_t op_SYM_AMPERSAND_x4       = MAKE_ALIAS_OP(&&&&,op_AND4_get, NULL, 4, true);
-const tele_op_t op_SYM_PIPE_x4            = MAKE_ALIAS_OP(||||,op_OR4_get , NULL, 4, true);
+const tele_op_t op_TIF = MAKE_PURE_OP(?, op_TIF_get, 3, true);
+
+const tele_op_t op_XOR   = MAKE_PURE_OP(XOR, op_NE_get, 2, true);
+
+const tele_op_t op_SYM_PLUS               = MAKE_PURE_OP(+ ,  op_ADD_get, 2, true);
+const tele_op_t op_SYM_DASH               = MAKE_PURE_OP(- ,  op_SUB_get, 2, true);
+const tele_op_t op_SYM_STAR               = MAKE_PURE_OP(* ,  op_MUL_get, 2, true);
+const tele_op_t op_SYM_FORWARD_SLASH      = MAKE_PURE_OP(/ ,  op_DIV_get, 2, true);
+const tele_op_t op_SYM_PERCENTAGE         = MAKE_PURE_OP(% ,  op_MOD_get, 2, true);
+const tele_op_t op_SYM_EQUAL_x2           = MAKE_PURE_OP(==,  op_EQ_get , 2, true);
+const tele_op_t op_SYM_EXCLAMATION_EQUAL  = MAKE_PURE_OP(!=,  op_NE_get , 2, true);
+const tele_op_t op_SYM_LEFT_ANGLED        = MAKE_PURE_OP(< ,  op_LT_get , 2, true);
+const tele_op_t op_SYM_RIGHT_ANGLED       = MAKE_PURE_OP(> ,  op_GT_get , 2, true);
+const tele_op_t op_SYM_LEFT_ANGLED_EQUAL  = MAKE_PURE_OP(<=,  op_LTE_get, 2, true);
+const tele_op_t op_SYM_RIGHT_ANGLED_EQUAL = MAKE_PURE_OP(>=,  op_GTE_get, 2, true);
+const tele_op_t op_SYM_RIGHT_ANGLED_LEFT_ANGLED = MAKE_PURE_OP(><,  op_INR_get, 3, true);
+const tele_op_t op_SYM_LEFT_ANGLED_RIGHT_ANGLED = MAKE_PURE_OP(<>,  op_OUTR_get, 3, true);
+const tele_op_t op_SYM_RIGHT_ANGLED_EQUAL_LEFT_ANGLED = MAKE_PURE_OP(>=<,  op_INRI_get, 3, true);
+const tele_op_t op_SYM_LEFT_ANGLED_EQUAL_RIGHT_ANGLED = MAKE_PURE_OP(<=>,  op_OUTRI_get, 3, true);
+const tele_op_t op_SYM_EXCLAMATION        = MAKE_PURE_OP(! ,  op_EZ_get , 1, true);
+const tele_op_t op_SYM_LEFT_ANGLED_x2     = MAKE_PURE_OP(<<,  op_LSH_get, 2, true);
+const tele_op_t op_SYM_RIGHT_ANGLED_x2    = MAKE_PURE_OP(>>,  op_RSH_get, 2, true);
+const tele_op_t op_SYM_LEFT_ANGLED_x3     = MAKE_PURE_OP(<<<, op_LROT_get, 2, true);
+const tele_op_t op_SYM_RIGHT_ANGLED_x3    = MAKE_PURE_OP(>>>, op_RROT_get, 2, true);
+const tele_op_t op_SYM_AMPERSAND_x2       = MAKE_PURE_OP(&&,  op_AND_get, 2, true);
+const tele_op_t op_SYM_PIPE_x2            = MAKE_PURE_OP(||,  op_OR_get , 2, true);
+const tele_op_t op_SYM_AMPERSAND_x3       = MAKE_PURE_OP(&&&, op_AND3_get, 3, true);
+const tele_op_t op_SYM_PIPE_x3            = MAKE_PURE_OP(|||, op_OR3_get , 3, true);
+const tele_op_t op_SYM_AMPERSAND_x4       = MAKE_PURE_OP(&&&&,op_AND4_get, 4, true);
+const tele_op_t op_SYM_PIPE_x4            = MAKE_PURE_OP(||||,op_OR4_get , 4, true);
 // clang-format on
 
 static int16_t volts_to_note_number(int16_t v_in) {
@@ -380,6 +381,30 @@ static int16_t chord_n_s_to_bitmask(int16_t scale_n_s, int16_t degree,
     return scale_bits;
 }
 
+// the N.S scales prepared for QT.S, built the first time each is used
+static const quantize_scale_t *n_s_scale(int16_t scale_n_s) {
+    static quantize_scale_t scales[9];
+    static bool ready[9];
+    if (!ready[scale_n_s]) {
+        quantize_scale_init(&scales[scale_n_s],
+                            scale_n_s_to_bitmask(scale_n_s));
+        ready[scale_n_s] = true;
+    }
+    return &scales[scale_n_s];
+}
+
+// the N.B / N.BX scale i prepared for QT.B and QT.BX, rebuilt when N.B or
+// N.BX have changed it since it was last used
+static const n_scale_cache_t *n_scale(scene_state_t *ss, int16_t i) {
+    n_scale_cache_t *c = &ss->n_scale_cache[i];
+    if (!c->valid) {
+        quantize_scale_init(&c->scale, ss->variables.n_scale_bits[i]);
+        c->transpose = note_number_to_volts(ss->variables.n_scale_root[i]);
+        c->valid = true;
+    }
+    return c;
+}
+
 static int16_t get_degree_in_bitmask_scale(int16_t scale_bits,
                                            int16_t transpose, int16_t degree) {
     int16_t note = 0;
@@ -409,43 +434,6 @@ static int16_t get_degree_in_bitmask_scale(int16_t scale_bits,
     else { return -table_n[-note]; }
 }
 
-static int16_t quantize_to_bitmask_scale(int16_t scale_bits, int16_t transpose,
-                                         int16_t v_in) {
-    // accepts 12-bit scale mask and a pitch voltage. transpose is voltage for
-    // scale offset. returns nearest pitch voltage in scale.
-    if (scale_bits == 0) { return v_in; }  // no active scale bits
-
-    v_in = normalise_value(-table_n[127], table_n[127], 0, v_in);
-
-    int16_t sign_offset = (v_in < 0) ? 18022 : 0;  // 11 octaves
-    v_in = v_in + sign_offset;
-
-    int16_t octave_in = v_in / table_n[12];
-    if (v_in <= 18021 && v_in >= 18018) {
-        octave_in = 10;
-    }  // fix precision error
-    int16_t semitones_in = v_in % table_n[12];
-    transpose = transpose % table_n[12];
-
-    int16_t dist_nearest = INT16_MAX;
-    int16_t note_nearest = INT16_MAX;
-    int16_t try_note, try_distance;
-    for (int16_t i = 0; i < 12; i++) {
-        if (scale_bits & (1 << i)) {
-            for (int16_t j = -2; j <= 2; j++) {
-                try_note = table_n[i] + transpose + (j * table_n[12]);
-                try_distance = abs(try_note - semitones_in);
-                if (try_distance < dist_nearest) {
-                    dist_nearest = try_distance;
-                    note_nearest = try_note;
-                }
-            }
-        }
-    }
-
-    return (note_nearest + table_n[octave_in * 12]) - sign_offset;
-}
-
 static void op_ADD_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
                        exec_state_t *NOTUSED(es), command_state_t *cs) {
     cs_push(cs, cs_pop(cs) + cs_pop(cs));
@@ -645,9 +633,7 @@ static void op_QT_S_get(const void *NOTUSED(data), scene_state_t *ss,
     int16_t scale = cs_pop(cs) % 9;
     if (scale < 0) scale = 9 + scale;
 
-    int16_t mask = scale_n_s_to_bitmask(scale);
-
-    cs_push(cs, quantize_to_bitmask_scale(mask, transpose, v_in));
+    cs_push(cs, quantize_to_scale(n_s_scale(scale), transpose, v_in));
 }
 
 static void op_QT_CS_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
@@ -668,10 +654,9 @@ static void op_QT_CS_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
 static void op_QT_B_get(const void *NOTUSED(data), scene_state_t *ss,
                         exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t v_in = cs_pop(cs);  // v/oct
-    int16_t mask = ss->variables.n_scale_bits[0];
-    int16_t transpose = note_number_to_volts(ss->variables.n_scale_root[0]);
+    const n_scale_cache_t *c = n_scale(ss, 0);
 
-    cs_push(cs, quantize_to_bitmask_scale(mask, transpose, v_in));
+    cs_push(cs, quantize_to_scale(&c->scale, c->transpose, v_in));
 }
 
 static void op_QT_BX_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -682,11 +667,9 @@ static void op_QT_BX_get(const void *NOTUSED(data), scene_state_t *ss,
     if (scale_nb > NB_NBX_SCALES - 1) { scale_nb = NB_NBX_SCALES - 1; }
 
     int16_t v_in = cs_pop(cs);  // v/oct
-    int16_t mask = ss->variables.n_scale_bits[scale_nb];
-    int16_t transpose =
-        note_number_to_volts(ss->variables.n_scale_root[scale_nb]);
+    const n_scale_cache_t *c = n_scale(ss, scale_nb);
 
-    cs_push(cs, quantize_to_bitmask_scale(mask, transpose, v_in));
+    cs_push(cs, quantize_to_scale(&c->scale, c->transpose, v_in));
 }
 
 static void op_AVG_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
@@ -1167,7 +1150,7 @@ static void op_N_B_get(const void *NOTUSED(data), scene_state_t *ss,
 
 static void op_N_B_set(const void *NOTUSED(data), scene_state_t *ss,
                        exec_state_t *NOTUSED(es), command_state_t *cs) {
-    ss->variables.n_scale_root[0] = cs_pop(cs);
+    int16_t root = cs_pop(cs);
     int16_t scale_bits = cs_pop(cs);
 
     if (scale_bits < 1) {
@@ -1178,7 +1161,7 @@ static void op_N_B_set(const void *NOTUSED(data), scene_state_t *ss,
     }
     else { scale_bits = scale_bits & 0b111111111111; }
 
-    ss->variables.n_scale_bits[0] = scale_bits;
+    ss_set_n_scale(ss, 0, scale_bits, root);
 }
 
 static void op_N_BX_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -1199,7 +1182,7 @@ static void op_N_BX_get(const void *NOTUSED(data), scene_state_t *ss,
 static void op_N_BX_set(const void *NOTUSED(data), scene_state_t *ss,
                         exec_state_t *NOTUSED(es), command_state_t *cs) {
     int16_t scale_nb = cs_pop(cs) % 8;
-    ss->variables.n_scale_root[scale_nb] = cs_pop(cs);
+    int16_t root = cs_pop(cs);
     int16_t scale_bits = cs_pop(cs);
 
     if (scale_nb < 0) { scale_nb = 0; }
@@ -1213,7 +1196,7 @@ static void op_N_BX_set(const void *NOTUSED(data), scene_state_t *ss,
     }
     else { scale_bits = scale_bits & 0b111111111111; }
 
-    ss->variables.n_scale_bits[scale_nb] = scale_bits;
+    ss_set_n_scale(ss, scale_nb, scale_bits, root);
 }
 
 static void op_N_C_get(const void *NOTUSED(data), scene_state_t *NOTUSED(ss),
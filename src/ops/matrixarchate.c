@@ -2,6 +2,7 @@
 
 #include "helpers.h"
 #include "ii.h"
+#include "ii_queue.h"
 #include "teletype.h"
 #include "teletype_io.h"
 
@@ -83,7 +84,7 @@ u8 selected_ma = 0;
 static void ma_set(s16 row, s16 column, s16 value) {
     if (row < 0 || row > 15 || column < 0 || column > 7) return;
     uint8_t d[] = { value ? 0b10010000 : 0b10000000, (row << 3) + column, 128 };
-    tele_ii_tx(MATRIXARCHATE + selected_ma, d, 3);
+    ii_tx(MATRIXARCHATE + selected_ma, d, 3);
 }
 
 static void ma_set_pgm(s16 program, s16 row, s16 column, s16 value) {
@@ -92,31 +93,31 @@ static void ma_set_pgm(s16 program, s16 row, s16 column, s16 value) {
         return;
     uint8_t d[] = { value ? 0b10010000 : 0b10000000, (row << 3) + column,
                     program };
-    tele_ii_tx(MATRIXARCHATE + selected_ma, d, 3);
+    ii_tx(MATRIXARCHATE + selected_ma, d, 3);
 }
 
 static void ma_set_col(s16 column, u16 value) {
     if (column < 0 || column > 7) return;
     uint8_t d[] = { 0b10110000, column, 128, value & 255, value >> 8 };
-    tele_ii_tx(MATRIXARCHATE + selected_ma, d, 5);
+    ii_tx(MATRIXARCHATE + selected_ma, d, 5);
 }
 
 static void ma_set_col_pgm(s16 program, s16 column, u16 value) {
     if (program < 0 || program > 59 || column < 0 || column > 7) return;
     uint8_t d[] = { 0b10110000, column, program, value & 255, value >> 8 };
-    tele_ii_tx(MATRIXARCHATE + selected_ma, d, 5);
+    ii_tx(MATRIXARCHATE + selected_ma, d, 5);
 }
 
 static void ma_set_row(s16 row, u16 value) {
     if (row < 0 || row > 15) return;
     uint8_t d[] = { 0b10110000, row | 128, 128, value & 255, value >> 8 };
-    tele_ii_tx(MATRIXARCHATE + selected_ma, d, 5);
+    ii_tx(MATRIXARCHATE + selected_ma, d, 5);
 }
 
 static void ma_set_row_pgm(s16 program, s16 row, u16 value) {
     if (program < 0 || program > 59 || row < 0 || row > 15) return;
     uint8_t d[] = { 0b10110000, row | 128, program, value & 255, value >> 8 };
-    tele_ii_tx(MATRIXARCHATE + selected_ma, d, 5);
+    ii_tx(MATRIXARCHATE + selected_ma, d, 5);
 }
 
 static void op_MA_SELECT_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -134,13 +135,13 @@ static void op_MA_SELECT_set(const void *NOTUSED(data), scene_state_t *ss,
 static void op_MA_STEP_get(const void *NOTUSED(data), scene_state_t *ss,
                            exec_state_t *NOTUSED(es), command_state_t *cs) {
     uint8_t d[] = { 0b11111000 };
-    tele_ii_tx(MATRIXARCHATE + selected_ma, d, 1);
+    ii_tx(MATRIXARCHATE + selected_ma, d, 1);
 }
 
 static void op_MA_RESET_get(const void *NOTUSED(data), scene_state_t *ss,
                             exec_state_t *NOTUSED(es), command_state_t *cs) {
     uint8_t d[] = { 0b11111101 };
-    tele_ii_tx(MATRIXARCHATE + selected_ma, d, 1);
+    ii_tx(MATRIXARCHATE + selected_ma, d, 1);
 }
 
 static void op_MA_PGM_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -148,7 +149,7 @@ static void op_MA_PGM_get(const void *NOTUSED(data), scene_state_t *ss,
     s16 program = cs_pop(cs) - 1;
     if (program < 0 || program > 59) return;
     uint8_t d[] = { 0b11000000, program };
-    tele_ii_tx(MATRIXARCHATE + selected_ma, d, 2);
+    ii_tx(MATRIXARCHATE + selected_ma, d, 2);
 }
 
 static void op_MA_ON_get(const void *NOTUSED(data), scene_state_t *ss,
@@ -204,10 +205,10 @@ static void op_MA_COL_get(const void *NOTUSED(data), scene_state_t *ss,
     u16 value = 0;
     if (column >= 0 && column <= 7) {
         uint8_t d[] = { 0b11110101, column, 128 };
-        tele_ii_tx(MATRIXARCHATE + selected_ma, d, 3);
+        ii_tx(MATRIXARCHATE + selected_ma, d, 3);
         d[0] = 0;
         d[1] = 0;
-        tele_ii_rx(MATRIXARCHATE + selected_ma, d, 2);
+        ii_rx(MATRIXARCHATE + selected_ma, d, 2);
         value = (d[1] << 8) + d[0];
     }
     cs_push(cs, value);
@@ -227,10 +228,10 @@ static void op_MA_PCOL_get(const void *NOTUSED(data), scene_state_t *ss,
     u16 value = 0;
     if (column >= 0 && column <= 7 && program >= 0 && program <= 59) {
         uint8_t d[] = { 0b11110101, column, program };
-        tele_ii_tx(MATRIXARCHATE + selected_ma, d, 3);
+        ii_tx(MATRIXARCHATE + selected_ma, d, 3);
         d[0] = 0;
         d[1] = 0;
-        tele_ii_rx(MATRIXARCHATE + selected_ma, d, 2);
+        ii_rx(MATRIXARCHATE + selected_ma, d, 2);
         value = (d[1] << 8) + d[0];
     }
     cs_push(cs, value);
@@ -250,10 +251,10 @@ static void op_MA_ROW_get(const void *NOTUSED(data), scene_state_t *ss,
     u16 value = 0;
     if (row >= 0 && row <= 15) {
         uint8_t d[] = { 0b11110101, row | 128, 128 };
-        tele_ii_tx(MATRIXARCHATE + selected_ma, d, 3);
+        ii_tx(MATRIXARCHATE + selected_ma, d, 3);
         d[0] = 0;
         d[1] = 0;
-        tele_ii_rx(MATRIXARCHATE + selected_ma, d, 2);
+        ii_rx(MATRIXARCHATE + selected_ma, d, 2);
         value = (d[1] << 8) + d[0];
     }
     cs_push(cs, value);
@@ -273,10 +274,10 @@ static void op_MA_PROW_get(const void *NOTUSED(data), scene_state_t *ss,
     u16 value = 0;
     if (row >= 0 && row <= 15 && program >= 0 && program <= 59) {
         uint8_t d[] = { 0b11110101, row | 128, program };
-        tele_ii_tx(MATRIXARCHATE + selected_ma, d, 3);
+        ii_tx(MATRIXARCHATE + selected_ma, d, 3);
         d[0] = 0;
         d[1] = 0;
-        tele_ii_rx(MATRIXARCHATE + selected_ma, d, 2);
+        ii_rx(MATRIXARCHATE + selected_ma, d, 2);
         value = (d[1] << 8) + d[0];
     }
     cs_push(cs, value);
@@ -3,6 +3,7 @@
 #include <stddef.h>  // offsetof
 
 #include "helpers.h"
+#include "ii_queue.h"
 #include "ops/ansible.h"
 #include "ops/controlflow.h"
 #include "ops/crow.h"
@@ -24,6 +25,7 @@
 #include "ops/midi.h"
 #include "ops/orca.h"
 #include "ops/patterns.h"
+#include "ops/prof.h"
 #include "ops/queue.h"
 #include "ops/seed.h"
 #include "ops/stack.h"
@@ -320,7 +322,16 @@ const tele_op_t *tele_ops[E_OP__LENGTH] = {
     &op_MI_LC, &op_MI_LCC, &op_MI_LCCV, &op_MI_NL, &op_MI_N, &op_MI_NV,
     &op_MI_V, &op_MI_VV, &op_MI_OL, &op_MI_O, &op_MI_CL, &op_MI_C, &op_MI_CC,
     &op_MI_CCV, &op_MI_LCH, &op_MI_NCH, &op_MI_OCH, &op_MI_CCH, &op_MI_LE,
-    &op_MI_CLKD, &op_MI_CLKR
+    &op_MI_CLKD, &op_MI_CLKR,
+
+    // profiling
+    &op_PROF_OP, &op_PROF_US, &op_PROF_CLR,
+
+    // delay
+    &op_DEL_KILL, &op_DEL_N,
+
+    // i2c
+    &op_II_POLL, &op_II_AGE
 };
 
 /////////////////////////////////////////////////////////////////
@@ -347,7 +358,10 @@ const tele_mod_t *tele_mods[E_MOD__LENGTH] = {
     &mod_JF0, &mod_JF1, &mod_JF2,
 
     // crow
-    &mod_CROWN, &mod_CROW1, &mod_CROW2, &mod_CROW3, &mod_CROW4
+    &mod_CROWN, &mod_CROW1, &mod_CROW2, &mod_CROW3, &mod_CROW4,
+
+    // i2c
+    &mod_II_SYNC
 };
 
 /////////////////////////////////////////////////////////////////
@@ -380,5 +394,5 @@ void op_simple_i2c(const void *data, scene_state_t *NOTUSED(ss),
 
     uint8_t buffer[3] = { message_type, value >> 8, value & 0xFF };
 
-    tele_ii_tx(address, buffer, 3);
+    ii_tx(address, buffer, 3);
 }
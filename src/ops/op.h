@@ -8,7 +8,22 @@
 #include "op_enum.h"
 #include "state.h"
 
-typedef struct {
+// What running an op's get fn can touch. compile_command uses it to fold
+// expressions when a script line is stored: an OP_PURE op whose params are
+// all numbers is run once there and replaced by its result. The fn is called
+// without a scene, so an OP_PURE get must declare ss and es NOTUSED.
+// Ops default to OP_SIDE_EFFECTS, which is always safe.
+typedef enum {
+    OP_SIDE_EFFECTS = 0,  // changes state, or not known
+    OP_PURE,              // result depends on nothing but its params
+    OP_READS_STATE,       // reads scene or hardware state, changes nothing
+    OP_I2C,               // talks to another module over i2c
+    OP_LOADS_SCRIPTS,     // replaces the scripts, lines using it aren't compiled
+    OP_RUNS_SCRIPTS       // runs another script, which may replace this line
+} tele_op_effect_t;
+
+// named so that command.h can point to them before they are defined
+typedef struct tele_op_s {
     const char *name;
     void (*const get)(const void *data, scene_state_t *ss, exec_state_t *es,
                       command_state_t *cs);
@@ -17,12 +32,13 @@ typedef struct {
     const uint8_t params;
     const bool returns;
     const void *data;
+    const uint8_t effect;  // tele_op_effect_t
 } tele_op_t;
 
-typedef struct {
+typedef struct tele_mod_s {
     const char *name;
     void (*const func)(scene_state_t *ss, exec_state_t *es, command_state_t *cs,
-                       const tele_command_t *post_command);
+                       const tele_command_view_t *post_command);
     const uint8_t params;
 } tele_mod_t;
 
@@ -37,16 +53,44 @@ extern const tele_mod_t *tele_mods[E_MOD__LENGTH];
     }
 
 
+// Get only ops that can be folded when a command is stored
+#define MAKE_PURE_OP(n, g, p, r)                                      \
+    {                                                                 \
+        .name = #n, .get = g, .set = NULL, .params = p, .returns = r, \
+        .data = NULL, .effect = OP_PURE                               \
+    }
+
+
 // Get & set ops
 #define MAKE_GET_SET_OP(n, g, s, p, r) \
     { .name = #n, .get = g, .set = s, .params = p, .returns = r, .data = NULL }
 
 
+// Ops that load a scene or clear scripts (SCENE, INIT...), the line that runs
+// them is interpreted from a copy so that it can finish after its script has
+// been replaced
+#define MAKE_LOAD_OP(n, g, s, p, r)                                \
+    {                                                              \
+        .name = #n, .get = g, .set = s, .params = p, .returns = r, \
+        .data = NULL, .effect = OP_LOADS_SCRIPTS                   \
+    }
+
+
+// Ops that run another script (SCRIPT, $F, G.BTN.PR...), the script may
+// replace the line that called it, so the line is run from a copy
+#define MAKE_RUN_OP(n, g, s, p, r)                                 \
+    {                                                              \
+        .name = #n, .get = g, .set = s, .params = p, .returns = r, \
+        .data = NULL, .effect = OP_RUNS_SCRIPTS                    \
+    }
+
+
 // Variables, peek & poke
 #define MAKE_SIMPLE_VARIABLE_OP(n, v)                                    \
     {                                                                    \
         .name = #n, .get = op_peek_i16, .set = op_poke_i16, .params = 0, \
-        .returns = 1, .data = (void *)offsetof(scene_state_t, v)         \
+        .returns = 1, .data = (void *)offsetof(scene_state_t, v),        \
+        .effect = OP_READS_STATE                                         \
     }
 
 void op_peek_i16(const void *data, scene_state_t *ss, exec_state_t *es,
@@ -64,7 +108,7 @@ void op_poke_i16(const void *data, scene_state_t *ss, exec_state_t *es,
 #define MAKE_SIMPLE_I2C_OP(n, v)                                    \
     {                                                               \
         .name = #n, .get = op_simple_i2c, .set = NULL, .params = 1, \
-        .returns = 0, .data = (void *)v                             \
+        .returns = 0, .data = (void *)v, .effect = OP_I2C           \
     }
 
 void op_simple_i2c(const void *data, scene_state_t *ss, exec_state_t *es,
@@ -955,6 +955,13 @@ typedef enum {
     E_OP_MI_LE,
     E_OP_MI_CLKD,
     E_OP_MI_CLKR,
+    E_OP_PROF_OP,
+    E_OP_PROF_US,
+    E_OP_PROF_CLR,
+    E_OP_DEL_KILL,
+    E_OP_DEL_N,
+    E_OP_II_POLL,
+    E_OP_II_AGE,
     E_OP__LENGTH,
 } tele_op_idx_t;
 
@@ -989,6 +996,7 @@ typedef enum {
     E_MOD_CROW2,
     E_MOD_CROW3,
     E_MOD_CROW4,
+    E_MOD_II_SYNC,
     E_MOD__LENGTH,
 } tele_mod_idx_t;
 
@@ -1044,7 +1044,7 @@ const tele_op_t op_PN_SUBW = MAKE_GET_OP(PN.-W, op_PN_SUBW_get, 5, false);
 // mods: P.MAP, PN.MAP /////////////////////////////////////////////////////////
 
 static void p_map(scene_state_t *ss, exec_state_t *es,
-                  const tele_command_t *post_command, int16_t pn) {
+                  const tele_command_view_t *post_command, int16_t pn) {
     pn = normalise_pn(pn);
     int16_t start = ss_get_pattern_start(ss, pn);
     int16_t end = ss_get_pattern_end(ss, pn);
@@ -1055,7 +1055,7 @@ static void p_map(scene_state_t *ss, exec_state_t *es,
 
     for (int16_t idx = start; idx <= end; idx++) {
         *i = ss_get_pattern_val(ss, pn, idx);
-        output = process_command(ss, es, post_command);
+        output = process_command_view(ss, es, post_command);
         if (output.has_value) { ss_set_pattern_val(ss, pn, idx, output.value); }
     }
 
@@ -1064,13 +1064,13 @@ static void p_map(scene_state_t *ss, exec_state_t *es,
 
 static void mod_P_MAP_func(scene_state_t *ss, exec_state_t *es,
                            command_state_t *cs,
-                           const tele_command_t *post_command) {
+                           const tele_command_view_t *post_command) {
     p_map(ss, es, post_command, ss->variables.p_n);
 }
 
 static void mod_PN_MAP_func(scene_state_t *ss, exec_state_t *es,
                             command_state_t *cs,
-                            const tele_command_t *post_command) {
+                            const tele_command_view_t *post_command) {
     p_map(ss, es, post_command, cs_pop(cs));
 }
 
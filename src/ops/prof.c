@@ -0,0 +1,109 @@
+#include "ops/prof.h"
+
+#include <string.h>  // memset
+
+#include "helpers.h"
+#include "teletype.h"
+#include "teletype_io.h"
+
+// only the top entries can be queried, each rank is a scan of the table
+#define PROF_RANKS 16
+
+static void op_PROF_OP_get(const void *data, scene_state_t *ss,
+                           exec_state_t *es, command_state_t *cs);
+static void op_PROF_US_get(const void *data, scene_state_t *ss,
+                           exec_state_t *es, command_state_t *cs);
+static void op_PROF_CLR_get(const void *data, scene_state_t *ss,
+                            exec_state_t *es, command_state_t *cs);
+
+const tele_op_t op_PROF_OP = MAKE_GET_OP(PROF.OP, op_PROF_OP_get, 1, true);
+const tele_op_t op_PROF_US = MAKE_GET_OP(PROF.US, op_PROF_US_get, 1, true);
+const tele_op_t op_PROF_CLR = MAKE_GET_OP(PROF.CLR, op_PROF_CLR_get, 0, false);
+
+#ifdef TELETYPE_PROFILE
+// ops first, then mods. The counters aren't part of the scene, so the scene
+// copies made to save and load don't carry them.
+static op_profile_t profile[E_OP__LENGTH + E_MOD__LENGTH];
+
+// the time saturates rather than wrapping
+void prof_add(uint16_t i, uint32_t cycles) {
+    op_profile_t *p = &profile[i];
+    p->calls++;
+    if (cycles > UINT32_MAX - p->cycles)
+        p->cycles = UINT32_MAX;
+    else
+        p->cycles += cycles;
+}
+
+// true if entry a ranks above entry b, ties are broken by position so that
+// every entry has a distinct rank
+static bool prof_above(uint16_t a, uint16_t b) {
+    if (profile[a].cycles != profile[b].cycles)
+        return profile[a].cycles > profile[b].cycles;
+    return a < b;
+}
+#endif
+
+void prof_clear() {
+#ifdef TELETYPE_PROFILE
+    memset(profile, 0, sizeof(profile));
+#endif
+}
+
+const op_profile_t *prof_rank(uint16_t n, const char **name) {
+#ifdef TELETYPE_PROFILE
+    int16_t prev = -1;
+    for (uint16_t r = 0; r <= n; r++) {
+        int16_t found = -1;
+        for (uint16_t i = 0; i < E_OP__LENGTH + E_MOD__LENGTH; i++) {
+            if (profile[i].calls == 0) continue;
+            if (prev != -1 && !prof_above(prev, i)) continue;
+            if (found == -1 || prof_above(i, found)) found = i;
+        }
+        if (found == -1) return NULL;
+        prev = found;
+    }
+
+    if (name) {
+        *name = prev < E_OP__LENGTH ? tele_ops[prev]->name
+                                    : tele_mods[prev - E_OP__LENGTH]->name;
+    }
+    return &profile[prev];
+#else
+    return NULL;
+#endif
+}
+
+static const op_profile_t *prof_pop_rank(command_state_t *cs) {
+    int16_t n = cs_pop(cs);
+    if (n < 0 || n >= PROF_RANKS) return NULL;
+    return prof_rank(n, NULL);
+}
+
+static void op_PROF_OP_get(const void *NOTUSED(data),
+                           scene_state_t *NOTUSED(ss),
+                           exec_state_t *NOTUSED(es), command_state_t *cs) {
+    const op_profile_t *p = prof_pop_rank(cs);
+    uint32_t calls = p ? p->calls : 0;
+    cs_push(cs, calls > INT16_MAX ? INT16_MAX : calls);
+}
+
+static void op_PROF_US_get(const void *NOTUSED(data),
+                           scene_state_t *NOTUSED(ss),
+                           exec_state_t *NOTUSED(es), command_state_t *cs) {
+#ifdef TELETYPE_PROFILE
+    const op_profile_t *p = prof_pop_rank(cs);
+    uint32_t us = p ? tele_profile_count_us(p->cycles) : 0;
+    cs_push(cs, us > INT16_MAX ? INT16_MAX : us);
+#else
+    cs_pop(cs);
+    cs_push(cs, 0);
+#endif
+}
+
+static void op_PROF_CLR_get(const void *NOTUSED(data),
+                            scene_state_t *NOTUSED(ss),
+                            exec_state_t *NOTUSED(es),
+                            command_state_t *NOTUSED(cs)) {
+    prof_clear();
+}
@@ -0,0 +1,29 @@
+#ifndef _OPS_PROF_H_
+#define _OPS_PROF_H_
+
+#include "ops/op.h"
+
+extern const tele_op_t op_PROF_OP;
+extern const tele_op_t op_PROF_US;
+extern const tele_op_t op_PROF_CLR;
+
+// calls and time spent per op and mod, the time includes anything they run
+// (e.g. SCRIPT, or the POST of a mod) and is counted in tele_profile_count
+// units
+typedef struct {
+    uint32_t calls;
+    uint32_t cycles;
+} op_profile_t;
+
+#ifdef TELETYPE_PROFILE
+// count a call of op i, or of mod i - E_OP__LENGTH
+void prof_add(uint16_t i, uint32_t cycles);
+#endif
+
+// zero every counter, PROF.CLR does it
+void prof_clear(void);
+
+// the op or mod with the n-th highest time, NULL if fewer than n + 1 have run
+const op_profile_t *prof_rank(uint16_t n, const char **name);
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "helpers.h"
 #include "ii.h"
+#include "ii_queue.h"
 #include "teletype.h"
 #include "teletype_io.h"
 
@@ -355,6 +356,29 @@ const tele_op_t op_TI_PRM_INIT        = MAKE_ALIAS_OP(TI.PRM.INIT       , op_TI_
 // clang-format on
 
 // telex helpers
+
+// commands that only set where an output is heading, a newer one to the same
+// port can replace one that hasn't been sent yet
+static bool is_value_command(uint8_t command) {
+    switch (command) {
+        case TO_CV:
+        case TO_CV_SET:
+        case TO_CV_QT:
+        case TO_CV_QT_SET:
+        case TO_CV_N:
+        case TO_CV_N_SET:
+        case TO_OSC:
+        case TO_OSC_SET:
+        case TO_OSC_QT:
+        case TO_OSC_QT_SET:
+        case TO_OSC_FQ:
+        case TO_OSC_FQ_SET:
+        case TO_OSC_N:
+        case TO_OSC_N_SET: return true;
+        default: return false;
+    }
+}
+
 void SendIt(uint8_t address, uint8_t command, uint8_t port, int16_t value,
             bool set) {
     // init and fill the buffer (make the buffer smaller if we are not sending a
@@ -367,7 +391,10 @@ void SendIt(uint8_t address, uint8_t command, uint8_t port, int16_t value,
         buffer[2] = temp >> 8;
         buffer[3] = temp & 0xff;
     }
-    tele_ii_tx(address, buffer, set ? 4 : 2);
+    if (set && is_value_command(command))
+        ii_tx_value(address, buffer, 4);
+    else
+        ii_tx(address, buffer, set ? 4 : 2);
 }
 
 void TXSend(uint8_t model, uint8_t command, uint8_t output, int16_t value,
@@ -404,11 +431,11 @@ int16_t ReceiveValue(uint8_t address, uint8_t port) {
     // tell the device what value you are going to query
     uint8_t buffer[2];
     buffer[0] = port;
-    tele_ii_tx(address, buffer, 1);
+    ii_tx(address, buffer, 1);
     // now read the value
     buffer[0] = 0;
     buffer[1] = 0;
-    tele_ii_rx(address, buffer, 2);
+    ii_rx(address, buffer, 2);
     int16_t value = (buffer[0] << 8) + buffer[1];
     return value;
 }
@@ -0,0 +1,118 @@
+#include "quantize.h"
+
+#include <stdbool.h>
+#include <stdlib.h>  // abs
+
+#include "helpers.h"
+#include "table.h"
+
+// splits a pitch voltage into an octave and the voltage above it, negative
+// voltages are moved up by 11 octaves first and sign_offset says by how much
+static void split_octave(int16_t v_in, int16_t *octave_in,
+                         int16_t *semitones_in, int16_t *sign_offset) {
+    v_in = normalise_value(-table_n[127], table_n[127], 0, v_in);
+
+    *sign_offset = (v_in < 0) ? 18022 : 0;  // 11 octaves
+    v_in = v_in + *sign_offset;
+
+    *octave_in = v_in / table_n[12];
+    if (v_in <= 18021 && v_in >= 18018) {
+        *octave_in = 10;
+    }  // fix precision error
+    *semitones_in = v_in % table_n[12];
+}
+
+int16_t quantize_to_bitmask_scale(int16_t scale_bits, int16_t transpose,
+                                  int16_t v_in) {
+    if (scale_bits == 0) { return v_in; }  // no active scale bits
+
+    int16_t octave_in, semitones_in, sign_offset;
+    split_octave(v_in, &octave_in, &semitones_in, &sign_offset);
+    transpose = transpose % table_n[12];
+
+    int16_t dist_nearest = INT16_MAX;
+    int16_t note_nearest = INT16_MAX;
+    int16_t try_note, try_distance;
+    for (int16_t i = 0; i < 12; i++) {
+        if (scale_bits & (1 << i)) {
+            for (int16_t j = -2; j <= 2; j++) {
+                try_note = table_n[i] + transpose + (j * table_n[12]);
+                try_distance = abs(try_note - semitones_in);
+                if (try_distance < dist_nearest) {
+                    dist_nearest = try_distance;
+                    note_nearest = try_note;
+                }
+            }
+        }
+    }
+
+    return (note_nearest + table_n[octave_in * 12]) - sign_offset;
+}
+
+void quantize_scale_init(quantize_scale_t *q, int16_t scale_bits) {
+    q->scale_bits = scale_bits;
+    q->count = 0;
+
+    uint8_t degree[QUANTIZE_NOTES];
+    for (int16_t i = 0; i < 12; i++) {
+        if (!(scale_bits & (1 << i))) continue;
+        degree[q->count + 1] = i;
+        q->note[q->count + 1] = table_n[i];
+        q->count++;
+    }
+    if (q->count == 0) return;
+
+    degree[0] = degree[q->count];
+    q->note[0] = q->note[q->count] - table_n[12];
+    degree[q->count + 1] = degree[1];
+    q->note[q->count + 1] = q->note[1] + table_n[12];
+    q->count += 2;
+
+    for (uint8_t i = 1; i < q->count; i++) {
+        int16_t a = q->note[i - 1], b = q->note[i];
+        int16_t mid = a + (b - a) / 2;
+        // quantize_to_bitmask_scale tries the notes by degree and then from
+        // the lowest octave up, halfway between two notes the first one tried
+        // wins
+        bool a_first = degree[i - 1] < degree[i] ||
+                       (degree[i - 1] == degree[i] && a < b);
+        if ((b - a) % 2 || a_first)
+            q->bound[i - 1] = mid + 1;
+        else
+            q->bound[i - 1] = mid;
+    }
+}
+
+int16_t quantize_to_scale(const quantize_scale_t *q, int16_t transpose,
+                          int16_t v_in) {
+    if (q->count == 0) { return v_in; }  // no active scale bits
+
+    int16_t octave_in, semitones_in, sign_offset;
+    split_octave(v_in, &octave_in, &semitones_in, &sign_offset);
+    transpose = transpose % table_n[12];
+
+    // look the input up against the untransposed scale, moved by an octave
+    // if that takes it out of the one the bounds cover
+    int16_t shift = transpose;
+    int16_t r = semitones_in - transpose;
+    if (r < 0) {
+        r += table_n[12];
+        shift -= table_n[12];
+    }
+    else if (r >= table_n[12]) {
+        r -= table_n[12];
+        shift += table_n[12];
+    }
+
+    // the note follows the last bound at or below the input
+    uint8_t lo = 0, hi = q->count - 1;
+    while (lo < hi) {
+        uint8_t mid = (lo + hi) / 2;
+        if (r >= q->bound[mid])
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return (q->note[lo] + shift + table_n[octave_in * 12]) - sign_offset;
+}
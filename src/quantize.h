@@ -0,0 +1,34 @@
+#ifndef _QUANTIZE_H_
+#define _QUANTIZE_H_
+
+#include <stdint.h>
+
+// the notes of a scale in one octave plus its top note an octave down and its
+// bottom note an octave up
+#define QUANTIZE_NOTES 14
+
+// A 12-bit scale mask prepared for quantizing: its notes in order and the
+// inputs where the nearest note changes, so quantizing is a binary search
+// instead of trying every note of the scale in five octaves. The notes repeat
+// every octave, so one prepared scale does for any transpose.
+typedef struct {
+    int16_t scale_bits;
+    uint8_t count;  // 0 for an empty scale, which leaves inputs alone
+    int16_t note[QUANTIZE_NOTES];
+    // inputs from bound[i] up are nearest to note[i + 1]
+    int16_t bound[QUANTIZE_NOTES - 1];
+} quantize_scale_t;
+
+// accepts a 12-bit scale mask (LSB = root) and a pitch voltage, transpose is
+// the voltage for the scale offset. returns the nearest pitch voltage in the
+// scale.
+int16_t quantize_to_bitmask_scale(int16_t scale_bits, int16_t transpose,
+                                  int16_t v_in);
+
+// the same with the scale prepared by quantize_scale_init, gives the same
+// results
+void quantize_scale_init(quantize_scale_t *q, int16_t scale_bits);
+int16_t quantize_to_scale(const quantize_scale_t *q, int16_t transpose,
+                          int16_t v_in);
+
+#endif
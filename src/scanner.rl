@@ -50,15 +50,12 @@ error_t scanner(const char *data, tele_command_t *out,
         action token {
             // token matched
 
-            // copy the matched token to buf
-            char buf[kMaxTokenLength];
+            // match the token in place, it is only copied for the error
             size_t len = te-ts;
             if (len > kMaxTokenLength) len = kMaxTokenLength;
-            memcpy(buf, ts, len);
-            buf[len] = '\0';
 
             tele_data_t tele_data;
-            if (match_token(buf, len, &tele_data)) {
+            if (match_token_span(ts, len, &tele_data)) {
                 // if we have a match, copy data to the the command
                 out->data[out->length] = tele_data;
 
@@ -70,7 +67,10 @@ error_t scanner(const char *data, tele_command_t *out,
             }
             else {
                 // can't match the token, fail
-                strcpy(error_msg, buf);
+                if (len >= TELE_ERROR_MSG_LENGTH)
+                    len = TELE_ERROR_MSG_LENGTH - 1;
+                memcpy(error_msg, ts, len);
+                error_msg[len] = '\0';
                 return E_PARSE;
             }
         }
@@ -1,5 +1,9 @@
 #include "scene_serialization.h"
 
+#include <string.h>
+
+#include "helpers.h"
+#include "script_packing.h"
 #include "teletype.h"
 #include "util.h"
 
@@ -22,118 +26,126 @@ bool check_deserializer(tt_deserializer_t* stream);
 void serialize_grid(tt_serializer_t* stream, scene_state_t* scene);
 void deserialize_grid(tt_deserializer_t* stream, scene_state_t* scene, char c);
 
+// the one sector buffer behind all the (de)serializers below, only one of
+// them runs at a time
+static uint8_t sector[TT_STREAM_BUFFER_SIZE];
+
+// output is collected in sector and handed to the stream a sector at a time,
+// crc covers everything flushed so far
+static struct {
+    tt_serializer_t* stream;
+    uint16_t length;
+    uint32_t crc;
+} out;
+
+static void out_flush(void) {
+    if (out.length == 0) return;
+    out.crc = crc32_update(out.crc, sector, out.length);
+    out.stream->write_buffer(out.stream->data, sector, out.length);
+    out.length = 0;
+}
+
+static void out_char(char c) {
+    if (out.length == TT_STREAM_BUFFER_SIZE) out_flush();
+    sector[out.length++] = c;
+}
+
+static void out_string(const char* str, size_t length) {
+    while (length) {
+        if (out.length == TT_STREAM_BUFFER_SIZE) out_flush();
+        size_t n = TT_STREAM_BUFFER_SIZE - out.length;
+        if (n > length) n = length;
+        memcpy(sector + out.length, str, n);
+        out.length += n;
+        str += n;
+        length -= n;
+    }
+}
+
+// same output as itoa(value, s, 10), without the round trip through a string
+static void out_int(int16_t value, char separator) {
+    char digits[8];
+    uint8_t n = 0;
+    uint16_t v = value < 0 ? -(int32_t)value : value;
+    do {
+        digits[n++] = '0' + v % 10;
+        v /= 10;
+    } while (v);
+    if (value < 0) out_char('-');
+    while (n) out_char(digits[--n]);
+    out_char(separator);
+}
 
 void serialize_scene(tt_serializer_t* stream, scene_state_t* scene,
                      char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS]) {
     if (!check_serializer(stream)) { return; }
+    out.stream = stream;
+    out.length = 0;
 
     char blank = 0;
     for (int l = 0; l < SCENE_TEXT_LINES; l++) {
         size_t line_length = strlen((*text)[l]);
         if (line_length > 0) {
-            stream->write_buffer(stream->data, (uint8_t*)((*text)[l]),
-                                 line_length);
-            stream->write_char(stream->data, '\n');
+            out_string((*text)[l], line_length);
+            out_char('\n');
             blank = 0;
         }
         else if (!blank) {
-            stream->write_char(stream->data, '\n');
+            out_char('\n');
             blank = 1;
         }
     }
 
     char input[36];
     for (int s = 0; s < EDITABLE_SCRIPT_COUNT; s++) {
-        stream->write_char(stream->data, '\n');
-        stream->write_char(stream->data, '\n');
-        stream->write_char(stream->data, '#');
+        out_string("\n\n#", 3);
         if (s == METRO_SCRIPT)
-            stream->write_char(stream->data, 'M');
+            out_char('M');
         else if (s == INIT_SCRIPT)
-            stream->write_char(stream->data, 'I');
+            out_char('I');
         else
-            stream->write_char(stream->data, s + 49);
+            out_char(s + 49);
 
         for (int l = 0; l < ss_get_script_len(scene, s); l++) {
-            stream->write_char(stream->data, '\n');
+            out_char('\n');
             print_command(ss_get_script_command(scene, s, l), input);
-            stream->write_buffer(stream->data, (uint8_t*)input, strlen(input));
+            out_string(input, strlen(input));
         }
     }
 
-    stream->write_char(stream->data, '\n');
-    stream->write_char(stream->data, '\n');
-    stream->write_char(stream->data, '#');
-    stream->write_char(stream->data, 'P');
-    stream->write_char(stream->data, '\n');
-
-    for (int b = 0; b < 4; b++) {
-        itoa(ss_get_pattern_len(scene, b), input, 10);
-        stream->write_buffer(stream->data, (uint8_t*)input, strlen(input));
-        if (b == 3)
-            stream->write_char(stream->data, '\n');
-        else
-            stream->write_char(stream->data, '\t');
-    }
+    out_string("\n\n#P\n", 5);
 
-    for (int b = 0; b < 4; b++) {
-        itoa(ss_get_pattern_wrap(scene, b), input, 10);
-        stream->write_buffer(stream->data, (uint8_t*)input, strlen(input));
-        if (b == 3)
-            stream->write_char(stream->data, '\n');
-        else
-            stream->write_char(stream->data, '\t');
-    }
+    for (int b = 0; b < 4; b++)
+        out_int(ss_get_pattern_len(scene, b), b == 3 ? '\n' : '\t');
 
-    for (int b = 0; b < 4; b++) {
-        itoa(ss_get_pattern_start(scene, b), input, 10);
-        stream->write_buffer(stream->data, (uint8_t*)input, strlen(input));
-        if (b == 3)
-            stream->write_char(stream->data, '\n');
-        else
-            stream->write_char(stream->data, '\t');
-    }
+    for (int b = 0; b < 4; b++)
+        out_int(ss_get_pattern_wrap(scene, b), b == 3 ? '\n' : '\t');
 
-    for (int b = 0; b < 4; b++) {
-        itoa(ss_get_pattern_end(scene, b), input, 10);
-        stream->write_buffer(stream->data, (uint8_t*)input, strlen(input));
-        if (b == 3)
-            stream->write_char(stream->data, '\n');
-        else
-            stream->write_char(stream->data, '\t');
-    }
+    for (int b = 0; b < 4; b++)
+        out_int(ss_get_pattern_start(scene, b), b == 3 ? '\n' : '\t');
+
+    for (int b = 0; b < 4; b++)
+        out_int(ss_get_pattern_end(scene, b), b == 3 ? '\n' : '\t');
 
-    stream->write_char(stream->data, '\n');
+    out_char('\n');
 
     for (int l = 0; l < 64; l++) {
-        for (int b = 0; b < 4; b++) {
-            itoa(ss_get_pattern_val(scene, b, l), input, 10);
-            stream->write_buffer(stream->data, (uint8_t*)input, strlen(input));
-            if (b == 3)
-                stream->write_char(stream->data, '\n');
-            else
-                stream->write_char(stream->data, '\t');
-        }
+        for (int b = 0; b < 4; b++)
+            out_int(ss_get_pattern_val(scene, b, l), b == 3 ? '\n' : '\t');
     }
 
     // serialize grid
 
-    char fvalue[36];
-
-    stream->write_char(stream->data, '\n');
-    stream->write_char(stream->data, '#');
-    stream->write_char(stream->data, 'G');
-    stream->write_char(stream->data, '\n');
+    out_string("\n#G\n", 4);
     for (uint16_t i = 0; i < GRID_BUTTON_COUNT; i++) {
-        stream->write_char(stream->data, '0' + scene->grid.button[i].state);
-        if ((i & 15) == 15) stream->write_char(stream->data, '\n');
-    }
-    stream->write_char(stream->data, '\n');
-    for (uint16_t i = 0; i < GRID_FADER_COUNT; i++) {
-        itoa(scene->grid.fader[i].value, fvalue, 10);
-        stream->write_buffer(stream->data, (uint8_t*)fvalue, strlen(fvalue));
-        stream->write_char(stream->data, (i & 15) == 15 ? '\n' : '\t');
+        out_char('0' + scene->grid.button[i].state);
+        if ((i & 15) == 15) out_char('\n');
     }
+    out_char('\n');
+    for (uint16_t i = 0; i < GRID_FADER_COUNT; i++)
+        out_int(scene->grid.fader[i].value, (i & 15) == 15 ? '\n' : '\t');
+
+    out_flush();
 }
 
 void deserialize_scene(tt_deserializer_t* stream, scene_state_t* scene,
@@ -154,9 +166,19 @@ void deserialize_scene(tt_deserializer_t* stream, scene_state_t* scene,
     char input[32];
     memset(input, 0, sizeof(input));
 
-    while (!stream->eof(stream->data)) {
+    // the stream is read a sector at a time and each byte run through the
+    // state machine below
+    uint16_t length = 0;
+    uint16_t pos = 0;
+
+    while (true) {
+        if (pos == length) {
+            length = stream->read_buffer(stream->data, sector, sizeof(sector));
+            pos = 0;
+            if (length == 0) break;
+        }
         new_line = c == '\n';
-        c = toupper(stream->read_char(stream->data));
+        c = toupper(sector[pos++]);
         // stream->print_dbg_char(c);
 
         // deal with line endings
@@ -345,10 +367,342 @@ void deserialize_scene(tt_deserializer_t* stream, scene_state_t* scene,
 }
 
 bool check_serializer(tt_serializer_t* stream) {
-    return (stream && stream->write_char && stream->write_buffer &&
-            stream->print_dbg);
+    return (stream && stream->write_buffer && stream->print_dbg);
 }
 
 bool check_deserializer(tt_deserializer_t* stream) {
-    return (stream && stream->read_char && stream->eof && stream->print_dbg);
+    return (stream && stream->read_buffer && stream->print_dbg);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// BINARY FORMAT ///////////////////////////////////////////////////////////////
+//
+// A header and a table of sections, the sections in table order and a CRC-32
+// of everything before it. Numbers are little endian.
+//
+//   "TTSC"          magic
+//   u8              version, SCENE_BINARY_VERSION
+//   u8              section count
+//   u16             E_OP__LENGTH, u16 E_MOD__LENGTH of the firmware that
+//                   wrote it, scripts store op numbers so these must match
+//   u8 id, u8 0, u16 length      for every section
+//   sections
+//   u32             CRC-32
+//
+// SECTION_SCRIPTS   the editable scripts in the pack_scripts encoding
+// SECTION_PATTERNS  idx, len, wrap, start, end and the values of each pattern
+// SECTION_GRID      button states a bit each, then a byte per fader value
+// SECTION_TEXT      the description as nul terminated lines, without the
+//                   trailing empty lines
+//
+// Sections with an unknown id are skipped.
+
+#define SECTION_SCRIPTS 1
+#define SECTION_PATTERNS 2
+#define SECTION_GRID 3
+#define SECTION_TEXT 4
+#define SECTION_COUNT 4
+#define SECTION_MAX_COUNT 16
+
+#define PATTERNS_SIZE (PATTERN_COUNT * (5 + PATTERN_LENGTH) * 2)
+#define GRID_BUTTON_BYTES (GRID_BUTTON_COUNT / 8)
+#define GRID_SIZE (GRID_BUTTON_BYTES + GRID_FADER_COUNT)
+
+static const uint8_t binary_magic[4] = { 'T', 'T', 'S', 'C' };
+
+static void out_u16(uint16_t v) {
+    out_char(v & 0xFF);
+    out_char(v >> 8);
+}
+
+static void out_section(uint8_t id, uint16_t length) {
+    out_char(id);
+    out_char(0);
+    out_u16(length);
+}
+
+// text lines up to the last one that isn't empty
+static uint8_t text_line_count(
+    char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS]) {
+    uint8_t lines = SCENE_TEXT_LINES;
+    while (lines > 0 && (*text)[lines - 1][0] == 0) lines--;
+    return lines;
+}
+
+// a text line may fill all SCENE_TEXT_CHARS without a nul, only as much as
+// fits with one is stored
+static uint8_t text_line_length(const char* line) {
+    uint8_t n = 0;
+    while (n < SCENE_TEXT_CHARS - 1 && line[n]) n++;
+    return n;
+}
+
+void serialize_scene_binary(tt_serializer_t* stream, scene_state_t* scene,
+                            char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS]) {
+    if (!check_serializer(stream)) { return; }
+    out.stream = stream;
+    out.length = 0;
+    out.crc = 0xFFFFFFFF;
+
+    uint8_t packed[PACKED_COMMAND_MAX_SIZE];
+    uint16_t scripts_size = 0;
+    for (uint8_t s = 0; s < EDITABLE_SCRIPT_COUNT; s++) {
+        scripts_size++;
+        for (uint8_t l = 0; l < ss_get_script_len(scene, s); l++)
+            scripts_size += pack_command(ss_get_script_command(scene, s, l),
+                                         packed, sizeof(packed));
+    }
+
+    uint8_t lines = text_line_count(text);
+    uint16_t text_size = 0;
+    for (uint8_t l = 0; l < lines; l++)
+        text_size += text_line_length((*text)[l]) + 1;
+
+    out_string((const char*)binary_magic, sizeof(binary_magic));
+    out_char(SCENE_BINARY_VERSION);
+    out_char(SECTION_COUNT);
+    out_u16(E_OP__LENGTH);
+    out_u16(E_MOD__LENGTH);
+    out_section(SECTION_SCRIPTS, scripts_size);
+    out_section(SECTION_PATTERNS, PATTERNS_SIZE);
+    out_section(SECTION_GRID, GRID_SIZE);
+    out_section(SECTION_TEXT, text_size);
+
+    for (uint8_t s = 0; s < EDITABLE_SCRIPT_COUNT; s++) {
+        out_char(ss_get_script_len(scene, s));
+        for (uint8_t l = 0; l < ss_get_script_len(scene, s); l++) {
+            size_t n = pack_command(ss_get_script_command(scene, s, l), packed,
+                                    sizeof(packed));
+            out_string((const char*)packed, n);
+        }
+    }
+
+    for (uint8_t b = 0; b < PATTERN_COUNT; b++) {
+        out_u16(ss_get_pattern_idx(scene, b));
+        out_u16(ss_get_pattern_len(scene, b));
+        out_u16(ss_get_pattern_wrap(scene, b));
+        out_u16(ss_get_pattern_start(scene, b));
+        out_u16(ss_get_pattern_end(scene, b));
+        for (uint8_t i = 0; i < PATTERN_LENGTH; i++)
+            out_u16(ss_get_pattern_val(scene, b, i));
+    }
+
+    for (uint16_t i = 0; i < GRID_BUTTON_BYTES; i++) {
+        uint8_t byte = 0;
+        for (uint8_t bit = 0; bit < 8; bit++)
+            byte |= (scene->grid.button[i * 8 + bit].state != 0) << bit;
+        out_char(byte);
+    }
+    for (uint16_t i = 0; i < GRID_FADER_COUNT; i++)
+        out_char(scene->grid.fader[i].value);
+
+    for (uint8_t l = 0; l < lines; l++) {
+        out_string((*text)[l], text_line_length((*text)[l]));
+        out_char(0);
+    }
+
+    out_flush();
+    uint32_t crc = ~out.crc;
+    out_u16(crc & 0xFFFF);
+    out_u16(crc >> 16);
+    out_flush();
+}
+
+// input is read into sector a sector at a time, crc covers everything taken
+// so far
+static struct {
+    tt_deserializer_t* stream;
+    uint16_t pos;
+    uint16_t length;
+    uint32_t crc;
+} in;
+
+// makes at least n bytes available from in.pos on, unless the stream ends
+// first, and returns how many are available
+static uint16_t in_fill(uint16_t n) {
+    if (in.length - in.pos >= n) return in.length - in.pos;
+    memmove(sector, sector + in.pos, in.length - in.pos);
+    in.length -= in.pos;
+    in.pos = 0;
+    while (in.length < n) {
+        uint16_t r = in.stream->read_buffer(
+            in.stream->data, sector + in.length,
+            TT_STREAM_BUFFER_SIZE - in.length);
+        if (r == 0) break;
+        in.length += r;
+    }
+    return in.length;
+}
+
+static void in_take(uint16_t n) {
+    in.crc = crc32_update(in.crc, sector + in.pos, n);
+    in.pos += n;
+}
+
+static bool in_bytes(uint8_t* data, uint16_t n) {
+    while (n) {
+        uint16_t c = in_fill(1);
+        if (c == 0) return false;
+        if (c > n) c = n;
+        memcpy(data, sector + in.pos, c);
+        in_take(c);
+        data += c;
+        n -= c;
+    }
+    return true;
+}
+
+static bool in_u16(uint16_t* v) {
+    uint8_t b[2];
+    if (!in_bytes(b, 2)) return false;
+    *v = b[0] | (b[1] << 8);
+    return true;
+}
+
+// each section reader consumes exactly size bytes or returns false
+
+// a command read back has to be one the parser could have made, the
+// separator is trusted by the interpreter
+static bool command_ok(const tele_command_t* c) {
+    int8_t separator = -1;
+    for (uint8_t i = 0; i < c->length; i++) {
+        if (c->data[i].tag == PRE_SEP) {
+            separator = i;
+            break;
+        }
+    }
+    if (c->separator != separator) return false;
+    char error_msg[TELE_ERROR_MSG_LENGTH];
+    return validate(c, error_msg) == E_OK;
+}
+
+static bool read_scripts(scene_state_t* scene, uint16_t size) {
+    memset(ss_scripts_ptr(scene), 0, ss_scripts_size(EDITABLE_SCRIPT_COUNT));
+    for (uint8_t s = 0; s < EDITABLE_SCRIPT_COUNT && size; s++) {
+        uint8_t l;
+        if (!in_bytes(&l, 1)) return false;
+        size--;
+        if (l > SCRIPT_MAX_COMMANDS) return false;
+        for (uint8_t i = 0; i < l; i++) {
+            uint16_t n = PACKED_COMMAND_MAX_SIZE;
+            if (n > size) n = size;
+            uint16_t available = in_fill(n);
+            if (available > n) available = n;
+            size_t r = unpack_command(sector + in.pos, available,
+                                      &scene->scripts[s].c[i]);
+            if (r == 0 || !command_ok(&scene->scripts[s].c[i])) return false;
+            in_take(r);
+            size -= r;
+        }
+        scene->scripts[s].l = l;
+    }
+    ss_compile_scripts(scene);
+    return size == 0;
+}
+
+static bool read_patterns(scene_state_t* scene, uint16_t size) {
+    if (size != PATTERNS_SIZE) return false;
+    for (uint8_t b = 0; b < PATTERN_COUNT; b++) {
+        uint16_t v[5];
+        for (uint8_t i = 0; i < 5; i++)
+            if (!in_u16(&v[i])) return false;
+        ss_set_pattern_idx(scene, b, v[0]);
+        ss_set_pattern_len(scene, b, v[1]);
+        ss_set_pattern_wrap(scene, b, v[2]);
+        ss_set_pattern_start(scene, b, v[3]);
+        ss_set_pattern_end(scene, b, v[4]);
+        for (uint8_t i = 0; i < PATTERN_LENGTH; i++) {
+            if (!in_u16(&v[0])) return false;
+            ss_set_pattern_val(scene, b, i, v[0]);
+        }
+    }
+    return true;
+}
+
+static bool read_grid(scene_state_t* scene, uint16_t size) {
+    if (size != GRID_SIZE) return false;
+    uint8_t byte;
+    for (uint16_t i = 0; i < GRID_BUTTON_BYTES; i++) {
+        if (!in_bytes(&byte, 1)) return false;
+        for (uint8_t bit = 0; bit < 8; bit++)
+            scene->grid.button[i * 8 + bit].state = (byte >> bit) & 1;
+    }
+    for (uint16_t i = 0; i < GRID_FADER_COUNT; i++) {
+        if (!in_bytes(&byte, 1)) return false;
+        scene->grid.fader[i].value = byte;
+    }
+    return true;
+}
+
+static bool read_text(char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS],
+                      uint16_t size) {
+    memset(text, 0, SCENE_TEXT_LINES * SCENE_TEXT_CHARS);
+    uint8_t l = 0, p = 0;
+    char c;
+    for (; size; size--) {
+        if (!in_bytes((uint8_t*)&c, 1)) return false;
+        if (c == 0) {
+            l++;
+            p = 0;
+        }
+        else if (l < SCENE_TEXT_LINES && p < SCENE_TEXT_CHARS - 1) {
+            (*text)[l][p++] = c;
+        }
+    }
+    return true;
+}
+
+// reads a scene written by serialize_scene_binary into scene and text.
+// Returns false if the data isn't a scene this version can read or the CRC
+// doesn't match, scene and text may have been partly overwritten by then.
+bool deserialize_scene_binary(
+    tt_deserializer_t* stream, scene_state_t* scene,
+    char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS]) {
+    if (!check_deserializer(stream)) { return false; }
+    in.stream = stream;
+    in.pos = in.length = 0;
+    in.crc = 0xFFFFFFFF;
+
+    uint8_t header[6];
+    if (!in_bytes(header, sizeof(header))) return false;
+    if (memcmp(header, binary_magic, sizeof(binary_magic)) != 0) return false;
+    if (header[4] == 0 || header[4] > SCENE_BINARY_VERSION) return false;
+    uint8_t count = header[5];
+    if (count > SECTION_MAX_COUNT) return false;
+
+    // written by a firmware with a different op table, the text file is needed
+    uint16_t ops, mods;
+    if (!in_u16(&ops) || !in_u16(&mods)) return false;
+    if (ops != E_OP__LENGTH || mods != E_MOD__LENGTH) return false;
+
+    uint8_t ids[SECTION_MAX_COUNT];
+    uint16_t sizes[SECTION_MAX_COUNT];
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t id[2];
+        if (!in_bytes(id, 2) || !in_u16(&sizes[i])) return false;
+        ids[i] = id[0];
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        bool ok;
+        switch (ids[i]) {
+            case SECTION_SCRIPTS: ok = read_scripts(scene, sizes[i]); break;
+            case SECTION_PATTERNS: ok = read_patterns(scene, sizes[i]); break;
+            case SECTION_GRID: ok = read_grid(scene, sizes[i]); break;
+            case SECTION_TEXT: ok = read_text(text, sizes[i]); break;
+            default:
+                ok = true;
+                for (uint16_t n = sizes[i]; n && ok; n--) {
+                    uint8_t skip;
+                    ok = in_bytes(&skip, 1);
+                }
+                break;
+        }
+        if (!ok) return false;
+    }
+
+    uint32_t crc = ~in.crc;
+    uint16_t lo, hi;
+    if (!in_u16(&lo) || !in_u16(&hi)) return false;
+    return (lo | ((uint32_t)hi << 16)) == crc;
 }
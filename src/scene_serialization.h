@@ -9,3 +9,12 @@ void serialize_scene(tt_serializer_t* stream, scene_state_t* scene,
                      char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS]);
 void deserialize_scene(tt_deserializer_t* stream, scene_state_t* scene,
                        char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS]);
+
+// a versioned binary container for the same data, with a CRC, which loads
+// without parsing any script text
+#define SCENE_BINARY_VERSION 1
+
+void serialize_scene_binary(tt_serializer_t* stream, scene_state_t* scene,
+                            char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS]);
+bool deserialize_scene_binary(tt_deserializer_t* stream, scene_state_t* scene,
+                              char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS]);
@@ -0,0 +1,148 @@
+#include "script_packing.h"
+
+#include <string.h>  // memset
+
+#include "ops/op.h"
+
+#define PACKED_TAG_SHIFT 5
+#define PACKED_SMALL_MAX 30
+#define PACKED_ESCAPE 31
+#define PACKED_COMMENT 0x80
+
+// writes one command into out, returns the number of bytes written or 0 if
+// it doesn't fit in size
+size_t pack_command(const tele_command_t *c, uint8_t *out, size_t size) {
+    if (size < 2) return 0;
+    out[0] = c->length | (c->comment ? PACKED_COMMENT : 0);
+    out[1] = (uint8_t)c->separator;
+    size_t n = 2;
+
+    for (uint8_t i = 0; i < c->length; i++) {
+        const tele_word_t tag = c->data[i].tag;
+        const uint16_t value = (uint16_t)c->data[i].value;
+        const uint8_t head = tag << PACKED_TAG_SHIFT;
+
+        if (tag == PRE_SEP || tag == SUB_SEP) {
+            if (n + 1 > size) return 0;
+            out[n++] = head;
+        }
+        else if (tag == OP) {
+            if (n + 2 > size) return 0;
+            out[n++] = head | (value >> 8);
+            out[n++] = value & 0xFF;
+        }
+        else if (value <= PACKED_SMALL_MAX) {
+            if (n + 1 > size) return 0;
+            out[n++] = head | value;
+        }
+        else {
+            if (n + 3 > size) return 0;
+            out[n++] = head | PACKED_ESCAPE;
+            out[n++] = value & 0xFF;
+            out[n++] = value >> 8;
+        }
+    }
+
+    return n;
+}
+
+// reads one command from in, returns the number of bytes read or 0 if in
+// doesn't hold a whole, valid command
+size_t unpack_command(const uint8_t *in, size_t len, tele_command_t *c) {
+    if (len < 2) return 0;
+    c->length = in[0] & ~PACKED_COMMENT;
+    c->comment = (in[0] & PACKED_COMMENT) != 0;
+    c->separator = (int8_t)in[1];
+    if (c->length > COMMAND_MAX_LENGTH) return 0;
+    size_t n = 2;
+
+    for (uint8_t i = 0; i < c->length; i++) {
+        if (n >= len) return 0;
+        const uint8_t head = in[n++];
+        const tele_word_t tag = head >> PACKED_TAG_SHIFT;
+        const uint8_t small = head & PACKED_ESCAPE;
+        c->data[i].tag = tag;
+
+        if (tag == PRE_SEP || tag == SUB_SEP) { c->data[i].value = 0; }
+        else if (tag == OP) {
+            if (n >= len) return 0;
+            uint16_t op = (small << 8) | in[n++];
+            if (op >= E_OP__LENGTH) return 0;
+            c->data[i].value = op;
+        }
+        else if (small != PACKED_ESCAPE) {
+            c->data[i].value = small;
+        }
+        else {
+            if (n + 2 > len) return 0;
+            c->data[i].value = (int16_t)(in[n] | (in[n + 1] << 8));
+            n += 2;
+        }
+
+        if (tag == MOD && c->data[i].value >= E_MOD__LENGTH) return 0;
+    }
+
+    return n;
+}
+
+// writes the editable scripts into out, each as its length followed by its
+// commands. Returns the number of bytes written. If they don't all fit in
+// size, the scripts are cut short at the last command that fits and any that
+// follow are left out.
+size_t pack_scripts(scene_state_t *ss, uint8_t *out, size_t size) {
+    size_t n = 0;
+    for (uint8_t s = 0; s < EDITABLE_SCRIPT_COUNT; s++) {
+        if (n >= size) {
+            // no room left for the length of the remaining scripts
+            return n;
+        }
+        const size_t len_pos = n++;
+        uint8_t l = 0;
+        for (; l < ss_get_script_len(ss, s); l++) {
+            size_t w = pack_command(ss_get_script_command(ss, s, l), out + n,
+                                    size - n);
+            if (w == 0) break;
+            n += w;
+        }
+        out[len_pos] = l;
+        if (l < ss_get_script_len(ss, s)) break;
+    }
+    return n;
+}
+
+// the number of bytes pack_scripts needs to write all of the editable scripts
+size_t packed_scripts_size(scene_state_t *ss) {
+    uint8_t scratch[PACKED_COMMAND_MAX_SIZE];
+    size_t n = 0;
+    for (uint8_t s = 0; s < EDITABLE_SCRIPT_COUNT; s++) {
+        n++;
+        for (uint8_t l = 0; l < ss_get_script_len(ss, s); l++)
+            n += pack_command(ss_get_script_command(ss, s, l), scratch,
+                              sizeof(scratch));
+    }
+    return n;
+}
+
+// reads scripts written by pack_scripts straight into ss and compiles them,
+// scripts missing from in are left empty. Returns the number of bytes read.
+size_t unpack_scripts(const uint8_t *in, size_t len, scene_state_t *ss) {
+    memset(ss_scripts_ptr(ss), 0, ss_scripts_size(EDITABLE_SCRIPT_COUNT));
+
+    size_t n = 0;
+    for (uint8_t s = 0; s < EDITABLE_SCRIPT_COUNT && n < len; s++) {
+        uint8_t l = in[n++];
+        if (l > SCRIPT_MAX_COMMANDS) l = 0;
+        uint8_t read = 0;
+        for (; read < l; read++) {
+            size_t r = unpack_command(in + n, len - n, &ss->scripts[s].c[read]);
+            if (r == 0) break;
+            n += r;
+        }
+        ss->scripts[s].l = read;
+        // a bad command means the rest can't be trusted either
+        if (read < l) break;
+    }
+
+    ss_compile_scripts(ss);
+    return n;
+}
@@ -0,0 +1,37 @@
+#ifndef _SCRIPT_PACKING_H_
+#define _SCRIPT_PACKING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "command.h"
+#include "state.h"
+
+// A compact binary encoding of script commands, used to store scenes in
+// flash.
+//
+// A command is a header of 2 bytes (length with the comment flag in the top
+// bit, then the separator) followed by its words. Each word starts with a
+// byte holding the tag in the top 3 bits and 5 bits of value:
+//
+//   OP                   13 bit op index, the low 8 bits in a second byte
+//   everything else      values 0 - 30 in the 5 bits, otherwise 31 followed
+//                        by the 16 bit value, low byte first
+//
+// Separators carry no value. A line typed into the editor packs into about 34
+// bytes, but scenes loaded from USB can hold longer commands, so
+// SCRIPT_PACKED_MAX_SIZE allows for every word of every command to be
+// escaped. pack_scripts never needs more than that, packed_scripts_size says
+// how much a scene needs.
+#define PACKED_COMMAND_MAX_SIZE (2 + 3 * COMMAND_MAX_LENGTH)
+#define SCRIPT_PACKED_MAX_SIZE \
+    (EDITABLE_SCRIPT_COUNT * (1 + SCRIPT_MAX_COMMANDS * PACKED_COMMAND_MAX_SIZE))
+
+size_t pack_command(const tele_command_t *c, uint8_t *out, size_t size);
+size_t unpack_command(const uint8_t *in, size_t len, tele_command_t *c);
+
+size_t pack_scripts(scene_state_t *ss, uint8_t *out, size_t size);
+size_t packed_scripts_size(scene_state_t *ss);
+size_t unpack_scripts(const uint8_t *in, size_t len, scene_state_t *ss);
+
+#endif
@@ -4,18 +4,23 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+// serialize_scene and deserialize_scene buffer the stream internally and
+// only call write_buffer and read_buffer with blocks of up to this many
+// bytes, one FAT sector
+#define TT_STREAM_BUFFER_SIZE 512
+
 typedef struct {
     void (*write_buffer)(void* self_data, uint8_t* buffer, uint16_t size);
-    void (*write_char)(void* self_data, uint8_t c);
     void (*print_dbg)(const char* str);
     void* data;
 } tt_serializer_t;
 
 typedef struct {
-    uint16_t (*read_char)(void* self_data);
-    bool (*eof)(void* self_data);
+    // reads up to size bytes into buffer, returns the number read, 0 at the
+    // end of the stream
+    uint16_t (*read_buffer)(void* self_data, uint8_t* buffer, uint16_t size);
     void (*print_dbg)(const char* str);
     void* data;
 } tt_deserializer_t;
 
-#endif  // _TT_SERIALIZER_H
\ No newline at end of file
+#endif  // _TT_SERIALIZER_H
@@ -4,8 +4,38 @@
 #include <string.h>
 
 #include "helpers.h"
+#include "ops/op.h"
 #include "teletype_io.h"
 
+////////////////////////////////////////////////////////////////////////////////
+// COMPILED SCRIPTS ////////////////////////////////////////////////////////////
+
+// Script lines compiled by compile_command, for one scene at a time. They're
+// kept out of scene_state_t so that the scenes put on the stack to load and
+// save don't carry them. A scene that runs a line compiled for another one
+// takes the cache over and compiles its lines again as they run.
+static tele_compiled_t compiled[TOTAL_SCRIPT_COUNT][SCRIPT_MAX_COMMANDS];
+static const scene_state_t *compiled_owner = NULL;
+static uint8_t compiled_valid[TOTAL_SCRIPT_COUNT];  // a bit per line
+
+// private
+static void ss_compiled_forget(scene_state_t *ss) {
+    if (compiled_owner != ss) return;
+    compiled_owner = NULL;
+}
+
+// private
+static void ss_compile_line(scene_state_t *ss, uint8_t script_idx,
+                            uint8_t c_idx) {
+    if (compiled_owner != ss) {
+        compiled_owner = ss;
+        memset(compiled_valid, 0, sizeof(compiled_valid));
+    }
+    compile_command(&compiled[script_idx][c_idx],
+                    &ss->scripts[script_idx].c[c_idx]);
+    compiled_valid[script_idx] |= 1 << c_idx;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // SCENE STATE /////////////////////////////////////////////////////////////////
 
@@ -17,13 +47,14 @@ void ss_init(scene_state_t *ss) {
     ss_grid_init(ss);
     ss_rand_init(ss);
     ss_midi_init(ss);
-    ss->delay.count = 0;
-    for (size_t i = 0; i < NB_NBX_SCALES; i++) {
-        ss->variables.n_scale_bits[i] = bit_reverse(0b101011010101, 12);
-        ss->variables.n_scale_root[i] = 0;
-    }
+    // the epoch is left as it was, ss_delay_init moves it on so that a tick
+    // running an INIT from a delayed command notices
+    ss_delay_init(ss);
+    for (size_t i = 0; i < NB_NBX_SCALES; i++)
+        ss_set_n_scale(ss, i, bit_reverse(0b101011010101, 12), 0);
     ss->stack_op.top = 0;
     memset(&ss->scripts, 0, ss_scripts_size(TOTAL_SCRIPT_COUNT));
+    ss_compiled_forget(ss);
     turtle_init(&ss->turtle);
     uint32_t ticks = tele_get_ticks();
     for (size_t i = 0; i < EDITABLE_SCRIPT_COUNT; i++)
@@ -86,6 +117,8 @@ void ss_variables_init(scene_state_t *ss) {
     ss_update_param_scale(ss);
     ss_update_in_scale(ss);
     ss_update_fader_scale_all(ss);
+    for (size_t i = 0; i < NB_NBX_SCALES; i++)
+        ss->n_scale_cache[i].valid = false;
 }
 
 void ss_patterns_init(scene_state_t *ss) {
@@ -109,11 +142,13 @@ void ss_pattern_init(scene_state_t *ss, size_t pattern_no) {
 void ss_grid_init(scene_state_t *ss) {
     ss->grid.rotate = 0;
     ss->grid.dim = 0;
+    ss->grid.index_dirty = 1;
 
     ss->grid.current_group = 0;
     ss->grid.latest_group = 0;
     ss->grid.latest_button = 0;
     ss->grid.latest_fader = 0;
+    ss->grid.slide_head = GRID_FADER_NONE;
 
     for (u8 i = 0; i < GRID_MAX_DIMENSION; i++)
         for (u8 j = 0; j < GRID_MAX_DIMENSION; j++)
@@ -137,6 +172,7 @@ void ss_grid_init(scene_state_t *ss) {
         ss->grid.fader[i].type = FADER_CH_BAR;
         ss->grid.fader[i].value = 0;
         ss->grid.fader[i].slide = 0;
+        ss->grid.fader[i].slide_listed = 0;
     }
 
     for (u8 i = 0; i < GRID_XYPAD_COUNT; i++) {
@@ -203,6 +239,50 @@ void ss_midi_init(scene_state_t *ss) {
 
 void ss_cal_init(scene_state_t *ss) {
     ss->cal = blank_cal_data;
+    ss->cal_dirty = false;
+    ss->cal_save_in = 0;
+}
+
+// saving calibration writes flash, so the setters only mark it as changed and
+// it's saved once CAL_SAVE_DELAY_MS passes without another change, a script
+// calibrating in a loop costs one write
+static void ss_cal_changed(scene_state_t *ss) {
+    ss->cal_dirty = true;
+    ss->cal_save_in = CAL_SAVE_DELAY_MS;
+}
+
+void ss_cal_tick(scene_state_t *ss, uint8_t time) {
+    if (!ss->cal_dirty) return;
+    ss->cal_save_in -= time;
+    if (ss->cal_save_in <= 0) ss_cal_commit(ss);
+}
+
+// saves calibration now if it has changed
+void ss_cal_commit(scene_state_t *ss) {
+    if (!ss->cal_dirty) return;
+    ss->cal_dirty = false;
+    ss->cal_save_in = 0;
+    tele_save_calibration();
+}
+
+// delay
+
+void ss_delay_init(scene_state_t *ss) {
+    scene_delay_t *d = &ss->delay;
+    d->count = 0;
+    // hand out the lowest slots first, like the old first-empty-slot search
+    for (uint8_t i = 0; i < DELAY_SIZE; i++) {
+        d->free[i] = DELAY_SIZE - 1 - i;
+        // slots popped by a tick that is still running must not look pending
+        d->prev[i] = DELAY_NONE;
+        d->next[i] = DELAY_NONE;
+        d->heap_pos[i] = DELAY_NONE;
+    }
+    d->free_count = DELAY_SIZE;
+    for (uint8_t i = 0; i <= NO_SCRIPT; i++) d->script_head[i] = DELAY_NONE;
+    d->epoch++;
+    d->now = 0;
+    d->next_seq = 0;
 }
 
 // Hardware
@@ -299,6 +379,170 @@ size_t ss_patterns_size() {
     return sizeof(scene_pattern_t) * PATTERN_COUNT;
 }
 
+// delay scheduling
+
+// private
+static bool ss_delay_before(scene_delay_t *d, uint8_t a, uint8_t b) {
+    // compare via the difference so that wrapping clocks still order correctly
+    int32_t diff = (int32_t)(d->due[a] - d->due[b]);
+    if (diff != 0) return diff < 0;
+    return (int32_t)(d->seq[a] - d->seq[b]) < 0;
+}
+
+// private
+static void ss_delay_heap_set(scene_delay_t *d, uint8_t pos, uint8_t slot) {
+    d->heap[pos] = slot;
+    d->heap_pos[slot] = pos;
+}
+
+// private
+static void ss_delay_sift_up(scene_delay_t *d, uint8_t pos) {
+    uint8_t slot = d->heap[pos];
+    while (pos > 0) {
+        uint8_t parent = (pos - 1) / 2;
+        if (!ss_delay_before(d, slot, d->heap[parent])) break;
+        ss_delay_heap_set(d, pos, d->heap[parent]);
+        pos = parent;
+    }
+    ss_delay_heap_set(d, pos, slot);
+}
+
+// private
+static void ss_delay_sift_down(scene_delay_t *d, uint8_t pos) {
+    while (true) {
+        uint8_t smallest = pos;
+        uint8_t l = 2 * pos + 1;
+        uint8_t r = 2 * pos + 2;
+        if (l < d->count && ss_delay_before(d, d->heap[l], d->heap[smallest]))
+            smallest = l;
+        if (r < d->count && ss_delay_before(d, d->heap[r], d->heap[smallest]))
+            smallest = r;
+        if (smallest == pos) return;
+        uint8_t tmp = d->heap[pos];
+        ss_delay_heap_set(d, pos, d->heap[smallest]);
+        ss_delay_heap_set(d, smallest, tmp);
+        pos = smallest;
+    }
+}
+
+// private
+static void ss_delay_heap_remove(scene_delay_t *d, uint8_t pos) {
+    d->heap_pos[d->heap[pos]] = DELAY_NONE;
+    d->count--;
+    if (pos == d->count) return;
+
+    // the last entry fills the hole, it can belong above or below it
+    uint8_t slot = d->heap[d->count];
+    ss_delay_heap_set(d, pos, slot);
+    ss_delay_sift_up(d, pos);
+    ss_delay_sift_down(d, d->heap_pos[slot]);
+}
+
+// private
+static void ss_delay_link(scene_delay_t *d, uint8_t slot) {
+    uint8_t *head = &d->script_head[d->origin_script[slot]];
+    d->prev[slot] = DELAY_NONE;
+    d->next[slot] = *head;
+    if (*head != DELAY_NONE) d->prev[*head] = slot;
+    *head = slot;
+}
+
+// private
+static void ss_delay_unlink(scene_delay_t *d, uint8_t slot) {
+    if (d->prev[slot] != DELAY_NONE)
+        d->next[d->prev[slot]] = d->next[slot];
+    else
+        d->script_head[d->origin_script[slot]] = d->next[slot];
+    if (d->next[slot] != DELAY_NONE) d->prev[d->next[slot]] = d->prev[slot];
+    d->prev[slot] = DELAY_NONE;
+    d->next[slot] = DELAY_NONE;
+}
+
+// queue cmd to run delay_time ms from now, returns the slot used or -1 if all
+// slots are taken
+int16_t ss_delay_schedule(scene_state_t *ss, int16_t delay_time,
+                          uint8_t origin_script, int16_t origin_i,
+                          const tele_command_view_t *cmd) {
+    scene_delay_t *d = &ss->delay;
+    if (d->free_count == 0) return -1;
+    if (delay_time < 1) delay_time = 1;
+    if (origin_script > NO_SCRIPT) origin_script = NO_SCRIPT;
+
+    uint8_t slot = d->free[--d->free_count];
+    d->due[slot] = d->now + delay_time;
+    d->seq[slot] = d->next_seq++;
+    d->origin_script[slot] = origin_script;
+    d->origin_i[slot] = origin_i;
+    copy_command_view(&d->commands[slot], cmd);
+    ss_delay_link(d, slot);
+
+    ss_delay_heap_set(d, d->count, slot);
+    ss_delay_sift_up(d, d->count++);
+
+    return slot;
+}
+
+// remove the earliest delay if it's due and return its slot, otherwise -1
+// the slot stays reserved (and pending) until ss_delay_release is called, so
+// that its command can be run without being overwritten by a new delay
+int16_t ss_delay_pop_due(scene_state_t *ss) {
+    scene_delay_t *d = &ss->delay;
+    if (d->count == 0) return -1;
+
+    uint8_t slot = d->heap[0];
+    if ((int32_t)(d->due[slot] - d->now) > 0) return -1;
+
+    ss_delay_heap_remove(d, 0);
+    return slot;
+}
+
+void ss_delay_release(scene_state_t *ss, uint8_t slot) {
+    scene_delay_t *d = &ss->delay;
+    if (ss_delay_pending(ss, slot)) ss_delay_unlink(d, slot);
+    // every slot is already free if the delays were cleared since the pop
+    if (d->free_count == DELAY_SIZE) return;
+    d->free[d->free_count++] = slot;
+}
+
+// a delay is pending from when it's scheduled until it's released or
+// cancelled, which is exactly while it's on its script's list
+bool ss_delay_pending(scene_state_t *ss, uint8_t slot) {
+    scene_delay_t *d = &ss->delay;
+    return d->prev[slot] != DELAY_NONE ||
+           d->script_head[d->origin_script[slot]] == slot;
+}
+
+// a delay that has been popped but not run yet is only marked as cancelled,
+// the tick that popped it releases the slot
+void ss_delay_cancel(scene_state_t *ss, uint8_t slot) {
+    scene_delay_t *d = &ss->delay;
+    ss_delay_unlink(d, slot);
+    if (d->heap_pos[slot] == DELAY_NONE) return;
+    ss_delay_heap_remove(d, d->heap_pos[slot]);
+    if (d->free_count < DELAY_SIZE) d->free[d->free_count++] = slot;
+}
+
+// cancels every pending delay queued by script, returns how many there were
+uint8_t ss_delay_cancel_script(scene_state_t *ss, uint8_t script) {
+    if (script > NO_SCRIPT) return 0;
+    uint8_t count = 0;
+    uint8_t slot;
+    while ((slot = ss->delay.script_head[script]) != DELAY_NONE) {
+        ss_delay_cancel(ss, slot);
+        count++;
+    }
+    return count;
+}
+
+uint8_t ss_delay_script_count(scene_state_t *ss, uint8_t script) {
+    if (script > NO_SCRIPT) return 0;
+    uint8_t count = 0;
+    for (uint8_t slot = ss->delay.script_head[script]; slot != DELAY_NONE;
+         slot = ss->delay.next[slot])
+        count++;
+    return count;
+}
+
 // script manipulation
 
 uint8_t ss_get_script_len(scene_state_t *ss, uint8_t idx) {
@@ -320,10 +564,28 @@ void ss_copy_script_command(tele_command_t *dest, scene_state_t *ss,
     memcpy(dest, &ss->scripts[script_idx].c[c_idx], sizeof(tele_command_t));
 }
 
+// runs the script lines from their compiled copies, when they've been compiled
+// for the scene that is running them
+const tele_compiled_t *ss_get_script_compiled(scene_state_t *ss,
+                                              uint8_t script_idx,
+                                              size_t c_idx) {
+    if (compiled_owner != ss || !(compiled_valid[script_idx] & (1 << c_idx)))
+        ss_compile_line(ss, script_idx, c_idx);
+    return &compiled[script_idx][c_idx];
+}
+
+// must be called after writing to ss_scripts_ptr directly
+void ss_compile_scripts(scene_state_t *ss) {
+    for (size_t s = 0; s < TOTAL_SCRIPT_COUNT; s++)
+        for (size_t c = 0; c < SCRIPT_MAX_COMMANDS; c++)
+            ss_compile_line(ss, s, c);
+}
+
 // private
 static void ss_set_script_command(scene_state_t *ss, uint8_t script_idx,
                                   size_t c_idx, const tele_command_t *cmd) {
     memcpy(&ss->scripts[script_idx].c[c_idx], cmd, sizeof(tele_command_t));
+    ss_compile_line(ss, script_idx, c_idx);
 }
 
 bool ss_get_script_comment(scene_state_t *ss, uint8_t script_idx,
@@ -406,6 +668,7 @@ void ss_delete_script_command(scene_state_t *ss, uint8_t script_idx,
 
         tele_command_t blank_command;
         blank_command.length = 0;
+        blank_command.separator = -1;
         blank_command.comment = false;
         ss_set_script_command(ss, script_idx, script_len, &blank_command);
     }
@@ -413,6 +676,7 @@ void ss_delete_script_command(scene_state_t *ss, uint8_t script_idx,
 
 void ss_clear_script(scene_state_t *ss, size_t script_idx) {
     memset(&ss->scripts[script_idx], 0, sizeof(scene_script_t));
+    if (compiled_owner == ss) compiled_valid[script_idx] = 0;
     ss->variables.j[script_idx] = 0;
     ss->variables.k[script_idx] = 0;
 }
@@ -523,6 +787,13 @@ void ss_set_in_scale(scene_state_t *ss, int16_t min, int16_t max) {
     ss_update_in_scale(ss);
 }
 
+void ss_set_n_scale(scene_state_t *ss, uint8_t scale_nb, int16_t scale_bits,
+                    int16_t root) {
+    ss->variables.n_scale_bits[scale_nb] = scale_bits;
+    ss->variables.n_scale_root[scale_nb] = root;
+    ss->n_scale_cache[scale_nb].valid = false;
+}
+
 void ss_set_fader_scale(scene_state_t *ss, int16_t fader, int16_t min,
                         int16_t max) {
     ss->variables.fader_ranges[fader].out_min = min;
@@ -557,39 +828,39 @@ int16_t ss_get_fader_max(scene_state_t *ss, int16_t fader) {
 void ss_set_param_min(scene_state_t *ss, int16_t min) {
     ss->cal.p_min = min;
     ss_update_param_scale(ss);
-    tele_save_calibration();
+    ss_cal_changed(ss);
 }
 
 void ss_set_param_max(scene_state_t *ss, int16_t max) {
     ss->cal.p_max = max;
     ss_update_param_scale(ss);
-    tele_save_calibration();
+    ss_cal_changed(ss);
 }
 
 void ss_set_fader_min(scene_state_t *ss, int16_t fader, int16_t min) {
     ss->cal.f_min[fader] = min;
     ss_update_fader_scale(ss, fader);
-    tele_save_calibration();
+    ss_cal_changed(ss);
 }
 
 void ss_set_fader_max(scene_state_t *ss, int16_t fader, int16_t max) {
     ss->cal.f_max[fader] = max;
     ss_update_fader_scale(ss, fader);
-    tele_save_calibration();
+    ss_cal_changed(ss);
 }
 
 void ss_reset_param_cal(scene_state_t *ss) {
     ss->cal.p_max = 16383;
     ss->cal.p_min = 0;
     ss_update_param_scale(ss);
-    tele_save_calibration();
+    ss_cal_changed(ss);
 }
 
 void ss_reset_fader_cal(scene_state_t *ss, int16_t fader) {
     ss->cal.f_max[fader] = 16383;
     ss->cal.f_min[fader] = 0;
     ss_update_fader_scale(ss, fader);
-    tele_save_calibration();
+    ss_cal_changed(ss);
 }
 
 int16_t ss_get_in_min(scene_state_t *ss) {
@@ -603,20 +874,20 @@ int16_t ss_get_in_max(scene_state_t *ss) {
 void ss_set_in_min(scene_state_t *ss, int16_t min) {
     ss->cal.i_min = min;
     ss_update_in_scale(ss);
-    tele_save_calibration();
+    ss_cal_changed(ss);
 }
 
 void ss_set_in_max(scene_state_t *ss, int16_t max) {
     ss->cal.i_max = max;
     ss_update_in_scale(ss);
-    tele_save_calibration();
+    ss_cal_changed(ss);
 }
 
 void ss_reset_in_cal(scene_state_t *ss) {
     ss->cal.i_max = 16383;
     ss->cal.i_min = 0;
     ss_update_in_scale(ss);
-    tele_save_calibration();
+    ss_cal_changed(ss);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -7,6 +7,8 @@
 
 #include "command.h"
 #include "every.h"
+#include "ops/op_enum.h"
+#include "quantize.h"
 #include "random.h"
 #include "scale.h"
 #include "script.h"
@@ -31,6 +33,7 @@
 #define GRID_MAX_DIMENSION 16
 #define GRID_BUTTON_COUNT 256
 #define GRID_FADER_COUNT 64
+#define GRID_FADER_NONE 0xFF
 #define GRID_XYPAD_COUNT 8
 #define LED_DIM -1
 #define LED_BRI -2
@@ -55,6 +58,9 @@
 
 #define NB_NBX_SCALES 16
 
+// calibration is saved once it has stopped changing for this long
+#define CAL_SAVE_DELAY_MS 1000
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // SCENE STATE /////////////////////////////////////////////////////////////////
@@ -127,13 +133,31 @@ typedef struct {
     int16_t val[PATTERN_LENGTH];
 } scene_pattern_t;
 
+// Pending delays live in a binary min-heap of slot indices ordered by due
+// time, so a tick only has to look at the delays that are actually due.
+// Unused slots are kept on a free stack. Every pending delay is also on a
+// doubly linked list for the script that queued it, so that one script's
+// delays can be cancelled without touching the others.
+#define DELAY_NONE 0xFF
+
 typedef struct {
     // TODO add a delay variables struct?
     tele_command_t commands[DELAY_SIZE];
-    int16_t time[DELAY_SIZE];
+    uint32_t due[DELAY_SIZE];  // absolute time, in ms, on the delay.now clock
+    uint32_t seq[DELAY_SIZE];  // scheduling order, used to order ties
     uint8_t origin_script[DELAY_SIZE];
     int16_t origin_i[DELAY_SIZE];
-    uint8_t count;
+    uint8_t heap[DELAY_SIZE];
+    uint8_t heap_pos[DELAY_SIZE];  // DELAY_NONE once popped
+    uint8_t script_head[TOTAL_SCRIPT_COUNT + 1];  // indexed up to NO_SCRIPT
+    uint8_t next[DELAY_SIZE];
+    uint8_t prev[DELAY_SIZE];
+    uint8_t free[DELAY_SIZE];
+    uint8_t free_count;
+    uint8_t count;  // number of pending delays (size of the heap)
+    uint8_t epoch;  // bumped every time the delays are cleared
+    uint32_t now;
+    uint32_t next_seq;
 } scene_delay_t;
 
 typedef struct {
@@ -179,6 +203,10 @@ typedef struct {
     u8 slide_end;
     u8 slide_delta;
     u8 slide_dir;
+    // faders with slide set are kept in a list ordered by index, a fader
+    // stays listed until the slew timer finds slide cleared
+    u8 slide_listed;
+    u8 slide_next;
 } grid_fader_t;
 
 typedef struct {
@@ -190,6 +218,7 @@ typedef struct {
 typedef struct {
     u8 grid_dirty;
     u8 scr_dirty;
+    u8 index_dirty;  // controls were moved, enabled or disabled
     u8 clear_held;
 
     u8 rotate;
@@ -199,6 +228,7 @@ typedef struct {
     u8 latest_group;
     u8 latest_button;
     u8 latest_fader;
+    u8 slide_head;  // first fader in the slide list
 
     s8 leds[GRID_MAX_DIMENSION][GRID_MAX_DIMENSION];
     grid_group_t group[GRID_GROUP_COUNT];
@@ -255,9 +285,19 @@ typedef union {
     tele_rand_t a[RAND_STATES_COUNT];
 } scene_rand_t;
 
+// an N.B / N.BX scale prepared for QT.B and QT.BX
+typedef struct {
+    bool valid;
+    int16_t transpose;  // n_scale_root as a voltage
+    quantize_scale_t scale;
+} n_scale_cache_t;
+
 typedef struct {
     bool initializing;
     scene_variables_t variables;
+    // built from n_scale_bits and n_scale_root when first quantized to, and
+    // marked out of date by ss_set_n_scale
+    n_scale_cache_t n_scale_cache[NB_NBX_SCALES];
     scene_pattern_t patterns[PATTERN_COUNT];
     scene_delay_t delay;
     scene_stack_op_t stack_op;
@@ -267,6 +307,9 @@ typedef struct {
     scene_grid_t grid;
     scene_rand_t rand_states;
     cal_data_t cal;
+    // set by the calibration setters until tele_save_calibration is called
+    bool cal_dirty;
+    int16_t cal_save_in;
     int8_t i2c_op_address;
     scene_midi_t midi;
 } scene_state_t;
@@ -280,6 +323,7 @@ extern void ss_grid_common_init(grid_common_t *gc);
 extern void ss_rand_init(scene_state_t *ss);
 extern void ss_midi_init(scene_state_t *ss);
 extern void ss_cal_init(scene_state_t *ss);
+extern void ss_delay_init(scene_state_t *ss);
 
 extern void ss_set_in(scene_state_t *ss, int16_t value);
 extern void ss_set_param(scene_state_t *ss, int16_t value);
@@ -309,11 +353,24 @@ extern void ss_set_pattern_val(scene_state_t *ss, size_t pattern, size_t idx,
 extern scene_pattern_t *ss_patterns_ptr(scene_state_t *ss);
 extern size_t ss_patterns_size(void);
 
+extern int16_t ss_delay_schedule(scene_state_t *ss, int16_t delay_time,
+                                 uint8_t origin_script, int16_t origin_i,
+                                 const tele_command_view_t *cmd);
+extern int16_t ss_delay_pop_due(scene_state_t *ss);
+extern void ss_delay_release(scene_state_t *ss, uint8_t slot);
+extern bool ss_delay_pending(scene_state_t *ss, uint8_t slot);
+extern void ss_delay_cancel(scene_state_t *ss, uint8_t slot);
+extern uint8_t ss_delay_cancel_script(scene_state_t *ss, uint8_t script);
+extern uint8_t ss_delay_script_count(scene_state_t *ss, uint8_t script);
+
 uint8_t ss_get_script_len(scene_state_t *ss, uint8_t idx);
 const tele_command_t *ss_get_script_command(scene_state_t *ss,
                                             uint8_t script_idx, size_t c_idx);
 void ss_copy_script_command(tele_command_t *dest, scene_state_t *ss,
                             uint8_t script_idx, size_t c_idx);
+const tele_compiled_t *ss_get_script_compiled(scene_state_t *ss,
+                                              uint8_t script_idx, size_t c_idx);
+void ss_compile_scripts(scene_state_t *ss);
 bool ss_get_script_comment(scene_state_t *ss, uint8_t script_idx, size_t c_idx);
 void ss_set_script_comment(scene_state_t *ss, uint8_t script_idx, size_t c_idx,
                            uint8_t on);
@@ -348,6 +405,8 @@ void ss_update_in_scale(scene_state_t *);
 void ss_update_param_scale(scene_state_t *);
 void ss_update_fader_scale(scene_state_t *ss, int16_t fader);
 void ss_update_fader_scale_all(scene_state_t *ss);
+void ss_set_n_scale(scene_state_t *ss, uint8_t scale_nb, int16_t scale_bits,
+                    int16_t root);
 
 int16_t ss_get_param(scene_state_t *);
 int16_t ss_get_in(scene_state_t *);
@@ -366,6 +425,8 @@ int16_t ss_get_fader_max(scene_state_t *ss, int16_t fader);
 void ss_set_fader_min(scene_state_t *ss, int16_t fader, int16_t min);
 void ss_set_fader_max(scene_state_t *ss, int16_t fader, int16_t max);
 void ss_reset_fader_cal(scene_state_t *ss, int16_t fader);
+void ss_cal_tick(scene_state_t *ss, uint8_t time);
+void ss_cal_commit(scene_state_t *ss);
 
 ////////////////////////////////////////////////////////////////////////////////
 // EXEC STATE //////////////////////////////////////////////////////////////////
@@ -6,7 +6,10 @@
 #include <unistd.h>  // ssize_t
 
 #include "helpers.h"
+#include "ii_cache.h"
+#include "ii_queue.h"
 #include "ops/op.h"
+#include "ops/prof.h"
 #include "scanner.h"
 #include "table.h"
 #include "teletype_io.h"
@@ -15,6 +18,15 @@
 
 bool processing_delays = false;
 
+// time each op and mod call, i is its index in prof.c's table
+#ifdef TELETYPE_PROFILE
+#define PROFILE_BEGIN() const uint32_t profile_start = tele_profile_count()
+#define PROFILE_END(i) prof_add(i, tele_profile_count() - profile_start)
+#else
+#define PROFILE_BEGIN()
+#define PROFILE_END(i)
+#endif
+
 /////////////////////////////////////////////////////////////////
 // DELAY ////////////////////////////////////////////////////////
 
@@ -24,9 +36,7 @@ void clear_delays(scene_state_t *ss) {
         tele_tr_pulse_end(ss, i);
     }
 
-    for (int16_t i = 0; i < DELAY_SIZE; i++) { ss->delay.time[i] = 0; }
-
-    ss->delay.count = 0;
+    ss_delay_init(ss);
     ss->stack_op.top = 0;
 
     tele_has_delays(false);
@@ -140,6 +150,14 @@ error_t validate(const tele_command_t *c,
 /////////////////////////////////////////////////////////////////
 // RUN //////////////////////////////////////////////////////////
 
+static process_result_t process_compiled_command(
+    scene_state_t *ss, exec_state_t *es, const tele_command_t *cmd,
+    const tele_compiled_t *compiled);
+static process_result_t run_compiled_subs(scene_state_t *ss, exec_state_t *es,
+                                          const tele_compiled_t *c,
+                                          uint8_t sub, uint8_t sub_count,
+                                          const tele_command_view_t *post);
+
 process_result_t run_script(scene_state_t *ss, size_t script_no) {
     exec_state_t es;
     es_init(&es);
@@ -155,7 +173,7 @@ static process_result_t _run_script_with_exec_state(scene_state_t *ss,
                                                     uint8_t line_no1,
                                                     uint8_t line_no2) {
 #ifdef TELETYPE_PROFILE
-    tele_profile_script(script_no);
+    tele_profile_script(script_no, true);
 #endif
     process_result_t result = { .has_value = false, .value = 0 };
 
@@ -173,8 +191,9 @@ static process_result_t _run_script_with_exec_state(scene_state_t *ss,
         if (es_variables(es)->breaking) break;
         do {
             // TODO: Check for 0-length commands before we bother?
-            result = process_command(ss, es,
-                                     ss_get_script_command(ss, script_no, i));
+            result = process_compiled_command(
+                ss, es, ss_get_script_command(ss, script_no, i),
+                ss_get_script_compiled(ss, script_no, i));
             // and WHILE implemented with while!
         } while (es_variables(es)->while_continue &&
                  !es_variables(es)->breaking);
@@ -183,8 +202,12 @@ static process_result_t _run_script_with_exec_state(scene_state_t *ss,
     es_variables(es)->breaking = false;
     ss_update_script_last(ss, script_no);
 
+    // a SCRIPT called from another script leaves its i2c writes for the
+    // outermost one to send
+    if (es_depth(es) <= 1) ii_flush();
+
 #ifdef TELETYPE_PROFILE
-    tele_profile_script(script_no);
+    tele_profile_script(script_no, false);
 #endif
     return result;
 }
@@ -229,19 +252,34 @@ process_result_t run_fline_with_exec_state(scene_state_t *ss, exec_state_t *es,
 // run a single command inside a given exec_state
 process_result_t process_command(scene_state_t *ss, exec_state_t *es,
                                  const tele_command_t *cmd) {
+    // the command may be overwritten while it runs (e.g. by SCENE), so work
+    // from a copy, anything nested inside it runs in place on that copy
+    tele_command_t c;
+    copy_command(&c, cmd);
+
+    tele_command_view_t view;
+    command_view(&view, &c);
+    return process_command_view(ss, es, &view);
+}
+
+// run a command in place, MODs are handed a view of the POST part of c
+process_result_t process_command_view(scene_state_t *ss, exec_state_t *es,
+                                      const tele_command_view_t *c) {
+    // the POST of a compiled command
+    if (c->compiled)
+        return run_compiled_subs(ss, es, c->compiled, c->compiled->post_sub,
+                                 c->compiled->sub_count, NULL);
+
     command_state_t cs;
     cs_init(&cs);  // initialise this here as well as inside the loop, in case
                    // the command has 0 length
 
-    tele_command_t c;
-    copy_command(&c, cmd);
-
     // 1. Do we have a PRE seperator?
     // ------------------------------
     // if we do then only process the PRE part, the MOD will determine if the
     // POST should be run and take care of running it
     ssize_t start_idx = 0;
-    ssize_t end_idx = c.separator == -1 ? c.length : c.separator;
+    ssize_t end_idx = c->separator == -1 ? c->length : c->separator;
 
     // 2. Determine the location of all the SUB commands
     // -------------------------------------------------
@@ -254,9 +292,9 @@ process_result_t process_command(scene_state_t *ss, exec_state_t *es,
     ssize_t sub_len = 0;
     ssize_t sub_start = 0;
 
-    // iterate through c.data to find all the SUB_SEPs and add to the array
+    // iterate through c->data to find all the SUB_SEPs and add to the array
     for (ssize_t idx = start_idx; idx < end_idx; idx++) {
-        tele_word_t word_type = c.data[idx].tag;
+        tele_word_t word_type = c->data[idx].tag;
         if (word_type == SUB_SEP && idx > sub_start) {
             subs[sub_len].start = sub_start;
             subs[sub_len].end = idx - 1;
@@ -288,8 +326,8 @@ process_result_t process_command(scene_state_t *ss, exec_state_t *es,
         // as we are using a stack based language, we must process commands from
         // right to left
         for (ssize_t idx = sub_end; idx >= sub_start; idx--) {
-            const tele_word_t word_type = c.data[idx].tag;
-            const int16_t word_value = c.data[idx].value;
+            const tele_word_t word_type = c->data[idx].tag;
+            const int16_t word_value = c->data[idx].value;
 
             if (word_type == NUMBER || word_type == XNUMBER ||
                 word_type == BNUMBER || word_type == RNUMBER) {
@@ -297,6 +335,7 @@ process_result_t process_command(scene_state_t *ss, exec_state_t *es,
             }
             else if (word_type == OP) {
                 const tele_op_t *op = tele_ops[word_value];
+                PROFILE_BEGIN();
 
                 // if we're in the first command position, and there is a set fn
                 // pointer and we have enough params, then run set, else run get
@@ -305,12 +344,14 @@ process_result_t process_command(scene_state_t *ss, exec_state_t *es,
                     op->set(op->data, ss, es, &cs);
                 else
                     op->get(op->data, ss, es, &cs);
+                PROFILE_END(word_value);
             }
             else if (word_type == MOD) {
-                tele_command_t post_command;
-                post_command.comment = false;
-                copy_post_command(&post_command, &c);
+                tele_command_view_t post_command;
+                post_command_view(&post_command, c);
+                PROFILE_BEGIN();
                 tele_mods[word_value]->func(ss, es, &cs, &post_command);
+                PROFILE_END(E_OP__LENGTH + word_value);
             }
         }
     }
@@ -328,11 +369,100 @@ process_result_t process_command(scene_state_t *ss, exec_state_t *es,
     }
 }
 
+// run a compiled command where it is, the MOD gets the POST words where they
+// are stored
+static process_result_t run_compiled_command(scene_state_t *ss,
+                                             exec_state_t *es,
+                                             const tele_command_t *cmd,
+                                             const tele_compiled_t *compiled) {
+    tele_command_view_t post;
+    if (compiled->has_mod) {
+        post.data = &cmd->data[cmd->separator + 1];
+        post.length = cmd->length - cmd->separator - 1;
+        post.separator = -1;
+        post.compiled = compiled;
+    }
+
+    return run_compiled_subs(ss, es, compiled, 0, compiled->post_sub, &post);
+}
+
+// run a command that was compiled when it was stored in a script, this skips
+// the SUB splitting and the get / set decisions made by process_command
+static process_result_t process_compiled_command(
+    scene_state_t *ss, exec_state_t *es, const tele_command_t *cmd,
+    const tele_compiled_t *compiled) {
+    if (!compiled->ok) return process_command(ss, es, cmd);
+    if (!compiled->runs_scripts)
+        return run_compiled_command(ss, es, cmd, compiled);
+
+    // a script it runs may replace this line (INIT.SCRIPT, SCENE...), so it
+    // finishes from a copy
+    tele_command_t c;
+    tele_compiled_t cc;
+    copy_command(&c, cmd);
+    memcpy(&cc, compiled, sizeof(cc));
+    return run_compiled_command(ss, es, &c, &cc);
+}
+
+// runs SUBs [sub, sub_count) of c
+static process_result_t run_compiled_subs(scene_state_t *ss, exec_state_t *es,
+                                          const tele_compiled_t *c,
+                                          uint8_t sub, uint8_t sub_count,
+                                          const tele_command_view_t *post) {
+    process_result_t o = { .has_value = false, .value = 0 };
+
+    command_state_t cs;
+    cs_init(&cs);
+
+    uint8_t w = sub ? c->sub_end[sub - 1] : 0;
+    for (; sub < sub_count && !es_variables(es)->breaking; sub++) {
+        cs_init(&cs);
+
+        for (; w < c->sub_end[sub]; w++) {
+            const int16_t value = c->words[w].value;
+            switch (c->words[w].instr) {
+                case I_PUSH: cs_push(&cs, value); continue;
+                case I_GET: {
+                    const tele_op_t *op = c->words[w].call.op;
+                    PROFILE_BEGIN();
+                    op->get(op->data, ss, es, &cs);
+                    PROFILE_END(value);
+                    break;
+                }
+                case I_SET: {
+                    const tele_op_t *op = c->words[w].call.op;
+                    PROFILE_BEGIN();
+                    op->set(op->data, ss, es, &cs);
+                    PROFILE_END(value);
+                    break;
+                }
+                case I_MOD: {
+                    PROFILE_BEGIN();
+                    c->words[w].call.mod->func(ss, es, &cs, post);
+                    PROFILE_END(E_OP__LENGTH + value);
+                    break;
+                }
+            }
+        }
+    }
+
+    if (cs_stack_size(&cs)) {
+        o.has_value = true;
+        o.value = cs_pop(&cs);
+    }
+    return o;
+}
+
 
 /////////////////////////////////////////////////////////////////
 // TICK /////////////////////////////////////////////////////////
 
 void tele_tick(scene_state_t *ss, uint8_t time) {
+    // send i2c writes from anything that ran outside a script, then age the
+    // values read back from followers, ii_cache_refresh polls them
+    ii_flush();
+    ii_cache_tick(time);
+
     // could be a while() if there is reason to expect a user to cascade moves
     // with SCRIPTs without the tick delay
     if (ss->turtle.stepped && ss->turtle.script_number != NO_SCRIPT) {
@@ -340,53 +470,75 @@ void tele_tick(scene_state_t *ss, uint8_t time) {
         run_script(ss, turtle_get_script(&ss->turtle));
     }
 
+    ss_cal_tick(ss, time);
+
     // process delays
-    for (int16_t i = 0; i < DELAY_SIZE; i++) {
-        if (ss->delay.time[i]) {
-            ss->delay.time[i] -= time;
-            if (ss->delay.time[i] <= 0) {
+    // collect everything that has come due during this tick first, then run it
+    // in the order it was scheduled (the old slot scan fired in slot order,
+    // which was the same thing until slots started being reused)
+    ss->delay.now += time;
+
+    uint8_t ready[DELAY_SIZE];
+    uint8_t ready_count = 0;
+    int16_t slot;
+    while ((slot = ss_delay_pop_due(ss)) >= 0) {
+        uint8_t pos = ready_count++;
+        while (pos > 0 && (int32_t)(ss->delay.seq[ready[pos - 1]] -
+                                     ss->delay.seq[slot]) > 0) {
+            ready[pos] = ready[pos - 1];
+            pos--;
+        }
+        ready[pos] = slot;
+    }
+
+    if (ready_count == 0) return;
+
+    const uint8_t epoch = ss->delay.epoch;
+    for (uint8_t r = 0; r < ready_count; r++) {
+        uint8_t i = ready[r];
+        // DEL.KILL from an earlier delay in this tick has cancelled it
+        if (!ss_delay_pending(ss, i)) {
+            ss_delay_release(ss, i);
+            continue;
+        }
 #ifdef TELETYPE_PROFILE
-                tele_profile_delay(i);
+        tele_profile_delay(i);
 #endif
-                // Workaround for issue #80. (0 is the signifier for "empty")
-                // Setting delay.time[i] to 1 prevents delayed delay commands
-                //     from seeing a perfectly-timed delay slot as empty
-                //     while it's still being processed.
-                ss->delay.time[i] = 1;
-
-                // Instead of just running the command, we use the TEMP script
-                // to execute it.  This is required for THIS to be tracked, as
-                // it needs to have a script number.
-                // TODO: dynamically allocate scripts to prevent waste
-                ss_clear_script(ss, DELAY_SCRIPT);
-                ss_overwrite_script_command(ss, DELAY_SCRIPT, 0,
-                                            &ss->delay.commands[i]);
-
-                // We always need to execute from within an execution context
-                // TODO: ensure all code does so!
-                // New execution context setup needs to es_push, but it's
-                // decoupled to allow SCRIPT to work
-                exec_state_t es;
-                es_init(&es);
-                es_push(&es);
-
-                // The delay flag is required to protect the script number
-                // TODO: investigate delayed nested SCRIPTs
-                es_variables(&es)->delayed = true;
-                es_variables(&es)->script_number = ss->delay.origin_script[i];
-                es_variables(&es)->i = ss->delay.origin_i[i];
-
-                run_script_with_exec_state(ss, &es, DELAY_SCRIPT);
-
-                ss->delay.time[i] = 0;
-                ss->delay.count--;
-                if (ss->delay.count == 0) tele_has_delays(false);
+        // Instead of just running the command, we use the TEMP script
+        // to execute it.  This is required for THIS to be tracked, as
+        // it needs to have a script number.
+        // TODO: dynamically allocate scripts to prevent waste
+        ss_clear_script(ss, DELAY_SCRIPT);
+        ss_overwrite_script_command(ss, DELAY_SCRIPT, 0,
+                                    &ss->delay.commands[i]);
+
+        // We always need to execute from within an execution context
+        // TODO: ensure all code does so!
+        // New execution context setup needs to es_push, but it's
+        // decoupled to allow SCRIPT to work
+        exec_state_t es;
+        es_init(&es);
+        es_push(&es);
+
+        // The delay flag is required to protect the script number
+        // TODO: investigate delayed nested SCRIPTs
+        es_variables(&es)->delayed = true;
+        es_variables(&es)->script_number = ss->delay.origin_script[i];
+        es_variables(&es)->i = ss->delay.origin_i[i];
+
+        // the command has been copied out, so the slot can be reused by any
+        // delays it queues
+        ss_delay_release(ss, i);
+
+        run_script_with_exec_state(ss, &es, DELAY_SCRIPT);
 #ifdef TELETYPE_PROFILE
-                tele_profile_delay(i);
+        tele_profile_delay(i);
 #endif
-            }
-        }
+        // DEL.CLR or INIT has thrown away the rest of this tick's delays
+        if (ss->delay.epoch != epoch) break;
     }
+
+    if (ss->delay.count == 0) tele_has_delays(false);
 }
 
 void tele_tr_pulse_end(scene_state_t *ss, uint8_t i) {
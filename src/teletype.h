@@ -8,9 +8,10 @@
 #include "command.h"
 #include "state.h"
 
-#define TELE_ERROR_MSG_LENGTH 16
 // #define TELETYPE_PROFILE // un-comment this line to enable profiling
 
+#define TELE_ERROR_MSG_LENGTH 16
+
 typedef enum {
     E_OK,
     E_PARSE,
@@ -49,6 +50,8 @@ process_result_t run_fline_with_exec_state(scene_state_t *ss, exec_state_t *es,
                                            size_t script_no, uint8_t line_no);
 process_result_t process_command(scene_state_t *ss, exec_state_t *es,
                                  const tele_command_t *cmd);
+process_result_t process_command_view(scene_state_t *ss, exec_state_t *es,
+                                      const tele_command_view_t *cmd);
 
 void tele_tick(scene_state_t *ss, uint8_t);
 
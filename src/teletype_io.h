@@ -2,6 +2,7 @@
 #define _TELETYPE_IO_H_
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #define SUB_MODE_OFF 0
@@ -54,9 +55,15 @@ extern bool tele_get_input_state(uint8_t);
 
 void tele_save_calibration(void);
 
+// only defined when TELETYPE_PROFILE is
 #ifdef TELETYPE_PROFILE
-void tele_profile_script(size_t);
+// called with start set when a script starts and clear when it ends
+void tele_profile_script(size_t, bool start);
 void tele_profile_delay(uint8_t);
+// a free running counter used to time ops (CPU cycles on the module)
+uint32_t tele_profile_count(void);
+// converts a difference of tele_profile_count values to microseconds
+uint32_t tele_profile_count_us(uint32_t count);
 #endif
 
 // emulate grid key press
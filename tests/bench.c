@@ -0,0 +1,422 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "chaos.h"
+#include "chaos_reference.h"
+#include "match_token.h"
+#include "quantize.h"
+#include "scene_serialization.h"
+#include "teletype.h"
+
+// Host side interpreter benchmarks, run with 'make run-bench'.
+//
+// Every workload is timed in BENCH_BATCHES batches and the fastest batch is
+// reported. An op is one unit of work for the workload: a command executed,
+// a scene line parsed, a scene written or a token matched. Pass --csv for
+// machine readable output.
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+#define BENCH_BATCHES 7
+
+// same as the line buffer in serialize_scene
+#define BENCH_LINE_LENGTH 36
+
+typedef struct {
+    const char *name;
+    // scene text in the format read by deserialize_scene, script 1 is run
+    const char *scene;
+    // commands executed by each run
+    uint32_t ops;
+    uint32_t runs;
+} bench_workload_t;
+
+static const bench_workload_t workloads[] = {
+    { .name = "math",
+      .scene = "#1\n"
+               "X ADD MUL X 3 DIV Y 2\n"
+               "Y SUB LIM X -100 100 MOD Z 7\n"
+               "Z WRAP ADD Z 1 0 1000\n"
+               "A BSET A RRAND 0 15\n"
+               "B QT RAND 100 12\n",
+      .ops = 5,
+      .runs = 20000 },
+    { .name = "pattern",
+      .scene = "#1\n"
+               "P.N 1\n"
+               "P.PUSH RAND 100\n"
+               "P.INS 0 P.NEXT\n"
+               "P.RM 63\n"
+               "X ADD X P.POP\n",
+      .ops = 5,
+      .runs = 20000 },
+    { .name = "loop",
+      .scene = "#1\n"
+               "L 1 100: X ADD X I\n"
+               "Y 0\n"
+               "W LT Y 100: Y ADD Y 1\n",
+      .ops = 201,
+      .runs = 1000 },
+    // 64 delays, drained by ticking until none are left
+    { .name = "delay_storm",
+      .scene = "#1\n"
+               "DEL.X 16 1: X ADD X 1\n"
+               "DEL.X 16 2: Y ADD Y 1\n"
+               "DEL.X 16 3: Z ADD Z 1\n"
+               "DEL.X 16 4: X SUB X 1\n",
+      .ops = 68,
+      .runs = 2000 },
+    // each script calls the next, 7 levels deep
+    { .name = "script_recursion",
+      .scene = "#1\nX ADD X 1\n$ 2\n\n"
+               "#2\nX ADD X 1\n$ 3\n\n"
+               "#3\nX ADD X 1\n$ 4\n\n"
+               "#4\nX ADD X 1\n$ 5\n\n"
+               "#5\nX ADD X 1\n$ 6\n\n"
+               "#6\nX ADD X 1\n$ 7\n\n"
+               "#7\nX ADD X 1\n",
+      .ops = 13,
+      .runs = 20000 },
+    // four CVs and a TXo quantized every run, with a scale change
+    { .name = "quantize",
+      .scene = "#1\n"
+               "X QT.B RAND 16383\n"
+               "Y QT.BX 3 RAND 16383\n"
+               "Z QT.S 2 100 RAND 16383\n"
+               "T QT.S 5 -300 RAND 16383\n"
+               "A QT.B ADD X Y\n"
+               "N.BX 3 0 RRAND 1 4095\n",
+      .ops = 6,
+      .runs = 20000 },
+};
+
+typedef struct {
+    const char *data;
+    size_t length;
+    size_t position;
+} bench_reader_t;
+
+static uint16_t bench_read_buffer(void *self_data, uint8_t *buffer,
+                                  uint16_t size) {
+    bench_reader_t *r = (bench_reader_t *)self_data;
+    size_t n = r->length - r->position;
+    if (n > size) n = size;
+    memcpy(buffer, r->data + r->position, n);
+    r->position += n;
+    return n;
+}
+
+static void bench_write_buffer(void *self_data, uint8_t *buffer,
+                               uint16_t size) {
+    bench_reader_t *w = (bench_reader_t *)self_data;
+    w->length += size;
+}
+
+static void bench_print_dbg(const char *str) {}
+
+static void bench_deserialize(
+    scene_state_t *ss, const char *data, size_t length,
+    char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS]) {
+    bench_reader_t reader = { .data = data, .length = length };
+    tt_deserializer_t stream = { .read_buffer = bench_read_buffer,
+                                 .print_dbg = bench_print_dbg,
+                                 .data = &reader };
+    deserialize_scene(&stream, ss, text);
+}
+
+static bool csv = false;
+
+static void report(const char *name, uint32_t runs, uint32_t ops,
+                   uint64_t ns) {
+    double ns_per_run = (double)ns / runs;
+    double ns_per_op = ns_per_run / ops;
+    if (csv) {
+        printf("%s,%u,%u,%.1f,%.2f,%.0f\n", name, runs, ops, ns_per_run,
+               ns_per_op, 1e9 / ns_per_op);
+    }
+    else {
+        printf("%-24s %12.1f ns/run %9.2f ns/op %12.0f ops/s\n", name,
+               ns_per_run, ns_per_op, 1e9 / ns_per_op);
+    }
+}
+
+static void bench_workload(const bench_workload_t *w) {
+    static scene_state_t ss;
+    static char text[SCENE_TEXT_LINES][SCENE_TEXT_CHARS];
+    ss_init(&ss);
+    bench_deserialize(&ss, w->scene, strlen(w->scene), &text);
+
+    uint64_t best = UINT64_MAX;
+    for (uint8_t b = 0; b < BENCH_BATCHES; b++) {
+        uint64_t start = now_ns();
+        for (uint32_t i = 0; i < w->runs; i++) {
+            run_script(&ss, 0);
+            while (ss.delay.count) tele_tick(&ss, 1);
+        }
+        uint64_t ns = now_ns() - start;
+        if (ns < best) best = ns;
+    }
+    report(w->name, w->runs, w->ops, best);
+}
+
+// runs a single line, both directly through process_command and stored as a
+// script line with run_script, ops is the commands executed per run
+static void bench_command(const char *name, const char *line, uint32_t ops,
+                          uint32_t runs) {
+    tele_command_t cmd;
+    char error_msg[TELE_ERROR_MSG_LENGTH];
+    cmd.comment = false;
+    if (parse(line, &cmd, error_msg) != E_OK ||
+        validate(&cmd, error_msg) != E_OK) {
+        fprintf(stderr, "%s: %s\n", line, error_msg);
+        return;
+    }
+
+    static scene_state_t ss;
+    ss_init(&ss);
+    exec_state_t es;
+    es_init(&es);
+    es_push(&es);
+
+    uint64_t best[2] = { UINT64_MAX, UINT64_MAX };
+    for (uint8_t b = 0; b < BENCH_BATCHES; b++) {
+        uint64_t start = now_ns();
+        for (uint32_t i = 0; i < runs; i++) process_command(&ss, &es, &cmd);
+        uint64_t ns = now_ns() - start;
+        if (ns < best[0]) best[0] = ns;
+    }
+
+    ss_init(&ss);
+    ss_overwrite_script_command(&ss, 0, 0, &cmd);
+    for (uint8_t b = 0; b < BENCH_BATCHES; b++) {
+        uint64_t start = now_ns();
+        for (uint32_t i = 0; i < runs; i++) run_script(&ss, 0);
+        uint64_t ns = now_ns() - start;
+        if (ns < best[1]) best[1] = ns;
+    }
+
+    char label[32];
+    snprintf(label, sizeof(label), "%s_process", name);
+    report(label, runs, ops, best[0]);
+    snprintf(label, sizeof(label), "%s_script", name);
+    report(label, runs, ops, best[1]);
+}
+
+// splits every line into tokens the way scanner.rl does and matches them,
+// either copied into a buffer for match_token or in place with
+// match_token_span, returns the number of tokens matched
+static uint32_t match_lines(char (*lines)[BENCH_LINE_LENGTH], uint16_t count,
+                            bool span) {
+    uint32_t matched = 0;
+    for (uint16_t l = 0; l < count; l++) {
+        const char *p = lines[l];
+        while (*p) {
+            if (strchr(" :;", *p)) {
+                p++;
+                continue;
+            }
+            const char *ts = p;
+            while (*p && !strchr(" :;", *p)) p++;
+            size_t len = p - ts;
+            tele_data_t data;
+            if (span) { matched += match_token_span(ts, len, &data); }
+            else {
+                char buf[32];
+                if (len > sizeof(buf) - 1) len = sizeof(buf) - 1;
+                memcpy(buf, ts, len);
+                buf[len] = '\0';
+                matched += match_token(buf, len, &data);
+            }
+        }
+    }
+    return matched;
+}
+
+// the search QT.S, QT.B and QT.BX used to run on every call against the
+// prepared scale they use now, over every input for the default N.B scale
+static void bench_quantize(uint32_t runs) {
+    const int16_t major = 0xAB5;
+    quantize_scale_t q;
+    quantize_scale_init(&q, major);
+
+    volatile int16_t sink = 0;
+    uint64_t best[3] = { UINT64_MAX, UINT64_MAX, UINT64_MAX };
+    for (uint8_t b = 0; b < BENCH_BATCHES; b++) {
+        uint64_t start = now_ns();
+        for (uint32_t i = 0; i < runs; i++)
+            for (int16_t v = 0; v < 16384; v += 16)
+                sink += quantize_to_bitmask_scale(major, 300, v);
+        uint64_t ns = now_ns() - start;
+        if (ns < best[0]) best[0] = ns;
+
+        start = now_ns();
+        for (uint32_t i = 0; i < runs; i++)
+            for (int16_t v = 0; v < 16384; v += 16)
+                sink += quantize_to_scale(&q, 300, v);
+        ns = now_ns() - start;
+        if (ns < best[1]) best[1] = ns;
+
+        // the cost of N.B changing the scale every time
+        start = now_ns();
+        for (uint32_t i = 0; i < runs; i++)
+            for (int16_t v = 0; v < 16384; v += 16) {
+                quantize_scale_init(&q, major);
+                sink += quantize_to_scale(&q, 300, v);
+            }
+        ns = now_ns() - start;
+        if (ns < best[2]) best[2] = ns;
+    }
+
+    report("quantize_search", runs, 1024, best[0]);
+    report("quantize_prepared", runs, 1024, best[1]);
+    report("quantize_rebuilt", runs, 1024, best[2]);
+}
+
+// the float CHAOS maps against the fixed point ones, runs times 1024 values
+// from the middle of the parameter range
+static void bench_chaos(uint32_t runs) {
+    static const char *names[][2] = {
+        { "chaos_float_logistic", "chaos_fixed_logistic" },
+        { "chaos_float_cubic", "chaos_fixed_cubic" },
+        { "chaos_float_henon", "chaos_fixed_henon" },
+    };
+
+    volatile int16_t sink = 0;
+    for (int16_t alg = CHAOS_ALGO_LOGISTIC; alg <= CHAOS_ALGO_HENON; alg++) {
+        uint64_t best[2] = { UINT64_MAX, UINT64_MAX };
+        for (uint8_t b = 0; b < BENCH_BATCHES; b++) {
+            chaos_float_set_alg(alg);
+            chaos_float_set_r(5000);
+            chaos_float_set_val(2500);
+            uint64_t start = now_ns();
+            for (uint32_t i = 0; i < runs * 1024; i++)
+                sink += chaos_float_get_val();
+            uint64_t ns = now_ns() - start;
+            if (ns < best[0]) best[0] = ns;
+
+            chaos_set_alg(alg);
+            chaos_set_r(5000);
+            chaos_set_val(2500);
+            start = now_ns();
+            for (uint32_t i = 0; i < runs * 1024; i++)
+                sink += chaos_get_val();
+            ns = now_ns() - start;
+            if (ns < best[1]) best[1] = ns;
+        }
+        report(names[alg][0], runs, 1024, best[0]);
+        report(names[alg][1], runs, 1024, best[1]);
+    }
+}
+
+#define BENCH_MAX_PRESETS 32
+#define BENCH_MAX_LINES \
+    (BENCH_MAX_PRESETS * TOTAL_SCRIPT_COUNT * SCRIPT_MAX_COMMANDS)
+
+// writes a scene with serialize_scene, only counting the bytes, like a
+// backup to USB without the disk
+static size_t bench_serialize(
+    scene_state_t *ss, char (*text)[SCENE_TEXT_LINES][SCENE_TEXT_CHARS]) {
+    bench_reader_t writer = { .length = 0 };
+    tt_serializer_t stream = { .write_buffer = bench_write_buffer,
+                               .print_dbg = bench_print_dbg,
+                               .data = &writer };
+    serialize_scene(&stream, ss, text);
+    return writer.length;
+}
+
+// parses every scene in presets with deserialize_scene, writes them back out
+// with serialize_scene, and matches all of their script tokens with both
+// matchers
+static void bench_presets(const char *dir, uint32_t runs) {
+    static char files[BENCH_MAX_PRESETS][8192];
+    static size_t lengths[BENCH_MAX_PRESETS];
+    static char lines[BENCH_MAX_LINES][BENCH_LINE_LENGTH];
+    static scene_state_t ss;
+    static scene_state_t scenes[BENCH_MAX_PRESETS];
+    static char texts[BENCH_MAX_PRESETS][SCENE_TEXT_LINES][SCENE_TEXT_CHARS];
+    static char text[SCENE_TEXT_LINES][SCENE_TEXT_CHARS];
+
+    uint8_t presets = 0;
+    uint16_t count = 0;
+    for (; presets < BENCH_MAX_PRESETS; presets++) {
+        char path[256];
+        snprintf(path, sizeof(path), "%s/tt%02u.txt", dir, presets);
+        FILE *f = fopen(path, "rb");
+        if (!f) break;
+        lengths[presets] = fread(files[presets], 1, sizeof(files[0]), f);
+        fclose(f);
+
+        scene_state_t *scene = &scenes[presets];
+        ss_init(scene);
+        bench_deserialize(scene, files[presets], lengths[presets],
+                          &texts[presets]);
+        for (uint8_t s = 0; s < TOTAL_SCRIPT_COUNT; s++)
+            for (uint8_t c = 0; c < ss_get_script_len(scene, s); c++)
+                print_command(ss_get_script_command(scene, s, c),
+                              lines[count++]);
+    }
+    if (presets == 0) {
+        fprintf(stderr, "no presets found in %s\n", dir);
+        return;
+    }
+
+    uint32_t tokens = match_lines(lines, count, true);
+    uint64_t best[4] = { UINT64_MAX, UINT64_MAX, UINT64_MAX, UINT64_MAX };
+    for (uint8_t b = 0; b < BENCH_BATCHES; b++) {
+        uint64_t start = now_ns();
+        for (uint32_t i = 0; i < runs; i++)
+            for (uint8_t p = 0; p < presets; p++)
+                bench_deserialize(&ss, files[p], lengths[p], &text);
+        uint64_t ns = now_ns() - start;
+        if (ns < best[0]) best[0] = ns;
+
+        start = now_ns();
+        for (uint32_t i = 0; i < runs; i++)
+            for (uint8_t p = 0; p < presets; p++)
+                bench_serialize(&scenes[p], &texts[p]);
+        ns = now_ns() - start;
+        if (ns < best[1]) best[1] = ns;
+
+        for (uint8_t m = 0; m < 2; m++) {
+            start = now_ns();
+            for (uint32_t i = 0; i < runs; i++) match_lines(lines, count, m);
+            ns = now_ns() - start;
+            if (ns < best[2 + m]) best[2 + m] = ns;
+        }
+    }
+
+    report("parse_presets", runs, count, best[0]);
+    report("write_presets", runs, presets, best[1]);
+    report("match_token", runs, tokens, best[2]);
+    report("match_token_span", runs, tokens, best[3]);
+}
+
+int main(int argc, char **argv) {
+    const char *presets = "../presets";
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0)
+            csv = true;
+        else
+            presets = argv[i];
+    }
+
+    if (csv)
+        printf("workload,runs,ops_per_run,ns_per_run,ns_per_op,ops_per_sec\n");
+
+    for (size_t i = 0; i < sizeof(workloads) / sizeof(workloads[0]); i++)
+        bench_workload(&workloads[i]);
+    // the line the mod POST view was first measured with
+    bench_command("loop_10000", "L 1 10000: X ADD X 1", 10000, 200);
+    bench_quantize(200);
+    bench_chaos(200);
+    bench_presets(presets, 50);
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "chaos_reference.h"
+
+#include "chaos.h"  // chaos_algo_t
+
+typedef struct {
+    int16_t ix;
+    float fx;
+    int16_t ir;
+    float fr;
+    float fx0;
+    float fx1;
+    chaos_algo_t alg;
+} chaos_float_state_t;
+
+static int16_t logistic_get_val(void);
+static int16_t cubic_get_val(void);
+static int16_t henon_get_val(void);
+static void chaos_scale_values(chaos_float_state_t*);
+
+// constants defining I/O ranges
+static const int16_t chaos_value_max = 10000;
+static const int16_t chaos_param_max = 10000;
+// fixed beta for henon map
+static const float chaos_henon_b = 0.3;
+
+static chaos_float_state_t chaos_state = { .ix = 5000,
+                                           .ir = 5000,
+                                           .alg = CHAOS_ALGO_LOGISTIC };
+
+void chaos_float_init() {
+    chaos_state.fx0 = chaos_state.fx1 = 0.f;
+    chaos_scale_values(&chaos_state);
+}
+
+// scale integer state and param values to float,
+// as appropriate for current algorithm
+static void chaos_scale_values(chaos_float_state_t* state) {
+    switch (state->alg) {
+        case CHAOS_ALGO_HENON:
+            // for henon, x in [-1.5, 1.5], r in [1, 1.4]
+            state->fx = state->ix / (float)chaos_value_max * 1.5;
+            state->fr = 1.f + state->ir / (float)chaos_param_max * 0.4;
+            if (state->fr < 1.f) { state->fr = 1.f; }
+            if (state->fr > 1.4) { state->fr = 1.4f; }
+            break;
+        case CHAOS_ALGO_CUBIC:
+        case CHAOS_ALGO_LOGISTIC:  // fall through
+        default:
+            // for cubic / logistic, x in [-1, 1] and r in [3.2, 4)
+            state->fx = state->ix / (float)chaos_value_max;
+            state->fr = state->ir / (float)chaos_param_max * 0.9999 + 3.0;
+            break;
+    }
+}
+
+void chaos_float_set_val(int16_t val) {
+    chaos_state.ix = val;
+    chaos_scale_values(&chaos_state);
+}
+
+static int16_t logistic_get_val() {
+    if (chaos_state.fx < 0.f) { chaos_state.fx = 0.f; }
+    chaos_state.fx = chaos_state.fx * chaos_state.fr * (1.f - chaos_state.fx);
+    chaos_state.ix = chaos_state.fx * (float)chaos_value_max;
+    return chaos_state.ix;
+}
+
+static int16_t cubic_get_val() {
+    float x3 = chaos_state.fx * chaos_state.fx * chaos_state.fx;
+    chaos_state.fx =
+        chaos_state.fr * x3 + chaos_state.fx * (1.f - chaos_state.fr);
+    chaos_state.ix = chaos_state.fx * (float)chaos_value_max;
+    return chaos_state.ix;
+}
+
+static int16_t henon_get_val() {
+    float x0_2 = chaos_state.fx0 * chaos_state.fx0;
+    float x = 1.f - (x0_2 * chaos_state.fr) + (chaos_henon_b * chaos_state.fx1);
+    // reflect bounds to avoid blowup
+    while (x < -1.5) { x = -1.5 - x; }
+    while (x > 1.5) { x = 1.5 - x; }
+    chaos_state.fx1 = chaos_state.fx0;
+    chaos_state.fx0 = chaos_state.fx;
+    chaos_state.fx = x;
+    chaos_state.ix = x / 1.5 * (float)chaos_value_max;
+    return chaos_state.ix;
+}
+
+int16_t chaos_float_get_val() {
+    switch (chaos_state.alg) {
+        case CHAOS_ALGO_LOGISTIC: return logistic_get_val();
+        case CHAOS_ALGO_CUBIC: return cubic_get_val();
+        case CHAOS_ALGO_HENON: return henon_get_val();
+        default: return 0;
+    }
+}
+
+void chaos_float_set_r(int16_t r) {
+    chaos_state.ir = r;
+    chaos_scale_values(&chaos_state);
+}
+
+void chaos_float_set_alg(int16_t a) {
+    if (a < 0) { a = 0; }
+    if (a >= CHAOS_ALGO_COUNT) { a = CHAOS_ALGO_COUNT - 1; }
+    chaos_state.alg = a;
+    chaos_scale_values(&chaos_state);
+}
@@ -0,0 +1,17 @@
+#ifndef _CHAOS_REFERENCE_H_
+#define _CHAOS_REFERENCE_H_
+
+#include <stdint.h>
+
+// The floating point CHAOS generator that src/chaos.c replaced, kept to test
+// and benchmark the fixed point one against. Takes the same values as the
+// chaos_* functions, the cellular automaton isn't included as it never used
+// floats.
+
+void chaos_float_init(void);
+void chaos_float_set_val(int16_t);
+int16_t chaos_float_get_val(void);
+void chaos_float_set_r(int16_t);
+void chaos_float_set_alg(int16_t);
+
+#endif
@@ -0,0 +1,85 @@
+#include "chaos_tests.h"
+
+#include <stdio.h>
+#include <stdlib.h>  // abs
+
+#include "chaos.h"
+#include "chaos_reference.h"
+#include "greatest/greatest.h"
+
+// the float reference rounds differently, so chaotic trajectories drift apart
+// after a while however exact either is
+#define CHAOS_TOLERANCE 2
+
+static void start(int16_t alg, int16_t x, int16_t r) {
+    chaos_set_alg(alg);
+    chaos_set_r(r);
+    chaos_set_val(x);
+    chaos_init();
+    chaos_float_set_alg(alg);
+    chaos_float_set_r(r);
+    chaos_float_set_val(x);
+    chaos_float_init();
+}
+
+// runs steps values from every x and r on a grid and fails if any is further
+// than CHAOS_TOLERANCE from the float reference
+TEST trajectories_helper(int16_t alg, int16_t r_min, int16_t r_max,
+                         uint16_t steps) {
+    static char message[64];
+    for (int16_t r = r_min; r <= r_max; r += 250) {
+        for (int16_t x = -10000; x <= 10000; x += 250) {
+            start(alg, x, r);
+            for (uint16_t i = 0; i < steps; i++) {
+                int16_t fixed = chaos_get_val();
+                int16_t reference = chaos_float_get_val();
+                if (abs(fixed - reference) > CHAOS_TOLERANCE) {
+                    sprintf(message, "alg %d x %d r %d step %u: %d vs %d",
+                            alg, x, r, i, fixed, reference);
+                    FAILm(message);
+                }
+            }
+        }
+    }
+    PASS();
+}
+
+TEST test_first_steps() {
+    for (int16_t alg = CHAOS_ALGO_LOGISTIC; alg <= CHAOS_ALGO_HENON; alg++)
+        CHECK_CALL(trajectories_helper(alg, 0, 10000, 3));
+    PASS();
+}
+
+// the logistic and cubic maps settle into cycles for low r, which the fixed
+// point version has to keep following. below r = 1500 the cubic map has
+// starting values right at the edge between two cycles, rounding decides
+// which one they end up in
+TEST test_periodic_orbits() {
+    CHECK_CALL(trajectories_helper(CHAOS_ALGO_LOGISTIC, 0, 5000, 1000));
+    CHECK_CALL(trajectories_helper(CHAOS_ALGO_CUBIC, 1500, 2750, 1000));
+    PASS();
+}
+
+// values outside the documented ranges are clamped rather than overflowing
+TEST test_out_of_range() {
+    for (int16_t alg = CHAOS_ALGO_LOGISTIC; alg <= CHAOS_ALGO_HENON; alg++) {
+        chaos_set_alg(alg);
+        chaos_set_r(32767);
+        chaos_set_val(-32768);
+        for (uint16_t i = 0; i < 1000; i++) {
+            int16_t v = chaos_get_val();
+            ASSERT(v >= -10000 && v <= 10000);
+        }
+        ASSERT_EQ(chaos_get_r(), 32767);
+    }
+    chaos_set_alg(CHAOS_ALGO_LOGISTIC);
+    chaos_set_r(5000);
+    chaos_set_val(5000);
+    PASS();
+}
+
+SUITE(chaos_suite) {
+    RUN_TEST(test_first_steps);
+    RUN_TEST(test_periodic_orbits);
+    RUN_TEST(test_out_of_range);
+}
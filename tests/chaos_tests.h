@@ -0,0 +1,8 @@
+#ifndef _CHAOS_TESTS_H_
+#define _CHAOS_TESTS_H_
+
+#include "greatest/greatest.h"
+
+SUITE_EXTERN(chaos_suite);
+
+#endif
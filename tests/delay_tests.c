@@ -0,0 +1,342 @@
+#include "delay_tests.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "greatest/greatest.h"
+#include "teletype.h"
+
+typedef struct {
+    int16_t time;
+    int16_t tag;
+} reference_delay_t;
+
+// the linear slot scan that tele_tick used before the delay heap, each tick
+// every occupied slot is decremented and fired in slot order
+static uint8_t reference_order(const reference_delay_t *delays, uint8_t n,
+                               const uint8_t *ticks, uint8_t tick_count,
+                               int16_t *out) {
+    int16_t time[DELAY_SIZE] = { 0 };
+    int16_t tag[DELAY_SIZE];
+    uint8_t out_len = 0;
+
+    for (uint8_t d = 0; d < n; d++) {
+        uint8_t i = 0;
+        while (i < DELAY_SIZE && time[i] != 0) i++;
+        if (i == DELAY_SIZE) break;
+        time[i] = delays[d].time < 1 ? 1 : delays[d].time;
+        tag[i] = delays[d].tag;
+    }
+
+    for (uint8_t t = 0; t < tick_count; t++) {
+        for (uint8_t i = 0; i < DELAY_SIZE; i++) {
+            if (time[i]) {
+                time[i] -= ticks[t];
+                if (time[i] <= 0) {
+                    out[out_len++] = tag[i];
+                    time[i] = 0;
+                }
+            }
+        }
+    }
+
+    return out_len;
+}
+
+// runs lines from script 1 and then ticks the scene, the delayed commands
+// record their firing order with P.PUSH
+TEST delay_order_helper(size_t n, char *lines[], const uint8_t *ticks,
+                        uint8_t tick_count, const int16_t *expected,
+                        uint8_t expected_len) {
+    scene_state_t ss;
+    ss_init(&ss);
+    exec_state_t es;
+    es_init(&es);
+    es_push(&es);
+    es_variables(&es)->script_number = 1;
+
+    for (size_t i = 0; i < n; i++) {
+        tele_command_t cmd;
+        char error_msg[TELE_ERROR_MSG_LENGTH];
+        ASSERT_EQm(lines[i], parse(lines[i], &cmd, error_msg), E_OK);
+        ASSERT_EQm(lines[i], validate(&cmd, error_msg), E_OK);
+        process_command(&ss, &es, &cmd);
+    }
+
+    for (uint8_t t = 0; t < tick_count; t++) tele_tick(&ss, ticks[t]);
+
+    ASSERT_EQ(ss_get_pattern_len(&ss, 0), expected_len);
+    for (uint8_t i = 0; i < expected_len; i++)
+        ASSERT_EQ(ss_get_pattern_val(&ss, 0, i), expected[i]);
+
+    PASS();
+}
+
+TEST test_delay_order_coarse_ticks() {
+    char *lines[] = { "DEL 15: P.PUSH 1", "DEL 12: P.PUSH 2",
+                      "DEL 40: P.PUSH 3", "DEL 25: P.PUSH 4",
+                      "DEL 0: P.PUSH 5" };
+    const reference_delay_t delays[] = {
+        { 15, 1 }, { 12, 2 }, { 40, 3 }, { 25, 4 }, { 0, 5 }
+    };
+    const uint8_t ticks[] = { 10, 10, 10, 10, 10 };
+
+    int16_t expected[DELAY_SIZE];
+    uint8_t len = reference_order(delays, 5, ticks, 5, expected);
+    ASSERT_EQ(len, 5);
+
+    CHECK_CALL(delay_order_helper(5, lines, ticks, 5, expected, len));
+    PASS();
+}
+
+TEST test_delay_order_fine_ticks() {
+    char *lines[] = { "DEL.X 3 10: P.PUSH 1", "DEL.R 3 15: P.PUSH 2",
+                      "DEL.B 5 3: P.PUSH 3", "DEL 10: P.PUSH 4" };
+    const reference_delay_t delays[] = { { 10, 1 }, { 20, 1 }, { 30, 1 },
+                                         { 1, 2 },  { 16, 2 }, { 31, 2 },
+                                         { 1, 3 },  { 5, 3 },  { 10, 4 } };
+    uint8_t ticks[40];
+    memset(ticks, 1, sizeof(ticks));
+
+    int16_t expected[DELAY_SIZE];
+    uint8_t len = reference_order(delays, 9, ticks, 40, expected);
+    ASSERT_EQ(len, 9);
+
+    CHECK_CALL(delay_order_helper(4, lines, ticks, 40, expected, len));
+    PASS();
+}
+
+TEST test_delay_order_full() {
+    // 64 slots are taken, the remaining delays are dropped
+    char *lines[] = { "DEL.X 40 5: P.PUSH 1", "DEL.R 40 3: P.PUSH 2" };
+    reference_delay_t delays[80];
+    for (uint8_t i = 0; i < 40; i++) {
+        delays[i].time = (i + 1) * 5;
+        delays[i].tag = 1;
+        delays[40 + i].time = i * 3 + 1;
+        delays[40 + i].tag = 2;
+    }
+    uint8_t ticks[25];
+    memset(ticks, 10, sizeof(ticks));
+
+    int16_t expected[DELAY_SIZE];
+    uint8_t len = reference_order(delays, 80, ticks, 25, expected);
+    ASSERT_EQ(len, DELAY_SIZE);
+
+    CHECK_CALL(delay_order_helper(2, lines, ticks, 25, expected, len));
+    PASS();
+}
+
+TEST test_delay_nested() {
+    // a delay queued by a delayed command is timed from when it was queued
+    scene_state_t ss;
+    ss_init(&ss);
+    tele_command_t cmd;
+    char error_msg[TELE_ERROR_MSG_LENGTH];
+    cmd.comment = false;
+    ASSERT_EQ(parse("DEL 10: P.PUSH 1", &cmd, error_msg), E_OK);
+    ss_overwrite_script_command(&ss, 2, 0, &cmd);
+    ASSERT_EQ(parse("DEL 10: SCRIPT 3", &cmd, error_msg), E_OK);
+    ss_overwrite_script_command(&ss, 0, 0, &cmd);
+    ASSERT_EQ(parse("DEL 15: P.PUSH 2", &cmd, error_msg), E_OK);
+    ss_overwrite_script_command(&ss, 0, 1, &cmd);
+    ASSERT_EQ(parse("DEL 30: P.PUSH 3", &cmd, error_msg), E_OK);
+    ss_overwrite_script_command(&ss, 0, 2, &cmd);
+
+    run_script(&ss, 0);
+    for (uint8_t t = 0; t < 30; t++) tele_tick(&ss, 1);
+
+    ASSERT_EQ(ss_get_pattern_len(&ss, 0), 3);
+    ASSERT_EQ(ss_get_pattern_val(&ss, 0, 0), 2);
+    ASSERT_EQ(ss_get_pattern_val(&ss, 0, 1), 1);
+    ASSERT_EQ(ss_get_pattern_val(&ss, 0, 2), 3);
+    ASSERT_EQ(ss.delay.count, 0);
+    PASS();
+}
+
+TEST test_delay_clear() {
+    // DEL.CLR from a delayed command drops the rest of that tick's delays
+    char *lines[] = { "DEL 5: P.PUSH 1", "DEL 6: DEL.CLR", "DEL 7: P.PUSH 2",
+                      "DEL 20: P.PUSH 3" };
+    const int16_t expected[] = { 1 };
+    const uint8_t ticks[] = { 10, 10, 10 };
+
+    CHECK_CALL(delay_order_helper(4, lines, ticks, 3, expected, 1));
+    PASS();
+}
+
+// runs line as if it was in script (0 based) and returns its value
+static int16_t delay_run_line(scene_state_t *ss, uint8_t script,
+                              const char *line) {
+    exec_state_t es;
+    es_init(&es);
+    es_push(&es);
+    es_variables(&es)->script_number = script;
+    tele_command_t cmd;
+    char error_msg[TELE_ERROR_MSG_LENGTH];
+    if (parse(line, &cmd, error_msg) != E_OK) return INT16_MIN;
+    if (validate(&cmd, error_msg) != E_OK) return INT16_MIN;
+    process_result_t result = process_command(ss, &es, &cmd);
+    return result.has_value ? result.value : 0;
+}
+
+TEST test_delay_kill() {
+    scene_state_t ss;
+    ss_init(&ss);
+    delay_run_line(&ss, 0, "DEL 10: P.PUSH 1");
+    delay_run_line(&ss, 0, "DEL.X 3 5: P.PUSH 2");
+    delay_run_line(&ss, 1, "DEL 15: P.PUSH 3");
+    ASSERT_EQ(delay_run_line(&ss, 1, "DEL.N 1"), 4);
+    ASSERT_EQ(delay_run_line(&ss, 1, "DEL.N 2"), 1);
+    ASSERT_EQ(delay_run_line(&ss, 1, "DEL.N 11"), 0);
+
+    delay_run_line(&ss, 1, "DEL.KILL 1");
+    ASSERT_EQ(delay_run_line(&ss, 1, "DEL.N 1"), 0);
+    ASSERT_EQ(ss.delay.count, 1);
+    ASSERT_EQ(ss.delay.free_count, DELAY_SIZE - 1);
+
+    for (uint8_t t = 0; t < 20; t++) tele_tick(&ss, 1);
+    ASSERT_EQ(ss_get_pattern_len(&ss, 0), 1);
+    ASSERT_EQ(ss_get_pattern_val(&ss, 0, 0), 3);
+    ASSERT_EQ(ss.delay.free_count, DELAY_SIZE);
+    PASS();
+}
+
+TEST test_delay_kill_same_tick() {
+    // a delay can cancel its script's other delays that are due in the same
+    // tick, delays from other scripts still run
+    scene_state_t ss;
+    ss_init(&ss);
+    delay_run_line(&ss, 1, "DEL 5: DEL.KILL $");
+    delay_run_line(&ss, 1, "DEL 6: P.PUSH 1");
+    delay_run_line(&ss, 0, "DEL 7: P.PUSH 2");
+    delay_run_line(&ss, 1, "DEL 30: P.PUSH 3");
+    tele_tick(&ss, 10);
+    tele_tick(&ss, 30);
+
+    ASSERT_EQ(ss_get_pattern_len(&ss, 0), 1);
+    ASSERT_EQ(ss_get_pattern_val(&ss, 0, 0), 2);
+    ASSERT_EQ(ss.delay.count, 0);
+    ASSERT_EQ(ss.delay.free_count, DELAY_SIZE);
+    PASS();
+}
+
+TEST test_delay_kill_order() {
+    // cancelling from the middle of the heap keeps the rest in order
+    scene_state_t ss;
+    ss_init(&ss);
+    reference_delay_t kept[DELAY_SIZE];
+    uint8_t kept_count = 0;
+    for (uint8_t i = 0; i < DELAY_SIZE; i++) {
+        int16_t time = (i * 37) % 100 + 1;
+        uint8_t script = i % 3;
+        char line[32];
+        sprintf(line, "DEL %d: P.PUSH %d", time, i);
+        delay_run_line(&ss, script, line);
+        if (script != 1) {
+            kept[kept_count].time = time;
+            kept[kept_count].tag = i;
+            kept_count++;
+        }
+    }
+    delay_run_line(&ss, 0, "DEL.KILL 2");
+    ASSERT_EQ(ss.delay.count, kept_count);
+
+    uint8_t ticks[100];
+    memset(ticks, 1, sizeof(ticks));
+    int16_t expected[DELAY_SIZE];
+    uint8_t len = reference_order(kept, kept_count, ticks, 100, expected);
+    ASSERT_EQ(len, kept_count);
+
+    for (uint8_t t = 0; t < 100; t++) tele_tick(&ss, ticks[t]);
+    ASSERT_EQ(ss_get_pattern_len(&ss, 0), len);
+    for (uint8_t i = 0; i < len; i++)
+        ASSERT_EQ(ss_get_pattern_val(&ss, 0, i), expected[i]);
+    PASS();
+}
+
+TEST test_delay_init_same_tick() {
+    // INIT from a delayed command throws away the delays due with it, even
+    // when the scene has already been through ss_init before
+    scene_state_t ss;
+    ss_init(&ss);
+    ss_init(&ss);
+    delay_run_line(&ss, 1, "DEL 5: INIT");
+    delay_run_line(&ss, 1, "DEL 6: P.PUSH 1");
+    delay_run_line(&ss, 0, "DEL 7: P.PUSH 2");
+    delay_run_line(&ss, 2, "DEL 30: P.PUSH 3");
+    tele_tick(&ss, 10);
+
+    ASSERT_EQ(ss_get_pattern_len(&ss, 0), 0);
+    ASSERT_EQ(ss.delay.count, 0);
+    ASSERT_EQ(ss.delay.free_count, DELAY_SIZE);
+
+    // and the pool still works afterwards
+    delay_run_line(&ss, 0, "DEL 5: P.PUSH 4");
+    tele_tick(&ss, 30);
+    ASSERT_EQ(ss_get_pattern_len(&ss, 0), 1);
+    ASSERT_EQ(ss_get_pattern_val(&ss, 0, 0), 4);
+    ASSERT_EQ(ss.delay.free_count, DELAY_SIZE);
+    PASS();
+}
+
+TEST test_delay_order_reused_slot() {
+    // a delay that reuses a lower slot still fires after the delays that
+    // were queued before it, unlike the old slot scan
+    scene_state_t ss;
+    ss_init(&ss);
+    delay_run_line(&ss, 0, "DEL 5: P.PUSH 1");
+    delay_run_line(&ss, 0, "DEL 50: P.PUSH 2");
+    tele_tick(&ss, 10);
+    delay_run_line(&ss, 0, "DEL 40: P.PUSH 3");
+    tele_tick(&ss, 40);
+
+    ASSERT_EQ(ss_get_pattern_len(&ss, 0), 3);
+    ASSERT_EQ(ss_get_pattern_val(&ss, 0, 0), 1);
+    ASSERT_EQ(ss_get_pattern_val(&ss, 0, 1), 2);
+    ASSERT_EQ(ss_get_pattern_val(&ss, 0, 2), 3);
+    PASS();
+}
+
+TEST test_delay_lists_after_init() {
+    // INIT.SCENE from a delayed command zeroes the scene while the tick is
+    // still holding popped slots, the per script lists must come out intact
+    scene_state_t ss;
+    ss_init(&ss);
+    delay_run_line(&ss, 1, "DEL 5: INIT.SCENE");
+    delay_run_line(&ss, 1, "DEL 6: P.PUSH 1");
+    delay_run_line(&ss, 2, "DEL 7: P.PUSH 2");
+    tele_tick(&ss, 10);
+
+    for (uint8_t i = 0; i < DELAY_SIZE; i++) ASSERT(!ss_delay_pending(&ss, i));
+
+    delay_run_line(&ss, 1, "DEL 5: P.PUSH 3");
+    delay_run_line(&ss, 2, "DEL 6: P.PUSH 4");
+    delay_run_line(&ss, 2, "DEL 7: DEL.KILL 3");
+    delay_run_line(&ss, 2, "DEL 8: P.PUSH 5");
+    ASSERT_EQ(delay_run_line(&ss, 1, "DEL.N 2"), 1);
+    ASSERT_EQ(delay_run_line(&ss, 1, "DEL.N 3"), 3);
+    tele_tick(&ss, 10);
+
+    ASSERT_EQ(ss_get_pattern_len(&ss, 0), 2);
+    ASSERT_EQ(ss_get_pattern_val(&ss, 0, 0), 3);
+    ASSERT_EQ(ss_get_pattern_val(&ss, 0, 1), 4);
+    ASSERT_EQ(ss.delay.count, 0);
+    ASSERT_EQ(ss.delay.free_count, DELAY_SIZE);
+    ASSERT_EQ(delay_run_line(&ss, 1, "DEL.N 3"), 0);
+    PASS();
+}
+
+SUITE(delay_suite) {
+    RUN_TEST(test_delay_order_coarse_ticks);
+    RUN_TEST(test_delay_order_fine_ticks);
+    RUN_TEST(test_delay_order_full);
+    RUN_TEST(test_delay_nested);
+    RUN_TEST(test_delay_clear);
+    RUN_TEST(test_delay_kill);
+    RUN_TEST(test_delay_kill_same_tick);
+    RUN_TEST(test_delay_kill_order);
+    RUN_TEST(test_delay_init_same_tick);
+    RUN_TEST(test_delay_order_reused_slot);
+    RUN_TEST(test_delay_lists_after_init);
+}
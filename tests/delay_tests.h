@@ -0,0 +1,8 @@
+#ifndef _DELAY_TESTS_H_
+#define _DELAY_TESTS_H_
+
+#include "greatest/greatest.h"
+
+SUITE_EXTERN(delay_suite);
+
+#endif
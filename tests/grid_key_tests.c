@@ -0,0 +1,83 @@
+#include "grid_key_tests.h"
+
+#include "greatest/greatest.h"
+#include "grid_key.h"
+#include "teletype.h"
+
+static void grid_run_line(scene_state_t *ss, const char *line) {
+    exec_state_t es;
+    es_init(&es);
+    es_push(&es);
+    tele_command_t cmd;
+    char error_msg[TELE_ERROR_MSG_LENGTH];
+    if (parse(line, &cmd, error_msg) != E_OK) return;
+    if (validate(&cmd, error_msg) != E_OK) return;
+    process_command(ss, &es, &cmd);
+}
+
+TEST test_grid_key_fader() {
+    scene_state_t ss;
+    ss_init(&ss);
+    uint8_t scripts[EDITABLE_SCRIPT_COUNT] = { 0 };
+
+    // a coarse fader jumps to the key
+    grid_run_line(&ss, "G.FDR 1 0 0 8 1 0 7 2");
+    ASSERT(!grid_key_fader(&ss, 1, 0, 1, GRID_KEY_NONE, GRID_KEY_NONE,
+                           scripts));
+    ASSERT(grid_key_fader(&ss, 1, 5, 0, GRID_KEY_NONE, GRID_KEY_NONE,
+                          scripts));
+    ASSERT_EQ(ss.grid.fader[1].value, 5);
+    ASSERT_EQ(ss.grid.latest_fader, 1);
+    ASSERT_EQ(scripts[1], 1);
+
+    // and slides there while another key on it is held
+    ASSERT(grid_key_fader(&ss, 1, 1, 0, 5, 0, scripts));
+    ASSERT_EQ(ss.grid.fader[1].value, 5);
+    ASSERT_EQ(ss.grid.fader[1].slide, 1);
+    ASSERT_EQ(ss.grid.fader[1].slide_end, 1);
+    ASSERT_EQ(ss.grid.fader[1].slide_dir, 0);
+    ASSERT_EQ(ss.grid.slide_head, 1);
+
+    // the end keys of a fine fader step it, holding one of them doesn't slide
+    grid_run_line(&ss, "G.FDR 2 0 1 6 1 4 8 0");
+    ASSERT(grid_key_fader(&ss, 2, 5, 1, 0, 1, scripts));
+    ASSERT_EQ(ss.grid.fader[2].value, 1);
+    ASSERT_EQ(ss.grid.fader[2].slide, 0);
+    ASSERT(grid_key_fader(&ss, 2, 3, 1, GRID_KEY_NONE, GRID_KEY_NONE,
+                          scripts));
+    ASSERT_EQ(ss.grid.fader[2].value, 5);
+    PASS();
+}
+
+TEST test_grid_key_button() {
+    scene_state_t ss;
+    ss_init(&ss);
+    uint8_t scripts[EDITABLE_SCRIPT_COUNT] = { 0 };
+
+    grid_run_line(&ss, "G.BTN 3 2 2 2 2 0 15 3");
+    grid_run_line(&ss, "G.BTN 4 0 0 1 1 1 15 0");
+
+    // a momentary button follows the key
+    ASSERT(grid_key_button(&ss, 3, 3, 3, 1, scripts));
+    ASSERT_EQ(ss.grid.button[3].state, 1);
+    ASSERT(grid_key_button(&ss, 3, 3, 3, 0, scripts));
+    ASSERT_EQ(ss.grid.button[3].state, 0);
+    ASSERT_EQ(scripts[2], 1);
+    ASSERT(!grid_key_button(&ss, 3, 4, 3, 1, scripts));
+
+    // a latching one toggles on the press
+    ASSERT(grid_key_button(&ss, 4, 0, 0, 1, scripts));
+    ASSERT(grid_key_button(&ss, 4, 0, 0, 0, scripts));
+    ASSERT_EQ(ss.grid.button[4].state, 1);
+    ASSERT_EQ(ss.grid.latest_button, 4);
+
+    // a disabled group ignores its controls
+    ss.grid.group[0].enabled = false;
+    ASSERT(!grid_key_button(&ss, 4, 0, 0, 1, scripts));
+    PASS();
+}
+
+SUITE(grid_key_suite) {
+    RUN_TEST(test_grid_key_fader);
+    RUN_TEST(test_grid_key_button);
+}
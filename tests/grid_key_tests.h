@@ -0,0 +1,8 @@
+#ifndef _GRID_KEY_TESTS_H_
+#define _GRID_KEY_TESTS_H_
+
+#include "greatest/greatest.h"
+
+SUITE_EXTERN(grid_key_suite);
+
+#endif
@@ -0,0 +1,106 @@
+#include "ii_bus_tests.h"
+
+#include "greatest/greatest.h"
+#include "ii.h"
+#include "ii_bus.h"
+#include "ops/telex.h"
+#include "state.h"
+
+// the virtual bus the simulators send their i2c traffic to, see
+// simulator/ii_bus.h
+
+static int16_t ii_bus_read_cv(uint8_t port) {
+    uint8_t query[2] = { TO_CV | II_GET, port };
+    uint8_t data[2];
+    ii_bus_tx(TO, query, 2);
+    ii_bus_rx(TO, data, 2);
+    return (int16_t)((data[0] << 8) | data[1]);
+}
+
+TEST test_bus_registers() {
+    ii_bus_init(100);
+
+    // a read returns the last value written to the register it queries
+    uint8_t write[4] = { TO_CV, 1, 0x12, 0x34 };
+    ii_bus_tx(TO, write, 4);
+    ASSERT_EQ(ii_bus_read_cv(1), 0x1234);
+    ASSERT_EQ(ii_bus_read_cv(2), 0);
+
+    // the second TXo answers on the next address with its own registers
+    ii_bus_tx(TO + 1, write, 4);
+    write[3] = 0x35;
+    ii_bus_tx(TO, write, 4);
+    ASSERT_EQ(ii_bus_read_cv(1), 0x1235);
+
+    uint8_t query[2] = { TO_CV | II_GET, 3 };
+    ii_bus_set(TO, query, 2, -5);
+    ASSERT_EQ(ii_bus_read_cv(3), -5);
+
+    // init forgets everything
+    ii_bus_init(100);
+    ASSERT_EQ(ii_bus_read_cv(1), 0);
+    PASS();
+}
+
+static void ii_bus_constant_rx(const ii_follower_t *f, uint8_t addr,
+                               uint8_t *data, uint8_t l) {
+    for (uint8_t i = 0; i < l; i++) data[i] = 0x11;
+}
+
+TEST test_bus_attach() {
+    ii_bus_init(100);
+    const ii_follower_t constant = { .name = "constant",
+                                     .addr = TO,
+                                     .count = 1,
+                                     .tx = ii_bus_register_tx,
+                                     .rx = ii_bus_constant_rx };
+    ASSERT(ii_bus_attach(&constant));
+    ASSERT_EQ(ii_bus_read_cv(1), 0x1111);
+
+    // addresses nobody answers on read as zeros
+    uint8_t data[2] = { 1, 1 };
+    ii_bus_rx(0x7F, data, 2);
+    ASSERT_EQ(data[0], 0);
+    ASSERT_EQ(data[1], 0);
+
+    ii_bus_init(100);
+    ASSERT_EQ(ii_bus_read_cv(1), 0);
+    PASS();
+}
+
+TEST test_bus_counts_by_script() {
+    ii_bus_init(100);
+    uint8_t write[4] = { TO_CV, 1, 0, 1 };
+
+    ii_bus_tx(TO, write, 4);
+    ii_bus_script_start(0);
+    ii_bus_tx(TO, write, 4);
+    // script 1 calling itself, then script 2
+    ii_bus_script_start(0);
+    ii_bus_tx(TO, write, 4);
+    ii_bus_script_start(1);
+    ii_bus_tx(TO, write, 4);
+    ii_bus_script_end();
+    ii_bus_script_end();
+    ii_bus_tx(TO, write, 4);
+    ii_bus_script_end();
+    ii_bus_tx(TO, write, 2);
+
+    ASSERT_EQ(ii_bus_script_count(0)->writes, 3);
+    ASSERT_EQ(ii_bus_script_count(1)->writes, 1);
+    const ii_bus_count_t *none = ii_bus_script_count(TOTAL_SCRIPT_COUNT);
+    ASSERT_EQ(none->writes, 2);
+    ASSERT_EQ(none->bytes, 6);
+    // a start, the address and the data bytes with their acks, and a stop
+    ASSERT_EQ(none->bits, (1 + 9 * 5 + 1) + (1 + 9 * 3 + 1));
+
+    ii_bus_reset_stats();
+    ASSERT_EQ(ii_bus_script_count(0)->writes, 0);
+    PASS();
+}
+
+SUITE(ii_bus_suite) {
+    RUN_TEST(test_bus_registers);
+    RUN_TEST(test_bus_attach);
+    RUN_TEST(test_bus_counts_by_script);
+}
@@ -0,0 +1,272 @@
+#include "ii_queue_tests.h"
+
+#include "greatest/greatest.h"
+#include "ii_cache.h"
+#include "ii_queue.h"
+#include "teletype.h"
+
+// counted by the tele_ii_tx and tele_ii_rx stubs
+extern uint32_t tele_ii_tx_calls;
+extern uint8_t tele_ii_tx_last[16];
+extern uint32_t tele_ii_rx_calls;
+
+TEST test_queue_holds_writes() {
+    ii_flush();
+    ii_queue_stats_reset();
+    tele_ii_tx_calls = 0;
+
+    uint8_t d[] = { 1, 2, 3 };
+    ii_tx(0x10, d, 3);
+    ii_tx(0x10, d, 3);
+    ASSERT_EQ(tele_ii_tx_calls, 0);
+    ii_flush();
+    ASSERT_EQ(tele_ii_tx_calls, 2);
+    ASSERT_EQ(ii_queue_stats()->max_depth, 2);
+
+    // a read sends what's queued first
+    ii_tx(0x10, d, 3);
+    uint8_t r[2];
+    ii_rx(0x10, r, 2);
+    ASSERT_EQ(tele_ii_tx_calls, 3);
+
+    // a full queue is sent to make room
+    for (uint8_t i = 0; i < II_QUEUE_SIZE + 1; i++) ii_tx(0x10, d, 3);
+    ASSERT_EQ(tele_ii_tx_calls, 3 + II_QUEUE_SIZE);
+    ii_flush();
+    ASSERT_EQ(ii_queue_stats()->sent, 4 + II_QUEUE_SIZE);
+    PASS();
+}
+
+TEST test_value_writes_coalesce() {
+    ii_flush();
+    ii_queue_stats_reset();
+    tele_ii_tx_calls = 0;
+
+    uint8_t a[] = { 0x10, 0, 0, 1 };
+    uint8_t b[] = { 0x10, 0, 0, 2 };
+    uint8_t other_port[] = { 0x10, 1, 0, 3 };
+    uint8_t pulse[] = { 0x05, 0 };
+
+    // the last write to a register wins
+    ii_tx_value(0x60, a, 4);
+    ii_tx_value(0x61, other_port, 4);
+    ii_tx_value(0x60, b, 4);
+    ii_flush();
+    ASSERT_EQ(tele_ii_tx_calls, 2);
+    ASSERT_EQ(ii_queue_stats()->coalesced, 1);
+
+    // but not past another write to the same follower
+    ii_tx_value(0x60, a, 4);
+    ii_tx(0x60, pulse, 2);
+    ii_tx_value(0x60, b, 4);
+    ii_tx_value(0x60, other_port, 4);
+    ii_tx_value(0x60, a, 4);
+    ii_flush();
+    ASSERT_EQ(tele_ii_tx_calls, 7);
+    ASSERT_EQ(ii_queue_stats()->coalesced, 1);
+    ASSERT_EQ(ii_queue_stats()->queued, 8);
+    PASS();
+}
+
+TEST test_script_flushes() {
+    ii_flush();
+    tele_ii_tx_calls = 0;
+
+    scene_state_t ss;
+    ss_init(&ss);
+    tele_command_t cmd;
+    char error_msg[TELE_ERROR_MSG_LENGTH];
+    cmd.comment = false;
+    ASSERT_EQ(parse("CV 5 1; CV 5 2; CV 5 3", &cmd, error_msg), E_OK);
+    ASSERT_EQ(validate(&cmd, error_msg), E_OK);
+    ss_overwrite_script_command(&ss, 0, 0, &cmd);
+
+    // the CV writes to the ansible go out as one once the script is done
+    run_script(&ss, 0);
+    ASSERT_EQ(tele_ii_tx_calls, 1);
+    ASSERT_EQ(tele_ii_tx_last[3], 3);
+    PASS();
+}
+
+TEST test_local_output_flushes() {
+    ii_flush();
+    tele_ii_tx_calls = 0;
+
+    scene_state_t ss;
+    ss_init(&ss);
+    tele_command_t cmd;
+    char error_msg[TELE_ERROR_MSG_LENGTH];
+    cmd.comment = false;
+    ASSERT_EQ(parse("CV 5 1; TR 1 1; CV 5 2", &cmd, error_msg), E_OK);
+    ASSERT_EQ(validate(&cmd, error_msg), E_OK);
+    ss_overwrite_script_command(&ss, 0, 0, &cmd);
+
+    // TR 1 goes out after CV 5 1, so the two CV writes can't be merged
+    run_script(&ss, 0);
+    ASSERT_EQ(tele_ii_tx_calls, 2);
+    ASSERT_EQ(tele_ii_tx_last[3], 2);
+
+    // a line run from live mode doesn't wait for the next tick either
+    tele_ii_tx_calls = 0;
+    ASSERT_EQ(parse("CV 5 3", &cmd, error_msg), E_OK);
+    ss_clear_script(&ss, LIVE_SCRIPT);
+    ss_overwrite_script_command(&ss, LIVE_SCRIPT, 0, &cmd);
+    exec_state_t es;
+    es_init(&es);
+    es_push(&es);
+    run_script_with_exec_state(&ss, &es, LIVE_SCRIPT);
+    ASSERT_EQ(tele_ii_tx_calls, 1);
+    PASS();
+}
+
+// a tick followed by the poll timer
+static void tick(uint8_t time) {
+    ii_cache_tick(time);
+    ii_cache_refresh();
+}
+
+TEST test_cache_reads() {
+    ii_flush();
+    ii_cache_clear();
+    tele_ii_rx_calls = 0;
+    uint8_t d[2];
+
+    // without polling every read goes to the bus
+    d[0] = 1;
+    ii_read(0x20, d, 1, 1);
+    d[0] = 1;
+    ii_read(0x20, d, 1, 1);
+    ASSERT_EQ(tele_ii_rx_calls, 2);
+    ASSERT_EQ(d[0], 2);
+
+    // with it only the first read does, the rest get the cached value
+    ii_cache_set_poll(100);
+    d[0] = 1;
+    ii_read(0x20, d, 1, 1);
+    ASSERT_EQ(tele_ii_rx_calls, 3);
+    ASSERT_EQ(ii_cache_last_age(), 0);
+    tick(50);
+    d[0] = 1;
+    ii_read(0x20, d, 1, 1);
+    ASSERT_EQ(tele_ii_rx_calls, 3);
+    ASSERT_EQ(d[0], 3);
+    ASSERT_EQ(ii_cache_last_age(), 50);
+
+    // until it's polled again
+    tick(50);
+    ASSERT_EQ(tele_ii_rx_calls, 4);
+    d[0] = 1;
+    ii_read(0x20, d, 1, 1);
+    ASSERT_EQ(d[0], 4);
+    ASSERT_EQ(ii_cache_last_age(), 0);
+
+    // a different query is a different value
+    d[0] = 2;
+    ii_read(0x20, d, 1, 1);
+    ASSERT_EQ(tele_ii_rx_calls, 5);
+
+    // sync reads and reads after a write go to the bus
+    ii_cache_sync(true);
+    d[0] = 1;
+    ii_read(0x20, d, 1, 1);
+    ii_cache_sync(false);
+    ASSERT_EQ(tele_ii_rx_calls, 6);
+    uint8_t w[] = { 3, 0 };
+    ii_tx(0x20, w, 2);
+    d[0] = 1;
+    ii_read(0x20, d, 1, 1);
+    ASSERT_EQ(tele_ii_rx_calls, 7);
+    d[0] = 1;
+    ii_read(0x20, d, 1, 1);
+    ASSERT_EQ(tele_ii_rx_calls, 7);
+
+    // values nobody reads stop being polled
+    for (uint16_t t = 0; t <= II_CACHE_IDLE_MS; t += 10) tick(10);
+    uint32_t calls = tele_ii_rx_calls;
+    tick(100);
+    ASSERT_EQ(tele_ii_rx_calls, calls);
+
+    ii_cache_clear();
+    PASS();
+}
+
+TEST test_cache_polls_in_turn() {
+    ii_flush();
+    ii_cache_clear();
+    ii_cache_set_poll(10);
+    tele_ii_rx_calls = 0;
+    uint8_t d[2];
+    for (uint8_t q = 1; q <= 3; q++) {
+        d[0] = q;
+        ii_read(0x20, d, 1, 1);
+    }
+    ASSERT_EQ(tele_ii_rx_calls, 3);
+
+    // all three are due, the tick never reads the bus and each poll only
+    // reads one of them
+    ii_cache_tick(10);
+    ASSERT_EQ(tele_ii_rx_calls, 3);
+    ii_cache_refresh();
+    ASSERT_EQ(tele_ii_rx_calls, 4);
+    tick(0);
+    ASSERT_EQ(tele_ii_rx_calls, 5);
+    tick(0);
+    ASSERT_EQ(tele_ii_rx_calls, 6);
+    tick(0);
+    ASSERT_EQ(tele_ii_rx_calls, 6);
+
+    // the first one is the next one due
+    tick(10);
+    ASSERT_EQ(tele_ii_rx_calls, 7);
+    d[0] = 1;
+    ii_read(0x20, d, 1, 1);
+    ASSERT_EQ(ii_cache_last_age(), 0);
+    d[0] = 2;
+    ii_read(0x20, d, 1, 1);
+    ASSERT_EQ(ii_cache_last_age(), 10);
+
+    ii_cache_clear();
+    PASS();
+}
+
+TEST test_cache_cleared_by_init() {
+    ii_flush();
+    ii_cache_clear();
+    ii_cache_set_poll(10);
+    uint8_t d[2] = { 1, 0 };
+    ii_read(0x20, d, 1, 1);
+
+    // a scene set up to be saved or loaded leaves the live one's cache alone
+    scene_state_t ss;
+    ss_init(&ss);
+    ASSERT_EQ(ii_cache_poll(), 10);
+
+    tele_command_t cmd;
+    char error_msg[TELE_ERROR_MSG_LENGTH];
+    cmd.comment = false;
+    ASSERT_EQ(parse("INIT", &cmd, error_msg), E_OK);
+    ASSERT_EQ(validate(&cmd, error_msg), E_OK);
+    ss_overwrite_script_command(&ss, 0, 0, &cmd);
+    run_script(&ss, 0);
+    ASSERT_EQ(ii_cache_poll(), 0);
+
+    // and the value read before is gone
+    ii_cache_set_poll(10);
+    tele_ii_rx_calls = 0;
+    d[0] = 1;
+    ii_read(0x20, d, 1, 1);
+    ASSERT_EQ(tele_ii_rx_calls, 1);
+
+    ii_cache_clear();
+    PASS();
+}
+
+SUITE(ii_queue_suite) {
+    RUN_TEST(test_queue_holds_writes);
+    RUN_TEST(test_value_writes_coalesce);
+    RUN_TEST(test_script_flushes);
+    RUN_TEST(test_local_output_flushes);
+    RUN_TEST(test_cache_reads);
+    RUN_TEST(test_cache_polls_in_turn);
+    RUN_TEST(test_cache_cleared_by_init);
+}
@@ -37,7 +37,74 @@ TEST match_token_should_return_mod() {
     PASS();
 }
 
+// match_token_span must find every op and mod without a NUL terminator, so
+// the name is followed by more text in the buffer.
+TEST match_token_span_should_return_op_and_mod() {
+    char text[64];
+    for (size_t i = 0; i < E_OP__LENGTH; i++) {
+        const char* name = tele_ops[i]->name;
+        strcpy(text, name);
+        strcat(text, "X 1");
+        tele_data_t data;
+        bool result = match_token_span(text, strlen(name), &data);
+        ASSERT_EQm(name, result, true);
+        ASSERT_EQm(name, data.tag, OP);
+        ASSERT_EQm(name, data.value, (int16_t)i);
+    }
+    for (size_t i = 0; i < E_MOD__LENGTH; i++) {
+        const char* name = tele_mods[i]->name;
+        strcpy(text, name);
+        strcat(text, ": X");
+        tele_data_t data;
+        bool result = match_token_span(text, strlen(name), &data);
+        ASSERT_EQm(name, result, true);
+        ASSERT_EQm(name, data.tag, MOD);
+        ASSERT_EQm(name, data.value, (int16_t)i);
+    }
+    PASS();
+}
+
+// Numbers are converted the same way as the MATCH_NUMBER action in
+// match_token.rl, including strtol's octal reading of a leading 0.
+TEST match_token_span_should_return_number() {
+    const struct {
+        const char* text;
+        tele_word_t tag;
+        int16_t value;
+    } numbers[] = {
+        { "0", NUMBER, 0 },          { "-1", NUMBER, -1 },
+        { "32767", NUMBER, 32767 },  { "40000", NUMBER, 32767 },
+        { "-40000", NUMBER, -32768 }, { "010", NUMBER, 8 },
+        { "X1F", XNUMBER, 31 },      { "XFFFF", XNUMBER, -1 },
+        { "B101", BNUMBER, 5 },      { "R1", RNUMBER, 1 },
+        { "R01", RNUMBER, 2 },       { "R110", RNUMBER, 3 },
+    };
+    for (size_t i = 0; i < sizeof(numbers) / sizeof(numbers[0]); i++) {
+        const char* text = numbers[i].text;
+        tele_data_t data;
+        bool result = match_token_span(text, strlen(text), &data);
+        ASSERT_EQm(text, result, true);
+        ASSERT_EQm(text, data.tag, numbers[i].tag);
+        ASSERT_EQm(text, data.value, numbers[i].value);
+    }
+    PASS();
+}
+
+TEST match_token_span_should_reject_unknown() {
+    const char* tokens[] = { "ADD1", "add", "X-1", "XG",
+                             "B2",   "R2",  "--1", "P.N." };
+    for (size_t i = 0; i < sizeof(tokens) / sizeof(tokens[0]); i++) {
+        tele_data_t data;
+        ASSERT_FALSEm(tokens[i],
+                      match_token_span(tokens[i], strlen(tokens[i]), &data));
+    }
+    PASS();
+}
+
 SUITE(match_token_suite) {
     RUN_TEST(match_token_should_return_op);
     RUN_TEST(match_token_should_return_mod);
+    RUN_TEST(match_token_span_should_return_op_and_mod);
+    RUN_TEST(match_token_span_should_return_number);
+    RUN_TEST(match_token_span_should_reject_unknown);
 }
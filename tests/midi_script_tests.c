@@ -0,0 +1,56 @@
+#include "midi_script_tests.h"
+
+#include "greatest/greatest.h"
+#include "midi_script.h"
+#include "teletype.h"
+
+TEST test_midi_script_queue() {
+    scene_state_t ss;
+    ss_init(&ss);
+    ss.midi.on_script = 0;
+    ss.midi.cc_script = 1;
+
+    midi_script_note_on(&ss, 2, 60, 100);
+    ASSERT_EQ(ss.midi.on_count, 1);
+    ASSERT_EQ(ss.midi.note_on[0], 60);
+    ASSERT_EQ(ss.midi.last_event_type, 1);
+
+    // no off script, so note offs are only remembered as the last event
+    midi_script_note_off(&ss, 2, 60, 0);
+    ASSERT_EQ(ss.midi.off_count, 0);
+    ASSERT_EQ(ss.midi.last_event_type, 2);
+
+    // a controller that moves again keeps its slot
+    midi_script_cc(&ss, 1, 7, 10);
+    midi_script_cc(&ss, 1, 7, 20);
+    midi_script_cc(&ss, 2, 7, 30);
+    ASSERT_EQ(ss.midi.cc_count, 2);
+    ASSERT_EQ(ss.midi.cc[0], 20);
+    ASSERT_EQ(ss.midi.cc[1], 30);
+
+    midi_script_run_queued(&ss);
+    ASSERT_EQ(ss.midi.on_count, 0);
+    ASSERT_EQ(ss.midi.cc_count, 0);
+    PASS();
+}
+
+TEST test_midi_script_clock() {
+    scene_state_t ss;
+    ss_init(&ss);
+    uint8_t counter = 0;
+    ss.midi.clock_div = 3;
+
+    midi_script_clock(&ss, &counter);
+    midi_script_clock(&ss, &counter);
+    ASSERT_EQ(counter, 2);
+    ASSERT(ss.midi.last_event_type != 4);
+    midi_script_clock(&ss, &counter);
+    ASSERT_EQ(counter, 0);
+    ASSERT_EQ(ss.midi.last_event_type, 4);
+    PASS();
+}
+
+SUITE(midi_script_suite) {
+    RUN_TEST(test_midi_script_queue);
+    RUN_TEST(test_midi_script_clock);
+}
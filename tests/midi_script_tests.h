@@ -0,0 +1,8 @@
+#ifndef _MIDI_SCRIPT_TESTS_H_
+#define _MIDI_SCRIPT_TESTS_H_
+
+#include "greatest/greatest.h"
+
+SUITE_EXTERN(midi_script_suite);
+
+#endif
@@ -112,7 +112,9 @@ TEST mod_stack_size() {
                                              .separator = 0,
                                              .data = { { .tag = OP,
                                                          .value = E_OP_A } } };
-        mod->func(&ss, &es, &cs, &sub_command);
+        tele_command_view_t sub_view;
+        command_view(&sub_view, &sub_command);
+        mod->func(&ss, &es, &cs, &sub_view);
 
         // check that the stack has the correct number of items in it
         ASSERT_EQm(mod->name, cs_stack_size(&cs), stack_extra);
@@ -5,7 +5,12 @@
 #include <unistd.h>  // ssize_t
 
 #include "greatest/greatest.h"
+#include "ops/op.h"
 #include "teletype.h"
+
+// counted by the tele_save_calibration stub
+extern uint32_t tele_save_calibration_calls;
+
 // runs multiple lines of commands and then asserts that the final answer is
 // correct (allows contiuation of state)
 TEST process_helper_state(scene_state_t* ss, size_t n, char* lines[],
@@ -359,6 +364,236 @@ TEST test_P_ROT_3() {
     PASS();
 }
 
+// runs each line both through process_command and as a compiled script line
+// and checks that the results and variables agree
+TEST test_compiled_commands() {
+    char* lines[] = { "1",
+                      "ADD 5 6",
+                      "X 5",
+                      "X",
+                      "X 4; Y 6; ADD X Y",
+                      "X 3; Y X",
+                      "A ADD A 1",
+                      "IF 1: X 7",
+                      "IF 0: X 8",
+                      "L 1 4: X ADD X I",
+                      "IF EQ X 0: Z 2; Y 3",
+                      "P.N 1; P 2 5; P 2",
+                      "TR.P 1",
+                      "X ADD 1 MUL 2 3",
+                      "Y SUB ADD X 1 4; Z DIV 7 0",
+                      "X N 12; Y ? 0 1 2; A RSH 256 2",
+                      "IF 1: X ADD 2 3",
+                      "L 1 3: X ADD X 1; Y SUB Y I",
+                      "" };
+    const size_t count = sizeof(lines) / sizeof(lines[0]);
+
+    for (size_t i = 0; i < count; i++) {
+        tele_command_t cmd;
+        char error_msg[TELE_ERROR_MSG_LENGTH];
+        ASSERT_EQm(lines[i], parse(lines[i], &cmd, error_msg), E_OK);
+        ASSERT_EQm(lines[i], validate(&cmd, error_msg), E_OK);
+
+        scene_state_t interpreted;
+        ss_init(&interpreted);
+        exec_state_t es;
+        es_init(&es);
+        es_push(&es);
+        es_variables(&es)->script_number = 0;
+        process_result_t expected = process_command(&interpreted, &es, &cmd);
+
+        scene_state_t compiled;
+        ss_init(&compiled);
+        cmd.comment = false;
+        ss_overwrite_script_command(&compiled, 0, 0, &cmd);
+        ASSERTm(lines[i], ss_get_script_compiled(&compiled, 0, 0)->ok);
+        process_result_t result = run_script(&compiled, 0);
+
+        ASSERT_EQm(lines[i], result.has_value, expected.has_value);
+        ASSERT_EQm(lines[i], result.value, expected.value);
+        ASSERT_EQm(lines[i], compiled.variables.a, interpreted.variables.a);
+        ASSERT_EQm(lines[i], compiled.variables.x, interpreted.variables.x);
+        ASSERT_EQm(lines[i], compiled.variables.y, interpreted.variables.y);
+        ASSERT_EQm(lines[i], compiled.variables.z, interpreted.variables.z);
+        ASSERT_EQm(lines[i], ss_get_pattern_val(&compiled, 1, 2),
+                   ss_get_pattern_val(&interpreted, 1, 2));
+    }
+
+    PASS();
+}
+
+// stores line as script 0 line 0 and checks the number of compiled words
+TEST compiled_length_helper(char* line, uint8_t length) {
+    tele_command_t cmd;
+    char error_msg[TELE_ERROR_MSG_LENGTH];
+    ASSERT_EQm(line, parse(line, &cmd, error_msg), E_OK);
+    ASSERT_EQm(line, validate(&cmd, error_msg), E_OK);
+
+    scene_state_t ss;
+    ss_init(&ss);
+    cmd.comment = false;
+    ss_overwrite_script_command(&ss, 0, 0, &cmd);
+    const tele_compiled_t* compiled = ss_get_script_compiled(&ss, 0, 0);
+    ASSERTm(line, compiled->ok);
+    ASSERT_EQm(line, compiled->sub_end[compiled->sub_count - 1], length);
+
+    // the stored command still prints as it was typed
+    char printed[32];
+    print_command(ss_get_script_command(&ss, 0, 0), printed);
+    ASSERT_STR_EQm(line, line, printed);
+    PASS();
+}
+
+TEST test_constant_folding() {
+    // pure ops with number params collapse into one push
+    CHECK_CALL(compiled_length_helper("ADD 1 2", 1));
+    CHECK_CALL(compiled_length_helper("X ADD 1 MUL 2 3", 2));
+    CHECK_CALL(compiled_length_helper("X N 12; Y 1", 4));
+    // but not if a param is a variable or the op isn't pure
+    CHECK_CALL(compiled_length_helper("ADD X MUL 2 3", 3));
+    CHECK_CALL(compiled_length_helper("ADD RAND 5 1", 4));
+    CHECK_CALL(compiled_length_helper("TR.P 1", 2));
+    // the POST of a MOD is compiled too
+    CHECK_CALL(compiled_length_helper("IF 1: X ADD 2 3", 4));
+    CHECK_CALL(compiled_length_helper("L 1 4: X ADD X I", 7));
+    PASS();
+}
+
+// parses line into script (0 based) line 0
+static void compiled_store(scene_state_t* ss, uint8_t script, char* line) {
+    tele_command_t cmd;
+    char error_msg[TELE_ERROR_MSG_LENGTH];
+    parse(line, &cmd, error_msg);
+    cmd.comment = false;
+    ss_overwrite_script_command(ss, script, 0, &cmd);
+}
+
+// op and mod words point at their definitions, they're run from there
+TEST test_compiled_resolved() {
+    scene_state_t ss;
+    ss_init(&ss);
+    compiled_store(&ss, 0, "IF X: Y ADD X 1");
+    const tele_compiled_t* c = ss_get_script_compiled(&ss, 0, 0);
+    ASSERT(c->ok);
+
+    uint8_t ops = 0, mods = 0;
+    for (uint8_t w = 0; w < c->sub_end[c->sub_count - 1]; w++) {
+        const tele_compiled_word_t* word = &c->words[w];
+        if (word->instr == I_MOD) {
+            ASSERT_EQ(word->call.mod, tele_mods[word->value]);
+            mods++;
+        }
+        else if (word->instr != I_PUSH) {
+            ASSERT_EQ(word->call.op, tele_ops[word->value]);
+            ops++;
+        }
+    }
+    ASSERT_EQ(ops, 4);
+    ASSERT_EQ(mods, 1);
+    PASS();
+}
+
+TEST test_compiled_replaced() {
+    scene_state_t ss;
+    ss_init(&ss);
+
+    // a line that clears its own script isn't compiled, it runs from a copy
+    // and finishes
+    compiled_store(&ss, 1, "INIT.SCRIPT 2; X 5");
+    ASSERT(!ss_get_script_compiled(&ss, 1, 0)->ok);
+    run_script(&ss, 1);
+    ASSERT_EQ(ss.variables.x, 5);
+    ASSERT_EQ(ss_get_script_len(&ss, 1), 0);
+
+    // a compiled line whose script is cleared by a script it calls runs from
+    // a copy too, and finishes
+    compiled_store(&ss, 0, "SCRIPT 3; Y 5");
+    compiled_store(&ss, 2, "INIT.SCRIPT 1");
+    ASSERT(ss_get_script_compiled(&ss, 0, 0)->ok);
+    run_script(&ss, 0);
+    ASSERT_EQ(ss.variables.y, 5);
+    ASSERT_EQ(ss_get_script_len(&ss, 0), 0);
+
+    // and so does the POST of a MOD, every time round
+    ss.variables.y = 0;
+    compiled_store(&ss, 0, "L 1 4: SCRIPT 3; Y ADD Y 1");
+    run_script(&ss, 0);
+    ASSERT_EQ(ss.variables.y, 4);
+
+    // a script cleared by an unrelated one doesn't stop the caller either
+    ss.variables.y = 0;
+    compiled_store(&ss, 0, "$ 3; Y 7");
+    compiled_store(&ss, 2, "INIT.SCRIPT 2");
+    compiled_store(&ss, 1, "X 1");
+    run_script(&ss, 0);
+    ASSERT_EQ(ss.variables.y, 7);
+    ASSERT_EQ(ss_get_script_len(&ss, 1), 0);
+    PASS();
+}
+
+TEST test_compiled_two_scenes() {
+    // the compiled lines belong to one scene at a time, the other one gets
+    // its lines compiled again when it runs them
+    scene_state_t a, b;
+    ss_init(&a);
+    ss_init(&b);
+    compiled_store(&a, 0, "X ADD X 1");
+    compiled_store(&b, 0, "X ADD X 10");
+    for (uint8_t i = 0; i < 3; i++) {
+        run_script(&a, 0);
+        run_script(&b, 0);
+    }
+    ASSERT_EQ(a.variables.x, 3);
+    ASSERT_EQ(b.variables.x, 30);
+
+    // ss_init throws the lines away with the scripts
+    ss_init(&a);
+    run_script(&a, 0);
+    ASSERT_EQ(a.variables.x, 0);
+    PASS();
+}
+
+// runs tele_tick in 10 ms steps, like the module does
+static void tick_for(scene_state_t* ss, int16_t ms) {
+    for (int16_t t = 0; t < ms; t += 10) tele_tick(ss, 10);
+}
+
+TEST test_calibration_saves() {
+    scene_state_t ss;
+    ss_init(&ss);
+    tele_save_calibration_calls = 0;
+
+    // calibrating in a loop doesn't save anything straight away
+    char* test1[2] = { "L 1 100: PARAM.CAL.MIN", "1" };
+    CHECK_CALL(process_helper_state(&ss, 2, test1, 1));
+    ASSERT_EQ(tele_save_calibration_calls, 0);
+
+    // but once, after it has been left alone for CAL_SAVE_DELAY_MS
+    tick_for(&ss, CAL_SAVE_DELAY_MS - 10);
+    ASSERT_EQ(tele_save_calibration_calls, 0);
+    tele_tick(&ss, 10);
+    ASSERT_EQ(tele_save_calibration_calls, 1);
+    tick_for(&ss, CAL_SAVE_DELAY_MS);
+    ASSERT_EQ(tele_save_calibration_calls, 1);
+
+    // a change restarts the wait
+    char* test2[2] = { "IN.CAL.RESET", "1" };
+    CHECK_CALL(process_helper_state(&ss, 2, test2, 1));
+    tick_for(&ss, CAL_SAVE_DELAY_MS - 100);
+    CHECK_CALL(process_helper_state(&ss, 2, test2, 1));
+    tick_for(&ss, 200);
+    ASSERT_EQ(tele_save_calibration_calls, 1);
+
+    // and committing saves straight away, only if there's something to save
+    ss_cal_commit(&ss);
+    ASSERT_EQ(tele_save_calibration_calls, 2);
+    ss_cal_commit(&ss);
+    tick_for(&ss, CAL_SAVE_DELAY_MS);
+    ASSERT_EQ(tele_save_calibration_calls, 2);
+
+    PASS();
+}
+
 SUITE(process_suite) {
     RUN_TEST(test_numbers);
     RUN_TEST(test_ADD);
@@ -375,4 +610,10 @@ SUITE(process_suite) {
     RUN_TEST(test_blank_command);
     RUN_TEST(test_P_ROT_1);
     RUN_TEST(test_P_ROT_3);
+    RUN_TEST(test_compiled_commands);
+    RUN_TEST(test_constant_folding);
+    RUN_TEST(test_compiled_resolved);
+    RUN_TEST(test_compiled_replaced);
+    RUN_TEST(test_compiled_two_scenes);
+    RUN_TEST(test_calibration_saves);
 }
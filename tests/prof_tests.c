@@ -0,0 +1,114 @@
+#include "prof_tests.h"
+
+#include <string.h>
+
+#include "greatest/greatest.h"
+#include "ops/prof.h"
+#include "teletype.h"
+
+// the test stubs advance the profile counter by one on every read, so each
+// op call is timed at one microsecond
+
+static int16_t prof_run_line(scene_state_t *ss, const char *line) {
+    exec_state_t es;
+    es_init(&es);
+    es_push(&es);
+    tele_command_t cmd;
+    char error_msg[TELE_ERROR_MSG_LENGTH];
+    if (parse(line, &cmd, error_msg) != E_OK) return INT16_MIN;
+    if (validate(&cmd, error_msg) != E_OK) return INT16_MIN;
+    process_result_t result = process_command(ss, &es, &cmd);
+    return result.has_value ? result.value : 0;
+}
+
+TEST test_prof_count() {
+    scene_state_t ss;
+    ss_init(&ss);
+    prof_clear();
+    for (uint8_t i = 0; i < 10; i++) prof_run_line(&ss, "X ADD X 1");
+
+    // X is called twice per line, once to get and once to set
+    const char *name;
+    const op_profile_t *p = prof_rank(0, &name);
+    ASSERT(p != NULL);
+    ASSERT_STR_EQ(name, "X");
+    ASSERT_EQ(p->calls, 20);
+    ASSERT_EQ(p->cycles, 20);
+    p = prof_rank(1, &name);
+    ASSERT(p != NULL);
+    ASSERT_STR_EQ(name, "ADD");
+    ASSERT_EQ(p->calls, 10);
+    ASSERT(prof_rank(2, NULL) == NULL);
+
+    ASSERT_EQ(prof_run_line(&ss, "PROF.OP 0"), 20);
+    ASSERT_EQ(prof_run_line(&ss, "PROF.US 0"), 20);
+    ASSERT_EQ(prof_run_line(&ss, "PROF.OP 1"), 10);
+    ASSERT_EQ(prof_run_line(&ss, "PROF.US 1"), 10);
+    // out of range ranks read as 0
+    ASSERT_EQ(prof_run_line(&ss, "PROF.OP 16"), 0);
+    ASSERT_EQ(prof_run_line(&ss, "PROF.US -1"), 0);
+    PASS();
+}
+
+TEST test_prof_clear() {
+    scene_state_t ss;
+    ss_init(&ss);
+    prof_clear();
+    ASSERT(prof_rank(0, NULL) == NULL);
+    prof_run_line(&ss, "X ADD X 1");
+    ASSERT(prof_rank(0, NULL) != NULL);
+
+    // PROF.CLR counts itself once it has cleared the table
+    prof_run_line(&ss, "PROF.CLR");
+    const char *name;
+    const op_profile_t *p = prof_rank(0, &name);
+    ASSERT(p != NULL);
+    ASSERT_STR_EQ(name, "PROF.CLR");
+    ASSERT_EQ(p->calls, 1);
+    ASSERT(prof_rank(1, NULL) == NULL);
+
+    // they aren't part of the scene, a scene set up to be saved or loaded
+    // leaves them alone
+    scene_state_t other;
+    ss_init(&other);
+    ASSERT(prof_rank(0, NULL) != NULL);
+    prof_clear();
+    ASSERT(prof_rank(0, NULL) == NULL);
+    PASS();
+}
+
+TEST test_prof_folded() {
+    // constant expressions in a script are folded when it is stored, the ops
+    // that were folded away are never called and so are never counted
+    scene_state_t ss;
+    ss_init(&ss);
+    prof_clear();
+    tele_command_t cmd;
+    char error_msg[TELE_ERROR_MSG_LENGTH];
+    ASSERT_EQ(parse("X ADD 1 2", &cmd, error_msg), E_OK);
+    ASSERT_EQ(validate(&cmd, error_msg), E_OK);
+    cmd.comment = false;
+    ss_overwrite_script_command(&ss, 0, 0, &cmd);
+    run_script(&ss, 0);
+    ASSERT_EQ(ss.variables.x, 3);
+
+    const char *name;
+    const op_profile_t *p = prof_rank(0, &name);
+    ASSERT(p != NULL);
+    ASSERT_STR_EQ(name, "X");
+    ASSERT_EQ(p->calls, 1);
+    ASSERT(prof_rank(1, NULL) == NULL);
+
+    // typed in live mode the same command isn't folded
+    prof_run_line(&ss, "X ADD 1 2");
+    p = prof_rank(1, &name);
+    ASSERT(p != NULL);
+    ASSERT_STR_EQ(name, "ADD");
+    PASS();
+}
+
+SUITE(prof_suite) {
+    RUN_TEST(test_prof_count);
+    RUN_TEST(test_prof_clear);
+    RUN_TEST(test_prof_folded);
+}
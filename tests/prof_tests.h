@@ -0,0 +1,8 @@
+#ifndef _PROF_TESTS_H_
+#define _PROF_TESTS_H_
+
+#include "greatest/greatest.h"
+
+SUITE_EXTERN(prof_suite);
+
+#endif
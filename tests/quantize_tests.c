@@ -0,0 +1,73 @@
+#include "quantize_tests.h"
+
+#include <stdio.h>
+
+#include "greatest/greatest.h"
+#include "quantize.h"
+#include "table.h"
+#include "teletype.h"
+
+// every scale against the search it replaces, at transposes that need the
+// input moved an octave either way
+TEST test_matches_search() {
+    const int16_t transposes[] = { 0, 500, -500, 1637, -1637, 3000, -3000 };
+    char message[64];
+    for (int16_t bits = 0; bits < 4096; bits++) {
+        quantize_scale_t q;
+        quantize_scale_init(&q, bits);
+        for (uint8_t t = 0; t < sizeof(transposes) / sizeof(transposes[0]);
+             t++) {
+            int16_t transpose = transposes[t];
+            for (int32_t v = -table_n[127] - 10; v <= table_n[127] + 10;
+                 v += 17) {
+                int16_t expected =
+                    quantize_to_bitmask_scale(bits, transpose, v);
+                int16_t got = quantize_to_scale(&q, transpose, v);
+                if (expected != got) {
+                    sprintf(message, "scale %d transpose %d input %d", bits,
+                            transpose, (int)v);
+                    ASSERT_EQm(message, expected, got);
+                }
+            }
+        }
+    }
+    PASS();
+}
+
+static int16_t run(scene_state_t *ss, const char *text) {
+    tele_command_t cmd;
+    char error_msg[TELE_ERROR_MSG_LENGTH];
+    parse(text, &cmd, error_msg);
+    validate(&cmd, error_msg);
+    exec_state_t es;
+    es_init(&es);
+    es_push(&es);
+    return process_command(ss, &es, &cmd).value;
+}
+
+// QT.B and QT.BX follow N.B and N.BX after quantizing to the old scale
+TEST test_n_b_changes_scale() {
+    scene_state_t ss;
+    ss_init(&ss);
+
+    // D is in the default major scale
+    ASSERT_EQ(run(&ss, "QT.B SUB N 2 20"), run(&ss, "N 2"));
+    // C and E
+    run(&ss, "N.B 0 17");
+    ASSERT_EQ(run(&ss, "QT.B SUB N 2 20"), run(&ss, "N 0"));
+    ASSERT_EQ(run(&ss, "QT.BX 1 SUB N 2 20"), run(&ss, "N 2"));
+    // C# alone
+    run(&ss, "N.BX 1 0 2");
+    ASSERT_EQ(run(&ss, "QT.BX 1 0"), run(&ss, "N 1"));
+    ASSERT_EQ(run(&ss, "QT.B 0"), 0);
+
+    // INIT.DATA leaves no scale, so inputs are left alone
+    run(&ss, "INIT.DATA");
+    ASSERT_EQ(run(&ss, "QT.B 1000"), 1000);
+    PASS();
+}
+
+SUITE(quantize_suite) {
+    RUN_TEST(test_matches_search);
+    RUN_TEST(test_n_b_changes_scale);
+}
@@ -0,0 +1,8 @@
+#ifndef _QUANTIZE_TESTS_H_
+#define _QUANTIZE_TESTS_H_
+
+#include "greatest/greatest.h"
+
+SUITE_EXTERN(quantize_suite);
+
+#endif
@@ -0,0 +1,178 @@
+#include "script_packing_tests.h"
+
+#include <string.h>
+
+#include "greatest/greatest.h"
+#include "ops/op_enum.h"
+#include "script_packing.h"
+#include "teletype.h"
+
+static uint8_t packed[SCRIPT_PACKED_MAX_SIZE];
+
+// fills script s of ss with lines
+TEST load_script(scene_state_t *ss, uint8_t s, size_t n, char *lines[]) {
+    for (size_t i = 0; i < n; i++) {
+        tele_command_t cmd;
+        char error_msg[TELE_ERROR_MSG_LENGTH];
+        ASSERT_EQm(lines[i], parse(lines[i], &cmd, error_msg), E_OK);
+        ASSERT_EQm(lines[i], validate(&cmd, error_msg), E_OK);
+        cmd.comment = false;
+        ss_overwrite_script_command(ss, s, i, &cmd);
+    }
+    PASS();
+}
+
+TEST assert_scripts_equal(scene_state_t *a, scene_state_t *b) {
+    for (uint8_t s = 0; s < EDITABLE_SCRIPT_COUNT; s++) {
+        ASSERT_EQ(ss_get_script_len(a, s), ss_get_script_len(b, s));
+        for (uint8_t l = 0; l < ss_get_script_len(a, s); l++) {
+            const tele_command_t *x = ss_get_script_command(a, s, l);
+            const tele_command_t *y = ss_get_script_command(b, s, l);
+            ASSERT_EQ(x->length, y->length);
+            ASSERT_EQ(x->separator, y->separator);
+            ASSERT_EQ(x->comment, y->comment);
+            for (uint8_t w = 0; w < x->length; w++) {
+                ASSERT_EQ(x->data[w].tag, y->data[w].tag);
+                if (x->data[w].tag == PRE_SEP || x->data[w].tag == SUB_SEP)
+                    continue;
+                ASSERT_EQ(x->data[w].value, y->data[w].value);
+            }
+        }
+    }
+    PASS();
+}
+
+TEST test_pack_round_trip() {
+    char *script_1[] = { "X ADD 1000 -7", "Y 30", "Z 31",
+                         "IF GT X 0: CV 1 N 60; TR.P 1", "A 5",
+                         "B -32768" };
+    char *metro[] = { "L 1 4: P.PUSH I" };
+    char *init[] = { "M 250", "T 32767" };
+
+    scene_state_t ss;
+    ss_init(&ss);
+    CHECK_CALL(load_script(&ss, 0, 6, script_1));
+    CHECK_CALL(load_script(&ss, METRO_SCRIPT, 1, metro));
+    CHECK_CALL(load_script(&ss, INIT_SCRIPT, 2, init));
+    ss_set_script_comment(&ss, 0, 4, 1);
+
+    size_t n = pack_scripts(&ss, packed, sizeof(packed));
+
+    scene_state_t out;
+    ss_init(&out);
+    ASSERT_EQ(unpack_scripts(packed, n, &out), n);
+    CHECK_CALL(assert_scripts_equal(&ss, &out));
+
+    // the scripts are compiled and ready to run
+    run_script(&out, 0);
+    ASSERT_EQ(out.variables.x, 993);
+    ASSERT_EQ(out.variables.z, 31);
+    ASSERT_EQ(out.variables.a, 1);  // commented out
+    ASSERT_EQ(out.variables.b, -32768);
+
+    PASS();
+}
+
+TEST test_pack_small_values() {
+    tele_command_t cmd;
+    char error_msg[TELE_ERROR_MSG_LENGTH];
+    uint8_t buf[PACKED_COMMAND_MAX_SIZE];
+
+    // 2 bytes of header, 2 for the op and 1 for the value
+    // parse doesn't set it, pack_command stores it
+    cmd.comment = false;
+    parse("X 30", &cmd, error_msg);
+    ASSERT_EQ(pack_command(&cmd, buf, sizeof(buf)), 5);
+
+    // values above 30 are escaped
+    parse("X 31", &cmd, error_msg);
+    ASSERT_EQ(pack_command(&cmd, buf, sizeof(buf)), 7);
+    parse("X -1", &cmd, error_msg);
+    ASSERT_EQ(pack_command(&cmd, buf, sizeof(buf)), 7);
+
+    // and a short buffer is refused rather than overrun
+    ASSERT_EQ(pack_command(&cmd, buf, 6), 0);
+
+    PASS();
+}
+
+TEST test_pack_truncated() {
+    char *lines[] = { "X 1", "Y 2", "Z 3" };
+
+    scene_state_t ss;
+    ss_init(&ss);
+    CHECK_CALL(load_script(&ss, 0, 3, lines));
+    CHECK_CALL(load_script(&ss, 1, 3, lines));
+
+    // all of it needs a byte per script and 5 per line
+    ASSERT_EQ(packed_scripts_size(&ss), EDITABLE_SCRIPT_COUNT + 6 * 5);
+
+    // room for script 1 and a line and a half of script 2
+    size_t n = pack_scripts(&ss, packed, 1 + 3 * 5 + 1 + 5 + 3);
+    ASSERT_EQ(n, 1 + 3 * 5 + 1 + 5);
+
+    scene_state_t out;
+    ss_init(&out);
+    ASSERT_EQ(unpack_scripts(packed, n, &out), n);
+    ASSERT_EQ(ss_get_script_len(&out, 0), 3);
+    ASSERT_EQ(ss_get_script_len(&out, 1), 1);
+    ASSERT_EQ(ss_get_script_len(&out, 2), 0);
+
+    PASS();
+}
+
+TEST test_pack_largest() {
+    // every word escaped, which a scene loaded from USB can do
+    tele_command_t cmd;
+    cmd.length = COMMAND_MAX_LENGTH;
+    cmd.separator = -1;
+    cmd.comment = false;
+    for (uint8_t w = 0; w < COMMAND_MAX_LENGTH; w++) {
+        cmd.data[w].tag = NUMBER;
+        cmd.data[w].value = 1000 + w;
+    }
+
+    scene_state_t ss;
+    ss_init(&ss);
+    for (uint8_t s = 0; s < EDITABLE_SCRIPT_COUNT; s++)
+        for (uint8_t l = 0; l < SCRIPT_MAX_COMMANDS; l++)
+            ss_overwrite_script_command(&ss, s, l, &cmd);
+
+    // it all fits, nothing is cut off
+    ASSERT_EQ(packed_scripts_size(&ss), SCRIPT_PACKED_MAX_SIZE);
+    size_t n = pack_scripts(&ss, packed, sizeof(packed));
+    ASSERT_EQ(n, SCRIPT_PACKED_MAX_SIZE);
+
+    scene_state_t out;
+    ss_init(&out);
+    ASSERT_EQ(unpack_scripts(packed, n, &out), n);
+    CHECK_CALL(assert_scripts_equal(&ss, &out));
+
+    PASS();
+}
+
+TEST test_unpack_bad_op() {
+    tele_command_t cmd;
+    char error_msg[TELE_ERROR_MSG_LENGTH];
+    uint8_t buf[PACKED_COMMAND_MAX_SIZE];
+
+    cmd.comment = false;
+    parse("X 1", &cmd, error_msg);
+    size_t n = pack_command(&cmd, buf, sizeof(buf));
+    ASSERT_EQ(unpack_command(buf, n, &cmd), n);
+    ASSERT_EQ(unpack_command(buf, n - 1, &cmd), 0);
+
+    // erased flash is never a valid command
+    memset(buf, 0xFF, sizeof(buf));
+    ASSERT_EQ(unpack_command(buf, sizeof(buf), &cmd), 0);
+
+    PASS();
+}
+
+SUITE(script_packing_suite) {
+    RUN_TEST(test_pack_round_trip);
+    RUN_TEST(test_pack_small_values);
+    RUN_TEST(test_pack_truncated);
+    RUN_TEST(test_pack_largest);
+    RUN_TEST(test_unpack_bad_op);
+}
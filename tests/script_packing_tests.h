@@ -0,0 +1,8 @@
+#ifndef _SCRIPT_PACKING_TESTS_H_
+#define _SCRIPT_PACKING_TESTS_H_
+
+#include "greatest/greatest.h"
+
+SUITE_EXTERN(script_packing_suite);
+
+#endif
@@ -4,6 +4,7 @@
 #include <string.h>
 
 #include "greatest/greatest.h"
+#include "helpers.h"
 #include "log.h"
 #include "ops/op_enum.h"
 #include "scene_serialization.h"
@@ -14,18 +15,13 @@
 void test_file_write_buffer(void* self_data, uint8_t* buffer, uint16_t size) {
     fwrite(buffer, 1, size, (FILE*)self_data);
 }
-void test_file_write_char(void* self_data, uint8_t c) {
-    fputc(c, (FILE*)self_data);
-}
 void test_print_dbg(const char* c) {
     printf("%s\n", c);
 }
 
-uint16_t test_file_read_char(void* self_data) {
-    return (uint16_t)fgetc((FILE*)self_data);
-}
-bool test_file_eof(void* self_data) {
-    return feof((FILE*)self_data) != 0;
+uint16_t test_file_read_buffer(void* self_data, uint8_t* buffer,
+                               uint16_t size) {
+    return fread(buffer, 1, size, (FILE*)self_data);
 }
 
 typedef struct {
@@ -36,28 +32,21 @@ typedef struct {
 
 void test_string_write_buffer(void* self_data, uint8_t* buffer, uint16_t size) {
     stringsource* ss = (stringsource*)self_data;
-    strncpy(ss->buffer + ss->position, (char*)buffer, size);
+    memcpy(ss->buffer + ss->position, buffer, size);
     ss->position += size;
     ss->length += size;
 }
-void test_string_write_char(void* self_data, uint8_t c) {
-    stringsource* ss = (stringsource*)self_data;
-    ss->buffer[ss->position] = c;
-    ss->position += 1;
-    ss->length += 1;
-}
-uint16_t test_string_read_char(void* self_data) {
-    stringsource* ss = (stringsource*)self_data;
-    if (ss->position < ss->length) {
-        char r = ss->buffer[ss->position];
-        ss->position += 1;
-        return r;
-    }
-    else { return -1; }
-}
-bool test_string_eof(void* self_data) {
+// hands out at most 3 bytes at a time, so the tests cover reads that split
+// lines and tokens
+uint16_t test_string_read_buffer(void* self_data, uint8_t* buffer,
+                                 uint16_t size) {
     stringsource* ss = (stringsource*)self_data;
-    return (ss->position >= ss->length);
+    uint16_t n = ss->length - ss->position;
+    if (n > size) n = size;
+    if (n > 3) n = 3;
+    memcpy(buffer, ss->buffer + ss->position, n);
+    ss->position += n;
+    return n;
 }
 
 tt_serializer_t test_file_writer, test_string_writer;
@@ -65,19 +54,15 @@ tt_deserializer_t test_file_reader, test_string_reader;
 
 void init_serializers() {
     test_file_writer.write_buffer = &test_file_write_buffer;
-    test_file_writer.write_char = &test_file_write_char;
     test_file_writer.print_dbg = &test_print_dbg;
 
-    test_file_reader.read_char = &test_file_read_char;
-    test_file_reader.eof = &test_file_eof;
+    test_file_reader.read_buffer = &test_file_read_buffer;
     test_file_reader.print_dbg = &test_print_dbg;
 
     test_string_writer.write_buffer = &test_string_write_buffer;
-    test_string_writer.write_char = &test_string_write_char;
     test_string_writer.print_dbg = &test_print_dbg;
 
-    test_string_reader.read_char = &test_string_read_char;
-    test_string_reader.eof = &test_string_eof;
+    test_string_reader.read_buffer = &test_string_read_buffer;
     test_string_reader.print_dbg = &test_print_dbg;
 }
 
@@ -165,6 +150,215 @@ TEST test_deserialize_fragment_script_basic() {
     PASS();
 }
 
+TEST test_round_trip_patterns() {
+    scene_state_t scene;
+    ss_init(&scene);
+
+    char text[SCENE_TEXT_LINES][SCENE_TEXT_CHARS];
+    memset(text, 0, SCENE_TEXT_LINES * SCENE_TEXT_CHARS);
+    strcpy(text[0], "PATTERNS");
+
+    for (int l = 0; l < PATTERN_LENGTH; l++)
+        for (int b = 0; b < PATTERN_COUNT; b++)
+            ss_set_pattern_val(&scene, b, l, (l * 331 + b) * (b & 1 ? -1 : 1));
+    ss_set_pattern_len(&scene, 2, 17);
+
+    // a whole scene is several buffers long
+    static char buffer[16384];
+    stringsource ss = { .buffer = buffer, .length = 0, .position = 0 };
+    test_string_writer.data = (void*)&ss;
+    serialize_scene(&test_string_writer, &scene, &text);
+    ASSERT(ss.length > 2 * TT_STREAM_BUFFER_SIZE);
+
+    scene_state_t out;
+    ss_init(&out);
+    char out_text[SCENE_TEXT_LINES][SCENE_TEXT_CHARS];
+    memset(out_text, 0, SCENE_TEXT_LINES * SCENE_TEXT_CHARS);
+    buffer[ss.length] = 0;
+    deserialize_fragment(buffer, &out, &out_text);
+
+    ASSERT_STR_EQ(text[0], out_text[0]);
+    ASSERT_EQ(ss_get_pattern_len(&out, 2), 17);
+    for (int l = 0; l < PATTERN_LENGTH; l++)
+        for (int b = 0; b < PATTERN_COUNT; b++)
+            ASSERT_EQ(ss_get_pattern_val(&scene, b, l),
+                      ss_get_pattern_val(&out, b, l));
+
+    PASS();
+}
+
+// text -> binary -> text should give back the file it started from
+TEST test_round_trip_binary(char* filename) {
+    scene_state_t scene;
+    ss_init(&scene);
+    char text[SCENE_TEXT_LINES][SCENE_TEXT_CHARS];
+    memset(text, 0, SCENE_TEXT_LINES * SCENE_TEXT_CHARS);
+
+    FILE* infile = fopen(filename, "rb");
+    ASSERT(infile != 0);
+    test_file_reader.data = (void*)infile;
+    deserialize_scene(&test_file_reader, &scene, &text);
+
+    static char binary[8192];
+    stringsource bin = { .buffer = binary, .length = 0, .position = 0 };
+    test_string_writer.data = (void*)&bin;
+    serialize_scene_binary(&test_string_writer, &scene, &text);
+
+    scene_state_t out;
+    ss_init(&out);
+    char out_text[SCENE_TEXT_LINES][SCENE_TEXT_CHARS];
+    memset(out_text, 0, SCENE_TEXT_LINES * SCENE_TEXT_CHARS);
+    bin.position = 0;
+    test_string_reader.data = (void*)&bin;
+    ASSERT(deserialize_scene_binary(&test_string_reader, &out, &out_text));
+
+    FILE* outfile = tmpfile();
+    ASSERT(outfile != 0);
+    test_file_writer.data = (void*)outfile;
+    serialize_scene(&test_file_writer, &out, &out_text);
+    CHECK_CALL(compare_files(filename, infile, outfile));
+
+    fclose(infile);
+    fclose(outfile);
+    PASS();
+}
+
+// puts a new CRC on a binary scene that has been changed on purpose
+static void binary_reseal(char* binary, size_t length) {
+    uint32_t crc =
+        ~crc32_update(0xFFFFFFFF, (const uint8_t*)binary, length - 4);
+    for (uint8_t i = 0; i < 4; i++) binary[length - 4 + i] = crc >> (8 * i);
+}
+
+TEST test_binary_checks() {
+    scene_state_t scene;
+    ss_init(&scene);
+    char text[SCENE_TEXT_LINES][SCENE_TEXT_CHARS];
+    memset(text, 0, SCENE_TEXT_LINES * SCENE_TEXT_CHARS);
+    deserialize_fragment("HELLO\n\n#1\nTR.P 4\nX 1\n\n#P\n1\t2\t3\t4\n",
+                         &scene, &text);
+
+    char binary[4096];
+    stringsource bin = { .buffer = binary, .length = 0, .position = 0 };
+    test_string_writer.data = (void*)&bin;
+    serialize_scene_binary(&test_string_writer, &scene, &text);
+    bin.position = 0;
+    test_string_reader.data = (void*)&bin;
+
+    scene_state_t out;
+    ss_init(&out);
+    ASSERT(deserialize_scene_binary(&test_string_reader, &out, &text));
+    ASSERT_EQ(ss_get_script_len(&out, 0), 2);
+    ASSERT_EQ(ss_get_pattern_len(&out, 3), 4);
+    ASSERT_STR_EQ(text[0], "HELLO");
+
+    // any flipped bit is caught by the CRC
+    for (unsigned int i = 0; i < bin.length; i += 7) {
+        binary[i] ^= 0x10;
+        bin.position = 0;
+        ASSERT(!deserialize_scene_binary(&test_string_reader, &out, &text));
+        binary[i] ^= 0x10;
+    }
+
+    // and so is a truncated file
+    bin.length--;
+    bin.position = 0;
+    ASSERT(!deserialize_scene_binary(&test_string_reader, &out, &text));
+
+    // text isn't mistaken for a binary scene
+    bin.length = 0;
+    bin.position = 0;
+    serialize_scene(&test_string_writer, &scene, &text);
+    bin.position = 0;
+    ASSERT(!deserialize_scene_binary(&test_string_reader, &out, &text));
+
+    PASS();
+}
+
+TEST test_binary_header() {
+    scene_state_t scene;
+    ss_init(&scene);
+    char text[SCENE_TEXT_LINES][SCENE_TEXT_CHARS];
+    memset(text, 0, SCENE_TEXT_LINES * SCENE_TEXT_CHARS);
+    deserialize_fragment("#1\nX 1\n", &scene, &text);
+
+    char binary[4096];
+    stringsource bin = { .buffer = binary, .length = 0, .position = 0 };
+    test_string_writer.data = (void*)&bin;
+    serialize_scene_binary(&test_string_writer, &scene, &text);
+    test_string_reader.data = (void*)&bin;
+    scene_state_t out;
+
+    // version 0 was never written
+    binary[4] = 0;
+    binary_reseal(binary, bin.length);
+    bin.position = 0;
+    ASSERT(!deserialize_scene_binary(&test_string_reader, &out, &text));
+    binary[4] = SCENE_BINARY_VERSION;
+
+    // nor were scenes from a firmware with more ops or mods
+    binary[6]++;
+    binary_reseal(binary, bin.length);
+    bin.position = 0;
+    ASSERT(!deserialize_scene_binary(&test_string_reader, &out, &text));
+    binary[6]--;
+    binary[8]++;
+    binary_reseal(binary, bin.length);
+    bin.position = 0;
+    ASSERT(!deserialize_scene_binary(&test_string_reader, &out, &text));
+    binary[8]--;
+
+    binary_reseal(binary, bin.length);
+    bin.position = 0;
+    ASSERT(deserialize_scene_binary(&test_string_reader, &out, &text));
+    PASS();
+}
+
+// a binary scene with cmd as the only command of script 1 is rejected, even
+// though its CRC is good
+TEST binary_bad_command_helper(const tele_command_t* cmd) {
+    scene_state_t scene;
+    ss_init(&scene);
+    char text[SCENE_TEXT_LINES][SCENE_TEXT_CHARS];
+    memset(text, 0, SCENE_TEXT_LINES * SCENE_TEXT_CHARS);
+    ss_overwrite_script_command(&scene, 0, 0, cmd);
+
+    char binary[4096];
+    stringsource bin = { .buffer = binary, .length = 0, .position = 0 };
+    test_string_writer.data = (void*)&bin;
+    serialize_scene_binary(&test_string_writer, &scene, &text);
+    test_string_reader.data = (void*)&bin;
+    scene_state_t out;
+    ss_init(&out);
+    ASSERT(!deserialize_scene_binary(&test_string_reader, &out, &text));
+    PASS();
+}
+
+TEST test_binary_bad_commands() {
+    tele_command_t cmd;
+    char error_msg[TELE_ERROR_MSG_LENGTH];
+
+    // ADD 1, short of a parameter
+    ASSERT_EQ(parse("ADD 1 2", &cmd, error_msg), E_OK);
+    cmd.comment = false;
+    cmd.length = 2;
+    CHECK_CALL(binary_bad_command_helper(&cmd));
+
+    // a separator that isn't where the PRE_SEP is
+    ASSERT_EQ(parse("IF 1: X 1", &cmd, error_msg), E_OK);
+    cmd.comment = false;
+    cmd.separator = 3;
+    CHECK_CALL(binary_bad_command_helper(&cmd));
+    cmd.separator = -1;
+    CHECK_CALL(binary_bad_command_helper(&cmd));
+
+    ASSERT_EQ(parse("X 1", &cmd, error_msg), E_OK);
+    cmd.comment = false;
+    cmd.separator = 1;
+    CHECK_CALL(binary_bad_command_helper(&cmd));
+    PASS();
+}
+
 SUITE(serialize_scene_suite) {
     log_init();
     init_serializers();
@@ -187,5 +381,12 @@ SUITE(serialize_scene_suite) {
     RUN_TESTp(test_round_trip_file, "../presets/tt08.txt",
               "./test_output/tt08.txt");
     RUN_TEST(test_deserialize_fragment_script_basic);
+    RUN_TEST(test_round_trip_patterns);
+    RUN_TESTp(test_round_trip_binary, "../presets/tt00.txt");
+    RUN_TESTp(test_round_trip_binary, "../presets/tt04.txt");
+    RUN_TESTp(test_round_trip_binary, "../presets/tt08.txt");
+    RUN_TEST(test_binary_checks);
+    RUN_TEST(test_binary_header);
+    RUN_TEST(test_binary_bad_commands);
     log_print();
 }
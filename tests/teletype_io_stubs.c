@@ -0,0 +1,77 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "teletype_io.h"
+
+// host implementations of the hardware hooks, shared by tests and bench
+
+uint32_t tele_get_ticks() {
+    return 0;
+}
+void tele_metro_updated() {}
+void tele_metro_reset() {}
+void tele_tr(uint8_t i, int16_t v) {}
+void tele_tr_pulse(uint8_t i, int16_t time) {}
+void tele_tr_pulse_clear(uint8_t i) {}
+void tele_tr_pulse_time(uint8_t i, int16_t time) {}
+void tele_cv(uint8_t i, int16_t v, uint8_t s) {}
+void tele_cv_slew(uint8_t i, int16_t v) {}
+uint16_t tele_get_cv(uint8_t i) {
+    return 0;
+}
+void tele_update_adc(uint8_t force) {}
+void tele_has_delays(bool i) {}
+void tele_has_stack(bool i) {}
+void tele_cv_off(uint8_t i, int16_t v) {}
+// i2c writes that reached the bus, checked by ii_queue_tests
+uint32_t tele_ii_tx_calls = 0;
+uint8_t tele_ii_tx_last[16];
+void tele_ii_tx(uint8_t addr, uint8_t *data, uint8_t l) {
+    tele_ii_tx_calls++;
+    for (uint8_t i = 0; i < l && i < sizeof(tele_ii_tx_last); i++)
+        tele_ii_tx_last[i] = data[i];
+}
+// each read returns the number of reads so far in its last byte
+uint32_t tele_ii_rx_calls = 0;
+void tele_ii_rx(uint8_t addr, uint8_t *data, uint8_t l) {
+    tele_ii_rx_calls++;
+    if (l > 0) data[l - 1] = tele_ii_rx_calls;
+}
+void tele_scene(uint8_t i, uint8_t init_grid, uint8_t init_pattern) {}
+void tele_pattern_updated() {}
+void tele_kill() {}
+void tele_mute() {}
+void tele_vars_updated() {}
+void tele_profile_script(size_t s, bool start) {}
+void tele_profile_delay(uint8_t d) {}
+// every read moves the counter on by one, so each op call takes one
+// microsecond
+uint32_t tele_profile_count() {
+    static uint32_t count = 0;
+    return count++;
+}
+uint32_t tele_profile_count_us(uint32_t count) {
+    return count;
+}
+bool tele_get_input_state(uint8_t n) {
+    return false;
+}
+void device_flip() {}
+void set_live_submode(uint8_t submode) {}
+void select_dash_screen(uint8_t screen) {}
+void print_dashboard_value(uint8_t index, int16_t value) {}
+int16_t get_dashboard_value(uint8_t index) {
+    return 0;
+}
+void reset_midi_counter() {}
+uint32_t tele_save_calibration_calls = 0;
+void tele_save_calibration() {
+    tele_save_calibration_calls++;
+}
+void grid_key_press(uint8_t x, uint8_t y, uint8_t z) {}
+// simulator/ii_bus.c names the scripts with this from simulator/profile.c,
+// which the tests don't link
+void profile_script_name(uint8_t s, char *name) {
+    name[0] = 0;
+}
@@ -57,6 +57,7 @@ OPS_SECTIONS = [
     ("stack",         "Stack",         False),
     ("queue",         "Queue",         False),
     ("seed",          "Seed",          False),
+    ("profile",       "Profiling",     False),
     ("turtle",        "Turtle",        True),
     ("grid",          "Grid",          True),
     ("midi_in",       "MIDI In",       True),
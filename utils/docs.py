@@ -42,6 +42,7 @@ OPS_SECTIONS = [
     "stack",
     "queue",
     "seed",
+    "profile",
     "turtle",
     "grid",
     "midi_in",
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+
+import re
+import sys
+from glob import glob
+from os import path
+
+from common import list_tele_ops, list_tele_mods, OP_C
+
+if (sys.version_info.major, sys.version_info.minor) < (3, 6):
+    raise Exception("need Python 3.6 or later")
+
+THIS_FILE = path.realpath(__file__)
+THIS_DIR = path.dirname(THIS_FILE)
+TABLE_H = path.abspath(path.join(THIS_DIR, "../src/match_token_hash.h"))
+OPS_DIR = path.abspath(path.join(THIS_DIR, "../src/ops"))
+
+# the first argument of every MAKE_*_OP and MAKE_MOD macro is stringified into
+# the .name field
+DEFINITION = re.compile(r"const\s+tele_(?:op|mod)_t\s+((?:op|mod)_\w+)\s*="
+                        r"\s*MAKE_\w+\s*\(\s*([^,]+?)\s*,")
+
+# must match match_hash() in src/match_token_hash.c
+FNV_BASIS = 0x811C9DC5
+FNV_PRIME = 0x01000193
+
+# flag for mod entries in the slot table
+MATCH_HASH_MOD = 0x8000
+
+# average number of keys per bucket, lower values make the search faster but
+# the displacement table larger
+BUCKET_SIZE = 4
+
+HEADER_PRE = """// clang-format off
+
+#ifndef _MATCH_TOKEN_HASH_H_
+#define _MATCH_TOKEN_HASH_H_
+
+// This file has been autogenerated by 'utils/match_token_hash.py'
+
+#include <stdint.h>
+
+"""
+HEADER_POST = "#endif\n"
+
+
+def list_names():
+    """Return the .name of every struct defined in src/ops"""
+    names = {}
+    for c_file in glob(path.join(OPS_DIR, "*.c")):
+        with open(c_file, "r") as f:
+            for struct, name in DEFINITION.findall(f.read()):
+                names[struct] = " ".join(name.split())
+    return names
+
+
+def match_hash(name, seed):
+    h = FNV_BASIS ^ seed
+    for c in name.encode("ascii"):
+        h ^= c
+        h = (h * FNV_PRIME) & 0xFFFFFFFF
+    return h
+
+
+def make_perfect_hash(keys):
+    """Hash and displace: every key is assigned a bucket with seed 0, then
+    the buckets are placed largest first by searching for a seed that moves
+    all of their keys into free slots. Returns (seeds, slots)."""
+    size = len(keys)
+    bucket_count = (size + BUCKET_SIZE - 1) // BUCKET_SIZE
+    buckets = [[] for _ in range(bucket_count)]
+    for k in keys:
+        buckets[match_hash(k, 0) % bucket_count].append(k)
+
+    seeds = [0] * bucket_count
+    slots = [None] * size
+    order = sorted(range(bucket_count), key=lambda b: -len(buckets[b]))
+    for b in order:
+        if not buckets[b]:
+            continue
+        for seed in range(1, 0x10000):
+            taken = [match_hash(k, seed) % size for k in buckets[b]]
+            if len(set(taken)) == len(taken) and \
+               all(slots[t] is None for t in taken):
+                break
+        else:
+            raise Exception(f"no seed found for bucket {b}")
+        seeds[b] = seed
+        for k, t in zip(buckets[b], taken):
+            slots[t] = k
+    return seeds, slots
+
+
+def make_array(ctype, name, size, entries, per_line):
+    output = f"static const {ctype} {name}[{size}] = {{\n"
+    for i in range(0, len(entries), per_line):
+        output += "    " + " ".join(f"{e}," for e in entries[i:i + per_line])
+        output += "\n"
+    output += "};\n\n"
+    return output
+
+
+def main():
+    print("reading:    {}".format(OP_C))
+    print("generating: {}".format(TABLE_H))
+    names = list_names()
+    ops = [names[s] for s in list_tele_ops()]
+    mods = [names[s] for s in list_tele_mods()]
+    # ops are stored as their index, mods as their index with the top bit set
+    index = {}
+    for i, name in enumerate(ops):
+        index[name] = i
+    for i, name in enumerate(mods):
+        index[name] = MATCH_HASH_MOD | i
+    if len(index) != len(ops) + len(mods):
+        raise Exception("duplicate op or mod name")
+
+    seeds, slots = make_perfect_hash(list(index))
+    entries = [f"0x{index[name]:04X}" for name in slots]
+
+    output = HEADER_PRE
+    output += f"#define MATCH_HASH_MOD 0x{MATCH_HASH_MOD:04X}\n"
+    output += f"#define MATCH_HASH_SIZE {len(slots)}\n"
+    output += f"#define MATCH_HASH_BUCKETS {len(seeds)}\n\n"
+    output += make_array("uint16_t", "match_hash_seeds", "MATCH_HASH_BUCKETS",
+                         [str(s) for s in seeds], 12)
+    output += make_array("uint16_t", "match_hash_slots", "MATCH_HASH_SIZE",
+                         entries, 9)
+    output += HEADER_POST
+    with open(TABLE_H, "w") as g:
+        g.write(output)
+
+
+if __name__ == '__main__':
+    main()